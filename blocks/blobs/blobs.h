@@ -27,35 +27,301 @@ SOFTWARE.
 
 #include "../../port.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifndef CURRENT_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // CURRENT_WINDOWS
+
+#include "exceptions.h"
 
 #include "../../bricks/file/file.h"
-#include "../../typesystem/reflection/typeid.h"
+#include "../../typesystem/reflection/reflection.h"
 
 namespace current {
 
+// The blob file is the `TypeID` of `T`, followed by the raw array of `T`-s.
+// `T` must be trivially copyable, and must not require the alignment stricter than that of the header,
+// as the first element immediately follows the header in the file. Plain structs get their `TypeID`-s
+// via `CURRENT_INJECT_TYPE_ID()`; `CURRENT_STRUCT`-s are not trivially copyable, and thus can not be blobs.
+template <class T>
+struct BlobTraits final {
+  static_assert(std::is_trivially_copyable<T>::value, "Blobs can only hold trivially copyable types.");
+  static_assert(alignof(T) <= alignof(current::reflection::TypeID), "The blob header would misalign the elements.");
+  constexpr static size_t kHeaderSize = sizeof(current::reflection::TypeID);
+};
+
+// The hint passed to `madvise()` for the whole mapped blob.
+enum class BlobAccessPattern : int { Normal = 0, Sequential = 1, Random = 2 };
+
+// A read-only typed view of the blob file. The file is `mmap()`-ed, not read, so opening a multi-gigabyte blob
+// costs neither the copy nor the resident memory beyond the pages actually touched.
+// Exposes `size()`, `operator[]`, and `begin()` / `end()`, so that `for (const T& e : blob)` just works.
+// On Windows, falls back to reading the file into memory.
+template <class T>
+class BlobView final {
+ public:
+  using value_type = T;
+  using const_iterator = const T*;
+  using iterator = const_iterator;
+
+  // The default chunk for `ParallelForEachChunk()` is 1MB with 4KB pages.
+  constexpr static size_t kDefaultPagesPerChunk = 256u;
+
+  explicit BlobView(const std::string& filename, BlobAccessPattern access_pattern = BlobAccessPattern::Sequential) {
+    constexpr size_t header_size = BlobTraits<T>::kHeaderSize;
+#ifndef CURRENT_WINDOWS
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      CURRENT_THROW(blobs::BlobCannotOpenFileException(filename));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);                                                  // LCOV_EXCL_LINE
+      CURRENT_THROW(blobs::BlobCannotOpenFileException(filename));  // LCOV_EXCL_LINE
+    }
+    const size_t length = static_cast<size_t>(st.st_size);
+    if (length < header_size) {
+      ::close(fd);
+      CURRENT_THROW(blobs::BlobWrongSizeException());
+    }
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping remains valid after the descriptor is closed.
+    if (mapped == MAP_FAILED) {
+      CURRENT_THROW(blobs::BlobCannotOpenFileException(filename));  // LCOV_EXCL_LINE
+    }
+    mapped_ = static_cast<const char*>(mapped);
+    mapped_length_ = length;
+    page_size_ = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#else
+    contents_ = current::FileSystem::ReadFileAsString(filename);
+    if (contents_.length() < header_size) {
+      CURRENT_THROW(blobs::BlobWrongSizeException());
+    }
+    mapped_ = contents_.data();
+    mapped_length_ = contents_.length();
+    page_size_ = 4096u;
+#endif  // CURRENT_WINDOWS
+    // The destructor does not run if the constructor throws, so unmap explicitly if the checks below fail.
+    try {
+      if (*reinterpret_cast<const current::reflection::TypeID*>(mapped_) != current::reflection::CurrentTypeID<T>()) {
+        CURRENT_THROW(blobs::BlobWrongTypeException());
+      }
+      size_ = (mapped_length_ - header_size) / sizeof(T);
+      if (header_size + size_ * sizeof(T) != mapped_length_) {
+        CURRENT_THROW(blobs::BlobWrongSizeException());
+      }
+    } catch (...) {
+      Unmap();
+      throw;
+    }
+    data_ = reinterpret_cast<const T*>(mapped_ + header_size);
+    Advise(access_pattern);
+  }
+
+  BlobView(BlobView&& rhs)
+      : mapped_(rhs.mapped_),
+        mapped_length_(rhs.mapped_length_),
+        page_size_(rhs.page_size_),
+        data_(rhs.data_),
+        size_(rhs.size_) {
+#ifdef CURRENT_WINDOWS
+    contents_ = std::move(rhs.contents_);
+    mapped_ = contents_.data();
+    data_ = reinterpret_cast<const T*>(mapped_ + BlobTraits<T>::kHeaderSize);
+#endif  // CURRENT_WINDOWS
+    rhs.mapped_ = nullptr;
+    rhs.data_ = nullptr;
+    rhs.mapped_length_ = 0u;
+    rhs.size_ = 0u;
+  }
+
+  BlobView(const BlobView&) = delete;
+  BlobView& operator=(const BlobView&) = delete;
+  BlobView& operator=(BlobView&&) = delete;
+
+  ~BlobView() { Unmap(); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0u; }
+  const T* data() const { return data_; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  const T& operator[](size_t i) const { return data_[i]; }
+
+  // Changes the `madvise()` hint for the whole blob, i.e. `Random` before point lookups into a large blob.
+  void Advise(BlobAccessPattern access_pattern) const {
+#ifndef CURRENT_WINDOWS
+    const int advice = access_pattern == BlobAccessPattern::Sequential
+                           ? MADV_SEQUENTIAL
+                           : (access_pattern == BlobAccessPattern::Random ? MADV_RANDOM : MADV_NORMAL);
+    ::madvise(const_cast<char*>(mapped_), mapped_length_, advice);
+#else
+    static_cast<void>(access_pattern);
+#endif  // CURRENT_WINDOWS
+  }
+
+  // Calls `f(const T* chunk_begin, size_t chunk_size, size_t chunk_first_index)` for the consecutive chunks
+  // of the blob, from `threads` threads concurrently, so `f` must be thread-safe. `threads == 0` means one per core.
+  // The chunks are aligned by the pages of the file, so that no two threads fault in the same page, save for
+  // the element straddling the boundary, and each chunk is prefetched with `MADV_WILLNEED` right before it's used.
+  // Rethrows the first exception thrown by `f`, once all the threads are done.
+  template <class F>
+  void ParallelForEachChunk(F&& f, size_t threads = 0u, size_t pages_per_chunk = kDefaultPagesPerChunk) const {
+    const size_t chunk_bytes = std::max(static_cast<size_t>(1u), pages_per_chunk) * page_size_;
+    const size_t total_chunks = (mapped_length_ + chunk_bytes - 1u) / chunk_bytes;
+    if (!threads) {
+      threads = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1u));
+    }
+    threads = std::min(threads, total_chunks);
+
+    std::atomic_size_t next_chunk(0u);
+    std::exception_ptr first_exception;
+    std::mutex first_exception_mutex;
+    auto worker = [&]() {
+      size_t chunk;
+      while ((chunk = next_chunk++) < total_chunks) {
+        const size_t begin = FirstIndexAtOrPastByte(chunk * chunk_bytes);
+        const size_t end = FirstIndexAtOrPastByte((chunk + 1u) * chunk_bytes);
+        if (begin < end) {
+#ifndef CURRENT_WINDOWS
+          const size_t chunk_offset = chunk * chunk_bytes;
+          ::madvise(const_cast<char*>(mapped_) + chunk_offset,
+                    std::min(chunk_bytes, mapped_length_ - chunk_offset),
+                    MADV_WILLNEED);
+#endif  // CURRENT_WINDOWS
+          try {
+            f(data_ + begin, end - begin, begin);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(first_exception_mutex);
+            if (!first_exception) {
+              first_exception = std::current_exception();
+            }
+            next_chunk = total_chunks;
+          }
+        }
+      }
+    };
+
+    if (threads <= 1u) {
+      worker();
+    } else {
+      std::vector<std::thread> workers;
+      workers.reserve(threads - 1u);
+      for (size_t i = 1u; i < threads; ++i) {
+        workers.emplace_back(worker);
+      }
+      worker();
+      for (auto& t : workers) {
+        t.join();
+      }
+    }
+    if (first_exception) {
+      std::rethrow_exception(first_exception);
+    }
+  }
+
+ private:
+  // The index of the first element that begins at or past the byte `offset` of the file.
+  size_t FirstIndexAtOrPastByte(size_t offset) const {
+    constexpr size_t header_size = BlobTraits<T>::kHeaderSize;
+    if (offset <= header_size) {
+      return 0u;
+    }
+    return std::min(size_, (offset - header_size + sizeof(T) - 1u) / sizeof(T));
+  }
+
+  void Unmap() {
+#ifndef CURRENT_WINDOWS
+    if (mapped_) {
+      ::munmap(const_cast<char*>(mapped_), mapped_length_);
+    }
+#endif  // CURRENT_WINDOWS
+    mapped_ = nullptr;
+  }
+
+  const char* mapped_ = nullptr;
+  size_t mapped_length_ = 0u;
+  size_t page_size_ = 0u;
+  const T* data_ = nullptr;
+  size_t size_ = 0u;
+#ifdef CURRENT_WINDOWS
+  std::string contents_;
+#endif  // CURRENT_WINDOWS
+};
+
+// Writes the blob file element by element, so that the whole array never has to be held in memory.
+// The file is only ever appended to; it is a valid blob once the writer is destroyed, or after `Flush()`.
+template <class T>
+class BlobWriter final {
+ public:
+  explicit BlobWriter(const std::string& filename) : filename_(filename), file_(filename, std::ios::binary) {
+    if (!file_) {
+      CURRENT_THROW(blobs::BlobCannotOpenFileException(filename));
+    }
+    const auto signature = current::reflection::CurrentTypeID<T>();
+    Write(reinterpret_cast<const char*>(&signature), sizeof(signature));
+  }
+
+  BlobWriter& Append(const T& element) {
+    Write(reinterpret_cast<const char*>(&element), sizeof(T));
+    ++size_;
+    return *this;
+  }
+
+  BlobWriter& Append(const T* elements, size_t count) {
+    if (count) {
+      Write(reinterpret_cast<const char*>(elements), sizeof(T) * count);
+      size_ += count;
+    }
+    return *this;
+  }
+
+  BlobWriter& Append(const std::vector<T>& elements) { return Append(elements.data(), elements.size()); }
+
+  void Flush() {
+    file_.flush();
+    if (!file_) {
+      CURRENT_THROW(blobs::BlobException("Failed to flush the blob file: `" + filename_ + "`."));  // LCOV_EXCL_LINE
+    }
+  }
+
+  // The number of elements written so far.
+  size_t size() const { return size_; }
+
+ private:
+  void Write(const char* data, size_t length) {
+    file_.write(data, length);
+    if (!file_) {
+      CURRENT_THROW(blobs::BlobException("Failed to write the blob file: `" + filename_ + "`."));  // LCOV_EXCL_LINE
+    }
+  }
+
+  const std::string filename_;
+  std::ofstream file_;
+  size_t size_ = 0u;
+};
+
 template <class T>
 void WriteBlob(const std::vector<T>& data, const std::string& filename) {
-  std::ofstream file(filename, std::ios::binary);
-  const auto signature = current::reflection::CurrentTypeID<T>();
-  file.write(reinterpret_cast<const char*>(&signature), sizeof(signature));
-  file.write(reinterpret_cast<const char*>(&data[0]), sizeof(T) * data.size());
+  BlobWriter<T>(filename).Append(data);
 }
 
 template <class T, class F>
 void ProcessBlob(const std::string& filename, F&& f) {
-  const std::string contents = current::FileSystem::ReadFileAsString(filename);
-  const auto signature = *reinterpret_cast<const current::reflection::TypeID*>(contents.c_str());
-  if (signature != current::reflection::CurrentTypeID<T>()) {
-    throw current::Exception("Wrong type.");
-  }
-  size_t length = contents.length();
-  size_t n = (length - sizeof(signature)) / sizeof(T);
-  if (sizeof(signature) + n * sizeof(T) != length) {
-    throw current::Exception("Wrong file size.");
-  }
-  // TODO(dkorolev): Add a wrapper class so that it has `.size()`, iteration via `for (element : elements)`, etc.
-  f(reinterpret_cast<const T*>(contents.c_str() + sizeof(signature)), n);
+  const BlobView<T> blob(filename);
+  f(blob.data(), blob.size());
 }
 
 }  // namespace current
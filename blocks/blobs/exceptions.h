@@ -0,0 +1,53 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_BLOCKS_BLOBS_EXCEPTIONS_H
+#define CURRENT_BLOCKS_BLOBS_EXCEPTIONS_H
+
+#include "../../bricks/exception.h"
+
+namespace current {
+namespace blobs {
+
+struct BlobException : current::Exception {
+  using current::Exception::Exception;
+};
+
+struct BlobCannotOpenFileException : BlobException {
+  explicit BlobCannotOpenFileException(const std::string& filename)
+      : BlobException("Cannot open blob file: `" + filename + "`.") {}
+};
+
+struct BlobWrongTypeException : BlobException {
+  BlobWrongTypeException() : BlobException("Wrong type.") {}
+};
+
+struct BlobWrongSizeException : BlobException {
+  BlobWrongSizeException() : BlobException("Wrong file size.") {}
+};
+
+}  // namespace blobs
+}  // namespace current
+
+#endif  // CURRENT_BLOCKS_BLOBS_EXCEPTIONS_H
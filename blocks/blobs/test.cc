@@ -0,0 +1,176 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#include "blobs.h"
+
+#include "../../bricks/dflags/dflags.h"
+
+#include "../../3rdparty/gtest/gtest-main-with-dflags.h"
+
+DEFINE_string(blobs_test_tmpdir, ".current", "Local path for the test to create temporary files in.");
+
+TEST(Blobs, WriteAndProcess) {
+  const std::string filename = current::FileSystem::JoinPath(FLAGS_blobs_test_tmpdir, "blob");
+  const auto file_remover = current::FileSystem::ScopedRmFile(filename);
+
+  current::WriteBlob(std::vector<double>({1.0, 2.5, -3.0}), filename);
+  EXPECT_EQ(sizeof(current::reflection::TypeID) + 3u * sizeof(double),
+            current::FileSystem::ReadFileAsString(filename).length());
+
+  double sum = 0.0;
+  size_t count = 0u;
+  current::ProcessBlob<double>(filename, [&](const double* data, size_t n) {
+    count = n;
+    for (size_t i = 0; i < n; ++i) {
+      sum += data[i];
+    }
+  });
+  EXPECT_EQ(3u, count);
+  EXPECT_EQ(0.5, sum);
+}
+
+TEST(Blobs, View) {
+  const std::string filename = current::FileSystem::JoinPath(FLAGS_blobs_test_tmpdir, "blob");
+  const auto file_remover = current::FileSystem::ScopedRmFile(filename);
+
+  {
+    current::BlobWriter<uint64_t> writer(filename);
+    for (uint64_t i = 0; i < 1000; ++i) {
+      writer.Append(i * i);
+    }
+    EXPECT_EQ(1000u, writer.size());
+  }
+
+  const current::BlobView<uint64_t> blob(filename);
+  ASSERT_EQ(1000u, blob.size());
+  EXPECT_FALSE(blob.empty());
+  EXPECT_EQ(0u, blob[0]);
+  EXPECT_EQ(999u * 999u, blob[999]);
+  uint64_t i = 0u;
+  for (const uint64_t e : blob) {
+    ASSERT_EQ(i * i, e);
+    ++i;
+  }
+  EXPECT_EQ(1000u, i);
+
+  blob.Advise(current::BlobAccessPattern::Random);
+  EXPECT_EQ(500u * 500u, blob[500]);
+}
+
+TEST(Blobs, EmptyBlob) {
+  const std::string filename = current::FileSystem::JoinPath(FLAGS_blobs_test_tmpdir, "blob");
+  const auto file_remover = current::FileSystem::ScopedRmFile(filename);
+
+  current::WriteBlob(std::vector<int32_t>(), filename);
+  const current::BlobView<int32_t> blob(filename);
+  EXPECT_TRUE(blob.empty());
+  EXPECT_TRUE(blob.begin() == blob.end());
+  size_t calls = 0u;
+  blob.ParallelForEachChunk([&calls](const int32_t*, size_t, size_t) { ++calls; });
+  EXPECT_EQ(0u, calls);
+}
+
+TEST(Blobs, Errors) {
+  const std::string filename = current::FileSystem::JoinPath(FLAGS_blobs_test_tmpdir, "blob");
+  const auto file_remover = current::FileSystem::ScopedRmFile(filename);
+
+  ASSERT_THROW(current::BlobView<double>{filename}, current::blobs::BlobCannotOpenFileException);
+
+  current::WriteBlob(std::vector<double>({1.0, 2.0}), filename);
+  ASSERT_THROW(current::BlobView<uint64_t>{filename}, current::blobs::BlobWrongTypeException);
+  // The exceptions are `current::Exception`-s with the same messages `ProcessBlob()` has always thrown.
+  try {
+    current::ProcessBlob<uint64_t>(filename, [](const uint64_t*, size_t) {});
+    ASSERT_TRUE(false);
+  } catch (const current::Exception& e) {
+    EXPECT_EQ("Wrong type.", e.OriginalDescription());
+  }
+
+  current::FileSystem::WriteStringToFile(current::FileSystem::ReadFileAsString(filename) + "extra", filename.c_str());
+  ASSERT_THROW(current::BlobView<double>{filename}, current::blobs::BlobWrongSizeException);
+
+  current::FileSystem::WriteStringToFile("tiny", filename.c_str());
+  ASSERT_THROW(current::BlobView<double>{filename}, current::blobs::BlobWrongSizeException);
+}
+
+// An odd element size, so that the elements do straddle the page boundaries.
+// A plain struct, not a `CURRENT_STRUCT`, as blobs hold trivially copyable types only.
+struct Triple {
+  int32_t a;
+  int32_t b;
+  int32_t c;
+};
+static_assert(sizeof(Triple) == 12, "");
+CURRENT_INJECT_TYPE_ID(Triple, 9000000000000012345ull);
+
+TEST(Blobs, ParallelForEachChunk) {
+  const std::string filename = current::FileSystem::JoinPath(FLAGS_blobs_test_tmpdir, "blob");
+  const auto file_remover = current::FileSystem::ScopedRmFile(filename);
+
+  const size_t n = 100000u;
+  {
+    current::BlobWriter<Triple> writer(filename);
+    for (size_t i = 0; i < n; ++i) {
+      const int32_t x = static_cast<int32_t>(i);
+      writer.Append(Triple{x, x + 1, x + 2});
+    }
+  }
+
+  const current::BlobView<Triple> blob(filename);
+  ASSERT_EQ(n, blob.size());
+  for (size_t threads : {1u, 4u}) {
+    for (size_t pages_per_chunk : {1u, 3u, 256u}) {
+      std::vector<std::atomic_int> seen(n);
+      std::atomic_size_t chunks(0u);
+      blob.ParallelForEachChunk(
+          [&](const Triple* data, size_t count, size_t first_index) {
+            ASSERT_TRUE(data == blob.data() + first_index);
+            for (size_t i = 0; i < count; ++i) {
+              ASSERT_EQ(static_cast<int32_t>(first_index + i), data[i].a);
+              ASSERT_EQ(data[i].a + 2, data[i].c);
+              ++seen[first_index + i];
+            }
+            ++chunks;
+          },
+          threads,
+          pages_per_chunk);
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(1, seen[i]) << i;
+      }
+      if (pages_per_chunk == 1u) {
+        EXPECT_GT(chunks, 250u);
+      }
+    }
+  }
+
+  ASSERT_THROW(blob.ParallelForEachChunk(
+                   [](const Triple*, size_t, size_t first_index) {
+                     if (first_index) {
+                       CURRENT_THROW(current::Exception("Stop."));
+                     }
+                   },
+                   4u,
+                   1u),
+               current::Exception);
+}
@@ -30,14 +30,20 @@ SOFTWARE.
 
 #include "../types.h"
 
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <set>
+#include <utility>
 
 #include "../../url/url.h"
 
 #include "../../../bricks/net/http/http.h"
 #include "../../../bricks/file/file.h"
+#include "../../../bricks/util/singleton.h"
 
 namespace current {
 namespace http {
@@ -59,6 +65,92 @@ struct HTTPRedirectHelper : current::net::HTTPDefaultHelper {
 };
 }  // namespace impl
 
+// The idle HTTP/1.1 keep-alive connections of the POSIX HTTP client, per host and port.
+// A request takes a connection from here if there is one, and puts it back once the response has been read,
+// unless the server has asked to close it, or the response was not delimited by `Content-Length`.
+class HTTPClientConnectionPool final {
+ public:
+  // No more than this many idle connections are kept per host and port. Zero disables reusing connections.
+  void SetMaxIdleConnectionsPerHost(size_t max_idle_connections_per_host) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_idle_connections_per_host_ = max_idle_connections_per_host;
+    for (auto& e : idle_) {
+      while (e.second.size() > max_idle_connections_per_host_) {
+        e.second.pop_front();
+      }
+    }
+  }
+
+  // The connections idle for longer than this are closed instead of being reused. Should be shorter than
+  // the keep-alive timeout of the server, so that the connection is not closed by the server while in use.
+  void SetIdleTimeout(std::chrono::milliseconds idle_timeout) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_timeout_ = idle_timeout;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+  }
+
+  // Returns the most recently used idle connection to `host:port` which is still open, or `nullptr`.
+  std::unique_ptr<current::net::Connection> Acquire(const std::string& host, int port) {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = idle_.find(std::make_pair(host, port));
+    if (it == idle_.end()) {
+      return nullptr;
+    }
+    auto& connections = it->second;
+    while (!connections.empty()) {
+      IdleConnection idle = std::move(connections.back());
+      connections.pop_back();
+      if (now - idle.since <= idle_timeout_ && StillOpen(*idle.connection)) {
+        return std::move(idle.connection);
+      }
+    }
+    idle_.erase(it);
+    return nullptr;
+  }
+
+  void Release(const std::string& host, int port, std::unique_ptr<current::net::Connection> connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (max_idle_connections_per_host_) {
+      auto& connections = idle_[std::make_pair(host, port)];
+      if (connections.size() >= max_idle_connections_per_host_) {
+        connections.pop_front();
+      }
+      connections.push_back(IdleConnection{std::move(connection), std::chrono::steady_clock::now()});
+    }
+  }
+
+ private:
+  struct IdleConnection {
+    std::unique_ptr<current::net::Connection> connection;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  // Whether the server has not closed the connection, and has not sent anything over it, while it was idle.
+  static bool StillOpen(current::net::Connection& connection) {
+#ifndef CURRENT_WINDOWS
+    char c;
+    const auto retval = ::recv(connection.socket, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return retval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#else
+    // TODO(dkorolev): Non-blocking peek on Windows. Until then, connections are never reused there.
+    static_cast<void>(connection);
+    return false;
+#endif  // CURRENT_WINDOWS
+  }
+
+  std::mutex mutex_;
+  size_t max_idle_connections_per_host_ = 8u;
+  std::chrono::milliseconds idle_timeout_ = std::chrono::seconds(5);
+  std::map<std::pair<std::string, int>, std::deque<IdleConnection>> idle_;
+};
+
+inline HTTPClientConnectionPool& HTTPClientConnections() { return current::Singleton<HTTPClientConnectionPool>(); }
+
 template <class HTTP_HELPER>
 class GenericHTTPClientPOSIX final {
  private:
@@ -94,46 +186,41 @@ class GenericHTTPClientPOSIX final {
           port = 80;
         }
       }
-      current::net::Connection connection(current::net::Connection(current::net::ClientSocket(parsed_url.host, port)));
-      connection.BlockingWrite(
-          request_method_ + ' ' + parsed_url.path + parsed_url.ComposeParameters() + " HTTP/1.1\r\n", true);
-      connection.BlockingWrite("Host: " + parsed_url.host + "\r\n", true);
-      if (!request_user_agent_.empty()) {
-        connection.BlockingWrite("User-Agent: " + request_user_agent_ + "\r\n", true);
-      }
-      for (const auto& h : request_headers_) {
-        connection.BlockingWrite(h.header + ": " + h.value + "\r\n", true);
+      // The responses to `HEAD` carry `Content-Length` with no body, so their connections are not reused.
+      const bool keep_alive = keep_alive_ && request_method_ != "HEAD";
+      std::unique_ptr<current::net::Connection> connection;
+      if (keep_alive) {
+        connection = HTTPClientConnections().Acquire(parsed_url.host, port);
       }
-      if (!request_headers_.cookies.empty()) {
-        connection.BlockingWrite("Cookie: " + request_headers_.CookiesAsString() + "\r\n", true);
-      }
-      if (!request_body_content_type_.empty()) {
-        connection.BlockingWrite("Content-Type: " + request_body_content_type_ + "\r\n", true);
-      }
-      if (!request_body_contents_.empty() || current::net::NeedContentLengthHeader(request_method_)) {
-        // NOTE(dkorolev): The `try/catch/throw` combo here is a hack for the unit test for HTTP 413 to pass.
-        // It swallows the `SocketWriteException` exception for huge payloads, as Current's HTTP server logic
-        // does intentionally close the HTTP connection prematurely if `Content-Length` exceeds a reasonable limit.
+      if (connection) {
+        // The server may have closed the idle connection right as the request was being sent over it. Retry once,
+        // over a new connection, if the request could not be sent, or if the server has closed the connection
+        // without responding. The server may have processed the request in the latter case, and in the former one
+        // if only its end could not be sent, so only the requests that are safe to repeat are retried.
+        const bool idempotent = (request_method_ == "GET" || request_method_ == "HEAD");
+        bool sent = false;
         try {
-#ifndef CURRENT_WINDOWS
-          connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n", true);
-          connection.BlockingWrite("\r\n", true);
-          connection.BlockingWrite(request_body_contents_, false);
-#else
-          // TODO(grixa): this fix for the PayloadTooLarge test on Windows is temporary, need to revisit it.
-          connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n\r\n" +
-                                       request_body_contents_,
-                                   false);
-#endif
-        } catch (const net::SocketWriteException&) {
-          if (request_body_contents_.length() <= net::constants::kMaxHTTPPayloadSizeInBytes) {
+          SendRequest(*connection, parsed_url);
+          sent = true;
+        } catch (const current::net::SocketException&) {
+          if (!idempotent) {
             throw;
           }
         }
-      } else {
-        connection.BlockingWrite("\r\n", false);
+        if (sent && !(idempotent && ClosedWithoutResponding(*connection))) {
+          ReadResponse(*connection);
+        } else {
+          connection = nullptr;
+        }
+      }
+      if (!connection) {
+        connection = std::make_unique<current::net::Connection>(current::net::ClientSocket(parsed_url.host, port));
+        SendRequest(*connection, parsed_url);
+        ReadResponse(*connection);
+      }
+      if (keep_alive && http_request_->KeepAlive() && http_request_->HasContentLength()) {
+        HTTPClientConnections().Release(parsed_url.host, port, std::move(connection));
       }
-      http_request_.reset(new CustomHTTPRequestData(connection, request_data_construction_params_));
       // TODO(dkorolev): Rename `Path()`, it's only called so now because of HTTP request/response format.
       // Elaboration:
       // HTTP request  message is: `GET /path HTTP/1.1`, "/path" is the second component of it.
@@ -158,6 +245,69 @@ class GenericHTTPClientPOSIX final {
 
   const CustomHTTPRequestData& HTTPRequest() const { return *http_request_.get(); }
 
+ private:
+  void SendRequest(current::net::Connection& connection, const URL& parsed_url) {
+    connection.BlockingWrite(
+        request_method_ + ' ' + parsed_url.path + parsed_url.ComposeParameters() + " HTTP/1.1\r\n", true);
+    connection.BlockingWrite("Host: " + parsed_url.host + "\r\n", true);
+    if (!request_user_agent_.empty()) {
+      connection.BlockingWrite("User-Agent: " + request_user_agent_ + "\r\n", true);
+    }
+    for (const auto& h : request_headers_) {
+      connection.BlockingWrite(h.header + ": " + h.value + "\r\n", true);
+    }
+    if (!request_headers_.cookies.empty()) {
+      connection.BlockingWrite("Cookie: " + request_headers_.CookiesAsString() + "\r\n", true);
+    }
+    if (!request_body_content_type_.empty()) {
+      connection.BlockingWrite("Content-Type: " + request_body_content_type_ + "\r\n", true);
+    }
+    if (!request_body_contents_.empty() || current::net::NeedContentLengthHeader(request_method_)) {
+      // NOTE(dkorolev): The `try/catch/throw` combo here is a hack for the unit test for HTTP 413 to pass.
+      // It swallows the `SocketWriteException` exception for huge payloads, as Current's HTTP server logic
+      // does intentionally close the HTTP connection prematurely if `Content-Length` exceeds a reasonable limit.
+      try {
+#ifndef CURRENT_WINDOWS
+        connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n", true);
+        connection.BlockingWrite("\r\n", true);
+        connection.BlockingWrite(request_body_contents_, false);
+#else
+        // TODO(grixa): this fix for the PayloadTooLarge test on Windows is temporary, need to revisit it.
+        connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n\r\n" +
+                                     request_body_contents_,
+                                 false);
+#endif
+      } catch (const net::SocketWriteException&) {
+        if (request_body_contents_.length() <= net::constants::kMaxHTTPPayloadSizeInBytes) {
+          throw;
+        }
+      }
+    } else {
+      connection.BlockingWrite("\r\n", false);
+    }
+  }
+
+  void ReadResponse(current::net::Connection& connection) {
+    http_request_.reset(new CustomHTTPRequestData(connection, request_data_construction_params_));
+  }
+
+  // Waits for the response to begin, and returns whether the server has closed the connection before it did,
+  // i.e., whether reading from the connection reached a clean end of stream with not a single byte received.
+  static bool ClosedWithoutResponding(current::net::Connection& connection) {
+#ifndef CURRENT_WINDOWS
+    char c;
+    ssize_t retval;
+    do {
+      retval = ::recv(connection.socket, &c, 1, MSG_PEEK);
+    } while (retval < 0 && errno == EINTR);
+    return retval == 0;
+#else
+    // Connections are never reused on Windows, see `HTTPClientConnectionPool::StillOpen()`.
+    static_cast<void>(connection);
+    return false;
+#endif  // CURRENT_WINDOWS
+  }
+
  public:
   // Request parameters.
   std::string request_method_ = "";
@@ -168,6 +318,9 @@ class GenericHTTPClientPOSIX final {
   current::net::http::Headers request_headers_;
   const typename HTTP_HELPER::ConstructionParams request_data_construction_params_;
   bool allow_redirects_ = false;
+  // Whether to reuse the connections kept alive by `HTTPClientConnections()`. Not for chunk-by-chunk receivers,
+  // as the retry over a new connection would deliver the chunks already received once again.
+  bool keep_alive_ = false;
 
   // Output parameters.
   current::net::HTTPResponseCodeValue response_code_ = HTTPResponseCode.InvalidCode;
@@ -187,6 +340,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const HEAD& request, HTTPClientPOSIX& client) {
@@ -195,6 +349,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const POST& request, HTTPClientPOSIX& client) {
@@ -205,6 +360,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const POSTFromFile& request, HTTPClientPOSIX& client) {
@@ -216,6 +372,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
         current::FileSystem::ReadFileAsString(request.file_name);  // Can throw FileException.
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const PUT& request, HTTPClientPOSIX& client) {
@@ -226,6 +383,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const PATCH& request, HTTPClientPOSIX& client) {
@@ -236,6 +394,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const DELETE& request, HTTPClientPOSIX& client) {
@@ -244,6 +403,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;  // LCOV_EXCL_LINE  -- tested in GET above.
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = true;
   }
 
   inline static void PrepareInput(const KeepResponseInMemory&, HTTPClientPOSIX&) {}
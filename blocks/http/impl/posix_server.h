@@ -26,12 +26,23 @@ SOFTWARE.
 #define BLOCKS_HTTP_IMPL_POSIX_SERVER_H
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <string>
 #include <map>
 #include <memory>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include <iostream>  // TODO(dkorolev): More robust logging here.
 
+#ifdef CURRENT_POSIX
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif  // CURRENT_POSIX
+
 #include "../types.h"
 #include "../request.h"
 
@@ -156,20 +167,43 @@ struct StaticFileServer {
   }
 };
 
+// The threading model of `HTTPServerPOSIX`.
+// By default, a single thread accepts the connections, parses the requests, and calls the handlers, one at a time.
+// With nonzero `worker_threads`, on Linux, an `epoll`-based thread accepts the connections and reads the headers
+// of the requests without blocking, while the pool of `worker_threads` threads parses the requests and runs
+// the handlers. Then one slow client does not stall every route on the port, but the handlers run concurrently.
+struct HTTPServerOptions {
+  size_t worker_threads = 0u;
+  // The connection is handed over to a worker once this many bytes have been received, even if the headers
+  // are still incomplete. Then the worker reads the rest of the request, blocking.
+  size_t max_prefetched_bytes = 64 * 1024;
+  // In the event-driven mode, the connection is kept open after a non-chunked response if the client allows it,
+  // and the `epoll` thread waits for the next request on it. The connections on which no full request has arrived
+  // within this time are closed. Zero disables keep-alive.
+  std::chrono::milliseconds keep_alive_timeout = std::chrono::seconds(30);
+
+  explicit HTTPServerOptions(size_t worker_threads = 0u) : worker_threads(worker_threads) {}
+};
+
 // HTTP server bound to a specific port.
 class HTTPServerPOSIX final {
  public:
+  using options_t = HTTPServerOptions;
+
   // The constructor starts listening on the specified port.
   // Since instances of `HTTPServerPOSIX` are created via a singleton,
   // a listening thread will only be created once per port, on the first access to that port.
-  explicit HTTPServerPOSIX(current::net::BarePort port)
+  explicit HTTPServerPOSIX(current::net::BarePort port, const HTTPServerOptions& options = HTTPServerOptions())
       : terminating_(false),
         port_(static_cast<uint16_t>(port)),
-        thread_([this, port]() { Thread(current::net::Socket(port)); }) {}
-  explicit HTTPServerPOSIX(current::net::ReservedLocalPort reserved_port)
+        options_(options),
+        thread_([this, port]() { Run(current::net::Socket(port)); }) {}
+  explicit HTTPServerPOSIX(current::net::ReservedLocalPort reserved_port,
+                           const HTTPServerOptions& options = HTTPServerOptions())
       : terminating_(false),
         port_(reserved_port),
-        thread_([this](current::net::Socket socket) { Thread(std::move(socket)); }, std::move(reserved_port)) {}
+        options_(options),
+        thread_([this](current::net::Socket socket) { Run(std::move(socket)); }, std::move(reserved_port)) {}
 
   uint16_t LocalPort() const { return port_; }
 
@@ -413,67 +447,344 @@ class HTTPServerPOSIX final {
     return nullptr;
   }
 
+  void Run(current::net::Socket socket) {
+#ifdef CURRENT_POSIX
+    if (options_.worker_threads) {
+      EventDrivenThread(std::move(socket));
+      return;
+    }
+#endif  // CURRENT_POSIX
+    Thread(std::move(socket));
+  }
+
   void Thread(current::net::Socket socket) {
     // TODO(dkorolev): Benchmark QPS.
     while (!terminating_) {
-      try {
-        auto connection = std::make_unique<current::net::HTTPServerConnection>(socket.Accept());
-        if (terminating_) {
-          // Already terminating. Will not send the response, and this
-          // lack of response should not result in an exception.
-          connection->DoNotSendAnyResponse();
-          break;
+      ServeConnection([&socket]() { return std::make_unique<current::net::HTTPServerConnection>(socket.Accept()); });
+    }
+  }
+
+  // Accepts or otherwise obtains the connection via `create_connection()`, parses the request, and serves it.
+  template <typename F>
+  void ServeConnection(F&& create_connection) {
+    try {
+      auto connection = create_connection();
+      if (terminating_) {
+        // Already terminating. Will not send the response, and this
+        // lack of response should not result in an exception.
+        connection->DoNotSendAnyResponse();
+        return;
+      }
+      URLPathArgs url_path_args;
+      const auto handler = FindHandler(connection->HTTPRequest().URL().path, url_path_args);
+      if (Exists(handler)) {
+        // OK, here's the tricky part with error handling and exceptions in this multithreaded world.
+        // * On the one hand, the connection should be std::move-d into the request,
+        //   since it might end up being served in another thread, via a message queue, etc.
+        //   Thus, the user code is responsible for closing the connection.
+        //   Not to mention that the std::move-d away connection can easily outlive this scope.
+        // * On the other hand, if an exception occurs in user code, we need to return a 500,
+        //   which should obviously happen before the connection object is destructed.
+        //   This seems like a good reason to not std::move it away, or move it away with some flag,
+        //   but I thought hard of it, and don't think it's a good choice -- D.K.
+        //
+        // Solution: Do nothing here. No matter how tempting it is, it won't work across threads. Period.
+        //
+        // The implementation of HTTP connection will return an "INTERNAL SERVER ERROR"
+        // if no response was sent. That's what the user gets. In debugger, they can put a breakpoint there
+        // and see what caused the error.
+        //
+        // It is the job of the user of this library to ensure no exceptions leave their code.
+        // In practice, a top-level try-catch for `const current::Exception& e` is good enough.
+        try {
+          (*Value(handler))(Request(std::move(connection), url_path_args));
+        } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+          // WARNING: This `catch` is really not sufficient, it just logs a message
+          // if a user exception occurred in the same thread that ran the handler.
+          // DO NOT COUNT ON IT.
+          std::cerr << "HTTP route failed in user code: " << e.what() << '\n';  // LCOV_EXCL_LINE
+        }
+      } else {
+        connection->SendHTTPResponse(current::net::DefaultNotFoundMessage(),
+                                     HTTPResponseCode.NotFound,
+                                     current::net::http::Headers(),
+                                     current::net::constants::kDefaultHTMLContentType);
+      }
+    } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
+      // The `ChunkSizeNotAValidHEXValue` situation, if emerged, is already handled with a "400 BAD REQUEST" response.
+    } catch (const current::net::HTTPPayloadTooLarge&) {
+      // The `HTTPPayloadTooLarge` situation, if emerged, is already handled with a "413 ENTITY TOO LARGE" response.
+    } catch (const current::net::HTTPRequestBodyLengthNotProvided&) {
+      // The `HTTPRequestBodyLengthNotProvided` situation, if emerged, is already handled with "411 LENGTH REQUIRED".
+    } catch (const current::net::EmptySocketException&) {  // LCOV_EXCL_LINE
+      // Silently discard errors if no data was sent in.
+    } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+      // TODO(dkorolev): More reliable logging.
+      std::cerr << "HTTP route failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+
+#ifdef CURRENT_POSIX
+  // A connection, and the beginning of the request, which the `epoll` thread has read from it so far.
+  struct PrefetchedConnection {
+    std::unique_ptr<current::net::Connection> connection;
+    std::string bytes;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  // The connections kept alive after their responses, handed back to the `epoll` thread by whichever thread
+  // has sent the response. Shared, since the `Request` may well outlive the server.
+  struct KeptAliveConnections final {
+    const int event_fd;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<current::net::Connection>> connections;
+    bool closed = false;
+
+    KeptAliveConnections() : event_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+    ~KeptAliveConnections() {
+      if (event_fd >= 0) {
+        ::close(event_fd);
+      }
+    }
+
+    void Push(current::net::Connection&& connection) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+          // The server is shutting down, the connection is closed by its owner.
+          return;
+        }
+        connections.push_back(std::make_unique<current::net::Connection>(std::move(connection)));
+      }
+      const uint64_t one = 1u;
+      static_cast<void>(::write(event_fd, &one, sizeof(one)));
+    }
+
+    std::vector<std::unique_ptr<current::net::Connection>> Pop() {
+      uint64_t counter;
+      static_cast<void>(::read(event_fd, &counter, sizeof(counter)));
+      std::vector<std::unique_ptr<current::net::Connection>> result;
+      std::lock_guard<std::mutex> lock(mutex);
+      result.swap(connections);
+      return result;
+    }
+
+    void Close() {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+      connections.clear();
+    }
+  };
+
+  struct EPollFD final {
+    const int fd;
+    EPollFD() : fd(::epoll_create1(EPOLL_CLOEXEC)) {}
+    ~EPollFD() {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  };
+
+  static bool SetNonBlocking(SOCKET fd, bool non_blocking) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) == 0;
+  }
+
+  enum class PrefetchStatus { NeedMore, Ready, Closed };
+
+  // Reads whatever is available from the non-blocking connection.
+  PrefetchStatus Prefetch(SOCKET fd, std::string& bytes) const {
+    char buffer[16 * 1024];
+    while (true) {
+      const ssize_t retval = ::recv(fd, buffer, sizeof(buffer), 0);
+      if (retval > 0) {
+        const size_t search_from = bytes.length() >= 3u ? bytes.length() - 3u : 0u;
+        bytes.append(buffer, static_cast<size_t>(retval));
+        // The blank line marks the end of the headers.
+        if (bytes.find("\r\n\r\n", search_from) != std::string::npos ||
+            bytes.length() >= options_.max_prefetched_bytes) {
+          return PrefetchStatus::Ready;
+        }
+      } else if (retval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return PrefetchStatus::NeedMore;
+      } else if (retval < 0 && errno == EINTR) {
+        continue;  // LCOV_EXCL_LINE
+      } else {
+        // The connection was closed or reset by the client before sending the full request.
+        return PrefetchStatus::Closed;
+      }
+    }
+  }
+
+  void EventDrivenThread(current::net::Socket socket) {
+    const SOCKET listening_fd = socket.socket;
+    EPollFD epoll;
+    epoll_event listening_event;
+    listening_event.events = EPOLLIN;
+    listening_event.data.fd = listening_fd;
+    if (epoll.fd < 0 || !SetNonBlocking(listening_fd, true) ||
+        ::epoll_ctl(epoll.fd, EPOLL_CTL_ADD, listening_fd, &listening_event)) {
+      // LCOV_EXCL_START
+      std::cerr << "HTTP: `epoll` is unavailable, serving from a single thread.\n";
+      SetNonBlocking(listening_fd, false);
+      Thread(std::move(socket));
+      return;
+      // LCOV_EXCL_STOP
+    }
+
+    const bool keep_alive = options_.keep_alive_timeout.count() > 0;
+    std::shared_ptr<KeptAliveConnections> kept_alive;
+    if (keep_alive) {
+      kept_alive = std::make_shared<KeptAliveConnections>();
+      epoll_event kept_alive_event;
+      kept_alive_event.events = EPOLLIN;
+      kept_alive_event.data.fd = kept_alive->event_fd;
+      if (kept_alive->event_fd < 0 || ::epoll_ctl(epoll.fd, EPOLL_CTL_ADD, kept_alive->event_fd, &kept_alive_event)) {
+        kept_alive = nullptr;  // LCOV_EXCL_LINE
+      }
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0u; i < options_.worker_threads; ++i) {
+      workers.emplace_back([this, kept_alive]() { WorkerThread(kept_alive); });
+    }
+
+    std::unordered_map<SOCKET, PrefetchedConnection> pending;
+    const auto start_watching = [&](std::unique_ptr<current::net::Connection> connection) {
+      const SOCKET connection_fd = connection->socket;
+      epoll_event event;
+      event.events = EPOLLIN | EPOLLRDHUP;
+      event.data.fd = connection_fd;
+      if (SetNonBlocking(connection_fd, true) && !::epoll_ctl(epoll.fd, EPOLL_CTL_ADD, connection_fd, &event)) {
+        auto& entry = pending[connection_fd];
+        entry.connection = std::move(connection);
+        entry.since = std::chrono::steady_clock::now();
+      }
+    };
+    const auto stop_watching = [&](SOCKET fd) {
+      ::epoll_ctl(epoll.fd, EPOLL_CTL_DEL, fd, nullptr);
+      auto it = pending.find(fd);
+      PrefetchedConnection result = std::move(it->second);
+      pending.erase(it);
+      return result;
+    };
+
+    // With keep-alive on, the connections idle for longer than `keep_alive_timeout` are checked for and closed
+    // at most this often, so `epoll_wait()` should not block for longer than this.
+    const std::chrono::milliseconds sweep_period =
+        std::min(options_.keep_alive_timeout, std::chrono::milliseconds(1000));
+    auto next_sweep = std::chrono::steady_clock::now() + sweep_period;
+
+    constexpr int kMaxEvents = 64;
+    epoll_event events[kMaxEvents];
+    while (!terminating_) {
+      const int n = ::epoll_wait(
+          epoll.fd, events, kMaxEvents, keep_alive && !pending.empty() ? static_cast<int>(sweep_period.count()) : -1);
+      if (n < 0) {
+        // LCOV_EXCL_START
+        if (errno == EINTR) {
+          continue;
         }
-        URLPathArgs url_path_args;
-        const auto handler = FindHandler(connection->HTTPRequest().URL().path, url_path_args);
-        if (Exists(handler)) {
-          // OK, here's the tricky part with error handling and exceptions in this multithreaded world.
-          // * On the one hand, the connection should be std::move-d into the request,
-          //   since it might end up being served in another thread, via a message queue, etc.
-          //   Thus, the user code is responsible for closing the connection.
-          //   Not to mention that the std::move-d away connection can easily outlive this scope.
-          // * On the other hand, if an exception occurs in user code, we need to return a 500,
-          //   which should obviously happen before the connection object is destructed.
-          //   This seems like a good reason to not std::move it away, or move it away with some flag,
-          //   but I thought hard of it, and don't think it's a good choice -- D.K.
-          //
-          // Solution: Do nothing here. No matter how tempting it is, it won't work across threads. Period.
-          //
-          // The implementation of HTTP connection will return an "INTERNAL SERVER ERROR"
-          // if no response was sent. That's what the user gets. In debugger, they can put a breakpoint there
-          // and see what caused the error.
-          //
-          // It is the job of the user of this library to ensure no exceptions leave their code.
-          // In practice, a top-level try-catch for `const current::Exception& e` is good enough.
+        std::cerr << "HTTP: `epoll_wait()` failed, errno " << errno << ".\n";
+        break;
+        // LCOV_EXCL_STOP
+      }
+      for (int i = 0; i < n && !terminating_; ++i) {
+        const SOCKET fd = events[i].data.fd;
+        if (fd == listening_fd) {
+          std::unique_ptr<current::net::Connection> connection;
           try {
-            (*Value(handler))(Request(std::move(connection), url_path_args));
-          } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
-            // WARNING: This `catch` is really not sufficient, it just logs a message
-            // if a user exception occurred in the same thread that ran the handler.
-            // DO NOT COUNT ON IT.
-            std::cerr << "HTTP route failed in user code: " << e.what() << '\n';  // LCOV_EXCL_LINE
+            connection = std::make_unique<current::net::Connection>(socket.Accept());
+          } catch (const current::net::SocketException&) {  // LCOV_EXCL_LINE
+            continue;                                       // LCOV_EXCL_LINE
+          }
+          if (terminating_) {
+            break;
+          }
+          start_watching(std::move(connection));
+        } else if (kept_alive && fd == kept_alive->event_fd) {
+          for (auto& connection : kept_alive->Pop()) {
+            start_watching(std::move(connection));
           }
         } else {
-          connection->SendHTTPResponse(current::net::DefaultNotFoundMessage(),
-                                       HTTPResponseCode.NotFound,
-                                       current::net::http::Headers(),
-                                       current::net::constants::kDefaultHTMLContentType);
+          const auto it = pending.find(fd);
+          if (it != pending.end()) {
+            const PrefetchStatus status = Prefetch(fd, it->second.bytes);
+            if (status == PrefetchStatus::Closed) {
+              stop_watching(fd);
+            } else if (status == PrefetchStatus::Ready) {
+              PrefetchedConnection ready = stop_watching(fd);
+              SetNonBlocking(fd, false);
+              {
+                std::lock_guard<std::mutex> lock(workers_mutex_);
+                workers_queue_.push_back(std::move(ready));
+              }
+              workers_condition_variable_.notify_one();
+            }
+          }
         }
-      } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
-        // The `ChunkSizeNotAValidHEXValue` situation, if emerged, is already handled with a "400 BAD REQUEST" response.
-      } catch (const current::net::HTTPPayloadTooLarge&) {
-        // The `HTTPPayloadTooLarge` situation, if emerged, is already handled with a "413 ENTITY TOO LARGE" response.
-      } catch (const current::net::HTTPRequestBodyLengthNotProvided&) {
-        // The `HTTPRequestBodyLengthNotProvided` situation, if emerged, is already handled with "411 LENGTH REQUIRED".
-      } catch (const current::net::EmptySocketException&) {  // LCOV_EXCL_LINE
-        // Silently discard errors if no data was sent in.
-      } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
-        // TODO(dkorolev): More reliable logging.
-        std::cerr << "HTTP route failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
       }
+      if (keep_alive && !pending.empty()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= next_sweep) {
+          next_sweep = now + sweep_period;
+          std::vector<SOCKET> expired;
+          for (const auto& e : pending) {
+            if (now - e.second.since > options_.keep_alive_timeout) {
+              expired.push_back(e.first);
+            }
+          }
+          for (const SOCKET fd : expired) {
+            stop_watching(fd);
+          }
+        }
+      }
+    }
+
+    if (kept_alive) {
+      kept_alive->Close();
+    }
+    {
+      std::lock_guard<std::mutex> lock(workers_mutex_);
+      workers_terminating_ = true;
+      // The requests not picked up by the workers yet are dropped, as are those still in the listen queue.
+      workers_queue_.clear();
+    }
+    workers_condition_variable_.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
     }
   }
 
+  void WorkerThread(std::shared_ptr<KeptAliveConnections> kept_alive) {
+    while (true) {
+      PrefetchedConnection prefetched;
+      {
+        std::unique_lock<std::mutex> lock(workers_mutex_);
+        workers_condition_variable_.wait(lock, [this]() { return workers_terminating_ || !workers_queue_.empty(); });
+        if (workers_terminating_) {
+          return;
+        }
+        prefetched = std::move(workers_queue_.front());
+        workers_queue_.pop_front();
+      }
+      ServeConnection([&prefetched, &kept_alive]() {
+        auto connection = std::make_unique<current::net::HTTPServerConnection>(
+            std::move(*prefetched.connection),
+            current::net::HTTPRequestPrefetchedBytes{std::move(prefetched.bytes)});
+        if (kept_alive) {
+          // NOTE: The bytes of a pipelined request, if the client has sent one, are lost with the parser.
+          // Clients do not pipeline in practice, and Current's client does not either.
+          connection->KeepAliveVia(
+              [kept_alive](current::net::Connection&& c) { kept_alive->Push(std::move(c)); });
+        }
+        return connection;
+      });
+    }
+  }
+#endif  // CURRENT_POSIX
+
   void ValidateRoute(const std::string& path) {
     if (path.empty() || path[0] != '/') {
       CURRENT_THROW(PathDoesNotStartWithSlash("HTTP URL path does not start with a slash: `" + path + "`."));
@@ -542,6 +853,16 @@ class HTTPServerPOSIX final {
 
   std::atomic_bool terminating_;
   const uint16_t port_;
+  const HTTPServerOptions options_;
+
+#ifdef CURRENT_POSIX
+  // The connections ready to be served by the worker threads, in the event-driven mode.
+  std::mutex workers_mutex_;
+  std::condition_variable workers_condition_variable_;
+  std::deque<PrefetchedConnection> workers_queue_;
+  bool workers_terminating_ = false;
+#endif  // CURRENT_POSIX
+
   std::thread thread_;
 
   // TODO(dkorolev): Look into read-write mutexes here.
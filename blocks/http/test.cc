@@ -2056,3 +2056,160 @@ TEST(HTTPAPI, JSONDoesHaveCORSHeaderByDefault) {
     EXPECT_EQ("*", response.headers.Get("Access-Control-Allow-Origin"));
   }
 }
+
+#ifdef CURRENT_POSIX
+TEST(HTTPAPI, EventDrivenServer) {
+  using namespace current::http;
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port), HTTPServerOptions(4));
+  const auto scope = http_server.Register("/get", [](Request r) { r("OK\n"); }) +
+                     http_server.Register("/post", [](Request r) { r(r.body); });
+
+  // A client that has sent an incomplete request must not stall the others.
+  Connection slow_client(current::net::ClientSocket("localhost", port));
+  slow_client.BlockingWrite("GET /get HTTP/1.1\r\n", true);
+
+  EXPECT_EQ("OK\n", HTTP(GET(Printf("http://localhost:%d/get", port))).body);
+  {
+    // The body is larger than what the server prefetches before handing the connection over to a worker.
+    const std::string body(200 * 1000, 'x');
+    EXPECT_EQ(body, HTTP(POST(Printf("http://localhost:%d/post", port), body)).body);
+  }
+
+  slow_client.BlockingWrite("Host: localhost\r\n\r\n", false);
+  std::string response;
+  char buffer[1024];
+  while (response.find("OK\n") == std::string::npos) {
+    const size_t read = slow_client.BlockingRead(buffer, sizeof(buffer));
+    ASSERT_NE(0u, read);
+    response.append(buffer, read);
+  }
+  EXPECT_EQ("HTTP/1.1 200 OK", response.substr(0, 15));
+}
+
+TEST(HTTPAPI, KeepAlive) {
+  using namespace current::http;
+  const auto client_port = [](Request r) { r(current::ToString(r.connection.RemoteIPAndPort().port)); };
+  HTTPClientConnections().Clear();
+
+  {
+    // The event-driven server keeps the connection open, and the client reuses it.
+    auto reserved_port = current::net::ReserveLocalPort();
+    const int port = reserved_port;
+    HTTPServerOptions options(2);
+    options.keep_alive_timeout = std::chrono::milliseconds(200);
+    auto& http_server = HTTP(std::move(reserved_port), options);
+    const auto scope = http_server.Register("/port", client_port);
+    const std::string url = Printf("http://localhost:%d/port", port);
+
+    const auto response = HTTP(GET(url));
+    EXPECT_EQ("keep-alive", response.headers.Get("Connection"));
+    std::set<std::string> client_ports;
+    client_ports.insert(response.body);
+    for (int i = 0; i < 5; ++i) {
+      client_ports.insert(HTTP(GET(url)).body);
+      client_ports.insert(HTTP(POST(url, "body")).body);
+    }
+    EXPECT_EQ(1u, client_ports.size());
+
+    // Once the server has closed the idle connection, the client opens a new one.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    client_ports.insert(HTTP(GET(url)).body);
+    EXPECT_EQ(2u, client_ports.size());
+
+    // Nor does the client reuse the connections idle for longer than its own timeout.
+    HTTPClientConnections().SetIdleTimeout(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    client_ports.insert(HTTP(GET(url)).body);
+    EXPECT_EQ(3u, client_ports.size());
+    HTTPClientConnections().SetIdleTimeout(std::chrono::seconds(5));
+  }
+
+  {
+    // The single-threaded server closes the connection after each response.
+    auto reserved_port = current::net::ReserveLocalPort();
+    const int port = reserved_port;
+    auto& http_server = HTTP(std::move(reserved_port));
+    const auto scope = http_server.Register("/port", client_port);
+    const std::string url = Printf("http://localhost:%d/port", port);
+
+    const auto response = HTTP(GET(url));
+    EXPECT_EQ("close", response.headers.Get("Connection"));
+    std::set<std::string> client_ports;
+    client_ports.insert(response.body);
+    for (int i = 0; i < 3; ++i) {
+      client_ports.insert(HTTP(GET(url)).body);
+    }
+    EXPECT_EQ(4u, client_ports.size());
+  }
+}
+
+TEST(HTTPAPI, KeepAliveRetriesOnlyIdempotentRequests) {
+  using namespace current::http;
+  HTTPClientConnections().Clear();
+
+  // The server reads the whole request, body included, and then either responds, or closes the connection.
+  const auto read_request = [](Connection& connection) -> std::string {
+    std::string request;
+    char buffer[1024];
+    size_t end = std::string::npos;
+    while (end == std::string::npos || request.length() < end) {
+      const size_t read = connection.BlockingRead(buffer, sizeof(buffer));
+      if (!read) {
+        return "";
+      }
+      request.append(buffer, read);
+      const size_t headers_end = request.find("\r\n\r\n");
+      if (end == std::string::npos && headers_end != std::string::npos) {
+        const size_t content_length = request.find("Content-Length: ");
+        end = headers_end + 4u;
+        if (content_length != std::string::npos && content_length < headers_end) {
+          end += static_cast<size_t>(atoi(request.c_str() + content_length + 16u));
+        }
+      }
+    }
+    return request.substr(0u, request.find(' '));
+  };
+  const auto respond = [](Connection& connection) {
+    connection.BlockingWrite("HTTP/1.1 200 OK\r\nConnection: keep-alive\r\nContent-Length: 3\r\n\r\nOK\n", false);
+  };
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  std::vector<std::string> requests;
+  std::thread server(
+      [&](current::net::Socket socket) {
+        {
+          Connection connection = socket.Accept();
+          requests.push_back(read_request(connection));
+          respond(connection);
+          // Close the kept-alive connection once the `POST` has been read, before responding to it.
+          requests.push_back(read_request(connection));
+        }
+        {
+          Connection connection = socket.Accept();
+          requests.push_back(read_request(connection));
+          respond(connection);
+          // Same for a `GET`.
+          requests.push_back(read_request(connection));
+        }
+        {
+          Connection connection = socket.Accept();
+          requests.push_back(read_request(connection));
+          respond(connection);
+        }
+      },
+      std::move(reserved_port));
+
+  const std::string url = Printf("http://localhost:%d/", port);
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  // The `POST` may have been processed, so it is not sent again, and the error is reported to the caller.
+  EXPECT_THROW(HTTP(POST(url, "body")), current::net::SocketException);
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  // The `GET` is sent again, over a new connection.
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  server.join();
+  EXPECT_EQ("GET POST GET GET GET", current::strings::Join(requests, ' '));
+}
+#endif  // CURRENT_POSIX
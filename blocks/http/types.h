@@ -321,22 +321,27 @@ struct HTTPImpl {
     std::map<uint16_t, std::unique_ptr<server_impl_t>> servers;
   };
 
-  [[nodiscard]] server_impl_t& operator()(current::net::BarePort port) {
+  // The `options` only take effect if it is this very call that starts the server on this port.
+  [[nodiscard]] server_impl_t& operator()(
+      current::net::BarePort port,
+      const typename server_impl_t::options_t& options = typename server_impl_t::options_t()) {
     HandlersSingleton& handlers = current::Singleton<HandlersSingleton>();
     std::lock_guard<std::mutex> lock(handlers.mutex);
     std::unique_ptr<server_impl_t>& server = handlers.servers[static_cast<size_t>(port)];
     if (!server) {
-      server = std::make_unique<server_impl_t>(port);
+      server = std::make_unique<server_impl_t>(port, options);
     }
     return *server;
   }
 
-  [[nodiscard]] server_impl_t& operator()(current::net::ReservedLocalPort port) {
+  [[nodiscard]] server_impl_t& operator()(
+      current::net::ReservedLocalPort port,
+      const typename server_impl_t::options_t& options = typename server_impl_t::options_t()) {
     HandlersSingleton& handlers = current::Singleton<HandlersSingleton>();
     std::lock_guard<std::mutex> lock(handlers.mutex);
     std::unique_ptr<server_impl_t>& server = handlers.servers[static_cast<uint16_t>(port)];
     if (!server) {
-      server = std::make_unique<server_impl_t>(std::move(port));
+      server = std::make_unique<server_impl_t>(std::move(port), options);
     }
     return *server;
   }
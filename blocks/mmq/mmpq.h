@@ -27,11 +27,13 @@ SOFTWARE.
 
 // MMPQ is an in-memory priority queue, with the external interface loosely resembling the one of the original MMQ.
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
 #include <set>
+#include <vector>
 
 #include "../ss/ss.h"
 
@@ -105,6 +107,11 @@ class MMPQImpl {
   void operator=(MMPQImpl&&) = delete;
 
   void ConsumerThread() {
+    if (ss::IsBatchEntrySubscriber<CONSUMER, MESSAGE>::value) {
+      BatchConsumerThread();
+      return;
+    }
+
     while (true) {
       std::unique_lock<std::mutex> lock(mutex_);
 
@@ -122,6 +129,48 @@ class MMPQImpl {
     }
   }
 
+  // The number of entries at the beginning of the queue that are not past the head, up to `max_count`.
+  // MUTEX-LOCKED by the caller.
+  size_t ReadyEntriesCount(size_t max_count) const {
+    size_t count = 0u;
+    for (auto it = queue_.begin(); count < max_count && it != queue_.end() && it->index_timestamp.us <= last_idx_ts_.us;
+         ++it) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Same as `ConsumerThread()`, but for the consumers that accept `ss::EntriesBatch<MESSAGE>`.
+  void BatchConsumerThread() {
+    const ss::BatchingPolicy policy = consumer_.GetBatchingPolicy();
+    const size_t max_batch_size = std::max(static_cast<size_t>(1u), policy.max_batch_size);
+    std::vector<ss::IndexedEntry<message_t>> batch;
+    idxts_t save_last_idx_ts;
+
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_variable_.wait(lock, [this] { return ReadyEntriesCount(1u) || destructing_; });
+        if (policy.max_linger.count() > 0) {
+          condition_variable_.wait_for(lock, policy.max_linger, [this, max_batch_size] {
+            return ReadyEntriesCount(max_batch_size) == max_batch_size || destructing_;
+          });
+        }
+        if (destructing_) {
+          return;  // LCOV_EXCL_LINE
+        }
+        for (size_t count = ReadyEntriesCount(max_batch_size); count; --count) {
+          auto it = queue_.begin();
+          batch.push_back({it->index_timestamp, std::move(const_cast<Entry&>(*it).message_body)});
+          queue_.erase(it);
+        }
+        save_last_idx_ts = last_idx_ts_;
+      }
+      consumer_(ss::EntriesBatch<message_t>(batch.data(), batch.size()), save_last_idx_ts);
+      batch.clear();
+    }
+  }
+
   bool consumer_thread_created_ = false;
 
   // The instance of the consuming side of the FIFO buffer.
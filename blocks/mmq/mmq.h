@@ -30,7 +30,8 @@ SOFTWARE.
 // One of the objectives of MMQ is to minimize the time for which the thread publishing the message is blocked.
 //
 // Messages can be published into a MMQ via standard `Publish()` interface defined in `Blocks/ss/ss.h`.
-// The consumer is run in a separate thread, and is fed one message at a time via `OnMessage()`.
+// The consumer is run in a separate thread, and is fed one message at a time via `OnMessage()`, or, if it accepts
+// `ss::EntriesBatch<MESSAGE>`, all the messages ready by then at once, as configured by its `ss::BatchingPolicy`.
 //
 // The buffer size, i.e. the number of the messages MMQ can hold, is defined by the constructor argument
 // `buffer_size`. For usability reasons the default value for it can be set via `DEFAULT_BUFFER_SIZE`
@@ -45,7 +46,15 @@ SOFTWARE.
 //      the messages will be added in the order in which the functions were called. However, for any particular
 //      thread, MMQ DOES GUARANTEE that the order of messages published from this thread will be respected.
 //  Default behavior of MMQ is non-dropping and can be controlled via the `DROP_ON_OVERFLOW` template argument.
-
+//
+// `LockFreeMMQ` is the drop-in alternative for the many-producers case. Instead of a mutex and a condition variable
+// it uses a ring of slots with per-slot atomic sequence numbers: producers claim the next index with a single CAS,
+// copy or move the message in without holding any lock, and publish the slot with a release store. The consumer
+// spins, then yields, and only parks on a condition variable when the queue stays empty. The overflow strategies
+// and the per-thread ordering guarantee are the same as the ones of the mutex-based `MMQ`.
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
@@ -133,6 +142,11 @@ class MMQImpl {
 
   // The thread which extracts fully populated messages from the tail of the buffer and feeds them to the consumer.
   void ConsumerThread() {
+    if (ss::IsBatchEntrySubscriber<CONSUMER, MESSAGE>::value) {
+      BatchConsumerThread();
+      return;
+    }
+
     // The `tail` pointer is local to the procesing thread.
     size_t tail = 0u;
     idxts_t save_last_idx_ts;
@@ -174,6 +188,72 @@ class MMQImpl {
     }
   }
 
+  // The number of consecutive `READY` entries starting from `tail`, up to `max_count`. MUTEX-LOCKED by the caller.
+  size_t ReadyEntriesCount(size_t tail, size_t max_count) const {
+    size_t count = 0u;
+    while (count < max_count && circular_buffer_[tail].status == Entry::READY) {
+      ++count;
+      Increment(tail);
+    }
+    return count;
+  }
+
+  // Same as `ConsumerThread()`, but for the consumers that accept `ss::EntriesBatch<MESSAGE>`.
+  // Exports all the messages ready at the moment, up to the max batch size, at once, after having waited
+  // for up to the max linger time for more of them to arrive if the batch is not full yet.
+  void BatchConsumerThread() {
+    const ss::BatchingPolicy policy = consumer_.GetBatchingPolicy();
+    const size_t max_batch_size =
+        std::max(static_cast<size_t>(1u), std::min(policy.max_batch_size, circular_buffer_size_));
+    std::vector<ss::IndexedEntry<message_t>> batch;
+    batch.reserve(max_batch_size);
+    size_t tail = 0u;
+    size_t count;
+    idxts_t save_last_idx_ts;
+
+    while (true) {
+      {
+        // MUTEX-LOCKED, except for the condition variable part.
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_variable_.wait(
+            lock, [this, tail] { return (circular_buffer_[tail].status == Entry::READY) || destructing_; });
+        if (policy.max_linger.count() > 0) {
+          condition_variable_.wait_for(lock, policy.max_linger, [this, tail, max_batch_size] {
+            return ReadyEntriesCount(tail, max_batch_size) == max_batch_size || destructing_;
+          });
+        }
+        if (destructing_) {
+          return;  // LCOV_EXCL_LINE
+        }
+        count = ReadyEntriesCount(tail, max_batch_size);
+        for (size_t i = 0, j = tail; i < count; ++i, Increment(j)) {
+          circular_buffer_[j].status = Entry::BEING_EXPORTED;
+        }
+        save_last_idx_ts = last_idx_ts_;
+      }
+
+      {
+        // NO MUTEX REQUIRED.
+        for (size_t i = 0, j = tail; i < count; ++i, Increment(j)) {
+          batch.push_back({circular_buffer_[j].index_timestamp, std::move(circular_buffer_[j].message_body)});
+        }
+        consumer_(ss::EntriesBatch<message_t>(batch.data(), batch.size()), save_last_idx_ts);
+        batch.clear();
+      }
+
+      {
+        // MUTEX-LOCKED.
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          for (size_t i = 0; i < count; ++i, Increment(tail)) {
+            circular_buffer_[tail].status = Entry::FREE;
+          }
+        }
+        condition_variable_.notify_all();
+      }
+    }
+  }
+
   // Returns { successful allocation flag, circular buffer index }.
   template <bool DROP = DROP_ON_OVERFLOW, typename TIMESTAMP>
   std::enable_if_t<DROP && time::IsTimestamp<TIMESTAMP>::value, std::pair<bool, size_t>> CircularBufferAllocate(
@@ -273,9 +353,313 @@ class MMQImpl {
   std::thread consumer_thread_;
 };
 
+template <typename MESSAGE, typename CONSUMER, size_t DEFAULT_BUFFER_SIZE = 1024, bool DROP_ON_OVERFLOW = false>
+class LockFreeMMQImpl {
+  static_assert(current::ss::IsEntrySubscriber<CONSUMER, MESSAGE>::value, "");
+
+ public:
+  using message_t = MESSAGE;
+  using consumer_t = CONSUMER;
+
+  LockFreeMMQImpl(consumer_t& consumer, size_t buffer_size = DEFAULT_BUFFER_SIZE)
+      : consumer_(consumer), circular_buffer_size_(buffer_size), circular_buffer_(circular_buffer_size_) {
+    CURRENT_ASSERT(circular_buffer_size_ > 0u);
+    for (size_t i = 0; i < circular_buffer_size_; ++i) {
+      circular_buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    consumer_thread_ = std::thread(&LockFreeMMQImpl::ConsumerThread, this);
+  }
+
+  // The destructor lets the consumer thread drain the messages already published, and then joins it.
+  ~LockFreeMMQImpl() {
+    CURRENT_ASSERT(consumer_thread_.joinable());
+    destructing_.store(true);
+    WakeUpConsumer();
+    WakeUpProducers();
+    consumer_thread_.join();
+  }
+
+ protected:
+  // THREAD SAFE. Never blocks, unless `DROP_ON_OVERFLOW` is `false` and the buffer is full.
+  template <current::locks::MutexLockStatus, typename TIMESTAMP>  // `MutexLockStatus` is unused by MMQ.
+  idxts_t PublisherPublishImpl(const message_t& message, TIMESTAMP&& timestamp) {
+    const std::pair<bool, idxts_t> slot = CircularBufferAllocate(std::forward<TIMESTAMP>(timestamp));
+    if (slot.first) {
+      Entry& entry = circular_buffer_[Slot(slot.second.index)];
+      entry.message_body = message;
+      CircularBufferCommit(entry, slot.second);
+    }
+    return slot.second;
+  }
+
+  template <current::locks::MutexLockStatus, typename TIMESTAMP>  // `MutexLockStatus` is unused by MMQ.
+  idxts_t PublisherPublishImpl(message_t&& message, TIMESTAMP&& timestamp) {
+    const std::pair<bool, idxts_t> slot = CircularBufferAllocate(std::forward<TIMESTAMP>(timestamp));
+    if (slot.first) {
+      Entry& entry = circular_buffer_[Slot(slot.second.index)];
+      entry.message_body = std::move(message);
+      CircularBufferCommit(entry, slot.second);
+    }
+    return slot.second;
+  }
+
+ private:
+  LockFreeMMQImpl(const LockFreeMMQImpl&) = delete;
+  LockFreeMMQImpl(LockFreeMMQImpl&&) = delete;
+  void operator=(const LockFreeMMQImpl&) = delete;
+  void operator=(LockFreeMMQImpl&&) = delete;
+
+  // Each entry occupies its own cache line, so that producers writing into adjacent slots do not contend.
+  struct alignas(64) Entry {
+    std::atomic<uint64_t> sequence;
+    idxts_t index_timestamp;
+    message_t message_body;
+  };
+
+  // How many times a waiting thread re-checks the condition before yielding, and then before parking.
+  constexpr static size_t kSpinIterations = 64u;
+  constexpr static size_t kYieldIterations = 64u;
+
+  // Indexes are 1-based, as in `MMQ`, and the entry with the index `i` goes into the slot `(i - 1) % size`.
+  // The sequence number of a slot is `i - 1` while it is free for the entry `i`, and `i` once the entry is ready.
+  size_t Slot(uint64_t index) const { return static_cast<size_t>((index - 1u) % circular_buffer_size_); }
+
+  // Returns { successful allocation flag, the index and the timestamp of the message }.
+  //
+  // The (index, timestamp) pair must grow monotonically in both of its components, which is the one thing that
+  // can not be done with a single CAS over a single 64-bit value. So `state_` is a sequence lock: it holds twice
+  // the last allocated index, plus one while the producer that has just allocated it is storing its timestamp.
+  // This window is two atomic stores long, and it is the only point where producers wait for one another.
+  template <typename TIMESTAMP>
+  std::pair<bool, idxts_t> CircularBufferAllocate(const TIMESTAMP user_timestamp) {
+    static_assert(time::IsTimestamp<TIMESTAMP>::value, "");
+    size_t attempt = 0u;
+    while (true) {
+      if (destructing_.load(std::memory_order_relaxed)) {
+        return std::make_pair(false, idxts_t());  // LCOV_EXCL_LINE
+      }
+      uint64_t state = state_.load(std::memory_order_acquire);
+      if (state & 1u) {
+        Backoff(attempt);
+        continue;
+      }
+      const std::chrono::microseconds last_us(last_us_.load(std::memory_order_relaxed));
+      const auto timestamp = current::time::TimestampAsMicroseconds(user_timestamp);
+      const uint64_t index = state / 2u + 1u;
+      Entry& entry = circular_buffer_[Slot(index)];
+      if (entry.sequence.load(std::memory_order_acquire) != index - 1u) {
+        if (DROP_ON_OVERFLOW) {
+          // Overflow. Discarding the message. Unlike an exception, a drop does not make the index "used".
+          if (state_.load(std::memory_order_acquire) == state) {
+            return std::make_pair(false, idxts_t());
+          } else {
+            continue;  // LCOV_EXCL_LINE
+          }
+        } else {
+          WaitForFreeSlot(entry, index - 1u);
+          continue;
+        }
+      }
+      if (!(timestamp > last_us)) {
+        if (state_.load(std::memory_order_acquire) == state) {
+          CURRENT_THROW(ss::InconsistentTimestampException(last_us + std::chrono::microseconds(1), timestamp));
+        } else {
+          continue;  // Another producer got in between, so `last_us` was not the latest one. LCOV_EXCL_LINE
+        }
+      }
+      if (state_.compare_exchange_weak(state, state + 1u, std::memory_order_acquire, std::memory_order_relaxed)) {
+        last_us_.store(timestamp.count(), std::memory_order_relaxed);
+        state_.store(state + 2u, std::memory_order_release);
+        return std::make_pair(true, idxts_t(index, timestamp));
+      }
+    }
+  }
+
+  void CircularBufferCommit(Entry& entry, idxts_t idxts) {
+    // After the message has been copied over, mark it as ready for the consumer. No lock involved,
+    // unless the consumer is parked; the `seq_cst` pair of the store and the load below makes sure
+    // the consumer can not go to sleep without this producer seeing it does.
+    entry.index_timestamp = idxts;
+    entry.sequence.store(idxts.index);
+    if (consumer_parked_.load()) {
+      WakeUpConsumer();
+    }
+  }
+
+  static void Backoff(size_t& attempt) {
+    if (attempt < kSpinIterations) {
+      ++attempt;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  // For the non-dropping mode: spin, then yield, then park until the consumer frees the slot.
+  // Another producer may grab the slot first, in which case its sequence number moves past `expected_sequence`,
+  // and the caller should start over with the fresh index.
+  void WaitForFreeSlot(const Entry& entry, uint64_t expected_sequence) {
+    for (size_t i = 0; i < kSpinIterations + kYieldIterations; ++i) {
+      if (entry.sequence.load(std::memory_order_acquire) >= expected_sequence || destructing_.load()) {
+        return;
+      }
+      if (i >= kSpinIterations) {
+        std::this_thread::yield();
+      }
+    }
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    ++producers_parked_;
+    producers_condition_variable_.wait(lock, [&] {
+      return entry.sequence.load() >= expected_sequence || destructing_.load();
+    });
+    --producers_parked_;
+  }
+
+  void WakeUpConsumer() {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    consumer_condition_variable_.notify_one();
+  }
+
+  void WakeUpProducers() {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    producers_condition_variable_.notify_all();
+  }
+
+  // The latest allocated (index, timestamp) pair, read consistently with respect to concurrent producers.
+  idxts_t LastIndexAndTimestamp() const {
+    while (true) {
+      const uint64_t state = state_.load(std::memory_order_acquire);
+      if (!(state & 1u)) {
+        const std::chrono::microseconds us(last_us_.load(std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (state_.load(std::memory_order_relaxed) == state) {
+          return idxts_t(state / 2u, us);
+        }
+      }
+      std::this_thread::yield();  // LCOV_EXCL_LINE
+    }
+  }
+
+  // Returns `false` if the queue is being destructed and there is nothing left to export.
+  bool WaitForReadySlot(const Entry& entry, uint64_t expected_sequence) {
+    for (size_t i = 0; i < kSpinIterations + kYieldIterations; ++i) {
+      if (entry.sequence.load(std::memory_order_acquire) == expected_sequence) {
+        return true;
+      }
+      if (i >= kSpinIterations) {
+        std::this_thread::yield();
+      }
+    }
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    consumer_parked_.store(true);
+    consumer_condition_variable_.wait(
+        lock, [&] { return entry.sequence.load() == expected_sequence || destructing_.load(); });
+    consumer_parked_.store(false);
+    return entry.sequence.load(std::memory_order_acquire) == expected_sequence;
+  }
+
+  // The thread which extracts fully populated messages from the tail of the buffer and feeds them to the consumer.
+  void ConsumerThread() {
+    if (ss::IsBatchEntrySubscriber<CONSUMER, MESSAGE>::value) {
+      BatchConsumerThread();
+      return;
+    }
+
+    uint64_t index = 1u;
+    while (true) {
+      Entry& entry = circular_buffer_[Slot(index)];
+      if (!WaitForReadySlot(entry, index)) {
+        return;
+      }
+      consumer_(std::move(entry.message_body), entry.index_timestamp, LastIndexAndTimestamp());
+      // Free the slot for the producer of the entry `index + size`.
+      entry.sequence.store(index - 1u + circular_buffer_size_);
+      if (!DROP_ON_OVERFLOW && producers_parked_.load()) {
+        WakeUpProducers();
+      }
+      ++index;
+    }
+  }
+
+  // The number of consecutive ready entries starting from `index`, up to `max_count`.
+  size_t ReadyEntriesCount(uint64_t index, size_t max_count) const {
+    size_t count = 0u;
+    while (count < max_count &&
+           circular_buffer_[Slot(index + count)].sequence.load(std::memory_order_acquire) == index + count) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Same as `ConsumerThread()`, but for the consumers that accept `ss::EntriesBatch<MESSAGE>`.
+  void BatchConsumerThread() {
+    const ss::BatchingPolicy policy = consumer_.GetBatchingPolicy();
+    const size_t max_batch_size =
+        std::max(static_cast<size_t>(1u), std::min(policy.max_batch_size, circular_buffer_size_));
+    std::vector<ss::IndexedEntry<message_t>> batch;
+    batch.reserve(max_batch_size);
+    uint64_t index = 1u;
+    while (true) {
+      if (!WaitForReadySlot(circular_buffer_[Slot(index)], index)) {
+        return;
+      }
+      if (policy.max_linger.count() > 0 && ReadyEntriesCount(index, max_batch_size) < max_batch_size) {
+        // Park until the last entry of the full batch is ready, or until the linger time is up.
+        const Entry& last_entry = circular_buffer_[Slot(index + max_batch_size - 1u)];
+        const uint64_t last_entry_sequence = index + max_batch_size - 1u;
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        consumer_parked_.store(true);
+        consumer_condition_variable_.wait_for(lock, policy.max_linger, [&] {
+          return last_entry.sequence.load() == last_entry_sequence || destructing_.load();
+        });
+        consumer_parked_.store(false);
+      }
+      const size_t count = ReadyEntriesCount(index, max_batch_size);
+      for (size_t i = 0; i < count; ++i) {
+        Entry& entry = circular_buffer_[Slot(index + i)];
+        batch.push_back({entry.index_timestamp, std::move(entry.message_body)});
+      }
+      consumer_(ss::EntriesBatch<message_t>(batch.data(), batch.size()), LastIndexAndTimestamp());
+      batch.clear();
+      for (size_t i = 0; i < count; ++i, ++index) {
+        circular_buffer_[Slot(index)].sequence.store(index - 1u + circular_buffer_size_);
+      }
+      if (!DROP_ON_OVERFLOW && producers_parked_.load()) {
+        WakeUpProducers();
+      }
+    }
+  }
+
+  // The instance of the consuming side of the FIFO buffer.
+  consumer_t& consumer_;
+
+  // The capacity of the circular buffer for intermediate messages.
+  const size_t circular_buffer_size_;
+
+  std::vector<Entry> circular_buffer_;
+
+  // Twice the last allocated index, plus one while its timestamp is being stored. See `CircularBufferAllocate()`.
+  alignas(64) std::atomic<uint64_t> state_{0u};
+  std::atomic<int64_t> last_us_{-1};
+
+  // Only used to park and wake up the waiting threads.
+  alignas(64) std::atomic_bool consumer_parked_{false};
+  std::atomic_size_t producers_parked_{0u};
+  std::atomic_bool destructing_{false};
+  std::mutex park_mutex_;
+  std::condition_variable consumer_condition_variable_;
+  std::condition_variable producers_condition_variable_;
+
+  // The thread in which the consuming process is running.
+  std::thread consumer_thread_;
+};
+
 template <typename MESSAGE, typename CONSUMER, size_t DEFAULT_BUFFER_SIZE = 1024, bool DROP_ON_OVERFLOW = false>
 using MMQ = ss::EntryPublisher<MMQImpl<MESSAGE, CONSUMER, DEFAULT_BUFFER_SIZE, DROP_ON_OVERFLOW>, MESSAGE>;
 
+template <typename MESSAGE, typename CONSUMER, size_t DEFAULT_BUFFER_SIZE = 1024, bool DROP_ON_OVERFLOW = false>
+using LockFreeMMQ =
+    ss::EntryPublisher<LockFreeMMQImpl<MESSAGE, CONSUMER, DEFAULT_BUFFER_SIZE, DROP_ON_OVERFLOW>, MESSAGE>;
+
 }  // namespace mmq
 }  // namespace current
 
@@ -28,15 +28,23 @@ SOFTWARE.
 #include "mmq.h"
 #include "mmpq.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <iostream>
+#include <map>
 #include <thread>
 
+#include "../../bricks/dflags/dflags.h"
 #include "../../bricks/strings/printf.h"
 #include "../../bricks/strings/join.h"
 
-#include "../../3rdparty/gtest/gtest-main.h"
+#include "../../3rdparty/gtest/gtest-main-with-dflags.h"
 
+DEFINE_uint32(mmq_benchmark_messages, 20000u, "The number of messages to publish per run of the MMQ benchmark.");
+DEFINE_uint32(mmq_benchmark_max_producers, 32u, "The maximum number of producer threads for the MMQ benchmark.");
+
+using current::mmq::LockFreeMMQ;
 using current::mmq::MMPQ;
 using current::mmq::MMQ;
 using current::ss::EntryResponse;
@@ -413,3 +421,326 @@ TEST(InMemoryMQ, MMPQSupportsUpdateHead) {
   EXPECT_EQ("three @ 3, seven @ 7, ace @ 100, king @ 101, queen @ 102, jack @ 103, joker @ 1000",
             current::strings::Join(c.messages_by_timestamps_, ", "));
 }
+
+TEST(InMemoryMQ, LockFreeSmokeTest) {
+  current::time::ResetToZero();
+
+  struct ConsumerImpl {
+    std::string messages_;
+    uint64_t expected_next_message_index_ = 1u;
+    std::atomic_size_t processed_messages_;
+    ConsumerImpl() : processed_messages_(0u) {}
+    EntryResponse operator()(const std::string& s, idxts_t current, idxts_t last) {
+      EXPECT_EQ(expected_next_message_index_, current.index);
+      EXPECT_GE(last.index, current.index);
+      EXPECT_GE(last.us, current.us);
+      ++expected_next_message_index_;
+      messages_ += s + '\n';
+      ++processed_messages_;
+      return EntryResponse::More;
+    }
+  };
+
+  using Consumer = current::ss::EntrySubscriber<ConsumerImpl, std::string>;
+
+  Consumer c;
+  LockFreeMMQ<std::string, Consumer> mmq(c);
+  static_assert(current::ss::IsPublisher<decltype(mmq)>::value, "");
+  static_assert(current::ss::IsEntryPublisher<decltype(mmq), std::string>::value, "");
+  EXPECT_EQ(1u, mmq.Publish("one").index);
+  const std::string two = "two";
+  EXPECT_EQ(2u, mmq.Publish(two).index);
+  EXPECT_EQ(3u, mmq.Publish("three").index);
+  while (c.processed_messages_ != 3) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ("one\ntwo\nthree\n", c.messages_);
+}
+
+TEST(InMemoryMQ, LockFreeDropOnOverflowTest) {
+  current::time::ResetToZero();
+
+  SuspendableConsumer c;
+
+  LockFreeMMQ<std::string, SuspendableConsumer, 10, true> mmq(c);
+
+  // Suspend the consumer temporarily while the first 25 messages are published.
+  c.suspend_processing_ = true;
+
+  size_t messages_accepted = 0u;
+  for (size_t i = 0; i < 25; ++i) {
+    const idxts_t result = mmq.Publish(current::strings::Printf("M%02d", static_cast<int>(i)));
+    if (result.index) {
+      // Dropped messages do not consume indexes.
+      EXPECT_EQ(messages_accepted + 1u, result.index);
+      ++messages_accepted;
+    }
+  }
+  EXPECT_EQ(10u, messages_accepted);
+
+  c.suspend_processing_ = false;
+  while (c.processed_messages_ != messages_accepted) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(messages_accepted + 1u, mmq.Publish("Plus one").index);
+  while (c.processed_messages_ != messages_accepted + 1u) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(messages_accepted + 1u, c.messages_.size());
+  EXPECT_EQ(messages_accepted + 1u, c.total_messages_accepted_by_the_queue_);
+  EXPECT_EQ("Plus one", c.messages_.back());
+}
+
+TEST(InMemoryMQ, LockFreeWaitOnOverflowTest) {
+  current::time::ResetToZero();
+
+  SuspendableConsumer c;
+  c.SetProcessingDelayMillis(1u);
+
+  LockFreeMMQ<std::string, SuspendableConsumer, 10, false> mmq(c);
+
+  const auto producer = [&](char prefix, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      mmq.Publish(current::strings::Printf("%c%02d", prefix, static_cast<int>(i)));
+    }
+  };
+
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < 10; ++i) {
+    producers.emplace_back(producer, static_cast<char>('a' + i), 10u);
+  }
+  for (auto& p : producers) {
+    p.join();
+  }
+
+  EXPECT_GE(c.processed_messages_, 90u);
+  while (c.processed_messages_ != 100u) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(c.processed_messages_, c.total_messages_accepted_by_the_queue_);
+  EXPECT_EQ(100u, std::set<std::string>(c.messages_.begin(), c.messages_.end()).size());
+
+  // The messages from each producer thread must have been delivered in the order they were published.
+  std::map<char, int> last_seen;
+  for (const std::string& message : c.messages_) {
+    const int n = std::stoi(message.substr(1));
+    if (last_seen.count(message[0])) {
+      EXPECT_EQ(last_seen[message[0]] + 1, n) << message;
+    } else {
+      EXPECT_EQ(0, n) << message;
+    }
+    last_seen[message[0]] = n;
+  }
+}
+
+TEST(InMemoryMQ, LockFreeTimeShouldNotGoBack) {
+  current::time::ResetToZero();
+
+  SuspendableConsumer c;
+  LockFreeMMQ<std::string, SuspendableConsumer> mmq(c);
+  mmq.Publish("one", std::chrono::microseconds(1));
+  mmq.Publish("three", std::chrono::microseconds(3));
+  ASSERT_THROW(mmq.Publish("two", std::chrono::microseconds(2)), current::ss::InconsistentTimestampException);
+  ASSERT_THROW(mmq.Publish("three again", std::chrono::microseconds(3)), current::ss::InconsistentTimestampException);
+  // The index is not consumed by the message that has been rejected.
+  EXPECT_EQ(3u, mmq.Publish("four", std::chrono::microseconds(4)).index);
+  while (c.processed_messages_ != 3) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ("one three four", current::strings::Join(c.messages_, ' '));
+}
+
+struct BatchConsumerImpl {
+  std::vector<std::string> batches_;
+  std::atomic_size_t processed_messages_;
+  std::atomic_bool suspend_processing_;
+  uint64_t expected_next_message_index_ = 1u;
+  bool expect_consecutive_indexes_ = true;
+  size_t max_batch_size_;
+  std::chrono::microseconds max_linger_;
+  BatchConsumerImpl(size_t max_batch_size = 1024u, std::chrono::microseconds max_linger = std::chrono::microseconds(0))
+      : processed_messages_(0u),
+        suspend_processing_(false),
+        max_batch_size_(max_batch_size),
+        max_linger_(max_linger) {}
+  EntryResponse operator()(const std::string&, idxts_t, idxts_t) {
+    ADD_FAILURE() << "Should not be called for the consumer that accepts batches.";
+    return EntryResponse::More;
+  }
+  EntryResponse operator()(current::ss::EntriesBatch<std::string> batch, idxts_t last) {
+    EXPECT_FALSE(batch.empty());
+    EXPECT_LE(batch.size(), max_batch_size_);
+    std::vector<std::string> messages;
+    for (auto& e : batch) {
+      if (expect_consecutive_indexes_) {
+        EXPECT_EQ(expected_next_message_index_, e.idx_ts.index);
+      }
+      EXPECT_LE(e.idx_ts.index, last.index);
+      ++expected_next_message_index_;
+      messages.push_back(std::move(e.entry));
+    }
+    while (suspend_processing_) {
+      std::this_thread::yield();
+    }
+    batches_.push_back(current::strings::Join(messages, ','));
+    processed_messages_ += batch.size();
+    return EntryResponse::More;
+  }
+  current::ss::BatchingPolicy GetBatchingPolicy() const {
+    return current::ss::BatchingPolicy(max_batch_size_, max_linger_);
+  }
+};
+
+using BatchConsumer = current::ss::EntrySubscriber<BatchConsumerImpl, std::string>;
+static_assert(current::ss::IsBatchEntrySubscriber<BatchConsumer, std::string>::value, "");
+
+template <typename QUEUE>
+void RunBatchConsumerTest() {
+  current::time::ResetToZero();
+
+  {
+    // The messages published while the consumer is busy are delivered together, up to the max batch size.
+    BatchConsumer c(3u);
+    QUEUE queue(c);
+    c.suspend_processing_ = true;
+    queue.Publish("a");
+    while (c.expected_next_message_index_ != 2u) {
+      std::this_thread::yield();
+    }
+    for (const char* message : {"b", "c", "d", "e", "f"}) {
+      queue.Publish(message);
+    }
+    c.suspend_processing_ = false;
+    while (c.processed_messages_ != 6u) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ("a b,c,d e,f", current::strings::Join(c.batches_, ' '));
+  }
+
+  {
+    // With the linger time set, the consumer waits for the batch to fill up.
+    BatchConsumer c(4u, std::chrono::microseconds(10 * 1000 * 1000));
+    QUEUE queue(c);
+    for (const char* message : {"one", "two", "three"}) {
+      queue.Publish(message);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(0u, c.processed_messages_);
+    queue.Publish("four");
+    while (c.processed_messages_ != 4u) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ("one,two,three,four", current::strings::Join(c.batches_, ' '));
+  }
+}
+
+TEST(InMemoryMQ, BatchConsumer) { RunBatchConsumerTest<MMQ<std::string, BatchConsumer>>(); }
+
+TEST(InMemoryMQ, LockFreeBatchConsumer) { RunBatchConsumerTest<LockFreeMMQ<std::string, BatchConsumer>>(); }
+
+TEST(InMemoryMQ, MMPQBatchConsumer) {
+  current::time::ResetToZero();
+
+  // MMPQ assigns indexes in the order of publishing, but passes on the entries in the order of their timestamps.
+  BatchConsumer c(2u);
+  c.expect_consecutive_indexes_ = false;
+  MMPQ<std::string, BatchConsumer> mmpq(c);
+  mmpq.Publish("three", std::chrono::microseconds(3));
+  mmpq.Publish("one", std::chrono::microseconds(1));
+  mmpq.Publish("two", std::chrono::microseconds(2));
+  mmpq.Publish("four", std::chrono::microseconds(4));
+  mmpq.UpdateHead(std::chrono::microseconds(3));
+  while (c.processed_messages_ != 3u) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ("one,two three", current::strings::Join(c.batches_, ' '));
+  c.batches_.clear();
+  mmpq.UpdateHead(std::chrono::microseconds(4));
+  while (c.processed_messages_ != 4u) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ("four", current::strings::Join(c.batches_, ' '));
+}
+
+namespace mmq_benchmark {
+
+struct CountingConsumerImpl {
+  std::atomic_size_t processed_messages_;
+  CountingConsumerImpl() : processed_messages_(0u) {}
+  EntryResponse operator()(const std::string&, idxts_t, idxts_t) {
+    processed_messages_.fetch_add(1u, std::memory_order_relaxed);
+    return EntryResponse::More;
+  }
+};
+
+using CountingConsumer = current::ss::EntrySubscriber<CountingConsumerImpl, std::string>;
+
+struct Result {
+  double messages_per_second;
+  double p50_publish_latency_us;
+  double p99_publish_latency_us;
+};
+
+// Publishes `total_messages` from `producers_count` threads, and measures how long does it take
+// for all of them to reach the consumer, as well as the distribution of times spent in `Publish()`.
+template <template <typename, typename, size_t, bool> class QUEUE>
+Result Run(size_t producers_count, size_t total_messages) {
+  current::time::ResetToZero();
+  CountingConsumer c;
+  QUEUE<std::string, CountingConsumer, 1024, false> queue(c);
+  const size_t per_producer = total_messages / producers_count;
+  std::vector<std::vector<double>> latencies(producers_count);
+  std::vector<std::thread> producers;
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < producers_count; ++t) {
+    producers.emplace_back([&queue, &latencies, t, per_producer]() {
+      std::vector<double>& latency = latencies[t];
+      latency.reserve(per_producer);
+      const std::string message(32u, static_cast<char>('a' + t % 26));
+      for (size_t i = 0; i < per_producer; ++i) {
+        const auto publish_begin = std::chrono::steady_clock::now();
+        queue.Publish(message);
+        latency.push_back(
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - publish_begin).count());
+      }
+    });
+  }
+  for (auto& p : producers) {
+    p.join();
+  }
+  while (c.processed_messages_ != per_producer * producers_count) {
+    std::this_thread::yield();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  std::vector<double> all;
+  for (const auto& latency : latencies) {
+    all.insert(all.end(), latency.begin(), latency.end());
+  }
+  std::sort(all.begin(), all.end());
+  return Result{static_cast<double>(all.size()) / seconds, all[all.size() / 2], all[all.size() * 99 / 100]};
+}
+
+}  // namespace mmq_benchmark
+
+// Not a correctness test, but the numbers to compare the mutex-based and the lock-free queues by.
+// Run with `--mmq_benchmark_messages=1000000` for meaningful results. Keep in mind this test is built with
+// `CURRENT_MOCK_TIME`, so `Publish()` without the explicit timestamp also pays for the mock clock's mutex.
+TEST(InMemoryMQ, ThroughputAndLatencyBenchmark) {
+  for (size_t producers = 1u; producers <= FLAGS_mmq_benchmark_max_producers; producers *= 2u) {
+    const size_t messages = std::max(static_cast<size_t>(FLAGS_mmq_benchmark_messages), producers);
+    const mmq_benchmark::Result locked = mmq_benchmark::Run<MMQ>(producers, messages);
+    const mmq_benchmark::Result lock_free = mmq_benchmark::Run<LockFreeMMQ>(producers, messages);
+    std::cerr << current::strings::Printf(
+                     "%2d producers: MMQ %9.0f msg/s, p50 %6.2fus, p99 %8.2fus; "
+                     "LockFreeMMQ %9.0f msg/s, p50 %6.2fus, p99 %8.2fus\n",
+                     static_cast<int>(producers),
+                     locked.messages_per_second,
+                     locked.p50_publish_latency_us,
+                     locked.p99_publish_latency_us,
+                     lock_free.messages_per_second,
+                     lock_free.p50_publish_latency_us,
+                     lock_free.p99_publish_latency_us);
+  }
+}
@@ -0,0 +1,759 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// A file-based persister that stores the entries as length-prefixed binary records, instead of JSON lines.
+// The entries are serialized with `ToBinary()`, see `typesystem/serialization/binary.h`.
+// The file is the `kBinaryFileHeader` magic, followed by the records, each being the fixed-size
+// `BinaryRecordHeader` followed by the payload of `payload_size` bytes. The CRC32 of each record covers
+// its index, timestamp and payload. The first record is the signature, and the head is a payload-less record,
+// which, same as the `#head` directive of `persistence::File`, is rewritten in place while it is the last one.
+//
+// The iterators have the same semantics as those of `persistence::File`: the safe ones validate the records and
+// return parsed entries, the unsafe ones return the "raw" `JSON(idxts) \t JSON(entry)` log lines.
+// `ConvertFileToBinaryFile()` and `ConvertBinaryFileToFile()` migrate the data between the two formats.
+
+#ifndef BLOCKS_PERSISTENCE_BINARY_FILE_H
+#define BLOCKS_PERSISTENCE_BINARY_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include "exceptions.h"
+#include "file.h"
+
+#include "../ss/persister.h"
+#include "../ss/signature.h"
+
+#include "../../bricks/sync/locks.h"
+#include "../../bricks/sync/owned_borrowed.h"
+#include "../../bricks/time/chrono.h"
+#include "../../bricks/util/atomic_that_works.h"
+#include "../../bricks/util/crc32.h"
+#include "../../typesystem/schema/schema.h"
+#include "../../typesystem/serialization/binary.h"
+#include "../../typesystem/serialization/json.h"
+
+namespace current {
+namespace persistence {
+
+namespace impl {
+
+namespace constants {
+constexpr char kBinaryFileHeader[] = "C5TBIN1\n";
+constexpr uint64_t kBinaryHeadRecordIndex = static_cast<uint64_t>(-1);
+constexpr uint64_t kBinarySignatureRecordIndex = static_cast<uint64_t>(-2);
+}  // namespace constants
+
+// The header of each record, in host byte order. For the directives, `index` is one of the reserved values above.
+struct BinaryRecordHeader {
+  uint32_t payload_size;
+  uint32_t crc32;  // Of `index`, `us`, and the payload.
+  uint64_t index;
+  int64_t us;
+};
+static_assert(sizeof(BinaryRecordHeader) == 24, "");
+
+inline uint32_t BinaryRecordCRC32(const BinaryRecordHeader& header, const char* payload) {
+  static constexpr size_t kCRCedHeaderOffset = offsetof(BinaryRecordHeader, index);
+  const uint32_t crc = CRC32(0u,
+                             reinterpret_cast<const char*>(&header) + kCRCedHeaderOffset,
+                             sizeof(BinaryRecordHeader) - kCRCedHeaderOffset);
+  return CRC32(crc, payload, header.payload_size);
+}
+
+// Reads the records one by one. Returns `false` at the end of the file, or at the incomplete last record,
+// the "torn tail" a crash in the middle of a write leaves behind, in which case `IncompleteRecord()` is `true`.
+class BinaryRecordReader final {
+ public:
+  BinaryRecordReader(std::istream& fi, std::streampos offset)
+      : fi_(fi), offset_(offset), file_size_(static_cast<std::streamoff>(offset)) {
+    CURRENT_ASSERT(!fi_.bad());
+    fi_.seekg(offset, std::ios_base::beg);
+  }
+
+  bool ReadNextRecord() {
+    record_offset_ = offset_;
+    if (!fi_.read(reinterpret_cast<char*>(&header_), sizeof(header_))) {
+      incomplete_record_ = (fi_.gcount() != 0);
+      return false;
+    }
+    // Never trust `payload_size` to allocate the buffer before making sure the file has this many bytes.
+    // The file may be growing, so its size is only re-checked when the cached one is not enough.
+    const std::streamoff record_end =
+        static_cast<std::streamoff>(offset_) + static_cast<std::streamoff>(sizeof(header_) + header_.payload_size);
+    if (record_end > file_size_) {
+      const std::streampos payload_offset = fi_.tellg();
+      fi_.seekg(0, std::ios_base::end);
+      file_size_ = static_cast<std::streamoff>(fi_.tellg());
+      fi_.seekg(payload_offset, std::ios_base::beg);
+      if (record_end > file_size_) {
+        incomplete_record_ = true;
+        return false;
+      }
+    }
+    payload_.resize(header_.payload_size);
+    if (header_.payload_size && !fi_.read(&payload_[0], header_.payload_size)) {
+      incomplete_record_ = true;
+      return false;
+    }
+    offset_ = record_end;
+    return true;
+  }
+
+  void ValidateChecksum() const {
+    if (BinaryRecordCRC32(header_, payload_.data()) != header_.crc32) {
+      CURRENT_THROW(BinaryRecordChecksumMismatch(static_cast<uint64_t>(record_offset_)));
+    }
+  }
+
+  bool IsEntry() const {
+    return header_.index != constants::kBinaryHeadRecordIndex &&
+           header_.index != constants::kBinarySignatureRecordIndex;
+  }
+
+  const BinaryRecordHeader& Header() const { return header_; }
+  const std::string& Payload() const { return payload_; }
+  std::streampos RecordOffset() const { return record_offset_; }
+  std::streampos NextRecordOffset() const { return offset_; }
+  bool IncompleteRecord() const { return incomplete_record_; }
+
+ private:
+  std::istream& fi_;
+  std::streampos offset_;
+  std::streamoff file_size_;
+  std::streampos record_offset_;
+  bool incomplete_record_ = false;
+  BinaryRecordHeader header_;
+  std::string payload_;
+};
+
+// The implementation of a persister based exclusively on appending to and reading one binary file.
+template <typename ENTRY>
+class BinaryFilePersister {
+ protected:
+  // { last_published_index + 1, last_published_us, current_head_us }, or { 0, -1us, -1us } for an empty persister.
+  struct end_t {
+    uint64_t next_index;
+    std::chrono::microseconds last_entry_us;
+    std::chrono::microseconds head;
+  };
+
+  // The payload of an entry record is the entry serialized with `ToBinary()`.
+  // `PayloadFromEntryJSON()` and `EntryJSONFromPayload()` are what makes the unsafe publishing and iterating
+  // interchangeable with those of `persistence::File`, at the cost of converting between the two formats.
+  template <typename E>
+  static std::string PayloadFromEntry(E&& entry) {
+    // Explicit `MakeSureTheRightTypeIsSerialized` is essential, otherwise the `Variant`'s case
+    // would be serialized in an unwrapped way when passed directly.
+    return ToBinary(MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<E>>::DoIt(std::forward<E>(entry)));
+  }
+  static ENTRY EntryFromPayload(const std::string& payload) { return ParseBinary<ENTRY>(payload); }
+  static std::string PayloadFromEntryJSON(std::string_view entry_json) {
+    return ToBinary(ParseJSON<ENTRY>(std::string(entry_json)));
+  }
+  static std::string EntryJSONFromPayload(const std::string& payload) { return JSON(ParseBinary<ENTRY>(payload)); }
+
+ private:
+  struct BinaryFilePersisterImpl final {
+    const std::string filename_;
+    std::ofstream file_appender_;
+    std::fstream head_rewriter_;
+
+    // `record_offset_.size() == end.next_index`, and `record_offset_[i]` is where the record for index `i` begins.
+    std::mutex& publish_mutex_ref_;  // Guards `record_offset_`, `head_offset_`, `record_timestamp_`, and the below.
+    std::vector<std::streampos> record_offset_;
+    std::vector<std::chrono::microseconds> record_timestamp_;
+    // Where the head record begins, if it is the last record in the file, or zero otherwise.
+    std::streampos head_offset_;
+    // The offset at which the next record will be appended.
+    std::streampos append_offset_;
+    // The buffer to assemble the records in, so that each one is written with a single call.
+    std::string record_buffer_;
+
+    current::atomic_that_works<end_t> end_;
+
+    BinaryFilePersisterImpl() = delete;
+    BinaryFilePersisterImpl(const BinaryFilePersisterImpl&) = delete;
+    BinaryFilePersisterImpl(BinaryFilePersisterImpl&&) = delete;
+    BinaryFilePersisterImpl& operator=(const BinaryFilePersisterImpl&) = delete;
+    BinaryFilePersisterImpl& operator=(BinaryFilePersisterImpl&&) = delete;
+
+    BinaryFilePersisterImpl(std::mutex& publish_mutex_ref,
+                            const ss::StreamNamespaceName& namespace_name,
+                            const std::string& filename)
+        : filename_(filename),
+          file_appender_(filename, std::ofstream::binary | std::ofstream::app | std::ofstream::ate),
+          head_rewriter_(filename, std::ofstream::binary | std::ofstream::in | std::ofstream::out),
+          publish_mutex_ref_(publish_mutex_ref),
+          head_offset_(0) {
+      ValidateFileAndInitializeHead(namespace_name);
+      if (file_appender_.bad() || head_rewriter_.bad()) {
+        CURRENT_THROW(PersistenceFileNotWritable(filename));
+      }
+    }
+
+    // Writes the record into the file. Must be called from under `publish_mutex_ref_`.
+    void AppendRecord(uint64_t index, std::chrono::microseconds us, std::string_view payload) {
+      BinaryRecordHeader header;
+      header.payload_size = static_cast<uint32_t>(payload.size());
+      header.index = index;
+      header.us = static_cast<int64_t>(us.count());
+      header.crc32 = BinaryRecordCRC32(header, payload.data());
+      record_buffer_.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+      record_buffer_.append(payload.data(), payload.size());
+      file_appender_.write(record_buffer_.data(), record_buffer_.size());
+      file_appender_.flush();
+      append_offset_ += static_cast<std::streamoff>(record_buffer_.size());
+    }
+
+    // Replay the file but ignore its contents. Used to initialize `end_` and `append_offset_` at startup.
+    // An incomplete record in the end of the file, left by a crash in the middle of a write, is truncated away.
+    void ValidateFileAndInitializeHead(const ss::StreamNamespaceName& namespace_name) {
+      reflection::StructSchema struct_schema;
+      struct_schema.AddType<ENTRY>();
+      const auto signature = JSON(ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo()));
+
+      std::ifstream fi(filename_, std::ifstream::binary);
+      static constexpr size_t kHeaderLength = sizeof(constants::kBinaryFileHeader) - 1u;
+      char header[kHeaderLength];
+      if (fi.read(header, kHeaderLength)) {
+        if (memcmp(header, constants::kBinaryFileHeader, kHeaderLength)) {
+          CURRENT_THROW(MalformedEntryException("Not a binary stream file: `" + filename_ + "`."));
+        }
+        ReplayFile(fi, signature);
+        if (append_offset_ == std::streampos(static_cast<std::streamoff>(kHeaderLength))) {
+          // The signature record itself was torn.
+          AppendRecord(constants::kBinarySignatureRecordIndex, std::chrono::microseconds(0), signature);
+        }
+      } else if (fi.gcount() && memcmp(header, constants::kBinaryFileHeader, static_cast<size_t>(fi.gcount()))) {
+        CURRENT_THROW(MalformedEntryException("Not a binary stream file: `" + filename_ + "`."));
+      } else {
+        // A new or empty file, or one with a torn header, write the header and the signature.
+        if (fi.gcount()) {
+          TruncateFile(0);
+        }
+        end_.store({0ull, std::chrono::microseconds(-1), std::chrono::microseconds(-1)});
+        file_appender_.write(constants::kBinaryFileHeader, kHeaderLength);
+        append_offset_ = static_cast<std::streamoff>(kHeaderLength);
+        AppendRecord(constants::kBinarySignatureRecordIndex, std::chrono::microseconds(0), signature);
+      }
+    }
+
+    // The appender is in the `app` mode, so it keeps writing to the new end of the file.
+    void TruncateFile(std::streampos size) {
+      std::error_code ec;
+      std::filesystem::resize_file(filename_, static_cast<uintmax_t>(static_cast<std::streamoff>(size)), ec);
+      if (ec) {
+        CURRENT_THROW(PersistenceFileNotWritable(filename_));
+      }
+    }
+
+    void ReplayFile(std::istream& fi, const std::string& signature) {
+      static constexpr size_t kHeaderLength = sizeof(constants::kBinaryFileHeader) - 1u;
+      BinaryRecordReader reader(fi, static_cast<std::streamoff>(kHeaderLength));
+      end_t end{0ull, std::chrono::microseconds(-1), std::chrono::microseconds(-1)};
+      while (reader.ReadNextRecord()) {
+        reader.ValidateChecksum();
+        const auto& header = reader.Header();
+        const auto us = std::chrono::microseconds(header.us);
+        head_offset_ = 0;
+        if (header.index == constants::kBinarySignatureRecordIndex) {
+          // The signature, if present, should be at the beginning of the file.
+          if (reader.RecordOffset() != std::streampos(static_cast<std::streamoff>(kHeaderLength))) {
+            CURRENT_THROW(InvalidSignatureLocation());
+          }
+          if (reader.Payload() != signature) {
+            CURRENT_THROW(InvalidStreamSignature(signature, reader.Payload()));
+          }
+        } else {
+          if (!(us > end.head)) {
+            CURRENT_THROW(ss::InconsistentTimestampException(end.head + std::chrono::microseconds(1), us));
+          }
+          end.head = us;
+          if (header.index == constants::kBinaryHeadRecordIndex) {
+            head_offset_ = reader.RecordOffset();
+          } else {
+            if (header.index != end.next_index) {
+              // Indexes must be strictly continuous.
+              CURRENT_THROW(ss::InconsistentIndexException(end.next_index, header.index));
+            }
+            record_offset_.push_back(reader.RecordOffset());
+            record_timestamp_.push_back(us);
+            end.last_entry_us = us;
+            ++end.next_index;
+          }
+        }
+      }
+      append_offset_ = reader.RecordOffset();
+      if (reader.IncompleteRecord()) {
+        TruncateFile(append_offset_);
+      }
+      end_.store(end);
+    }
+  };
+
+ public:
+  BinaryFilePersister() = delete;
+  BinaryFilePersister(const BinaryFilePersister&) = delete;
+  BinaryFilePersister(BinaryFilePersister&&) = delete;
+  BinaryFilePersister& operator=(const BinaryFilePersister&) = delete;
+  BinaryFilePersister& operator=(BinaryFilePersister&&) = delete;
+
+  BinaryFilePersister(std::mutex& publish_mutex_ref,
+                      const ss::StreamNamespaceName& namespace_name,
+                      const std::string& filename)
+      : impl_(MakeOwned<BinaryFilePersisterImpl>(publish_mutex_ref, namespace_name, filename)) {}
+
+  class Iterator final {
+   public:
+    struct Entry {
+      idxts_t idx_ts;
+      ENTRY entry;
+    };
+
+    Iterator() = delete;
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    Iterator(Iterator&&) = default;
+    Iterator& operator=(Iterator&&) = default;
+
+    Iterator(Borrowed<BinaryFilePersisterImpl> impl, const std::string& filename, uint64_t i, std::streampos offset)
+        : impl_(std::move(impl)), i_(i) {
+      if (!filename.empty()) {
+        fi_ = std::make_unique<std::ifstream>(filename, std::ifstream::binary);
+        reader_ = std::make_unique<BinaryRecordReader>(*fi_, offset);
+      }
+    }
+
+    // The entry is read from the file once, on the first dereference, and kept until the iterator is incremented.
+    // Reading it there rather than in `operator++` keeps the increment non-throwing.
+    const Entry& operator*() const {
+      while (!current_entry_) {
+        if (!reader_->ReadNextRecord()) {
+          // End of file. Should never happen as long as the user only iterates over valid ranges.
+          CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+        }
+        if (reader_->IsEntry()) {
+          reader_->ValidateChecksum();
+          const auto& header = reader_->Header();
+          if (header.index == i_) {
+            current_entry_ = std::make_unique<Entry>(Entry{idxts_t(header.index, std::chrono::microseconds(header.us)),
+                                                           EntryFromPayload(reader_->Payload())});
+          } else if (header.index > i_) {
+            CURRENT_THROW(ss::InconsistentIndexException(i_, header.index));
+          }
+        }
+      }
+      return *current_entry_;
+    }
+
+    Iterator& operator++() {
+      // By convention, iterating over data, being an immutable operation, does not throw.
+      ++i_;
+      current_entry_ = nullptr;
+      return *this;
+    }
+    bool operator==(const Iterator& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const Iterator& rhs) const { return !operator==(rhs); }
+    operator bool() const { return impl_; }
+
+   private:
+    const Borrowed<BinaryFilePersisterImpl> impl_;
+    std::unique_ptr<std::ifstream> fi_;
+    std::unique_ptr<BinaryRecordReader> reader_;
+    uint64_t i_;
+    mutable std::unique_ptr<Entry> current_entry_;
+  };
+
+  class IteratorUnsafe final {
+   public:
+    IteratorUnsafe() = delete;
+    IteratorUnsafe(const IteratorUnsafe&) = delete;
+    IteratorUnsafe(IteratorUnsafe&&) = default;
+    IteratorUnsafe& operator=(const IteratorUnsafe&) = delete;
+    IteratorUnsafe& operator=(IteratorUnsafe&&) = default;
+
+    IteratorUnsafe(Borrowed<BinaryFilePersisterImpl> impl,
+                   const std::string& filename,
+                   uint64_t i,
+                   std::streampos offset)
+        : impl_(std::move(impl)), i_(i) {
+      if (!filename.empty()) {
+        fi_ = std::make_unique<std::ifstream>(filename, std::ifstream::binary);
+        reader_ = std::make_unique<BinaryRecordReader>(*fi_, offset);
+      }
+    }
+
+    // `operator*` relies on the fact each entry will be requested at most once.
+    std::string operator*() const { return std::string(RawLogLine()); }
+
+    // The raw log line is assembled from the record, so the view is into the buffer of this iterator.
+    std::string_view RawLogLine() const {
+      if (current_entry_.empty()) {
+        while (true) {
+          if (!reader_->ReadNextRecord()) {
+            // End of file. Should never happen as long as the user only iterates over valid ranges.
+            CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+          }
+          if (reader_->IsEntry() && reader_->Header().index >= i_) {
+            break;
+          }
+        }
+        const auto& header = reader_->Header();
+        current_entry_ = JSON(idxts_t(header.index, std::chrono::microseconds(header.us)));
+        current_entry_ += '\t';
+        current_entry_ += EntryJSONFromPayload(reader_->Payload());
+      }
+      return current_entry_;
+    }
+
+    IteratorUnsafe& operator++() {
+      ++i_;
+      current_entry_.clear();
+      return *this;
+    }
+    bool operator==(const IteratorUnsafe& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const IteratorUnsafe& rhs) const { return !operator==(rhs); }
+    operator bool() const { return impl_; }
+
+   private:
+    Borrowed<BinaryFilePersisterImpl> impl_;
+    std::unique_ptr<std::ifstream> fi_;
+    std::unique_ptr<BinaryRecordReader> reader_;
+    uint64_t i_;
+    mutable std::string current_entry_;
+  };
+
+  template <typename ITERATOR>
+  class IterableRangeImpl {
+   public:
+    IterableRangeImpl(Borrowed<BinaryFilePersisterImpl> impl,
+                      uint64_t begin,
+                      uint64_t end,
+                      std::streampos begin_offset)
+        : impl_(std::move(impl)), begin_(begin), end_(end), begin_offset_(begin_offset) {}
+
+    IterableRangeImpl(IterableRangeImpl&& rhs)
+        : impl_(std::move(rhs.impl_)), begin_(rhs.begin_), end_(rhs.end_), begin_offset_(rhs.begin_offset_) {}
+
+    ITERATOR begin() const {
+      // By convention, iterating over data, being an immutable operation, does not throw.
+      if (begin_ == end_) {
+        return ITERATOR(impl_, "", 0, 0);  // No need in accessing the file for a null iterator.
+      } else {
+        return ITERATOR(impl_, impl_->filename_, begin_, begin_offset_);
+      }
+    }
+    ITERATOR end() const {
+      // By convention, iterating over data, being an immutable operation, does not throw.
+      if (begin_ == end_) {
+        return ITERATOR(impl_, "", 0, 0);  // No need in accessing the file for a null iterator.
+      } else {
+        return ITERATOR(impl_, "", end_, 0);  // No need in accessing the file for a no-op `end` iterator.
+      }
+    }
+
+    operator bool() const { return impl_; }
+
+   private:
+    const Borrowed<BinaryFilePersisterImpl> impl_;
+    const uint64_t begin_;
+    const uint64_t end_;
+    const std::streampos begin_offset_;
+  };
+
+  // `TIMESTAMP` can be `std::chrono::microseconds` or `current::time::DefaultTimeArgument`.
+  template <current::locks::MutexLockStatus MLS, typename E, typename TIMESTAMP>
+  idxts_t PersisterPublishImpl(E&& entry, const TIMESTAMP provided_timestamp) {
+    const std::string payload = PayloadFromEntry(std::forward<E>(entry));
+
+    current::locks::SmartMutexLockGuard<MLS> lock(impl_->publish_mutex_ref_);
+    end_t iterator = impl_->end_.load();
+    const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
+    if (!(timestamp > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+    }
+    return AppendEntryRecord(iterator, idxts_t(iterator.next_index, timestamp), payload);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
+    const auto tab_pos = raw_log_line.find('\t');
+    if (tab_pos == std::string::npos) {
+      CURRENT_THROW(MalformedEntryException(raw_log_line));
+    }
+    const auto idxts = ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos));
+    const std::string payload = PayloadFromEntryJSON(std::string_view(raw_log_line).substr(tab_pos + 1u));
+
+    current::locks::SmartMutexLockGuard<MLS> lock(impl_->publish_mutex_ref_);
+    end_t iterator = impl_->end_.load();
+    if (idxts.index != iterator.next_index) {
+      CURRENT_THROW(UnsafePublishBadIndexTimestampException(iterator.next_index, idxts.index));
+    }
+    if (!(idxts.us > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), idxts.us));
+    }
+    return AppendEntryRecord(iterator, idxts, payload);
+  }
+
+  // The JSON entries are converted into the binary payloads before taking the lock, which is then taken once.
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterPublishUnsafeBatchImpl(const std::vector<std::string>& raw_log_lines) {
+    std::vector<std::pair<idxts_t, std::string>> records;
+    records.reserve(raw_log_lines.size());
+    for (const auto& raw_log_line : raw_log_lines) {
+      const auto tab_pos = raw_log_line.find('\t');
+      if (tab_pos == std::string::npos) {
+        CURRENT_THROW(MalformedEntryException(raw_log_line));
+      }
+      records.emplace_back(ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos)),
+                           PayloadFromEntryJSON(std::string_view(raw_log_line).substr(tab_pos + 1u)));
+    }
+
+    current::locks::SmartMutexLockGuard<MLS> lock(impl_->publish_mutex_ref_);
+    idxts_t result;
+    for (const auto& record : records) {
+      const end_t iterator = impl_->end_.load();
+      if (record.first.index != iterator.next_index) {
+        CURRENT_THROW(UnsafePublishBadIndexTimestampException(iterator.next_index, record.first.index));
+      }
+      if (!(record.first.us > iterator.head)) {
+        CURRENT_THROW(
+            ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), record.first.us));
+      }
+      result = AppendEntryRecord(iterator, record.first, record.second);
+    }
+    return result;
+  }
+
+  // The head record is rewritten in place while it is the last record in the file.
+  template <current::locks::MutexLockStatus MLS, typename TIMESTAMP>
+  void PersisterUpdateHeadImpl(const TIMESTAMP provided_timestamp) {
+    current::locks::SmartMutexLockGuard<MLS> lock(impl_->publish_mutex_ref_);
+
+    end_t iterator = impl_->end_.load();
+    const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
+    if (!(timestamp > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+    }
+    iterator.head = timestamp;
+    if (impl_->head_offset_) {
+      BinaryRecordHeader header;
+      header.payload_size = 0u;
+      header.index = constants::kBinaryHeadRecordIndex;
+      header.us = static_cast<int64_t>(timestamp.count());
+      header.crc32 = BinaryRecordCRC32(header, nullptr);
+      auto& rewriter = impl_->head_rewriter_;
+      rewriter.seekp(impl_->head_offset_, std::ios_base::beg);
+      rewriter.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      rewriter.flush();
+    } else {
+      impl_->head_offset_ = impl_->append_offset_;
+      impl_->AppendRecord(constants::kBinaryHeadRecordIndex, timestamp, std::string_view());
+    }
+    impl_->end_.store(iterator);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  bool PersisterEmptyImpl() const {
+    return !impl_->end_.load().next_index;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  uint64_t PersisterSizeImpl() const noexcept {
+    return impl_->end_.load().next_index;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  std::chrono::microseconds PersisterCurrentHeadImpl() const noexcept {
+    return impl_->end_.load().head;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterLastPublishedIndexAndTimestampImpl() const {
+    const auto iterator = impl_->end_.load();
+    if (iterator.next_index) {
+      return idxts_t(iterator.next_index - 1, iterator.last_entry_us);
+    } else {
+      CURRENT_THROW(NoEntriesPublishedYet());
+    }
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  head_optidxts_t PersisterHeadAndLastPublishedIndexAndTimestampImpl() const noexcept {
+    const auto iterator = impl_->end_.load();
+    if (iterator.next_index) {
+      return head_optidxts_t(iterator.head, iterator.next_index - 1, iterator.last_entry_us);
+    } else {
+      return head_optidxts_t(iterator.head);
+    }
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  std::pair<uint64_t, uint64_t> PersisterIndexRangeByTimestampRangeImpl(std::chrono::microseconds from,
+                                                                        std::chrono::microseconds till) const {
+    std::pair<uint64_t, uint64_t> result{static_cast<uint64_t>(-1), static_cast<uint64_t>(-1)};
+    current::locks::SmartMutexLockGuard<MLS> lock(impl_->publish_mutex_ref_);
+    const auto& timestamps = impl_->record_timestamp_;
+    const auto begin_it = std::lower_bound(timestamps.begin(), timestamps.end(), from);
+    if (begin_it != timestamps.end()) {
+      result.first = std::distance(timestamps.begin(), begin_it);
+    }
+    if (till.count() > 0) {
+      const auto end_it = std::upper_bound(timestamps.begin(), timestamps.end(), till);
+      if (end_it != timestamps.end()) {
+        result.second = std::distance(timestamps.begin(), end_it);
+      }
+    }
+    return result;
+  }
+
+  using IterableRange = IterableRangeImpl<Iterator>;
+  using IterableRangeUnsafe = IterableRangeImpl<IteratorUnsafe>;
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRange PersisterIterate(uint64_t begin_index, uint64_t end_index) const {
+    return PersisterIterateImpl<MLS, IterableRange>(begin_index, end_index);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRangeUnsafe PersisterIterateUnsafe(uint64_t begin_index, uint64_t end_index) const {
+    return PersisterIterateImpl<MLS, IterableRangeUnsafe>(begin_index, end_index);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRange PersisterIterate(std::chrono::microseconds from, std::chrono::microseconds till) const {
+    return PersisterIterateImpl<MLS, IterableRange>(from, till);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRangeUnsafe PersisterIterateUnsafe(std::chrono::microseconds from, std::chrono::microseconds till) const {
+    return PersisterIterateImpl<MLS, IterableRangeUnsafe>(from, till);
+  }
+
+ private:
+  // Must be called from under `publish_mutex_ref_`, with the index and the timestamp validated.
+  idxts_t AppendEntryRecord(end_t iterator, idxts_t idxts, const std::string& payload) {
+    CURRENT_ASSERT(impl_->record_offset_.size() == idxts.index);
+    CURRENT_ASSERT(impl_->record_timestamp_.size() == idxts.index);
+    impl_->record_offset_.push_back(impl_->append_offset_);
+    impl_->record_timestamp_.push_back(idxts.us);
+    impl_->AppendRecord(idxts.index, idxts.us, payload);
+    iterator.last_entry_us = iterator.head = idxts.us;
+    ++iterator.next_index;
+    impl_->head_offset_ = 0;
+    impl_->end_.store(iterator);
+    return idxts;
+  }
+
+  template <current::locks::MutexLockStatus MLS, typename ITERABLE>
+  ITERABLE PersisterIterateImpl(uint64_t begin_index, uint64_t end_index) const {
+    // OK to only lock the mutex later, as `impl_->end_` is an `atomic`.
+    const uint64_t current_size = impl_->end_.load().next_index;
+    if (end_index == static_cast<uint64_t>(-1)) {
+      end_index = current_size;
+    }
+    if (end_index > current_size) {
+      CURRENT_THROW(InvalidIterableRangeException());
+    }
+    if (begin_index == end_index) {
+      return ITERABLE(impl_, 0, 0, 0);  // OK, even for an empty persister, where 0 is an invalid index.
+    }
+    if (end_index < begin_index) {
+      CURRENT_THROW(InvalidIterableRangeException());
+    }
+
+    current::locks::SmartMutexLockGuard<MLS> lock(impl_->publish_mutex_ref_);
+    return ITERABLE(impl_, begin_index, end_index, impl_->record_offset_[static_cast<size_t>(begin_index)]);
+  }
+
+  template <current::locks::MutexLockStatus MLS, typename ITERABLE>
+  ITERABLE PersisterIterateImpl(std::chrono::microseconds from, std::chrono::microseconds till) const {
+    if (till.count() > 0 && till < from) {
+      CURRENT_THROW(InvalidIterableRangeException());
+    }
+
+    const auto index_range = PersisterIndexRangeByTimestampRangeImpl<MLS>(from, till);
+    if (index_range.first != static_cast<uint64_t>(-1)) {
+      return PersisterIterateImpl<MLS, ITERABLE>(index_range.first, index_range.second);
+    } else {  // No entries found in the requested range.
+      return ITERABLE(impl_, 0, 0, 0);
+    }
+  }
+
+  Owned<BinaryFilePersisterImpl> impl_;  // `Owned`, as iterators borrow it.
+};
+
+}  // namespace impl
+
+template <typename ENTRY>
+using BinaryFile = ss::EntryPersister<impl::BinaryFilePersister<ENTRY>, ENTRY>;
+
+namespace impl {
+
+template <typename FROM, typename TO>
+void CopyPersistedEntries(const ss::StreamNamespaceName& namespace_name,
+                          const std::string& from_filename,
+                          const std::string& to_filename) {
+  std::mutex from_mutex;
+  std::mutex to_mutex;
+  FROM from(from_mutex, namespace_name, from_filename);
+  TO to(to_mutex, namespace_name, to_filename);
+  if (to.Size() > from.Size()) {
+    CURRENT_THROW(InvalidIterableRangeException());
+  }
+  for (const auto& raw_log_line : from.IterateUnsafe(to.Size())) {
+    to.PublishUnsafe(raw_log_line);
+  }
+  const auto head = from.CurrentHead();
+  if (head > to.CurrentHead()) {
+    to.UpdateHead(head);
+  }
+}
+
+}  // namespace impl
+
+// Migrate the data between `persistence::File` and `persistence::BinaryFile`. If the destination file
+// already exists, only the entries past those already in it are copied, so the migration can be resumed.
+template <typename ENTRY>
+void ConvertFileToBinaryFile(const ss::StreamNamespaceName& namespace_name,
+                             const std::string& json_filename,
+                             const std::string& binary_filename) {
+  impl::CopyPersistedEntries<File<ENTRY>, BinaryFile<ENTRY>>(namespace_name, json_filename, binary_filename);
+}
+
+template <typename ENTRY>
+void ConvertBinaryFileToFile(const ss::StreamNamespaceName& namespace_name,
+                             const std::string& binary_filename,
+                             const std::string& json_filename) {
+  impl::CopyPersistedEntries<BinaryFile<ENTRY>, File<ENTRY>>(namespace_name, binary_filename, json_filename);
+}
+
+}  // namespace persistence
+}  // namespace current
+
+#endif  // BLOCKS_PERSISTENCE_BINARY_FILE_H
@@ -64,6 +64,12 @@ struct PersistenceFileNotWritable : PersistenceException {
       : PersistenceException("Persistence file not writable: `" + filename + "`.") {}
 };
 
+struct BinaryRecordChecksumMismatch : PersistenceException {
+  explicit BinaryRecordChecksumMismatch(uint64_t offset)
+      : PersistenceException(
+            current::strings::Printf("CRC32 mismatch in the record at offset %lld.", static_cast<long long>(offset))) {}
+};
+
 struct UnsafePublishBadIndexTimestampException : PersistenceException {
   explicit UnsafePublishBadIndexTimestampException(uint64_t expected, uint64_t found)
       : PersistenceException(current::strings::Printf(
@@ -27,13 +27,35 @@ SOFTWARE.
 // The file is replayed at startup to check its integriry and to extract the most recent index/timestamp.
 // Each iterator opens the same file again, to read its first N lines.
 // Iterators never outlive the persister.
+//
+// By default, each published entry is flushed to the file right away. A `FileFlushPolicy` can be passed
+// to the constructor to enable group commit instead, where entries are flushed in batches.
+// The entries that are not yet flushed are still visible to the iterators: they flush the file as needed.
+//
+// Optionally, with `FileIndexSidecar::Maintain`, the offsets and timestamps of the entries are also kept
+// in the `.idx` file next to the data, so that the startup does not have to replay the whole file.
+//
+// The unsafe iterators `mmap()` the byte range they cover, and expose the raw lines via `RawLogLine()`
+// as `std::string_view`-s pointing directly into the mapped file, with no per-entry copies or syscalls.
 
 #ifndef BLOCKS_PERSISTENCE_FILE_H
 #define BLOCKS_PERSISTENCE_FILE_H
 
 #include <atomic>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <thread>
+#include <vector>
+
+#include <string_view>
+
+#ifndef CURRENT_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // CURRENT_WINDOWS
 
 #ifdef CURRENT_BUILD_WITH_PARANOIC_RUNTIME_CHECKS
 #include <iostream>
@@ -54,6 +76,49 @@ SOFTWARE.
 namespace current {
 namespace persistence {
 
+// When to flush the entries appended to a `persistence::File`. Whichever limit is hit first triggers the flush.
+// The default policy flushes after each entry. A flush can also be requested explicitly via `Flush()`.
+struct FileFlushPolicy {
+  // Flush once this many entries are pending. Zero for no limit.
+  size_t max_pending_entries = 1u;
+  // Flush once this many bytes are pending. Zero for no limit.
+  size_t max_pending_bytes = 0u;
+  // Flush from a background thread once the oldest pending entry is this old. Zero for no background flushes.
+  std::chrono::microseconds max_pending_time = std::chrono::microseconds(0);
+  // Follow each flush by `fdatasync()`, so that the flushed entries survive a power loss, not just a process crash.
+  bool fdatasync = false;
+  // Have `Publish()` return only after the entry is flushed. Publishers that arrive while the flush is pending
+  // join the same batch, and all of them return once it lands.
+  bool wait_for_flush = false;
+
+  static FileFlushPolicy PerEntry() { return FileFlushPolicy(); }
+
+  static FileFlushPolicy GroupCommit(size_t max_pending_entries,
+                                     size_t max_pending_bytes,
+                                     std::chrono::microseconds max_pending_time) {
+    FileFlushPolicy policy;
+    policy.max_pending_entries = max_pending_entries;
+    policy.max_pending_bytes = max_pending_bytes;
+    policy.max_pending_time = max_pending_time;
+    return policy;
+  }
+
+  FileFlushPolicy& WithFDataSync(bool value = true) {
+    fdatasync = value;
+    return *this;
+  }
+
+  FileFlushPolicy& WithWaitForFlush(bool value = true) {
+    wait_for_flush = value;
+    return *this;
+  }
+};
+
+// Whether `persistence::File` should keep the `.idx` sidecar file of entry offsets and timestamps next to the data.
+// With the sidecar, the startup only replays the entries past the last indexed one, instead of the whole file.
+// If the sidecar is missing or does not match the file, the whole file is replayed, and the sidecar is rebuilt.
+enum class FileIndexSidecar : bool { None = false, Maintain = true };
+
 namespace impl {
 
 namespace constants {
@@ -61,10 +126,75 @@ constexpr char kDirectiveMarker = '#';
 constexpr char kSignatureDirective[] = "#signature";
 constexpr char kHeadDirective[] = "#head";
 constexpr char kHeadFormatString[] = "%020lld";
+constexpr char kIndexSidecarSuffix[] = ".idx";
+constexpr char kIndexSidecarHeader[] = "C5TIDX1\n";
 }  // namespace constants
 
 typedef int64_t head_value_t;
 
+// The index sidecar is the `kIndexSidecarHeader` followed by one fixed-width record per entry, in host byte order,
+// so that it can be read in bulk or `mmap()`-ed. The records are appended as the entries are published.
+struct IndexSidecarRecord {
+  int64_t offset;  // The offset in the file where the line of this entry begins.
+  int64_t us;      // The timestamp of this entry.
+};
+static_assert(sizeof(IndexSidecarRecord) == 16, "");
+
+// A read-only memory mapping of the `[begin, end)` byte range of a file.
+// The mapping itself starts at the page boundary, `Data()` points to the byte at `begin`.
+// Evaluates to `false` if the range could not be mapped, in which case the caller should fall back to regular reads.
+class ReadOnlyMappedFileRange final {
+ public:
+  ReadOnlyMappedFileRange(const std::string& filename, uint64_t begin, uint64_t end) {
+#ifndef CURRENT_WINDOWS
+    if (end > begin) {
+      const int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd >= 0) {
+        const uint64_t page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+        const uint64_t aligned_begin = begin - begin % page_size;
+        const size_t mapped_length = static_cast<size_t>(end - aligned_begin);
+        void* mapped = ::mmap(nullptr, mapped_length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(aligned_begin));
+        ::close(fd);  // The mapping remains valid after the descriptor is closed.
+        if (mapped != MAP_FAILED) {
+          ::madvise(mapped, mapped_length, MADV_SEQUENTIAL);
+          mapped_ = mapped;
+          mapped_length_ = mapped_length;
+          data_ = static_cast<const char*>(mapped) + (begin - aligned_begin);
+          size_ = static_cast<size_t>(end - begin);
+        }
+      }
+    }
+#else
+    static_cast<void>(filename);
+    static_cast<void>(begin);
+    static_cast<void>(end);
+#endif  // CURRENT_WINDOWS
+  }
+
+  ~ReadOnlyMappedFileRange() {
+#ifndef CURRENT_WINDOWS
+    if (mapped_) {
+      ::munmap(mapped_, mapped_length_);
+    }
+#endif  // CURRENT_WINDOWS
+  }
+
+  const char* Data() const { return data_; }
+  size_t Size() const { return size_; }
+  operator bool() const { return data_ != nullptr; }
+
+  ReadOnlyMappedFileRange(const ReadOnlyMappedFileRange&) = delete;
+  ReadOnlyMappedFileRange(ReadOnlyMappedFileRange&&) = delete;
+  ReadOnlyMappedFileRange& operator=(const ReadOnlyMappedFileRange&) = delete;
+  ReadOnlyMappedFileRange& operator=(ReadOnlyMappedFileRange&&) = delete;
+
+ private:
+  void* mapped_ = nullptr;
+  size_t mapped_length_ = 0u;
+  const char* data_ = nullptr;
+  size_t size_ = 0u;
+};
+
 // An iterator to read a file line by line, extracting tab-separated `idxts_t index` and `const char* data`.
 // Validates the entries come in the right order of 0-based indexes, and with strictly increasing timestamps.
 template <typename ENTRY>
@@ -88,7 +218,7 @@ class IteratorOverFileOfPersistedEntries {
         if (tab_pos == std::string::npos) {
           CURRENT_THROW(MalformedEntryException(line_));
         }
-        const auto current = ParseJSON<idxts_t>(line_.substr(0, tab_pos));
+        const auto current = ParseJSON<idxts_t>(std::string_view(line_).substr(0, tab_pos));
         if (current.index != next_.index) {
           // Indexes must be strictly continuous.
           CURRENT_THROW(ss::InconsistentIndexException(next_.index, current.index));
@@ -147,16 +277,48 @@ class FilePersister {
  private:
   struct FilePersisterImpl final {
     const std::string filename_;
-    std::ofstream file_appender_;
+    const FileFlushPolicy flush_policy_;
+    const FileIndexSidecar index_sidecar_;
+    mutable std::ofstream file_appender_;  // `mutable`, as flushing it is logically a const operation.
     std::fstream head_rewriter_;
 
     // `record_offset_.size() == end.next_index`,
     // and `record_offset_[i]` is the record_offset_ in bytes where the line for index `i` begins.
-    std::mutex& publish_mutex_ref_;  // Guards `record_offset_`, `head_offset_` and `record_timestamp_`.
+    std::mutex& publish_mutex_ref_;  // Guards `record_offset_`, `head_offset_`, `record_timestamp_`, and the below.
     std::vector<std::streampos> record_offset_;
     std::streampos head_offset_;
     std::vector<std::chrono::microseconds> record_timestamp_;
 
+    // The offset at which the next line will be appended, counting the bytes not yet flushed.
+    std::streampos append_offset_;
+
+    // The index sidecar, with one `IndexSidecarRecord` per entry, written out along with the file.
+    mutable std::ofstream index_appender_;
+    bool index_sidecar_needs_rewrite_ = false;
+
+    // The group commit state: what is appended but not yet written, and since when.
+    // It is `mutable` along with the below, so that the iterators can flush the file from the const context.
+    mutable size_t pending_entries_ = 0u;
+    mutable size_t pending_bytes_ = 0u;
+    std::chrono::steady_clock::time_point pending_since_;
+
+    // The entries before `written_next_index_` are handed over to the OS, and are visible to the iterators.
+    // The entries before `flushed_next_index_` are also `fdatasync()`-ed, if the policy says so.
+    // `written_next_index_` is guarded by `publish_mutex_ref_`. `flushed_next_index_` is only increased
+    // from under `flush_mutex_`, which also guards the rest of the below, so that the publishers waiting
+    // for their entries to be flushed do not hold the publish mutex, and can `fdatasync()` without it.
+    mutable uint64_t written_next_index_;
+    mutable std::atomic<uint64_t> flushed_next_index_;
+    mutable std::mutex flush_mutex_;
+    mutable std::condition_variable flush_cv_;
+    bool flush_in_progress_ = false;
+    bool flusher_terminating_ = false;
+    std::thread flusher_thread_;
+
+#ifndef CURRENT_WINDOWS
+    int fdatasync_fd_ = -1;
+#endif  // CURRENT_WINDOWS
+
     // Just `std::atomic<end_t> end_;` won't work in g++ until 5.1, ref.
     // http://stackoverflow.com/questions/29824570/segfault-in-stdatomic-load/29824840#29824840
     // std::atomic<end_t> end_;
@@ -170,8 +332,12 @@ class FilePersister {
 
     FilePersisterImpl(std::mutex& publish_mutex_ref,
                       const ss::StreamNamespaceName& namespace_name,
-                      const std::string& filename)
+                      const std::string& filename,
+                      const FileFlushPolicy& flush_policy,
+                      FileIndexSidecar index_sidecar)
         : filename_(filename),
+          flush_policy_(flush_policy),
+          index_sidecar_(index_sidecar),
           file_appender_(filename, std::ofstream::app | std::ofstream::ate),
           head_rewriter_(filename, std::ofstream::in | std::ofstream::out),
           publish_mutex_ref_(publish_mutex_ref),
@@ -180,79 +346,368 @@ class FilePersister {
       if (file_appender_.bad() || head_rewriter_.bad()) {
         CURRENT_THROW(PersistenceFileNotWritable(filename));
       }
+      append_offset_ = file_appender_.tellp();
+      written_next_index_ = end_.load().next_index;
+      flushed_next_index_ = written_next_index_;
+#ifndef CURRENT_WINDOWS
+      if (flush_policy_.fdatasync) {
+        fdatasync_fd_ = ::open(filename.c_str(), O_WRONLY | O_APPEND);
+        if (fdatasync_fd_ == -1) {
+          CURRENT_THROW(PersistenceFileNotWritable(filename));
+        }
+      }
+#endif  // CURRENT_WINDOWS
+      if (flush_policy_.max_pending_time.count() > 0) {
+        flusher_thread_ = std::thread(&FilePersisterImpl::FlusherThread, this);
+      }
+    }
+
+    ~FilePersisterImpl() {
+      if (flusher_thread_.joinable()) {
+        {
+          std::lock_guard<std::mutex> lock(flush_mutex_);
+          flusher_terminating_ = true;
+        }
+        flush_cv_.notify_all();
+        flusher_thread_.join();
+      }
+      // No one else can be publishing at this point, so it is safe to flush without locking the publish mutex.
+      FlushFromLockedSection();
+#ifndef CURRENT_WINDOWS
+      if (fdatasync_fd_ != -1) {
+        ::close(fdatasync_fd_);
+      }
+#endif  // CURRENT_WINDOWS
+    }
+
+    // Writes the line into the file buffer. Must be called from under `publish_mutex_ref_`.
+    void AppendLine(const std::string& line) {
+      file_appender_ << line << '\n';
+      append_offset_ += static_cast<std::streamoff>(line.length() + 1u);
+    }
+
+    // Writes the `idxts \t entry` line into the file buffer. Must be called from under `publish_mutex_ref_`.
+    void AppendEntryLine(const std::string& idxts_json, const std::string& entry_json) {
+      file_appender_ << idxts_json << '\t' << entry_json << '\n';
+      append_offset_ += static_cast<std::streamoff>(idxts_json.length() + 1u + entry_json.length() + 1u);
+    }
+
+    // Accounts for the just appended entry, or entries, and flushes the file if the policy says so.
+    // Must be called from under `publish_mutex_ref_`, after `end_` has been updated.
+    void EntryAppended(size_t bytes, size_t entries = 1u) {
+      if (!pending_entries_) {
+        pending_since_ = std::chrono::steady_clock::now();
+      }
+      pending_entries_ += entries;
+      pending_bytes_ += bytes;
+      if ((flush_policy_.max_pending_entries && pending_entries_ >= flush_policy_.max_pending_entries) ||
+          (flush_policy_.max_pending_bytes && pending_bytes_ >= flush_policy_.max_pending_bytes)) {
+        FlushFromLockedSection();
+      }
+    }
+
+    // Hands the appended entries over to the OS, and returns the index up to which they are written.
+    // Must be called from under `publish_mutex_ref_`.
+    uint64_t WriteFromLockedSection() const {
+      if (pending_entries_) {
+        file_appender_.flush();
+        if (index_sidecar_ == FileIndexSidecar::Maintain) {
+          // The sidecar goes after the file, so that it never points past the end of it.
+          index_appender_.flush();
+        }
+        pending_entries_ = 0u;
+        pending_bytes_ = 0u;
+        written_next_index_ = end_.load().next_index;
+      }
+      return written_next_index_;
+    }
+
+    void SyncIfNecessary() const {
+#ifndef CURRENT_WINDOWS
+      if (fdatasync_fd_ != -1) {
+#ifdef CURRENT_APPLE
+        ::fsync(fdatasync_fd_);
+#else
+        ::fdatasync(fdatasync_fd_);
+#endif  // CURRENT_APPLE
+      }
+#endif  // CURRENT_WINDOWS
+    }
+
+    void MarkFlushed(uint64_t next_index) const {
+      {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        if (flushed_next_index_ < next_index) {
+          flushed_next_index_ = next_index;
+        }
+      }
+      flush_cv_.notify_all();
+    }
+
+    // Flushes all the appended entries. Must be called from under `publish_mutex_ref_`.
+    void FlushFromLockedSection() const {
+      const uint64_t written_next_index = WriteFromLockedSection();
+      if (flushed_next_index_ < written_next_index) {
+        SyncIfNecessary();
+        MarkFlushed(written_next_index);
+      }
+    }
+
+    // Returns once the entry with the given index has been flushed, leading the flush if no one else is.
+    // While the leader is flushing without holding the publish mutex, more publishers append their entries,
+    // and then the next leader flushes them all at once. This is what makes concurrent publishers form batches.
+    template <current::locks::MutexLockStatus MLS>
+    void WaitForFlush(uint64_t index) {
+      if (flushed_next_index_ > index) {
+        return;
+      }
+      if constexpr (MLS == current::locks::MutexLockStatus::NeedToLock) {
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        if (flush_policy_.max_pending_time.count() > 0) {
+          flush_cv_.wait_for(
+              lock, flush_policy_.max_pending_time, [this, index]() { return flushed_next_index_ > index; });
+        }
+        while (flushed_next_index_ <= index) {
+          if (!flush_in_progress_) {
+            flush_in_progress_ = true;
+            lock.unlock();
+            uint64_t written_next_index;
+            {
+              std::lock_guard<std::mutex> publish_lock(publish_mutex_ref_);
+              written_next_index = WriteFromLockedSection();
+            }
+            SyncIfNecessary();
+            lock.lock();
+            flush_in_progress_ = false;
+            if (flushed_next_index_ < written_next_index) {
+              flushed_next_index_ = written_next_index;
+            }
+            flush_cv_.notify_all();
+          } else {
+            flush_cv_.wait(lock);
+          }
+        }
+      } else {
+        // The caller holds the publish mutex, so no other publisher can join the batch.
+        FlushFromLockedSection();
+      }
+    }
+
+    // Flushes the entries that have been pending for longer than `max_pending_time`.
+    void FlusherThread() {
+      auto wait = flush_policy_.max_pending_time;
+      std::unique_lock<std::mutex> lock(flush_mutex_);
+      while (!flusher_terminating_) {
+        flush_cv_.wait_for(lock, wait, [this]() { return flusher_terminating_; });
+        if (!flusher_terminating_) {
+          lock.unlock();
+          wait = flush_policy_.max_pending_time;
+          {
+            std::lock_guard<std::mutex> publish_lock(publish_mutex_ref_);
+            if (pending_entries_ || flushed_next_index_ < written_next_index_) {
+              const auto pending_for = std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - pending_since_);
+              if (pending_for >= flush_policy_.max_pending_time) {
+                FlushFromLockedSection();
+              } else {
+                wait = flush_policy_.max_pending_time - pending_for;
+              }
+            }
+          }
+          lock.lock();
+        }
+      }
     }
 
     // Replay the file but ignore its contents. Used to initialize `end_` at startup.
+    // With the index sidecar, only the tail of the file past the last indexed entry is replayed.
     void ValidateFileAndInitializeHead(const ss::StreamNamespaceName& namespace_name) {
       std::ifstream fi(filename_);
       if (!fi.bad()) {
-        // Read through all the lines.
-        // Let `IteratorOverFileOfPersistedEntries` maintain its own `next_`, which later becomes `this->end_`.
-        // While reading the file, record the offset of each record and store it in `record_offset_`.
-        IteratorOverFileOfPersistedEntries<ENTRY> cit(fi, 0, 0);
-        const std::streampos offset_zero(0);
-        auto current_offset = offset_zero;
-        auto head = std::chrono::microseconds(-1);
         reflection::StructSchema struct_schema;
         struct_schema.AddType<ENTRY>();
         const auto signature = JSON(ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo()));
-        while (cit.ProcessNextEntry(
-            [&](const idxts_t& current, const char*) {
-              CURRENT_ASSERT(current.index == record_offset_.size());
-              CURRENT_ASSERT(current.index == record_timestamp_.size());
-              if (!(current.us > head)) {
-                CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), current.us));
-              }
-              record_offset_.push_back(current_offset);
-              record_timestamp_.push_back(current.us);
-              current_offset = fi.tellg();
-              head = current.us;
-              head_offset_ = 0;
-            },
-            [&](const std::string& value) {
-              static const auto head_key_length = strlen(constants::kHeadDirective);
-              static const auto signature_key_length = strlen(constants::kSignatureDirective);
-              head_offset_ = 0;
-              if (!value.compare(0, head_key_length, constants::kHeadDirective)) {
-                auto offset = head_key_length;
-                while (std::isspace(value[offset])) {
-                  ++offset;
-                }
-                const auto us = std::chrono::microseconds(current::FromString<head_value_t>(value.c_str() + offset));
-                if (!(us > head)) {
-                  CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), us));
-                }
-                head = us;
-                head_offset_ = std::streampos(static_cast<size_t>(current_offset) + offset);
-              } else if (!value.compare(0, signature_key_length, constants::kSignatureDirective)) {
-                // The signature, if present, should be at the beginning of the file.
-                if (current_offset != offset_zero) {
-                  CURRENT_THROW(InvalidSignatureLocation());
-                }
-                auto offset = signature_key_length;
-                while (std::isspace(value[offset])) {
-                  ++offset;
-                }
-                if (value.compare(offset, signature.length(), signature)) {
-                  CURRENT_THROW(InvalidStreamSignature(signature, value.substr(offset)));
-                }
-              }
-              current_offset = fi.tellg();
-            })) {
-          ;
+        uint64_t indexed_entries = 0u;
+        std::streampos current_offset;
+        if (index_sidecar_ == FileIndexSidecar::Maintain) {
+          indexed_entries = LoadIndexSidecar(fi, signature);
+        }
+        fi.clear();
+        if (indexed_entries) {
+          // Re-validate the last indexed entry as part of the tail, as it is where `end_` and the head come from.
+          const auto last_entry_offset = record_offset_.back();
+          const auto head = record_timestamp_.size() > 1u ? record_timestamp_[record_timestamp_.size() - 2u]
+                                                          : std::chrono::microseconds(-1);
+          record_offset_.pop_back();
+          record_timestamp_.pop_back();
+          current_offset = ReplayFile(fi, last_entry_offset, indexed_entries - 1u, head, signature);
+        } else {
+          record_offset_.clear();
+          record_timestamp_.clear();
+          fi.seekg(0, std::ios_base::beg);
+          current_offset = ReplayFile(fi, 0, 0u, std::chrono::microseconds(-1), signature);
         }
-        const auto& next = cit.Next();
-        // The `next.us` stores the closest possible next entry timestamp,
-        // so the last processed entry timestamp is always 1us less.
-        end_.store({next.index, next.us - std::chrono::microseconds(1), head});
         // Append the signature if there is neither entries nor directives in the file.
         if (!current_offset) {
           file_appender_ << constants::kSignatureDirective << ' ' << signature << std::endl;
         }
+        if (index_sidecar_ == FileIndexSidecar::Maintain) {
+          OpenIndexSidecarForAppending(indexed_entries);
+        }
       } else {
         end_.store({0ull, std::chrono::microseconds(-1), std::chrono::microseconds(-1)});
       }
     }
+
+    // Read the lines starting from `offset`, which is where the entry `index` begins, or zero.
+    // Returns the offset of the end of the last processed line, and sets `end_`.
+    std::streampos ReplayFile(std::istream& fi,
+                              std::streampos offset,
+                              uint64_t index,
+                              std::chrono::microseconds head,
+                              const std::string& signature) {
+      // Read through all the lines.
+      // Let `IteratorOverFileOfPersistedEntries` maintain its own `next_`, which later becomes `this->end_`.
+      // While reading the file, record the offset of each record and store it in `record_offset_`.
+      IteratorOverFileOfPersistedEntries<ENTRY> cit(fi, offset, index);
+      const std::streampos offset_zero(0);
+      auto current_offset = offset;
+      while (cit.ProcessNextEntry(
+          [&](const idxts_t& current, const char*) {
+            CURRENT_ASSERT(current.index == record_offset_.size());
+            CURRENT_ASSERT(current.index == record_timestamp_.size());
+            if (!(current.us > head)) {
+              CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), current.us));
+            }
+            record_offset_.push_back(current_offset);
+            record_timestamp_.push_back(current.us);
+            current_offset = fi.tellg();
+            head = current.us;
+            head_offset_ = 0;
+          },
+          [&](const std::string& value) {
+            static const auto head_key_length = strlen(constants::kHeadDirective);
+            static const auto signature_key_length = strlen(constants::kSignatureDirective);
+            head_offset_ = 0;
+            if (!value.compare(0, head_key_length, constants::kHeadDirective)) {
+              auto offset = head_key_length;
+              while (std::isspace(value[offset])) {
+                ++offset;
+              }
+              const auto us = std::chrono::microseconds(current::FromString<head_value_t>(value.c_str() + offset));
+              if (!(us > head)) {
+                CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), us));
+              }
+              head = us;
+              head_offset_ = std::streampos(static_cast<size_t>(current_offset) + offset);
+            } else if (!value.compare(0, signature_key_length, constants::kSignatureDirective)) {
+              // The signature, if present, should be at the beginning of the file.
+              if (current_offset != offset_zero) {
+                CURRENT_THROW(InvalidSignatureLocation());
+              }
+              ValidateSignature(value, signature);
+            }
+            current_offset = fi.tellg();
+          })) {
+        ;
+      }
+      const auto& next = cit.Next();
+      // The `next.us` stores the closest possible next entry timestamp,
+      // so the last processed entry timestamp is always 1us less.
+      end_.store({next.index, next.us - std::chrono::microseconds(1), head});
+      return current_offset;
+    }
+
+    static void ValidateSignature(const std::string& directive, const std::string& signature) {
+      auto offset = strlen(constants::kSignatureDirective);
+      while (std::isspace(directive[offset])) {
+        ++offset;
+      }
+      if (directive.compare(offset, signature.length(), signature)) {
+        CURRENT_THROW(InvalidStreamSignature(signature, directive.substr(offset)));
+      }
+    }
+
+    // Loads the index sidecar into `record_offset_` and `record_timestamp_`, and makes sure it matches the file,
+    // by checking the first and the last indexed entries. Returns the number of entries loaded, zero if the index
+    // is missing or does not match the file. If the signature is present in the file, it is validated too.
+    uint64_t LoadIndexSidecar(std::istream& fi, const std::string& signature) {
+      std::string line;
+      if (std::getline(fi, line) &&
+          !line.compare(0, strlen(constants::kSignatureDirective), constants::kSignatureDirective)) {
+        ValidateSignature(line, signature);
+      }
+      fi.clear();
+
+      std::ifstream fidx(filename_ + constants::kIndexSidecarSuffix, std::ifstream::binary);
+      char header[sizeof(constants::kIndexSidecarHeader) - 1u];
+      if (!fidx.read(header, sizeof(header)) || memcmp(header, constants::kIndexSidecarHeader, sizeof(header))) {
+        return 0u;
+      }
+      std::vector<IndexSidecarRecord> records;
+      IndexSidecarRecord record;
+      while (fidx.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (!records.empty() && !(record.offset > records.back().offset && record.us > records.back().us)) {
+          return 0u;
+        }
+        records.push_back(record);
+      }
+      if (records.empty() || !IndexSidecarRecordMatchesFile(fi, 0u, records.front()) ||
+          !IndexSidecarRecordMatchesFile(fi, records.size() - 1u, records.back())) {
+        return 0u;
+      }
+      index_sidecar_needs_rewrite_ = (fidx.gcount() != 0);  // A partially written record in the end.
+      record_offset_.resize(records.size());
+      record_timestamp_.resize(records.size());
+      for (size_t i = 0u; i < records.size(); ++i) {
+        record_offset_[i] = static_cast<std::streamoff>(records[i].offset);
+        record_timestamp_[i] = std::chrono::microseconds(records[i].us);
+      }
+      return records.size();
+    }
+
+    static bool IndexSidecarRecordMatchesFile(std::istream& fi, uint64_t index, const IndexSidecarRecord& record) {
+      std::string line;
+      fi.clear();
+      fi.seekg(static_cast<std::streamoff>(record.offset), std::ios_base::beg);
+      if (!std::getline(fi, line)) {
+        return false;
+      }
+      const size_t tab_pos = line.find('\t');
+      if (line.empty() || line[0] == constants::kDirectiveMarker || tab_pos == std::string::npos) {
+        return false;
+      }
+      try {
+        const auto idxts = ParseJSON<idxts_t>(std::string_view(line).substr(0, tab_pos));
+        return idxts.index == index && idxts.us.count() == record.us;
+      } catch (const current::Exception&) {
+        return false;
+      }
+    }
+
+    // Brings the index sidecar in sync with the first `indexed_entries` entries, and opens it for appending.
+    void OpenIndexSidecarForAppending(uint64_t indexed_entries) {
+      const std::string index_filename = filename_ + constants::kIndexSidecarSuffix;
+      if (!indexed_entries || index_sidecar_needs_rewrite_) {
+        index_appender_.open(index_filename, std::ofstream::binary | std::ofstream::trunc);
+        index_appender_.write(constants::kIndexSidecarHeader, sizeof(constants::kIndexSidecarHeader) - 1u);
+        indexed_entries = 0u;
+      } else {
+        index_appender_.open(index_filename, std::ofstream::binary | std::ofstream::app);
+      }
+      for (size_t i = static_cast<size_t>(indexed_entries); i < record_offset_.size(); ++i) {
+        AppendIndexSidecarRecord(record_offset_[i], record_timestamp_[i]);
+      }
+      index_appender_.flush();
+      if (index_appender_.bad()) {
+        CURRENT_THROW(PersistenceFileNotWritable(index_filename));
+      }
+    }
+
+    void AppendIndexSidecarRecord(std::streampos offset, std::chrono::microseconds us) {
+      const IndexSidecarRecord record{static_cast<int64_t>(offset), static_cast<int64_t>(us.count())};
+      index_appender_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
   };
 
  public:
@@ -264,8 +719,17 @@ class FilePersister {
 
   FilePersister(std::mutex& publish_mutex_ref,
                 const ss::StreamNamespaceName& namespace_name,
-                const std::string& filename)
-      : file_persister_impl_(MakeOwned<FilePersisterImpl>(publish_mutex_ref, namespace_name, filename)) {}
+                const std::string& filename,
+                const FileFlushPolicy& flush_policy = FileFlushPolicy(),
+                FileIndexSidecar index_sidecar = FileIndexSidecar::None)
+      : file_persister_impl_(MakeOwned<FilePersisterImpl>(
+            publish_mutex_ref, namespace_name, filename, flush_policy, index_sidecar)) {}
+
+  FilePersister(std::mutex& publish_mutex_ref,
+                const ss::StreamNamespaceName& namespace_name,
+                const std::string& filename,
+                FileIndexSidecar index_sidecar)
+      : FilePersister(publish_mutex_ref, namespace_name, filename, FileFlushPolicy(), index_sidecar) {}
 
   class Iterator final {
    public:
@@ -285,6 +749,7 @@ class FilePersister {
              const std::string& filename,
              uint64_t i,
              std::streampos offset,
+             std::streampos,
              uint64_t index_at_offset)
         : file_persister_impl_(std::move(file_persister_impl)), i_(i) {
       if (!filename.empty()) {
@@ -341,43 +806,63 @@ class FilePersister {
     IteratorUnsafe& operator=(const IteratorUnsafe&) = delete;
     IteratorUnsafe& operator=(IteratorUnsafe&&) = default;
 
+    // The `[offset, end_offset)` range of the file is mapped into memory once, and then scanned line by line.
+    // If the range can not be mapped, the lines are read via `std::ifstream`, seeking to each entry.
     IteratorUnsafe(Borrowed<FilePersisterImpl> file_persister_impl,
                    const std::string& filename,
                    uint64_t i,
                    std::streampos offset,
+                   std::streampos end_offset,
                    uint64_t)
         : file_persister_impl_(std::move(file_persister_impl)), i_(i), current_offset_(offset) {
       if (!filename.empty()) {
-        fi_ = std::make_unique<std::ifstream>(filename);
-        CURRENT_ASSERT(!fi_->bad());
-        if (offset) {
-          fi_->seekg(offset, std::ios_base::beg);
+        mapped_range_ = std::make_unique<ReadOnlyMappedFileRange>(
+            filename, static_cast<uint64_t>(offset), static_cast<uint64_t>(end_offset));
+        if (!*mapped_range_) {
+          mapped_range_ = nullptr;
+          fi_ = std::make_unique<std::ifstream>(filename);
+          CURRENT_ASSERT(!fi_->bad());
+          if (offset) {
+            fi_->seekg(offset, std::ios_base::beg);
+          }
         }
       }
     }
 
     // `operator*` relies on the fact each entry will be requested at most once.
     // The range-based for-loop works fine. -- D.K.
-    std::string operator*() const {
-      if (current_entry_.empty()) {
-        const auto offset = file_persister_impl_->record_offset_[static_cast<size_t>(i_)];
-        if (offset != current_offset_) {
-          fi_->seekg(offset, std::ios_base::beg);
-          current_offset_ = offset;
-        }
-        if (std::getline(*fi_, current_entry_)) {
-          CURRENT_ASSERT(current_entry_[0] != constants::kDirectiveMarker);
+    std::string operator*() const { return std::string(RawLogLine()); }
+
+    // The zero-copy accessor. The returned view is valid until the iterator is advanced or destroyed.
+    std::string_view RawLogLine() const {
+      if (current_line_.empty()) {
+        if (mapped_range_) {
+          current_line_ = NextMappedEntryLine();
         } else {
-          // End of file. Should never happen as long as the user only iterates over valid ranges.
-          CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+          const auto offset = file_persister_impl_->record_offset_[static_cast<size_t>(i_)];
+          if (offset != current_offset_) {
+            fi_->seekg(offset, std::ios_base::beg);
+            current_offset_ = offset;
+          }
+          if (std::getline(*fi_, current_entry_)) {
+            CURRENT_ASSERT(current_entry_[0] != constants::kDirectiveMarker);
+          } else {
+            // End of file. Should never happen as long as the user only iterates over valid ranges.
+            CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+          }
+          current_line_ = current_entry_;
         }
       }
-      return current_entry_;
+      return current_line_;
     }
 
     IteratorUnsafe& operator++() {
+      if (mapped_range_ && current_line_.empty()) {
+        // Skip the entry that has not been read, as the mapped range is scanned sequentially.
+        NextMappedEntryLine();
+      }
       ++i_;
-      current_entry_.clear();
+      current_line_ = std::string_view();
       return *this;
     }
     bool operator==(const IteratorUnsafe& rhs) const { return i_ == rhs.i_; }
@@ -385,10 +870,29 @@ class FilePersister {
     operator bool() const { return file_persister_impl_; }
 
    private:
+    // Returns the next line of the mapped range that is an entry, not a directive.
+    std::string_view NextMappedEntryLine() const {
+      const char* const data = mapped_range_->Data();
+      const size_t size = mapped_range_->Size();
+      while (mapped_position_ < size) {
+        const char* begin = data + mapped_position_;
+        const char* eol = static_cast<const char*>(::memchr(begin, '\n', size - mapped_position_));
+        const size_t length = eol ? static_cast<size_t>(eol - begin) : size - mapped_position_;
+        mapped_position_ += length + 1u;
+        if (length && *begin != constants::kDirectiveMarker) {
+          return std::string_view(begin, length);
+        }
+      }
+      // End of range. Should never happen as long as the user only iterates over valid ranges.
+      CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+    }
+
     Borrowed<FilePersisterImpl> file_persister_impl_;
-    bool valid_ = true;
+    std::unique_ptr<ReadOnlyMappedFileRange> mapped_range_;
     std::unique_ptr<std::ifstream> fi_;
     uint64_t i_;
+    mutable size_t mapped_position_ = 0u;
+    mutable std::string_view current_line_;
     mutable std::string current_entry_;
     mutable std::streampos current_offset_;
   };
@@ -399,30 +903,37 @@ class FilePersister {
     IterableRangeImpl(Borrowed<FilePersisterImpl> file_persister_impl,
                       uint64_t begin,
                       uint64_t end,
-                      std::streampos begin_offset)
-        : file_persister_impl_(std::move(file_persister_impl)), begin_(begin), end_(end), begin_offset_(begin_offset) {}
+                      std::streampos begin_offset,
+                      std::streampos end_offset)
+        : file_persister_impl_(std::move(file_persister_impl)),
+          begin_(begin),
+          end_(end),
+          begin_offset_(begin_offset),
+          end_offset_(end_offset) {}
 
     IterableRangeImpl(IterableRangeImpl&& rhs)
         : file_persister_impl_(std::move(rhs.file_persister_impl_)),
           begin_(rhs.begin_),
           end_(rhs.end_),
-          begin_offset_(rhs.begin_offset_) {}
+          begin_offset_(rhs.begin_offset_),
+          end_offset_(rhs.end_offset_) {}
 
     ITERATOR begin() const {
       // By convention, iterating over data, being an immutable operation, does not throw.
       if (begin_ == end_) {
-        return ITERATOR(file_persister_impl_, "", 0, 0, 0);  // No need in accessing the file for a null iterator.
+        return ITERATOR(file_persister_impl_, "", 0, 0, 0, 0);  // No need in accessing the file for a null iterator.
       } else {
-        return ITERATOR(file_persister_impl_, file_persister_impl_->filename_, begin_, begin_offset_, begin_);
+        return ITERATOR(
+            file_persister_impl_, file_persister_impl_->filename_, begin_, begin_offset_, end_offset_, begin_);
       }
     }
     ITERATOR end() const {
       // By convention, iterating over data, being an immutable operation, does not throw.
       if (begin_ == end_) {
-        return ITERATOR(file_persister_impl_, "", 0, 0, 0);  // No need in accessing the file for a null iterator.
+        return ITERATOR(file_persister_impl_, "", 0, 0, 0, 0);  // No need in accessing the file for a null iterator.
       } else {
         return ITERATOR(
-            file_persister_impl_, "", end_, 0, 0);  // No need in accessing the file for a no-op `end` iterator.
+            file_persister_impl_, "", end_, 0, 0, 0);  // No need in accessing the file for a no-op `end` iterator.
       }
     }
 
@@ -433,73 +944,103 @@ class FilePersister {
     const uint64_t begin_;
     const uint64_t end_;
     const std::streampos begin_offset_;
+    const std::streampos end_offset_;
   };
 
   // `TIMESTAMP` can be `std::chrono::microseconds` or `current::time::DefaultTimeArgument`.
   template <current::locks::MutexLockStatus MLS, typename E, typename TIMESTAMP>
   idxts_t PersisterPublishImpl(E&& entry, const TIMESTAMP provided_timestamp) {
-    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+    idxts_t idxts;
+    {
+      current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
 
-    end_t iterator = file_persister_impl_->end_.load();
-    const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
-    if (!(timestamp > iterator.head)) {
+      end_t iterator = file_persister_impl_->end_.load();
+      const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
+      if (!(timestamp > iterator.head)) {
 #ifdef CURRENT_BUILD_WITH_PARANOIC_RUNTIME_CHECKS
-      std::cerr << "timestamp: " << timestamp.count() << ", iterator.head: " << iterator.head.count() << std::endl;
+        std::cerr << "timestamp: " << timestamp.count() << ", iterator.head: " << iterator.head.count() << std::endl;
 #endif  // CURRENT_BUILD_WITH_PARANOIC_RUNTIME_CHECKS
-      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
-    }
+        CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+      }
 
-    iterator.last_entry_us = iterator.head = timestamp;
-    const auto idxts = idxts_t(iterator.next_index, iterator.last_entry_us);
-    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() == iterator.next_index);
-    CURRENT_ASSERT(file_persister_impl_->record_timestamp_.size() == iterator.next_index);
-    file_persister_impl_->record_offset_.push_back(file_persister_impl_->file_appender_.tellp());
-    file_persister_impl_->record_timestamp_.push_back(timestamp);
+      iterator.last_entry_us = iterator.head = timestamp;
+      idxts = idxts_t(iterator.next_index, iterator.last_entry_us);
+      CURRENT_ASSERT(file_persister_impl_->record_offset_.size() == iterator.next_index);
+      CURRENT_ASSERT(file_persister_impl_->record_timestamp_.size() == iterator.next_index);
+      const auto offset = file_persister_impl_->append_offset_;
+      file_persister_impl_->record_offset_.push_back(offset);
+      file_persister_impl_->record_timestamp_.push_back(timestamp);
+
+      // Explicit `MakeSureTheRightTypeIsSerialized` is essential, otherwise the `Variant`'s case
+      // would be serialized in an unwrapped way when passed directly.
+      file_persister_impl_->AppendEntryLine(
+          JSON(idxts), JSON(MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<E>>::DoIt(std::forward<E>(entry))));
+      if (file_persister_impl_->index_sidecar_ == FileIndexSidecar::Maintain) {
+        file_persister_impl_->AppendIndexSidecarRecord(offset, timestamp);
+      }
+      ++iterator.next_index;
+      file_persister_impl_->head_offset_ = 0;
+      file_persister_impl_->end_.store(iterator);
+      file_persister_impl_->EntryAppended(static_cast<size_t>(file_persister_impl_->append_offset_ - offset));
+    }
 
-    // Explicit `MakeSureTheRightTypeIsSerialized` is essential, otherwise the `Variant`'s case
-    // would be serialized in an unwrapped way when passed directly.
-    file_persister_impl_->file_appender_ << JSON(idxts) << '\t'
-                                         << JSON(MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<E>>::DoIt(
-                                                std::forward<E>(entry)))
-                                         << std::endl;
-    ++iterator.next_index;
-    file_persister_impl_->head_offset_ = 0;
-    file_persister_impl_->end_.store(iterator);
+    if (file_persister_impl_->flush_policy_.wait_for_flush) {
+      file_persister_impl_->template WaitForFlush<MLS>(idxts.index);
+    }
 
     return idxts;
   }
 
   template <current::locks::MutexLockStatus MLS>
   idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
-    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
-
-    end_t iterator = file_persister_impl_->end_.load();
-    const auto tab_pos = raw_log_line.find('\t');
-    if (tab_pos == std::string::npos) {
-      CURRENT_THROW(MalformedEntryException(raw_log_line));
-    }
-    const idxts_t idxts = ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos));
-    if (idxts.index != iterator.next_index) {
-      CURRENT_THROW(UnsafePublishBadIndexTimestampException(iterator.next_index, idxts.index));
+    idxts_t idxts;
+    {
+      current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+      idxts = AppendRawLogLine(raw_log_line);
+      file_persister_impl_->EntryAppended(raw_log_line.length() + 1u);
     }
-    if (!(idxts.us > iterator.head)) {
-      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), idxts.us));
+
+    if (file_persister_impl_->flush_policy_.wait_for_flush) {
+      file_persister_impl_->template WaitForFlush<MLS>(idxts.index);
     }
 
-    iterator.last_entry_us = iterator.head = idxts.us;
-    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() == idxts.index);
-    CURRENT_ASSERT(file_persister_impl_->record_timestamp_.size() == idxts.index);
-    file_persister_impl_->record_offset_.push_back(file_persister_impl_->file_appender_.tellp());
-    file_persister_impl_->record_timestamp_.push_back(idxts.us);
+    return idxts;
+  }
 
-    file_persister_impl_->file_appender_ << raw_log_line << std::endl;
-    ++iterator.next_index;
-    file_persister_impl_->head_offset_ = 0;
-    file_persister_impl_->end_.store(iterator);
+  // Appends the raw log lines under a single lock, as a single group commit: the flush policy is applied,
+  // and waited for, once per batch. Returns the index and timestamp of the last line.
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterPublishUnsafeBatchImpl(const std::vector<std::string>& raw_log_lines) {
+    idxts_t idxts;
+    {
+      current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+      size_t bytes = 0u;
+      size_t entries = 0u;
+      try {
+        for (const auto& raw_log_line : raw_log_lines) {
+          idxts = AppendRawLogLine(raw_log_line);
+          bytes += raw_log_line.length() + 1u;
+          ++entries;
+        }
+      } catch (const current::Exception&) {
+        if (entries) {
+          file_persister_impl_->EntryAppended(bytes, entries);
+        }
+        throw;
+      }
+      if (entries) {
+        file_persister_impl_->EntryAppended(bytes, entries);
+      }
+    }
+
+    if (!raw_log_lines.empty() && file_persister_impl_->flush_policy_.wait_for_flush) {
+      file_persister_impl_->template WaitForFlush<MLS>(idxts.index);
+    }
 
     return idxts;
   }
 
+  // Updating the head always flushes the file, as the `#head` directive is rewritten in place.
   template <current::locks::MutexLockStatus MLS, typename TIMESTAMP>
   void PersisterUpdateHeadImpl(const TIMESTAMP provided_timestamp) {
     current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
@@ -516,14 +1057,23 @@ class FilePersister {
       rewriter.seekp(file_persister_impl_->head_offset_, std::ios_base::beg);
       rewriter << head_str << std::endl;
     } else {
-      auto& file_appender_ = file_persister_impl_->file_appender_;
-      file_appender_ << constants::kHeadDirective << ' ';
-      file_persister_impl_->head_offset_ = file_appender_.tellp();
-      file_appender_ << head_str << std::endl;
+      const std::string head_directive = std::string(constants::kHeadDirective) + ' ';
+      file_persister_impl_->head_offset_ =
+          file_persister_impl_->append_offset_ + static_cast<std::streamoff>(head_directive.length());
+      file_persister_impl_->AppendLine(head_directive + head_str);
+      file_persister_impl_->file_appender_.flush();
+      file_persister_impl_->FlushFromLockedSection();
     }
     file_persister_impl_->end_.store(iterator);
   }
 
+  // Flushes the entries published so far, regardless of the flush policy.
+  template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
+  void Flush() const {
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+    file_persister_impl_->FlushFromLockedSection();
+  }
+
   template <current::locks::MutexLockStatus MLS>
   bool PersisterEmptyImpl() const {
     return !file_persister_impl_->end_.load().next_index;
@@ -609,6 +1159,37 @@ class FilePersister {
   }
 
  private:
+  // Must be called from under `publish_mutex_ref_`, followed by `EntryAppended()`.
+  idxts_t AppendRawLogLine(const std::string& raw_log_line) {
+    end_t iterator = file_persister_impl_->end_.load();
+    const auto tab_pos = raw_log_line.find('\t');
+    if (tab_pos == std::string::npos) {
+      CURRENT_THROW(MalformedEntryException(raw_log_line));
+    }
+    const auto idxts = ParseJSON<idxts_t>(std::string_view(raw_log_line).substr(0, tab_pos));
+    if (idxts.index != iterator.next_index) {
+      CURRENT_THROW(UnsafePublishBadIndexTimestampException(iterator.next_index, idxts.index));
+    }
+    if (!(idxts.us > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), idxts.us));
+    }
+
+    iterator.last_entry_us = iterator.head = idxts.us;
+    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() == idxts.index);
+    CURRENT_ASSERT(file_persister_impl_->record_timestamp_.size() == idxts.index);
+    file_persister_impl_->record_offset_.push_back(file_persister_impl_->append_offset_);
+    file_persister_impl_->record_timestamp_.push_back(idxts.us);
+    if (file_persister_impl_->index_sidecar_ == FileIndexSidecar::Maintain) {
+      file_persister_impl_->AppendIndexSidecarRecord(file_persister_impl_->append_offset_, idxts.us);
+    }
+
+    file_persister_impl_->AppendLine(raw_log_line);
+    ++iterator.next_index;
+    file_persister_impl_->head_offset_ = 0;
+    file_persister_impl_->end_.store(iterator);
+    return idxts;
+  }
+
   template <current::locks::MutexLockStatus MLS, typename ITERABLE>
   ITERABLE PersisterIterateImpl(uint64_t begin_index, uint64_t end_index) const {
     // OK to only lock the mutex later, as `file_persister_impl_->end_` is an `atomic`.
@@ -620,7 +1201,8 @@ class FilePersister {
       CURRENT_THROW(InvalidIterableRangeException());
     }
     if (begin_index == end_index) {
-      return ITERABLE(file_persister_impl_, 0, 0, 0);  // OK, even for an empty persister, where 0 is an invalid index.
+      // OK, even for an empty persister, where 0 is an invalid index.
+      return ITERABLE(file_persister_impl_, 0, 0, 0, 0);
     }
     if (end_index < begin_index) {
       CURRENT_THROW(InvalidIterableRangeException());
@@ -631,10 +1213,22 @@ class FilePersister {
     // ">" is OK, as this call is multithreading-friendly, and more entries could have been added during this call.
     CURRENT_ASSERT(file_persister_impl_->record_offset_.size() >= current_size);
 
+    // The iterators read the file directly, so the entries pending the group commit should be written first.
+    if (file_persister_impl_->written_next_index_ < end_index) {
+      file_persister_impl_->WriteFromLockedSection();
+    }
+
+    // The range ends where the next entry begins, or, for the most recent entry, where the next one will be appended.
+    // The latter is safe, as the head directives, which could be pending the flush, are always flushed right away.
+    const std::streampos end_offset = end_index < file_persister_impl_->record_offset_.size()
+                                          ? file_persister_impl_->record_offset_[static_cast<size_t>(end_index)]
+                                          : std::streampos(file_persister_impl_->append_offset_);
+
     return ITERABLE(file_persister_impl_,
                     static_cast<size_t>(begin_index),
                     static_cast<size_t>(end_index),
-                    file_persister_impl_->record_offset_[static_cast<size_t>(begin_index)]);
+                    file_persister_impl_->record_offset_[static_cast<size_t>(begin_index)],
+                    end_offset);
   }
 
   template <current::locks::MutexLockStatus MLS, typename ITERABLE>
@@ -647,7 +1241,7 @@ class FilePersister {
     if (index_range.first != static_cast<uint64_t>(-1)) {
       return PersisterIterateImpl<MLS, ITERABLE>(index_range.first, index_range.second);
     } else {  // No entries found in the requested range.
-      return ITERABLE(file_persister_impl_, 0, 0, 0);
+      return ITERABLE(file_persister_impl_, 0, 0, 0, 0);
     }
   }
 
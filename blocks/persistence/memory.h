@@ -40,6 +40,7 @@ SOFTWARE.
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 #include "exceptions.h"
 
@@ -119,6 +120,11 @@ class MemoryPersister {
       const auto& entry = container_->entries_[static_cast<size_t>(i_)];
       return JSON(idxts_t(i_, entry.first)) + '\t' + JSON(entry.second);
     }
+    // Same interface as the file persister's zero-copy accessor. There is no file here, so the line is built.
+    std::string_view RawLogLine() const {
+      current_line_ = operator*();
+      return current_line_;
+    }
     IteratorUnsafe& operator++() {
       ++i_;
       return *this;
@@ -130,6 +136,7 @@ class MemoryPersister {
    private:
     mutable Borrowed<Container> container_;
     uint64_t i_;
+    mutable std::string current_line_;
   };
 
   template <class ITERATOR>
@@ -169,23 +176,18 @@ class MemoryPersister {
   template <current::locks::MutexLockStatus MLS>
   idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
     current::locks::SmartMutexLockGuard<MLS> lock(container_->memory_persister_container_mutex_);
-    const auto head = container_->head_;
-    const auto tab_pos = raw_log_line.find('\t');
-    if (tab_pos == std::string::npos) {
-      CURRENT_THROW(MalformedEntryException(raw_log_line));
-    }
-    const auto idxts = ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos));
-    const auto expected_index = static_cast<uint64_t>(container_->entries_.size());
-    if (idxts.index != expected_index) {
-      CURRENT_THROW(UnsafePublishBadIndexTimestampException(expected_index, idxts.index));
-    }
-    if (!(idxts.us > head)) {
-      CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), idxts.us));
+    return AppendRawLogLine(raw_log_line);
+  }
+
+  // Appends the raw log lines under a single lock, returns the index and timestamp of the last one.
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterPublishUnsafeBatchImpl(const std::vector<std::string>& raw_log_lines) {
+    current::locks::SmartMutexLockGuard<MLS> lock(container_->memory_persister_container_mutex_);
+    idxts_t result;
+    for (const auto& raw_log_line : raw_log_lines) {
+      result = AppendRawLogLine(raw_log_line);
     }
-    container_->entries_.emplace_back(idxts.us, ParseJSON<ENTRY>(raw_log_line.substr(tab_pos + 1)));
-    container_->head_ = idxts.us;
-    CURRENT_ASSERT(container_->head_ >= container_->entries_.back().first);
-    return idxts;
+    return result;
   }
 
   template <current::locks::MutexLockStatus MLS, typename TIMESTAMP>
@@ -290,6 +292,27 @@ class MemoryPersister {
   }
 
  private:
+  // Must be called from under `memory_persister_container_mutex_`.
+  idxts_t AppendRawLogLine(const std::string& raw_log_line) {
+    const auto head = container_->head_;
+    const auto tab_pos = raw_log_line.find('\t');
+    if (tab_pos == std::string::npos) {
+      CURRENT_THROW(MalformedEntryException(raw_log_line));
+    }
+    const auto idxts = ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos));
+    const auto expected_index = static_cast<uint64_t>(container_->entries_.size());
+    if (idxts.index != expected_index) {
+      CURRENT_THROW(UnsafePublishBadIndexTimestampException(expected_index, idxts.index));
+    }
+    if (!(idxts.us > head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), idxts.us));
+    }
+    container_->entries_.emplace_back(idxts.us, ParseJSON<ENTRY>(raw_log_line.substr(tab_pos + 1)));
+    container_->head_ = idxts.us;
+    CURRENT_ASSERT(container_->head_ >= container_->entries_.back().first);
+    return idxts;
+  }
+
   template <current::locks::MutexLockStatus MLS, typename ITERABLE>
   ITERABLE PersisterIterateImpl(uint64_t begin, uint64_t end) const {
     const uint64_t size = [this]() {
@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include "memory.h"
 #include "file.h"
+#include "binary_file.h"
 
 #include "../ss/ss.h"
 
@@ -814,6 +815,366 @@ TEST(PersistenceLayer, FileSafeVsUnsafeIterators) {
   }
 }
 
+TEST(PersistenceLayer, FileUnsafeIteratorRawLogLine) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::File<StorableString>;
+  using current::persistence::FileFlushPolicy;
+  using us_t = std::chrono::microseconds;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  std::mutex file_mutex;
+  std::mutex memory_mutex;
+  // Keep some entries pending the group commit, to confirm the mapped range covers them too.
+  IMPL impl(file_mutex, namespace_name, persistence_file_name, FileFlushPolicy::GroupCommit(100u, 0u, us_t(0)));
+  current::persistence::Memory<StorableString> golden(memory_mutex, namespace_name);
+
+  // Enough entries for the file to span multiple pages, with the head directives in between.
+  const size_t n = 1000u;
+  for (size_t i = 0u; i < n; ++i) {
+    const auto entry = StorableString(Printf("entry_%04d", static_cast<int>(i)));
+    impl.Publish(entry, us_t(100 + i * 10));
+    golden.Publish(entry, us_t(100 + i * 10));
+    if (i % 7 == 0) {
+      impl.UpdateHead(us_t(100 + i * 10 + 5));
+    }
+  }
+
+  {
+    size_t index = 0u;
+    auto range = impl.IterateUnsafe();
+    auto golden_range = golden.IterateUnsafe();
+    auto golden_it = golden_range.begin();
+    for (auto it = range.begin(); it != range.end(); ++it, ++golden_it) {
+      const std::string_view raw_log_line = it.RawLogLine();
+      EXPECT_EQ(*golden_it, std::string(raw_log_line));
+      EXPECT_EQ(golden_it.RawLogLine(), raw_log_line);
+      EXPECT_EQ(raw_log_line.data(), it.RawLogLine().data()) << "The view should be stable until the iterator moves.";
+      EXPECT_EQ(*it, std::string(raw_log_line));
+      ++index;
+    }
+    EXPECT_EQ(n, index);
+  }
+
+  {
+    // The ranges starting and ending mid-page, with entries skipped without being read.
+    for (uint64_t begin : {1u, 333u, 998u}) {
+      for (uint64_t end : {begin + 1u, std::min(begin + 100u, static_cast<uint64_t>(n))}) {
+        auto range = impl.IterateUnsafe(begin, end);
+        auto it = range.begin();
+        EXPECT_EQ(Printf("{\"index\":%d,\"us\":%d}\t{\"s\":\"entry_%04d\"}",
+                         static_cast<int>(begin),
+                         static_cast<int>(100 + begin * 10),
+                         static_cast<int>(begin)),
+                  std::string(it.RawLogLine()));
+        if (end > begin + 2u) {
+          ++it;
+          ++it;
+          EXPECT_EQ(Printf("{\"index\":%d,\"us\":%d}\t{\"s\":\"entry_%04d\"}",
+                           static_cast<int>(begin + 2u),
+                           static_cast<int>(100 + (begin + 2u) * 10),
+                           static_cast<int>(begin + 2u)),
+                    std::string(it.RawLogLine()));
+        }
+      }
+    }
+  }
+}
+
+TEST(PersistenceLayer, FileGroupCommit) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::File<StorableString>;
+  using current::persistence::FileFlushPolicy;
+  using us_t = std::chrono::microseconds;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  current::reflection::StructSchema struct_schema;
+  struct_schema.AddType<StorableString>();
+  const std::string signature =
+      "#signature " + JSON(current::ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo())) + '\n';
+
+  const auto lines_in_file = [&persistence_file_name]() {
+    const std::string contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+    return static_cast<size_t>(std::count(contents.begin(), contents.end(), '\n'));
+  };
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, FileFlushPolicy::GroupCommit(3u, 0u, us_t(0)));
+
+    impl.Publish(StorableString("one"), us_t(100));
+    impl.Publish(StorableString("two"), us_t(200));
+    EXPECT_EQ(2u, impl.Size());
+    EXPECT_EQ(signature, current::FileSystem::ReadFileAsString(persistence_file_name));
+
+    // The third entry triggers the flush.
+    impl.Publish(StorableString("three"), us_t(300));
+    EXPECT_EQ(signature +
+                  "{\"index\":0,\"us\":100}\t{\"s\":\"one\"}\n"
+                  "{\"index\":1,\"us\":200}\t{\"s\":\"two\"}\n"
+                  "{\"index\":2,\"us\":300}\t{\"s\":\"three\"}\n",
+              current::FileSystem::ReadFileAsString(persistence_file_name));
+
+    // The explicit flush.
+    impl.Publish(StorableString("four"), us_t(400));
+    EXPECT_EQ(4u, lines_in_file());
+    impl.Flush();
+    EXPECT_EQ(5u, lines_in_file());
+
+    // The pending entries are visible to the iterators.
+    impl.Publish(StorableString("five"), us_t(500));
+    impl.PublishUnsafe("{\"index\":5,\"us\":600}\t{\"s\":\"six\"}");
+    EXPECT_EQ(5u, lines_in_file());
+    {
+      std::vector<std::string> all;
+      for (const auto& e : impl.Iterate()) {
+        all.push_back(e.entry.s);
+      }
+      EXPECT_EQ("one,two,three,four,five,six", Join(all, ','));
+      std::vector<std::string> last_two_unsafe;
+      for (const auto& e : impl.IterateUnsafe(4)) {
+        last_two_unsafe.push_back(e);
+      }
+      EXPECT_EQ(
+          "{\"index\":4,\"us\":500}\t{\"s\":\"five\"},"
+          "{\"index\":5,\"us\":600}\t{\"s\":\"six\"}",
+          Join(last_two_unsafe, ','));
+    }
+
+    // Updating the head flushes the pending entries.
+    impl.Publish(StorableString("seven"), us_t(700));
+    impl.UpdateHead(us_t(800));
+    impl.UpdateHead(us_t(900));
+    EXPECT_EQ(signature +
+                  "{\"index\":0,\"us\":100}\t{\"s\":\"one\"}\n"
+                  "{\"index\":1,\"us\":200}\t{\"s\":\"two\"}\n"
+                  "{\"index\":2,\"us\":300}\t{\"s\":\"three\"}\n"
+                  "{\"index\":3,\"us\":400}\t{\"s\":\"four\"}\n"
+                  "{\"index\":4,\"us\":500}\t{\"s\":\"five\"}\n"
+                  "{\"index\":5,\"us\":600}\t{\"s\":\"six\"}\n"
+                  "{\"index\":6,\"us\":700}\t{\"s\":\"seven\"}\n"
+                  "#head 00000000000000000900\n",
+              current::FileSystem::ReadFileAsString(persistence_file_name));
+
+    // The pending entries are flushed when the persister is destructed.
+    impl.Publish(StorableString("eight"), us_t(1000));
+  }
+
+  {
+    // The byte budget, and the replay of the file written in the group commit mode.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, FileFlushPolicy::GroupCommit(0u, 60u, us_t(0)));
+    EXPECT_EQ(8u, impl.Size());
+    EXPECT_EQ(1000, impl.CurrentHead().count());
+    EXPECT_EQ(10u, lines_in_file());
+    impl.Publish(StorableString("nine"), us_t(1100));
+    EXPECT_EQ(10u, lines_in_file());
+    impl.Publish(StorableString("ten"), us_t(1200));
+    EXPECT_EQ(12u, lines_in_file());
+  }
+
+  {
+    // The time window.
+    std::mutex mutex;
+    IMPL impl(mutex,
+              namespace_name,
+              persistence_file_name,
+              FileFlushPolicy::GroupCommit(0u, 0u, std::chrono::milliseconds(1)));
+    EXPECT_EQ(10u, impl.Size());
+    impl.Publish(StorableString("eleven"), us_t(1300));
+    while (lines_in_file() != 13u) {
+      std::this_thread::yield();
+    }
+  }
+
+  {
+    // Concurrent publishers waiting for their entries to be flushed.
+    std::mutex mutex;
+    IMPL impl(mutex,
+              namespace_name,
+              persistence_file_name,
+              FileFlushPolicy::GroupCommit(0u, 0u, std::chrono::milliseconds(1)).WithFDataSync().WithWaitForFlush());
+    EXPECT_EQ(11u, impl.Size());
+    current::time::SetNow(us_t(2000), us_t(3000));
+    std::vector<std::thread> threads;
+    for (size_t t = 0u; t < 10u; ++t) {
+      threads.emplace_back([&impl, &persistence_file_name]() {
+        for (size_t i = 0u; i < 10u; ++i) {
+          const auto idxts = impl.Publish(StorableString("concurrent"));
+          EXPECT_TRUE(current::FileSystem::ReadFileAsString(persistence_file_name).find(JSON(idxts)) !=
+                      std::string::npos);
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    EXPECT_EQ(111u, impl.Size());
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(111u, impl.Size());
+  }
+}
+
+TEST(PersistenceLayer, FileIndexSidecar) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::File<StorableString>;
+  using current::persistence::FileIndexSidecar;
+  using us_t = std::chrono::microseconds;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const std::string index_file_name = persistence_file_name + ".idx";
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+  const auto index_file_remover = current::FileSystem::ScopedRmFile(index_file_name);
+
+  const auto all_entries = [](const IMPL& impl) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.Iterate()) {
+      result.push_back(Printf("%s %d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(result, ',');
+  };
+  const size_t header_size = 8u;
+  const size_t record_size = sizeof(current::persistence::impl::IndexSidecarRecord);
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+    impl.Publish(StorableString("one"), us_t(100));
+    impl.Publish(StorableString("two"), us_t(200));
+    impl.UpdateHead(us_t(250));
+    impl.Publish(StorableString("three"), us_t(300));
+    impl.UpdateHead(us_t(350));
+    impl.UpdateHead(us_t(400));
+    EXPECT_EQ(header_size + record_size * 3u, current::FileSystem::GetFileSize(index_file_name));
+  }
+
+  {
+    // Restart with the index.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(400, impl.CurrentHead().count());
+    EXPECT_EQ(300, impl.LastPublishedIndexAndTimestamp().us.count());
+    EXPECT_EQ("one 100,two 200,three 300", all_entries(impl));
+    EXPECT_EQ(2u, impl.IndexRangeByTimestampRange(us_t(300)).first);
+    // The head is rewritten in place, as the offset of the `#head` directive is restored too.
+    impl.UpdateHead(us_t(450));
+    impl.Publish(StorableString("four"), us_t(500));
+  }
+
+  {
+    // Publish without the index, so that the index lags behind the file.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(4u, impl.Size());
+    impl.Publish(StorableString("five"), us_t(600));
+    impl.UpdateHead(us_t(700));
+    EXPECT_EQ(header_size + record_size * 4u, current::FileSystem::GetFileSize(index_file_name));
+  }
+
+  {
+    // Only the tail past the last indexed entry is replayed, and the index catches up.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+    EXPECT_EQ(5u, impl.Size());
+    EXPECT_EQ(700, impl.CurrentHead().count());
+    EXPECT_EQ(header_size + record_size * 5u, current::FileSystem::GetFileSize(index_file_name));
+    EXPECT_EQ("one 100,two 200,three 300,four 500,five 600", all_entries(impl));
+  }
+
+  const std::string golden_file_contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+  const std::string golden_index_contents = current::FileSystem::ReadFileAsString(index_file_name);
+
+  {
+    // Prove the entries before the last indexed one are not replayed: corrupt the index of the second one,
+    // which makes the full replay fail.
+    std::string contents = golden_file_contents;
+    const size_t pos = contents.find("{\"index\":1,");
+    ASSERT_NE(std::string::npos, pos);
+    contents[pos + 9] = '7';
+    current::FileSystem::WriteStringToFile(contents, persistence_file_name.c_str());
+    {
+      std::mutex mutex;
+      ASSERT_THROW(IMPL(mutex, namespace_name, persistence_file_name), current::ss::InconsistentIndexException);
+    }
+    {
+      std::mutex mutex;
+      IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+      EXPECT_EQ(5u, impl.Size());
+    }
+    current::FileSystem::WriteStringToFile(golden_file_contents, persistence_file_name.c_str());
+  }
+
+  {
+    // A partially written last record is dropped, and the index is rebuilt.
+    current::FileSystem::WriteStringToFile(golden_index_contents.substr(0u, golden_index_contents.length() - 5u),
+                                           index_file_name.c_str());
+    {
+      std::mutex mutex;
+      IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+      EXPECT_EQ(5u, impl.Size());
+      EXPECT_EQ("one 100,two 200,three 300,four 500,five 600", all_entries(impl));
+    }
+    EXPECT_EQ(golden_index_contents, current::FileSystem::ReadFileAsString(index_file_name));
+  }
+
+  {
+    // An index that does not match the file is ignored, and the index is rebuilt.
+    std::string index_contents = golden_index_contents;
+    index_contents[index_contents.length() - record_size] ^= 1;
+    current::FileSystem::WriteStringToFile(index_contents, index_file_name.c_str());
+    {
+      std::mutex mutex;
+      IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+      EXPECT_EQ(5u, impl.Size());
+      EXPECT_EQ("one 100,two 200,three 300,four 500,five 600", all_entries(impl));
+    }
+    EXPECT_EQ(golden_index_contents, current::FileSystem::ReadFileAsString(index_file_name));
+  }
+
+  {
+    // A missing index is rebuilt.
+    current::FileSystem::RmFile(index_file_name);
+    {
+      std::mutex mutex;
+      IMPL impl(mutex, namespace_name, persistence_file_name, FileIndexSidecar::Maintain);
+      EXPECT_EQ(5u, impl.Size());
+    }
+    EXPECT_EQ(golden_index_contents, current::FileSystem::ReadFileAsString(index_file_name));
+  }
+
+  {
+    // The signature is still validated.
+    std::mutex mutex;
+    ASSERT_THROW(IMPL(mutex,
+                      current::ss::StreamNamespaceName("another_namespace", "entry_name"),
+                      persistence_file_name,
+                      FileIndexSidecar::Maintain),
+                 current::persistence::InvalidStreamSignature);
+  }
+
+  EXPECT_EQ(golden_file_contents, current::FileSystem::ReadFileAsString(persistence_file_name));
+}
+
 namespace persistence_test {
 
 inline StorableString LargeTestStorableString(int index) {
@@ -889,6 +1250,301 @@ void IteratorPerformanceTest(IMPL& impl, bool publish = true) {
 
 }  // namespace persistence_test
 
+TEST(PersistenceLayer, BinaryFile) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::BinaryFile<StorableString>;
+  using us_t = std::chrono::microseconds;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  const auto GetAll = [](const IMPL& impl) -> std::string {
+    std::vector<std::string> all;
+    for (const auto& e : impl.Iterate()) {
+      all.push_back(Printf(
+          "%s %d %d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.index), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(all, ",");
+  };
+  const auto GetAllUnsafe = [](const IMPL& impl) -> std::string {
+    std::vector<std::string> all;
+    for (const auto& e : impl.IterateUnsafe()) {
+      all.push_back(e);
+    }
+    return Join(all, ",");
+  };
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(0u, impl.Size());
+    current::time::SetNow(us_t(100));
+    impl.Publish(StorableString("foo"));
+    current::time::SetNow(us_t(200));
+    impl.Publish(StorableString("bar"));
+    current::time::SetNow(us_t(300));
+    impl.UpdateHead();
+    current::time::SetNow(us_t(500));
+    impl.Publish(StorableString("meh"));
+    current::time::SetNow(us_t(550));
+    impl.UpdateHead();
+    current::time::SetNow(us_t(600));
+    impl.UpdateHead();
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(600, impl.CurrentHead().count());
+    EXPECT_EQ("foo 0 100,bar 1 200,meh 2 500", GetAll(impl));
+    EXPECT_EQ(
+        "{\"index\":0,\"us\":100}\t{\"s\":\"foo\"},"
+        "{\"index\":1,\"us\":200}\t{\"s\":\"bar\"},"
+        "{\"index\":2,\"us\":500}\t{\"s\":\"meh\"}",
+        GetAllUnsafe(impl));
+    EXPECT_EQ("bar 1 200,meh 2 500", [&]() {
+      std::vector<std::string> result;
+      for (const auto& e : impl.Iterate(us_t(150))) {
+        result.push_back(Printf("%s %d %d",
+                                e.entry.s.c_str(),
+                                static_cast<int>(e.idx_ts.index),
+                                static_cast<int>(e.idx_ts.us.count())));
+      }
+      return Join(result, ",");
+    }());
+  }
+
+  {
+    // The file is the header, the signature, three entries and two head records, the second one rewritten in place.
+    const std::string contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+    current::reflection::StructSchema struct_schema;
+    struct_schema.AddType<StorableString>();
+    const std::string signature =
+        JSON(current::ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo()));
+    const size_t header_size = sizeof(current::persistence::impl::BinaryRecordHeader);
+    EXPECT_EQ(8u + header_size * 6u + signature.length() + 3u * ToBinary(StorableString("foo")).length(),
+              contents.length());
+    EXPECT_EQ("C5TBIN1\n", contents.substr(0u, 8u));
+  }
+
+  {
+    // Confirm the data has been saved and can be replayed, and the head record is still rewritten in place.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(600, impl.CurrentHead().count());
+    EXPECT_EQ(500, impl.LastPublishedIndexAndTimestamp().us.count());
+    const auto size_before = current::FileSystem::GetFileSize(persistence_file_name);
+    impl.UpdateHead(us_t(700));
+    EXPECT_EQ(size_before, current::FileSystem::GetFileSize(persistence_file_name));
+    impl.PublishUnsafe("{\"index\":3,\"us\":999}\t{\"s\":\"blah\"}");
+    EXPECT_THROW(impl.PublishUnsafe("{\"index\":5,\"us\":1000}\t{\"s\":\"blah\"}"),
+                 current::persistence::UnsafePublishBadIndexTimestampException);
+    EXPECT_EQ("foo 0 100,bar 1 200,meh 2 500,blah 3 999", GetAll(impl));
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(4u, impl.Size());
+    EXPECT_EQ(999, impl.CurrentHead().count());
+    EXPECT_EQ("foo 0 100,bar 1 200,meh 2 500,blah 3 999", GetAll(impl));
+  }
+
+  {
+    // The signature is checked.
+    std::mutex mutex;
+    EXPECT_THROW(IMPL(mutex, current::ss::StreamNamespaceName("other", "entry_name"), persistence_file_name),
+                 current::persistence::InvalidStreamSignature);
+  }
+
+  {
+    // A flipped byte in the payload is caught by the checksum.
+    std::string contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+    const auto pos = contents.find("\x03" "bar");
+    ASSERT_NE(std::string::npos, pos);
+    contents[pos + 1u] = 'c';
+    current::FileSystem::WriteStringToFile(contents, persistence_file_name.c_str());
+    std::mutex mutex;
+    EXPECT_THROW(IMPL(mutex, namespace_name, persistence_file_name),
+                 current::persistence::BinaryRecordChecksumMismatch);
+  }
+
+  {
+    // An incomplete record in the end, the torn tail of a crashed write, is truncated away on open.
+    std::string contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+    const auto pos = contents.find("\x03" "car");
+    contents[pos + 1u] = 'b';
+    current::FileSystem::WriteStringToFile(contents.substr(0u, contents.length() - 3u), persistence_file_name.c_str());
+    const size_t blah_record_size = sizeof(current::persistence::impl::BinaryRecordHeader) + 5u;
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(700, impl.CurrentHead().count());
+    EXPECT_EQ("foo 0 100,bar 1 200,meh 2 500", GetAll(impl));
+    EXPECT_EQ(contents.length() - blah_record_size, current::FileSystem::GetFileSize(persistence_file_name));
+    impl.Publish(StorableString("new"), us_t(800));
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(4u, impl.Size());
+    EXPECT_EQ("foo 0 100,bar 1 200,meh 2 500,new 3 800", GetAll(impl));
+    // The entry is read once, and dereferencing the iterator again returns the same entry.
+    auto it = impl.Iterate(1, 3).begin();
+    EXPECT_EQ("bar", (*it).entry.s);
+    EXPECT_EQ("bar", (*it).entry.s);
+    ++it;
+    EXPECT_EQ("meh", (*it).entry.s);
+    EXPECT_EQ(2u, (*it).idx_ts.index);
+  }
+
+  {
+    // A record claiming a payload larger than the rest of the file is treated as the torn tail too,
+    // without attempting to allocate the buffer for it.
+    const std::string contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+    current::persistence::impl::BinaryRecordHeader header;
+    header.payload_size = static_cast<uint32_t>(-1);
+    header.crc32 = 0u;
+    header.index = 4u;
+    header.us = 900;
+    current::FileSystem::WriteStringToFile(
+        contents + std::string(reinterpret_cast<const char*>(&header), sizeof(header)) + "garbage",
+        persistence_file_name.c_str());
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(4u, impl.Size());
+    EXPECT_EQ(contents.length(), current::FileSystem::GetFileSize(persistence_file_name));
+  }
+
+  {
+    // A torn file header is treated as an empty file, while a non-binary one is rejected.
+    current::FileSystem::WriteStringToFile("C5TB", persistence_file_name.c_str());
+    {
+      std::mutex mutex;
+      IMPL impl(mutex, namespace_name, persistence_file_name);
+      EXPECT_EQ(0u, impl.Size());
+      impl.Publish(StorableString("foo"), us_t(100));
+    }
+    {
+      std::mutex mutex;
+      IMPL impl(mutex, namespace_name, persistence_file_name);
+      EXPECT_EQ("foo 0 100", GetAll(impl));
+    }
+    current::FileSystem::WriteStringToFile("{\"index\"", persistence_file_name.c_str());
+    std::mutex mutex;
+    EXPECT_THROW(IMPL(mutex, namespace_name, persistence_file_name), current::persistence::MalformedEntryException);
+  }
+}
+
+TEST(PersistenceLayer, ConvertBetweenFileAndBinaryFile) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using us_t = std::chrono::microseconds;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string json_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const std::string binary_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data.bin");
+  const std::string json_file_name_2 = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data.json");
+  const auto json_file_remover = current::FileSystem::ScopedRmFile(json_file_name);
+  const auto binary_file_remover = current::FileSystem::ScopedRmFile(binary_file_name);
+  const auto json_file_remover_2 = current::FileSystem::ScopedRmFile(json_file_name_2);
+
+  {
+    std::mutex mutex;
+    current::persistence::File<StorableString> impl(mutex, namespace_name, json_file_name);
+    impl.Publish(StorableString("foo"), us_t(100));
+    impl.Publish(StorableString("bar"), us_t(200));
+    impl.UpdateHead(us_t(300));
+  }
+
+  current::persistence::ConvertFileToBinaryFile<StorableString>(namespace_name, json_file_name, binary_file_name);
+
+  {
+    std::mutex mutex;
+    current::persistence::File<StorableString> impl(mutex, namespace_name, json_file_name);
+    impl.Publish(StorableString("meh"), us_t(500));
+    impl.UpdateHead(us_t(600));
+  }
+
+  // The second run only copies the entries published since the first one.
+  current::persistence::ConvertFileToBinaryFile<StorableString>(namespace_name, json_file_name, binary_file_name);
+
+  {
+    std::mutex mutex;
+    current::persistence::BinaryFile<StorableString> impl(mutex, namespace_name, binary_file_name);
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(600, impl.CurrentHead().count());
+  }
+
+  current::persistence::ConvertBinaryFileToFile<StorableString>(namespace_name, binary_file_name, json_file_name_2);
+
+  {
+    // The entries and the head make it back, the intermediate heads do not.
+    std::mutex mutex;
+    current::persistence::File<StorableString> impl(mutex, namespace_name, json_file_name_2);
+    EXPECT_EQ(600, impl.CurrentHead().count());
+    std::vector<std::string> all;
+    for (const auto& e : impl.IterateUnsafe()) {
+      all.push_back(e);
+    }
+    EXPECT_EQ(
+        "{\"index\":0,\"us\":100}\t{\"s\":\"foo\"},"
+        "{\"index\":1,\"us\":200}\t{\"s\":\"bar\"},"
+        "{\"index\":2,\"us\":500}\t{\"s\":\"meh\"}",
+        Join(all, ","));
+  }
+}
+
+TEST(PersistenceLayer, PublishUnsafeBatch) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+  using us_t = std::chrono::microseconds;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+
+  const std::vector<std::string> batch = {"{\"index\":1,\"us\":200}\t{\"s\":\"two\"}",
+                                          "{\"index\":2,\"us\":300}\t{\"s\":\"three\"}"};
+  const auto PublishAndGetAll = [&batch](auto& impl) -> std::string {
+    impl.Publish(StorableString("one"), us_t(100));
+    const auto last = impl.PublishUnsafeBatch(batch);
+    EXPECT_EQ(2u, last.index);
+    EXPECT_EQ(300, last.us.count());
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(300, impl.CurrentHead().count());
+    EXPECT_THROW(impl.PublishUnsafeBatch(batch), current::persistence::UnsafePublishBadIndexTimestampException);
+    std::vector<std::string> all;
+    for (const auto& e : impl.Iterate()) {
+      all.push_back(Printf(
+          "%s %d %d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.index), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(all, ",");
+  };
+
+  {
+    std::mutex mutex;
+    current::persistence::Memory<StorableString> impl(mutex, namespace_name);
+    EXPECT_EQ("one 0 100,two 1 200,three 2 300", PublishAndGetAll(impl));
+  }
+  {
+    const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+    std::mutex mutex;
+    current::persistence::File<StorableString> impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ("one 0 100,two 1 200,three 2 300", PublishAndGetAll(impl));
+  }
+  {
+    const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+    std::mutex mutex;
+    current::persistence::BinaryFile<StorableString> impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ("one 0 100,two 1 200,three 2 300", PublishAndGetAll(impl));
+  }
+}
+
 TEST(PersistenceLayer, MemoryIteratorPerformanceTest) {
   using namespace persistence_test;
   using IMPL = current::persistence::Memory<StorableString>;
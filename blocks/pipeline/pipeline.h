@@ -0,0 +1,857 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2019 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// A template-metaprogrammed way to define and run fast crunching pipelines over a circular buffer of blobs.
+//
+// The pipeline is one `BlockSource`, which fills the circular buffer with blobs, followed by the stages of workers.
+// Each stage is a `BlockWorker`, a `SequentialPipeline(...)` of stages, or a `ParallelPipeline(...)` of stages,
+// nested arbitrarily. Every worker sees every blob: the workers of a sequential stage process each blob one after
+// another, and the workers of a parallel stage process each blob concurrently. The source only overwrites the blob
+// once every worker is done with it.
+//
+// There are no locks on the hot path. Each block, the source and every worker, runs in its own thread, and keeps its
+// own counter of the blobs it is done with. The worker can proceed as far as the minimum of the counters of the
+// blocks it depends on. See `PipelineRunParams` for the CPU pinning and the wait policy of those threads.
+
+#ifndef BLOCKS_PIPELINE_PIPELINE_H
+#define BLOCKS_PIPELINE_PIPELINE_H
+
+#include "../../port.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#ifdef CURRENT_POSIX
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // CURRENT_POSIX
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "../../bricks/template/typelist.h"
+#include "../../bricks/time/chrono.h"
+#include "../../bricks/util/lazy_instantiation.h"
+#include "../../typesystem/struct.h"
+
+namespace current::pipeline {
+
+enum class SourceOrWorker : bool { Source = true, Worker = false };
+
+template <SourceOrWorker, class T>
+class BlockSourceOrWorker final {
+ private:
+  struct Impl final {
+    const current::LazilyInstantiated<T> instantiator;
+    template <typename... ARGS>
+    explicit Impl(ARGS&&... args) : instantiator(current::DelayedInstantiate<T>(std::forward<ARGS>(args)...)) {}
+  };
+  std::shared_ptr<Impl> impl_;
+
+ public:
+  using block_t = T;
+
+  BlockSourceOrWorker(const BlockSourceOrWorker& rhs) : impl_(rhs.impl_) {}
+  BlockSourceOrWorker(BlockSourceOrWorker&& rhs) : impl_(std::move(rhs.impl_)) {}
+  BlockSourceOrWorker& operator=(const BlockSourceOrWorker& rhs) {
+    impl_ = rhs.impl_;
+    return *this;
+  }
+  BlockSourceOrWorker& operator=(BlockSourceOrWorker&& rhs) {
+    impl_ = std::move(rhs.impl_);
+    return *this;
+  }
+
+  BlockSourceOrWorker() { impl_ = std::make_shared<Impl>(); }
+
+  // NOTE(dkorolev): This ugliness is essential, otherwise this constructor is chosed instead of the copy/move ones. :-(
+  template <typename X, typename... XS, class = std::enable_if_t<!std::is_same_v<std::decay_t<X>, BlockSourceOrWorker>>>
+  BlockSourceOrWorker(X&& arg, XS&&... args) {
+    impl_ = std::make_shared<Impl>(std::forward<X>(arg), std::forward<XS>(args)...);
+  }
+
+  std::unique_ptr<T> Instantiate() const { return impl_->instantiator.InstantiateAsUniquePtr(); }
+};
+
+template <class T>
+using BlockSource = BlockSourceOrWorker<SourceOrWorker::Source, T>;
+
+template <class T>
+using BlockWorker = BlockSourceOrWorker<SourceOrWorker::Worker, T>;
+
+template <class T>
+struct IsBlockSource final {
+  inline constexpr static bool value = false;
+};
+
+template <class T>
+struct IsBlockSource<BlockSource<T>> final {
+  inline constexpr static bool value = true;
+  using source_impl_t = T;
+};
+
+template <class T>
+inline constexpr bool is_block_source_v = IsBlockSource<T>::value;
+
+template <class T>
+using extract_source_impl_t = typename IsBlockSource<T>::source_impl_t;
+
+// The stages of the pipeline, which can be nested into one another in any way.
+template <class... STAGES>
+struct SequentialStage final {
+  std::tuple<STAGES...> stages;
+  explicit SequentialStage(std::tuple<STAGES...> stages) : stages(std::move(stages)) {}
+};
+
+template <class... STAGES>
+struct ParallelStage final {
+  std::tuple<STAGES...> stages;
+  explicit ParallelStage(std::tuple<STAGES...> stages) : stages(std::move(stages)) {}
+};
+
+template <class T>
+struct IsPipelineStage final {
+  inline constexpr static bool value = false;
+};
+
+template <class T>
+struct IsPipelineStage<BlockWorker<T>> final {
+  inline constexpr static bool value = true;
+};
+
+template <class... STAGES>
+struct IsPipelineStage<SequentialStage<STAGES...>> final {
+  inline constexpr static bool value = true;
+};
+
+template <class... STAGES>
+struct IsPipelineStage<ParallelStage<STAGES...>> final {
+  inline constexpr static bool value = true;
+};
+
+template <class T>
+inline constexpr bool is_pipeline_stage_v = IsPipelineStage<T>::value;
+
+template <class... UNDECAYED_STAGES>
+SequentialStage<std::decay_t<UNDECAYED_STAGES>...> SequentialPipeline(UNDECAYED_STAGES&&... stages) {
+  static_assert(sizeof...(UNDECAYED_STAGES) >= 1u, "`SequentialPipeline(...)` takes at least one stage.");
+  static_assert((is_pipeline_stage_v<std::decay_t<UNDECAYED_STAGES>> && ...),
+                "`SequentialPipeline(...)` takes `BlockWorker`-s, `SequentialPipeline`-s, and `ParallelPipeline`-s.");
+  return SequentialStage<std::decay_t<UNDECAYED_STAGES>...>(std::make_tuple(std::forward<UNDECAYED_STAGES>(stages)...));
+}
+
+template <class... UNDECAYED_STAGES>
+ParallelStage<std::decay_t<UNDECAYED_STAGES>...> ParallelPipeline(UNDECAYED_STAGES&&... stages) {
+  static_assert(sizeof...(UNDECAYED_STAGES) >= 1u, "`ParallelPipeline(...)` takes at least one stage.");
+  static_assert((is_pipeline_stage_v<std::decay_t<UNDECAYED_STAGES>> && ...),
+                "`ParallelPipeline(...)` takes `BlockWorker`-s, `SequentialPipeline`-s, and `ParallelPipeline`-s.");
+  return ParallelStage<std::decay_t<UNDECAYED_STAGES>...>(std::make_tuple(std::forward<UNDECAYED_STAGES>(stages)...));
+}
+
+// The set of the indexes of the blocks, the counters of which should be taken the minimum of.
+// The source has the index of zero, the workers are numbered from one, in the order they are listed in the pipeline.
+template <int... JS>
+struct PipelineDeps final {};
+
+template <class LHS, class RHS>
+struct PipelineDepsCatImpl;
+
+template <int... LHS, int... RHS>
+struct PipelineDepsCatImpl<PipelineDeps<LHS...>, PipelineDeps<RHS...>> final {
+  using type_t = PipelineDeps<LHS..., RHS...>;
+};
+
+template <class LHS, class RHS>
+using pipeline_deps_cat_t = typename PipelineDepsCatImpl<LHS, RHS>::type_t;
+
+// `PipelineWorker` is the worker wrapped into the assembled pipeline.
+//
+// `I` is the 1-based index of this worker, with 0 reserved for the source. The `I`-s of all workers are distinct,
+// and there is one counter kept per worker in the pipeline state. This counter keeps track of the number of blobs
+// processed so far by this worker.
+//
+// `DEPS` is the `PipelineDeps<...>` of the blocks that should be done with the blob for this worker to process it.
+// It is the source, or the workers of the previous sequential stage, for the very first worker of the stage.
+template <int I, class DEPS, class WORKER>
+struct PipelineWorker final {
+  static_assert(I >= 1);
+  using deps_t = DEPS;
+  using worker_t = WORKER;
+};
+
+// Flattens the stages into the list of `PipelineWorker`-s. `I` is the index of the first worker of the stage,
+// and `INPUT_DEPS` is what this stage depends on. Exposes `workers_t`, the `PipelineDeps<...>` of the workers
+// the completion of which completes the stage as `output_deps_t`, and the index of the next worker as `next_index`.
+template <int I, class INPUT_DEPS, class STAGE>
+struct FlattenStage;
+
+template <int I, class INPUT_DEPS, class WORKER>
+struct FlattenStage<I, INPUT_DEPS, BlockWorker<WORKER>> final {
+  using workers_t = metaprogramming::TypeListImpl<PipelineWorker<I, INPUT_DEPS, WORKER>>;
+  using output_deps_t = PipelineDeps<I>;
+  constexpr static int next_index = I + 1;
+};
+
+template <int I, class INPUT_DEPS>
+struct FlattenStage<I, INPUT_DEPS, SequentialStage<>> final {
+  using workers_t = metaprogramming::TypeListImpl<>;
+  using output_deps_t = INPUT_DEPS;
+  constexpr static int next_index = I;
+};
+
+template <int I, class INPUT_DEPS, class STAGE, class... STAGES>
+struct FlattenStage<I, INPUT_DEPS, SequentialStage<STAGE, STAGES...>> final {
+  using head_t = FlattenStage<I, INPUT_DEPS, STAGE>;
+  using tail_t = FlattenStage<head_t::next_index, typename head_t::output_deps_t, SequentialStage<STAGES...>>;
+  using workers_t = metaprogramming::TypeListCat<typename head_t::workers_t, typename tail_t::workers_t>;
+  using output_deps_t = typename tail_t::output_deps_t;
+  constexpr static int next_index = tail_t::next_index;
+};
+
+template <int I, class INPUT_DEPS>
+struct FlattenStage<I, INPUT_DEPS, ParallelStage<>> final {
+  using workers_t = metaprogramming::TypeListImpl<>;
+  using output_deps_t = PipelineDeps<>;
+  constexpr static int next_index = I;
+};
+
+template <int I, class INPUT_DEPS, class STAGE, class... STAGES>
+struct FlattenStage<I, INPUT_DEPS, ParallelStage<STAGE, STAGES...>> final {
+  using head_t = FlattenStage<I, INPUT_DEPS, STAGE>;
+  using tail_t = FlattenStage<head_t::next_index, INPUT_DEPS, ParallelStage<STAGES...>>;
+  using workers_t = metaprogramming::TypeListCat<typename head_t::workers_t, typename tail_t::workers_t>;
+  using output_deps_t = pipeline_deps_cat_t<typename head_t::output_deps_t, typename tail_t::output_deps_t>;
+  constexpr static int next_index = tail_t::next_index;
+};
+
+// Flattens the stages into the `std::tuple<>` of `BlockWorker`-s, in the same order as `FlattenStage` numbers them.
+template <class STAGE>
+struct FlattenBlockWorkers;
+
+template <class WORKER>
+struct FlattenBlockWorkers<BlockWorker<WORKER>> final {
+  static std::tuple<BlockWorker<WORKER>> Flatten(const BlockWorker<WORKER>& worker) { return std::make_tuple(worker); }
+};
+
+template <class... STAGES>
+struct FlattenBlockWorkers<SequentialStage<STAGES...>> final {
+  static auto Flatten(const SequentialStage<STAGES...>& stage) {
+    return std::apply(
+        [](const STAGES&... stages) { return std::tuple_cat(FlattenBlockWorkers<STAGES>::Flatten(stages)...); },
+        stage.stages);
+  }
+};
+
+template <class... STAGES>
+struct FlattenBlockWorkers<ParallelStage<STAGES...>> final {
+  static auto Flatten(const ParallelStage<STAGES...>& stage) {
+    return std::apply(
+        [](const STAGES&... stages) { return std::tuple_cat(FlattenBlockWorkers<STAGES>::Flatten(stages)...); },
+        stage.stages);
+  }
+};
+
+// What the threads do while the block they are running has nothing to do.
+// `Futex` spins for a short while, and then sleeps until woken up by the block it depends on making progress.
+// `BusyPoll` never sleeps, which yields the lowest latency, at the cost of keeping the CPU cores fully loaded.
+// `BusyPoll` is meant to be used along with pinning each block to its own core.
+enum class PipelineWaitPolicy : int { Futex = 0, BusyPoll = 1 };
+
+template <typename BLOB>
+struct PipelineRunParams {
+  size_t circular_buffer_size = (1ull << 20);  // 1MB sounds like a reasonable default. -- D.K.
+  PipelineWaitPolicy wait_policy = PipelineWaitPolicy::Futex;
+  std::map<int, int> cpu_per_block;  // Block index, zero for the source, to the index of the CPU to pin it to.
+
+  PipelineRunParams& SetCircularBufferSize(size_t value) {
+    circular_buffer_size = value;
+    return *this;
+  }
+  PipelineRunParams& SetWaitPolicy(PipelineWaitPolicy value) {
+    wait_policy = value;
+    return *this;
+  }
+  PipelineRunParams& PinBlockToCPU(int block_index, int cpu) {
+    cpu_per_block[block_index] = cpu;
+    return *this;
+  }
+};
+
+inline void PipelineCPURelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+// Returns whether the calling thread was pinned successfully.
+inline bool PinCurrentThreadToCPU(int cpu) {
+#ifdef CURRENT_POSIX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  static_cast<void>(cpu);
+  return false;
+#endif  // CURRENT_POSIX
+}
+
+// The 32-bit futex to wait on, with the fallback to a mutex and a condition variable where there is no `futex()`.
+class PipelineFutex final {
+ public:
+  uint32_t Load() const { return value_.load(); }
+
+  // Bumps the value, and wakes up all the waiters if there are any. Costs no system call if there are no waiters.
+  void BumpAndWakeAll() {
+    value_.fetch_add(1u);
+    if (waiters_.load()) {
+#ifdef CURRENT_POSIX
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value_), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_all();
+#endif  // CURRENT_POSIX
+    }
+  }
+
+  // Sleeps unless the value has already changed from `expected`. Spurious wakeups are possible.
+  void WaitWhileEquals(uint32_t expected) {
+#ifdef CURRENT_POSIX
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value_), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, expected]() { return value_.load() != expected; });
+#endif  // CURRENT_POSIX
+  }
+
+  // Waits until `predicate()` holds. The caller should `BumpAndWakeAll()` after every change that may satisfy it.
+  template <typename F>
+  void WaitUntil(F&& predicate) {
+    while (true) {
+      waiters_.fetch_add(1u);
+      const uint32_t seen = value_.load();
+      if (predicate()) {
+        waiters_.fetch_sub(1u);
+        return;
+      }
+      WaitWhileEquals(seen);
+      waiters_.fetch_sub(1u);
+      if (predicate()) {
+        return;
+      }
+    }
+  }
+
+ private:
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The futex must be a plain 32-bit integer.");
+  std::atomic<uint32_t> value_{0u};
+  std::atomic<uint32_t> waiters_{0u};
+#ifndef CURRENT_POSIX
+  std::mutex mutex_;
+  std::condition_variable cv_;
+#endif  // CURRENT_POSIX
+};
+
+// Each counter takes its own cache line, so that the threads updating their counters do not contend with each other.
+struct alignas(64) PipelineBlockCounter final {
+  std::atomic<size_t> value{0u};
+};
+
+template <class SOURCE, class WORKERS_TYPELIST, class SOURCE_DEPS>
+struct PipelineImpl;
+
+template <class T>
+class PipelineState;
+
+template <class SOURCE, class... WORKERS, class SOURCE_DEPS>
+class PipelineState<PipelineImpl<SOURCE, metaprogramming::TypeListImpl<WORKERS...>, SOURCE_DEPS>> final {
+ public:
+  constexpr static int N = sizeof...(WORKERS) + 1;
+
+ private:
+  std::array<PipelineBlockCounter, N> total_ready_;
+  std::atomic_bool terminate_requested_{false};
+  PipelineFutex futex_;
+
+  template <int I, bool IS_SOURCE = (I == 0)>
+  struct DepsOf final {
+    using deps_t = typename metaprogramming::TypeListElement<I - 1, metaprogramming::TypeListImpl<WORKERS...>>::deps_t;
+  };
+
+  template <int I>
+  struct DepsOf<I, true> final {
+    using deps_t = SOURCE_DEPS;
+  };
+
+  template <int... JS>
+  size_t MinimumOf(PipelineDeps<JS...>) const {
+    return std::min({total_ready_[JS].value.load(std::memory_order_acquire)...});
+  }
+
+ public:
+  // For the source, it's the number of blobs all the workers are done with. For the worker, it's the number of blobs
+  // it can process, as they have already been processed by the blocks this worker depends on.
+  template <int I>
+  size_t ReadyCountFor() const {
+    static_assert(I >= 0 && I < N);
+    return MinimumOf(typename DepsOf<I>::deps_t());
+  }
+
+  size_t GrandTotalProcessedCount() const { return ReadyCountFor<0>(); }
+
+  size_t ProcessedCount(int i) const { return total_ready_[i].value.load(std::memory_order_acquire); }
+
+  // NOTE(dkorolev): Only one thread runs each particular worker/source, so this call can be thread-unsafe by design.
+  template <int I>
+  void UpdateOutput(size_t value) {
+    static_assert(I >= 0 && I < N);
+#ifndef NDEBUG
+    if (!(value >= total_ready_[I].value.load())) {
+      std::cerr << "Internal error: The " << (I ? "worker" : "source")
+                << " attempted to decrease its `done_count` from " << total_ready_[I].value.load() << " to " << value
+                << ".\n";
+      std::exit(-1);
+    }
+#endif
+    total_ready_[I].value.store(value, std::memory_order_release);
+    futex_.BumpAndWakeAll();
+  }
+
+  bool TerminateRequested() const { return terminate_requested_.load(std::memory_order_relaxed); }
+
+  void RequestTermination() {
+    terminate_requested_ = true;
+    futex_.BumpAndWakeAll();
+  }
+
+  template <typename F>
+  void WaitUntil(PipelineWaitPolicy policy, F&& predicate) {
+    // Spin for a bit first, as the blocks up the pipeline are likely to make progress very soon under load.
+    const size_t spin_iterations = (policy == PipelineWaitPolicy::BusyPoll) ? static_cast<size_t>(-1) : 1000u;
+    for (size_t i = 0u; i < spin_iterations; ++i) {
+      if (predicate()) {
+        return;
+      }
+      PipelineCPURelax();
+    }
+    futex_.WaitUntil(std::forward<F>(predicate));
+  }
+};
+
+inline std::string PipelineBlockTypeName(const std::type_info& type_info) {
+#if defined(__GNUC__) || defined(__clang__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(type_info.name(), nullptr, nullptr, &status);
+  if (demangled) {
+    const std::string result = status == 0 ? std::string(demangled) : std::string(type_info.name());
+    std::free(demangled);
+    return result;
+  }
+#endif
+  return type_info.name();
+}
+
+// The runtime snapshot of the state of the running pipeline. See `status_page.h` for the HTTP endpoint.
+CURRENT_STRUCT(PipelineBlockStatus) {
+  CURRENT_FIELD(index, int32_t);
+  CURRENT_FIELD(is_source, bool);
+  CURRENT_FIELD(name, std::string);
+  CURRENT_FIELD(deps, std::vector<int32_t>);
+  CURRENT_FIELD(processed, uint64_t);
+  CURRENT_FIELD(cpu, int32_t, -1);  // The CPU this block is pinned to, or -1.
+};
+
+CURRENT_STRUCT(PipelineStatus) {
+  CURRENT_FIELD(circular_buffer_blobs, uint64_t);
+  CURRENT_FIELD(blob_size, uint64_t);
+  CURRENT_FIELD(busy_poll, bool);
+  CURRENT_FIELD(started, std::chrono::microseconds);
+  CURRENT_FIELD(now, std::chrono::microseconds);
+  CURRENT_FIELD(blocks, std::vector<PipelineBlockStatus>);
+};
+
+template <class IMPL, typename BLOB>
+struct PipelineRunContext;
+
+template <class SOURCE, class... WORKERS, class SOURCE_DEPS>
+struct PipelineImpl<SOURCE, metaprogramming::TypeListImpl<WORKERS...>, SOURCE_DEPS> final {
+  using this_t = PipelineImpl<SOURCE, metaprogramming::TypeListImpl<WORKERS...>, SOURCE_DEPS>;
+  using block_workers_t = std::tuple<BlockWorker<typename WORKERS::worker_t>...>;
+  constexpr static int N = sizeof...(WORKERS) + 1;
+
+  const BlockSource<SOURCE> source;
+  const block_workers_t workers;
+
+  PipelineImpl(BlockSource<SOURCE> source, block_workers_t workers)
+      : source(std::move(source)), workers(std::move(workers)) {}
+
+  template <typename BLOB>
+  PipelineRunContext<this_t, BLOB> Run(const PipelineRunParams<BLOB>& params) const {
+    return PipelineRunContext<this_t, BLOB>(*this, params);
+  }
+};
+
+template <class SOURCE, class... STAGES>
+struct PipelineBuilder final {
+  static_assert(sizeof...(STAGES) >= 1u, "`Pipeline(...)` takes at least two parameters, one source and one worker.");
+  static_assert(is_block_source_v<SOURCE>, "The first parameter to `Pipeline(...)` must be a `BlockSource`.");
+
+  using source_impl_t = extract_source_impl_t<SOURCE>;
+  using flattened_t = FlattenStage<1, PipelineDeps<0>, SequentialStage<STAGES...>>;
+  using type_t = PipelineImpl<source_impl_t, typename flattened_t::workers_t, typename flattened_t::output_deps_t>;
+
+  static type_t Build(SOURCE source, STAGES... stages) {
+    return type_t(std::move(source),
+                  FlattenBlockWorkers<SequentialStage<STAGES...>>::Flatten(
+                      SequentialStage<STAGES...>(std::make_tuple(std::move(stages)...))));
+  }
+};
+
+template <class UNDECAYED_SOURCE, class... UNDECAYED_STAGES>
+typename PipelineBuilder<std::decay_t<UNDECAYED_SOURCE>, std::decay_t<UNDECAYED_STAGES>...>::type_t Pipeline(
+    UNDECAYED_SOURCE&& source, UNDECAYED_STAGES&&... stages) {
+  return PipelineBuilder<std::decay_t<UNDECAYED_SOURCE>, std::decay_t<UNDECAYED_STAGES>...>::Build(
+      std::forward<UNDECAYED_SOURCE>(source), std::forward<UNDECAYED_STAGES>(stages)...);
+}
+
+template <int... JS>
+std::vector<int32_t> PipelineDepsAsVector(PipelineDeps<JS...>) {
+  return std::vector<int32_t>({JS...});
+}
+
+template <class SOURCE, class... WORKERS, class SOURCE_DEPS, typename BLOB>
+struct PipelineRunContext<PipelineImpl<SOURCE, metaprogramming::TypeListImpl<WORKERS...>, SOURCE_DEPS>, BLOB> final {
+  using self_t = PipelineImpl<SOURCE, metaprogramming::TypeListImpl<WORKERS...>, SOURCE_DEPS>;
+  static_assert((sizeof(BLOB) & (sizeof(BLOB) - 1)) == 0, "`sizeof(BLOB)` should be a power of two.");
+
+  using state_t = PipelineState<self_t>;
+  using workers_t = std::tuple<typename WORKERS::worker_t...>;
+
+  constexpr static size_t N = static_cast<size_t>(state_t::N);
+  static_assert(N == sizeof...(WORKERS) + 1);
+
+  template <int I>
+  using worker_t = std::tuple_element_t<I - 1, workers_t>;
+
+  struct PipelineInstances final {
+    std::unique_ptr<SOURCE> source;
+    std::tuple<std::unique_ptr<typename WORKERS::worker_t>...> workers;
+
+    explicit PipelineInstances(const self_t& self) {
+      // Respect the historical design of instantiating right-to-left.
+      InstantiateWorkers<N - 1>(self);
+      source = self.source.Instantiate();
+    }
+
+    template <int I>
+    void InstantiateWorkers(const self_t& self) {
+      if constexpr (I >= 1) {
+        std::get<I - 1>(workers) = std::get<I - 1>(self.workers).Instantiate();
+        InstantiateWorkers<I - 1>(self);
+      }
+    }
+
+    // And destruct in the reverse order of construction.
+    template <size_t... IS>
+    void DestructWorkers(std::index_sequence<IS...>) {
+      (std::get<IS>(workers).reset(), ...);
+    }
+
+    ~PipelineInstances() {
+      source = nullptr;
+      DestructWorkers(std::make_index_sequence<N - 1>());
+    }
+  };
+
+  struct PipelineRunContextImpl final {
+    PipelineInstances instances;
+    std::vector<BLOB> circular_buffer;
+    state_t state;
+    const PipelineRunParams<BLOB> params;
+    const std::chrono::microseconds started;
+    std::array<std::atomic_int, N> pinned_cpu;
+    std::mutex joined_mutex;
+    bool joined = false;
+    std::vector<std::thread> threads;
+
+    static size_t RoundUpToPowerOfTwo(size_t x) {
+      size_t n = 1u;
+      while (n < x) {
+        n *= 2;
+      }
+      return n;
+    }
+
+    PipelineRunContextImpl(const self_t& self, const PipelineRunParams<BLOB>& params)
+        : instances(self),
+          circular_buffer(RoundUpToPowerOfTwo(params.circular_buffer_size / sizeof(BLOB))),
+          params(params),
+          started(current::time::Now()) {
+      for (auto& cpu : pinned_cpu) {
+        cpu = -1;
+      }
+      StartWorkerThreads(std::make_index_sequence<N - 1>());
+      threads.emplace_back([this]() { SourceThread(); });
+    }
+
+    template <size_t... IS>
+    void StartWorkerThreads(std::index_sequence<IS...>) {
+      (threads.emplace_back([this]() { WorkerThread<IS + 1>(); }), ...);
+    }
+
+    void PinIfRequested(int block_index) {
+      const auto cit = params.cpu_per_block.find(block_index);
+      if (cit != params.cpu_per_block.end() && PinCurrentThreadToCPU(cit->second)) {
+        pinned_cpu[block_index] = cit->second;
+      }
+    }
+
+    template <int I>
+    void WorkerThread() {
+      PinIfRequested(I);
+
+      worker_t<I>& worker_instance = *std::get<I - 1>(instances.workers);
+
+      const size_t total_buffer_size = circular_buffer.size();
+      const size_t total_buffer_size_minus_one = total_buffer_size - 1u;
+
+      BLOB* mutable_buffer_ptr = &circular_buffer[0];
+
+      size_t updating_total_blobs_done = 0u;
+      size_t trailing_total_blobs_read = 0u;
+      const auto IsReady = [this, &trailing_total_blobs_read, &updating_total_blobs_done]() {
+        trailing_total_blobs_read = std::max(trailing_total_blobs_read, state.template ReadyCountFor<I>());
+        return updating_total_blobs_done < trailing_total_blobs_read || state.TerminateRequested();
+      };
+
+      while (true) {
+        if (!IsReady()) {
+          state.WaitUntil(params.wait_policy, IsReady);
+        }
+
+        if (state.TerminateRequested()) {
+          break;
+        }
+
+        const auto DoWorkOverCircularBuffer = [&](size_t begin, size_t end) {
+          BLOB* ptr_begin = mutable_buffer_ptr + begin;
+          BLOB* ptr_end = mutable_buffer_ptr + end;
+          const size_t processed = (worker_instance.DoWork(ptr_begin, ptr_end) - ptr_begin);
+          if (processed) {
+            updating_total_blobs_done += processed;
+            state.template UpdateOutput<I>(updating_total_blobs_done);
+          }
+        };
+
+        const size_t bgn = (updating_total_blobs_done & total_buffer_size_minus_one);
+        const size_t end = (trailing_total_blobs_read & total_buffer_size_minus_one);
+        if (bgn < end) {
+          DoWorkOverCircularBuffer(bgn, end);
+        } else {
+          DoWorkOverCircularBuffer(bgn, total_buffer_size);
+        }
+      }
+    }
+
+    void SourceThread() {
+      PinIfRequested(0);
+
+      SOURCE& source_instance = *instances.source;
+
+      const size_t total_buffer_size_in_bytes = circular_buffer.size() * sizeof(BLOB);
+      const size_t total_buffer_size_in_bytes_minus_one = total_buffer_size_in_bytes - 1u;
+
+      uint8_t* buffer_in_bytes = reinterpret_cast<uint8_t*>(&circular_buffer[0]);
+
+      // The number of bytes "available" is effectively the total bytes read plus the size of part
+      // of the buffer that is not presently used by the blobs already read but not yet processed.
+      size_t trailing_total_blobs_done = 0u;
+      size_t trailing_total_bytes_aval = 0u;
+
+      size_t updating_total_bytes_read = 0u;
+      size_t updating_total_blobs_read = 0u;
+
+      // Updates the value of `trailing_total_bytes_aval`, and checks whether there is room in the buffer.
+      const auto IsReady = [this,
+                            &trailing_total_bytes_aval,
+                            total_buffer_size_in_bytes,
+                            &trailing_total_blobs_done,
+                            &updating_total_bytes_read]() {
+        trailing_total_blobs_done = std::max(trailing_total_blobs_done, state.template ReadyCountFor<0>());
+        trailing_total_bytes_aval = (trailing_total_blobs_done * sizeof(BLOB) + total_buffer_size_in_bytes);
+        return trailing_total_bytes_aval != updating_total_bytes_read || state.TerminateRequested();
+      };
+
+      while (true) {
+        if (!IsReady()) {
+          state.WaitUntil(params.wait_policy, IsReady);
+        }
+
+        if (state.TerminateRequested()) {
+          break;
+        }
+
+        const auto DoWorkOverCircularBufferInBytes = [&](size_t bgn, size_t end) {
+          const size_t bytes_read = source_instance.DoGetInput(buffer_in_bytes + bgn, buffer_in_bytes + end);
+          if (bytes_read) {
+            updating_total_bytes_read += bytes_read;
+            const size_t candidate_total_blobs_read_value = updating_total_bytes_read / sizeof(BLOB);
+            if (candidate_total_blobs_read_value != updating_total_blobs_read) {
+              updating_total_blobs_read = candidate_total_blobs_read_value;
+              state.template UpdateOutput<0>(updating_total_blobs_read);
+            }
+          }
+        };
+
+        const size_t bgn = (updating_total_bytes_read & total_buffer_size_in_bytes_minus_one);
+        const size_t end = (trailing_total_bytes_aval & total_buffer_size_in_bytes_minus_one);
+        if (bgn < end) {
+          DoWorkOverCircularBufferInBytes(bgn, end);
+        } else {
+          DoWorkOverCircularBufferInBytes(bgn, total_buffer_size_in_bytes);
+        }
+      }
+    }
+
+    bool DoJoinAllThreadsCalled() {
+      std::lock_guard<std::mutex> lock(joined_mutex);
+      const bool already_joined = joined;
+      joined = true;
+      return already_joined;
+    }
+
+    void DoJoinAllThreads() {
+      if (!DoJoinAllThreadsCalled()) {
+        for (auto& thread : threads) {
+          thread.join();
+        }
+      }
+    }
+
+    ~PipelineRunContextImpl() {
+      if (!DoJoinAllThreadsCalled()) {
+        std::cerr << "Error: The pipeline context is out of scope with no `.Join()` or `.ForceStop()` called.\n";
+        std::exit(-1);
+      }
+    }
+
+    static PipelineBlockStatus BlockStatus(
+        int index, bool is_source, std::string name, std::vector<int32_t> deps, uint64_t processed, int cpu) {
+      PipelineBlockStatus result;
+      result.index = index;
+      result.is_source = is_source;
+      result.name = std::move(name);
+      result.deps = std::move(deps);
+      result.processed = processed;
+      result.cpu = cpu;
+      return result;
+    }
+
+    template <size_t... IS>
+    void AddWorkersStatus(PipelineStatus& status, std::index_sequence<IS...>) const {
+      (status.blocks.push_back(BlockStatus(static_cast<int>(IS + 1),
+                                           false,
+                                           PipelineBlockTypeName(typeid(worker_t<IS + 1>)),
+                                           PipelineDepsAsVector(typename WORKERS::deps_t()),
+                                           state.ProcessedCount(static_cast<int>(IS + 1)),
+                                           pinned_cpu[IS + 1].load())),
+       ...);
+    }
+
+    PipelineStatus Status() const {
+      PipelineStatus status;
+      status.circular_buffer_blobs = circular_buffer.size();
+      status.blob_size = sizeof(BLOB);
+      status.busy_poll = (params.wait_policy == PipelineWaitPolicy::BusyPoll);
+      status.started = started;
+      status.now = current::time::Now();
+      status.blocks.push_back(BlockStatus(0,
+                                          true,
+                                          PipelineBlockTypeName(typeid(SOURCE)),
+                                          PipelineDepsAsVector(SOURCE_DEPS()),
+                                          state.ProcessedCount(0),
+                                          pinned_cpu[0].load()));
+      AddWorkersStatus(status, std::make_index_sequence<N - 1>());
+      return status;
+    }
+  };
+
+  std::shared_ptr<PipelineRunContextImpl> impl;  // NOTE(dkorolev): Perhaps it should be `Owned`/`Borrowed` instead?
+
+  size_t GrandTotalProcessedCount() const { return impl->state.GrandTotalProcessedCount(); }
+
+  PipelineStatus Status() const { return impl->Status(); }
+
+  SOURCE& Source() { return *impl->instances.source; }
+  const SOURCE& Source() const { return *impl->instances.source; }
+
+  template <int I>
+  worker_t<I>& Worker() {
+    return *std::get<I - 1>(impl->instances.workers);
+  }
+
+  template <int I>
+  const worker_t<I>& Worker() const {
+    return *std::get<I - 1>(impl->instances.workers);
+  }
+
+  void Join() { impl->DoJoinAllThreads(); }
+  void ForceStop() {
+    impl->state.RequestTermination();
+    impl->DoJoinAllThreads();
+  }
+
+  PipelineRunContext() = default;
+
+  PipelineRunContext(const self_t& self, const PipelineRunParams<BLOB>& params)
+      : impl(std::make_shared<PipelineRunContextImpl>(self, params)) {}
+};
+
+}  // namespace current::pipeline
+
+#endif  // BLOCKS_PIPELINE_PIPELINE_H
@@ -0,0 +1,493 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Batched socket input for pipeline sources: any number of TCP connections fanned into one stream of whole records.
+//
+// On Linux the reads go through io_uring, with a registered staging buffer and one read in flight per connection,
+// so that a single `io_uring_enter()` reaps the completions and resubmits the reads for all the connections at once.
+// Elsewhere, or if the kernel refuses to set up the ring, it falls back to `poll()` followed by plain `recv()`-s.
+//
+// The records of different connections are interleaved, but never split: each returned batch is a whole number of
+// records, and the bytes of every record come from one connection, in order.
+
+#ifndef BLOCKS_PIPELINE_SOCKET_IO_H
+#define BLOCKS_PIPELINE_SOCKET_IO_H
+
+#include "../../port.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifndef CURRENT_WINDOWS
+#include <poll.h>
+#include <sys/socket.h>
+#endif  // CURRENT_WINDOWS
+
+#if defined(CURRENT_POSIX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CURRENT_PIPELINE_HAS_IO_URING
+#endif
+#endif
+
+#ifdef CURRENT_PIPELINE_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif  // CURRENT_PIPELINE_HAS_IO_URING
+
+#include "../../bricks/net/tcp/tcp.h"
+
+namespace current::pipeline {
+
+// `Auto` uses io_uring if it is available both at compile time and at runtime, and `Blocking` otherwise.
+enum class SocketReadBackend : int { Auto = 0, Blocking = 1, IOUring = 2 };
+
+#ifdef CURRENT_PIPELINE_HAS_IO_URING
+
+// The bare minimum of io_uring, on top of the raw system calls, to not depend on `liburing`.
+// Not thread-safe: the submission and the completion queues are both meant to be used from the same thread.
+class IOUring final {
+ public:
+  // Returns `nullptr` if the kernel would not set up the ring, i.e. if io_uring is unsupported or disabled.
+  static std::unique_ptr<IOUring> Create(uint32_t entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+      return nullptr;
+    }
+    std::unique_ptr<IOUring> result(new IOUring(fd, params));
+    if (!result->sq_ring_ || !result->cq_ring_ || !result->sqes_) {
+      return nullptr;
+    }
+    return result;
+  }
+
+  ~IOUring() {
+    if (sqes_) {
+      ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+      ::munmap(sq_ring_, sq_ring_size_);
+    }
+    ::close(fd_);
+  }
+
+  // Registers the buffers for the fixed reads. Returns `false` if the kernel refused, i.e. due to `RLIMIT_MEMLOCK`.
+  bool RegisterBuffers(const std::vector<iovec>& buffers) {
+    return ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) == 0;
+  }
+
+  // Queues a read into `buffer`, which should be within the registered buffer `buffer_index`, or `-1` if unregistered.
+  // Returns `false` if the submission queue is full.
+  bool PrepareRead(int fd, void* buffer, uint32_t length, uint64_t user_data, int buffer_index) {
+    const uint32_t tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      return false;  // LCOV_EXCL_LINE
+    }
+    const uint32_t index = tail & sq_mask_;
+    io_uring_sqe& sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = (buffer_index >= 0) ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(buffer);
+    sqe.len = length;
+    sqe.user_data = user_data;
+    if (buffer_index >= 0) {
+      sqe.buf_index = static_cast<uint16_t>(buffer_index);
+    }
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1u, __ATOMIC_RELEASE);
+    ++to_submit_;
+    return true;
+  }
+
+  // Submits what was prepared, and waits for at least `min_complete` completions. A single system call.
+  void SubmitAndWait(uint32_t min_complete) {
+    if (!to_submit_ && !min_complete) {
+      return;
+    }
+    while (true) {
+      const int submitted = static_cast<int>(::syscall(__NR_io_uring_enter,
+                                                       fd_,
+                                                       to_submit_,
+                                                       min_complete,
+                                                       min_complete ? IORING_ENTER_GETEVENTS : 0u,
+                                                       nullptr,
+                                                       0u));
+      if (submitted >= 0) {
+        to_submit_ -= std::min(to_submit_, static_cast<uint32_t>(submitted));
+        return;
+      }
+      if (errno != EINTR) {
+        CURRENT_THROW(net::SocketReadException());  // LCOV_EXCL_LINE
+      }
+    }
+  }
+
+  // Calls `f(user_data, result)` for each completion available, without blocking. Returns their number.
+  template <typename F>
+  size_t ForEachCompletion(F&& f) {
+    uint32_t head = *cq_head_;
+    const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    size_t count = 0u;
+    while (head != tail) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      f(cqe.user_data, cqe.res);
+      ++head;
+      ++count;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return count;
+  }
+
+ private:
+  IOUring(int fd, const io_uring_params& params) : fd_(fd) {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+    if (!sq_ring_) {
+      return;  // LCOV_EXCL_LINE
+    }
+    cq_ring_ = single_mmap ? sq_ring_ : Map(cq_ring_size_, IORING_OFF_CQ_RING);
+    if (!cq_ring_) {
+      return;  // LCOV_EXCL_LINE
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = reinterpret_cast<io_uring_sqe*>(Map(sqes_size_, IORING_OFF_SQES));
+
+    uint8_t* sq = reinterpret_cast<uint8_t*>(sq_ring_);
+    sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    uint8_t* cq = reinterpret_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  }
+
+  void* Map(size_t size, off_t offset) {
+    void* result = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+    return (result == MAP_FAILED) ? nullptr : result;
+  }
+
+  const int fd_;
+
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0u;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0u;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0u;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0u;
+  uint32_t sq_entries_ = 0u;
+  uint32_t to_submit_ = 0u;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0u;
+  io_uring_cqe* cqes_ = nullptr;
+
+  IOUring(const IOUring&) = delete;
+  IOUring& operator=(const IOUring&) = delete;
+};
+
+#endif  // CURRENT_PIPELINE_HAS_IO_URING
+
+// Reads from all the connections into the caller-provided buffer, returning whole `RECORD_SIZE`-byte records only.
+// `ReadInto()` blocks until at least one record is available. The connections that are closed by the other side are
+// dropped, with their incomplete trailing record, if any; once all of them are closed, `ConnectionResetByPeer` is
+// thrown.
+template <size_t RECORD_SIZE = 1u>
+class SocketFanInReader final {
+ public:
+  static_assert(RECORD_SIZE > 0u);
+
+  // The default staging buffer of 32KB per connection keeps the latency low without hurting the throughput.
+  explicit SocketFanInReader(std::vector<net::Connection>&& connections,
+                             SocketReadBackend backend = SocketReadBackend::Auto,
+                             size_t staging_buffer_size = (1u << 15))
+      : connections_(std::move(connections)) {
+    for (net::Connection& connection : connections_) {
+      Input input;
+      input.fd = static_cast<SOCKET>(connection.socket);
+      inputs_.push_back(std::move(input));
+    }
+    live_inputs_ = inputs_.size();
+    if (backend != SocketReadBackend::Blocking) {
+      InitIOUring(std::max(staging_buffer_size, RECORD_SIZE));
+    }
+  }
+
+  SocketFanInReader(net::Connection&& connection,
+                    SocketReadBackend backend = SocketReadBackend::Auto,
+                    size_t staging_buffer_size = (1u << 15))
+      : SocketFanInReader(SingleConnection(std::move(connection)), backend, staging_buffer_size) {}
+
+  size_t ConnectionsCount() const { return connections_.size(); }
+
+  bool UsesIOUring() const {
+#ifdef CURRENT_PIPELINE_HAS_IO_URING
+    return static_cast<bool>(ring_);
+#else
+    return false;
+#endif  // CURRENT_PIPELINE_HAS_IO_URING
+  }
+
+  // Returns the number of bytes read into `[begin, end)`, always a positive multiple of `RECORD_SIZE`.
+  // Requires the room for at least one record.
+  size_t ReadInto(uint8_t* begin, uint8_t* end) {
+    const size_t room = static_cast<size_t>(end - begin) / RECORD_SIZE * RECORD_SIZE;
+#ifdef CURRENT_PIPELINE_HAS_IO_URING
+    if (ring_) {
+      return ReadIntoViaIOUring(begin, room);
+    }
+#endif  // CURRENT_PIPELINE_HAS_IO_URING
+    return ReadIntoViaPoll(begin, room);
+  }
+
+ private:
+  struct Input final {
+    SOCKET fd;
+    bool closed = false;
+    // The blocking backend: the leading bytes of the incomplete record.
+    uint8_t carry[RECORD_SIZE];
+    size_t carry_size = 0u;
+    // The io_uring backend: the bytes read into this input's part of `staging_`, but not yet returned.
+    uint8_t* staging = nullptr;
+    size_t staged_begin = 0u;
+    size_t staged_end = 0u;
+    bool in_flight = false;
+  };
+
+  static std::vector<net::Connection> SingleConnection(net::Connection&& connection) {
+    std::vector<net::Connection> result;
+    result.push_back(std::move(connection));
+    return result;
+  }
+
+  void MarkClosed(Input& input) {
+    if (!input.closed) {
+      input.closed = true;
+      --live_inputs_;
+    }
+  }
+
+  void ThrowIfAllClosed() const {
+    if (!live_inputs_) {
+      CURRENT_THROW(net::ConnectionResetByPeer());
+    }
+  }
+
+  // Reads whatever is available from one input, returning the number of bytes of whole records placed at `output`.
+  size_t RecvFrom(Input& input, uint8_t* output, size_t room) {
+    std::memcpy(output, input.carry, input.carry_size);
+#ifndef CURRENT_WINDOWS
+    const ssize_t retval = ::recv(input.fd, output + input.carry_size, room - input.carry_size, 0);
+#else
+    const int retval = ::recv(
+        input.fd, reinterpret_cast<char*>(output + input.carry_size), static_cast<int>(room - input.carry_size), 0);
+#endif  // CURRENT_WINDOWS
+    if (retval <= 0) {
+      if (retval < 0 && errno == EINTR) {
+        return 0u;  // LCOV_EXCL_LINE
+      }
+      if (retval < 0 && errno != ECONNRESET) {
+        CURRENT_THROW(net::SocketReadException());  // LCOV_EXCL_LINE
+      }
+      MarkClosed(input);
+      return 0u;
+    }
+    const size_t total = input.carry_size + static_cast<size_t>(retval);
+    const size_t whole = total / RECORD_SIZE * RECORD_SIZE;
+    input.carry_size = total - whole;
+    std::memcpy(input.carry, output + whole, input.carry_size);
+    return whole;
+  }
+
+  size_t ReadIntoViaPoll(uint8_t* output, size_t room) {
+    while (true) {
+      ThrowIfAllClosed();
+      if (inputs_.size() == 1u) {
+        // A single connection needs no `poll()`, the blocking `recv()` is enough.
+        const size_t result = RecvFrom(inputs_.front(), output, room);
+        if (result) {
+          return result;
+        }
+        continue;
+      }
+      poll_fds_.clear();
+      poll_fds_index_.clear();
+      for (size_t i = 0u; i < inputs_.size(); ++i) {
+        if (!inputs_[i].closed) {
+          pollfd p;
+          p.fd = inputs_[i].fd;
+          p.events = POLLIN;
+          p.revents = 0;
+          poll_fds_.push_back(p);
+          poll_fds_index_.push_back(i);
+        }
+      }
+#ifndef CURRENT_WINDOWS
+      const int ready = ::poll(poll_fds_.data(), poll_fds_.size(), -1);
+#else
+      const int ready = ::WSAPoll(poll_fds_.data(), static_cast<ULONG>(poll_fds_.size()), -1);
+#endif  // CURRENT_WINDOWS
+      if (ready < 0) {
+        if (errno == EINTR) {
+          continue;  // LCOV_EXCL_LINE
+        }
+        CURRENT_THROW(net::SocketReadException());  // LCOV_EXCL_LINE
+      }
+      size_t result = 0u;
+      for (size_t j = 0u; j < poll_fds_.size() && room - result >= RECORD_SIZE; ++j) {
+        if (poll_fds_[j].revents) {
+          result += RecvFrom(inputs_[poll_fds_index_[j]], output + result, room - result);
+        }
+      }
+      if (result) {
+        return result;
+      }
+    }
+  }
+
+#ifdef CURRENT_PIPELINE_HAS_IO_URING
+  void InitIOUring(size_t staging_buffer_size) {
+    // Round the staging buffer up to whole records, so that the compacted leftover always leaves room to read into.
+    staging_buffer_size_ = (staging_buffer_size + RECORD_SIZE - 1u) / RECORD_SIZE * RECORD_SIZE;
+    ring_ = IOUring::Create(static_cast<uint32_t>(std::max(inputs_.size(), size_t(1u))));
+    if (!ring_) {
+      return;  // LCOV_EXCL_LINE
+    }
+    staging_.resize(staging_buffer_size_ * inputs_.size());
+    std::vector<iovec> buffers;
+    for (size_t i = 0u; i < inputs_.size(); ++i) {
+      inputs_[i].staging = &staging_[i * staging_buffer_size_];
+      iovec buffer;
+      buffer.iov_base = inputs_[i].staging;
+      buffer.iov_len = staging_buffer_size_;
+      buffers.push_back(buffer);
+    }
+    registered_buffers_ = ring_->RegisterBuffers(buffers);
+  }
+
+  // Compacts what is left in the staging buffer of this input, and queues the read into the rest of it.
+  void PrepareReadIfIdle(size_t i) {
+    Input& input = inputs_[i];
+    if (input.closed || input.in_flight) {
+      return;
+    }
+    const size_t leftover = input.staged_end - input.staged_begin;
+    if (leftover && input.staged_begin) {
+      std::memmove(input.staging, input.staging + input.staged_begin, leftover);
+    }
+    input.staged_begin = 0u;
+    input.staged_end = leftover;
+    if (leftover < staging_buffer_size_) {
+      input.in_flight = ring_->PrepareRead(static_cast<int>(input.fd),
+                                           input.staging + leftover,
+                                           static_cast<uint32_t>(staging_buffer_size_ - leftover),
+                                           i,
+                                           registered_buffers_ ? static_cast<int>(i) : -1);
+    }
+  }
+
+  size_t ReadIntoViaIOUring(uint8_t* output, size_t room) {
+    while (true) {
+      ring_->ForEachCompletion([this](uint64_t i, int32_t res) {
+        Input& input = inputs_[i];
+        input.in_flight = false;
+        if (res > 0) {
+          input.staged_end += static_cast<size_t>(res);
+        } else if (res == 0 || res == -ECONNRESET) {
+          MarkClosed(input);
+        } else if (res != -EINTR && res != -EAGAIN) {
+          CURRENT_THROW(net::SocketReadException());  // LCOV_EXCL_LINE
+        }
+      });
+
+      // Hand out the whole records, starting from a different input every time, so that none of them starves.
+      size_t result = 0u;
+      for (size_t k = 0u; k < inputs_.size() && room - result >= RECORD_SIZE; ++k) {
+        Input& input = inputs_[(next_input_ + k) % inputs_.size()];
+        const size_t available = (input.staged_end - input.staged_begin) / RECORD_SIZE * RECORD_SIZE;
+        const size_t n = std::min(available, room - result);
+        std::memcpy(output + result, input.staging + input.staged_begin, n);
+        input.staged_begin += n;
+        result += n;
+      }
+      next_input_ = (next_input_ + 1u) % inputs_.size();
+
+      for (size_t i = 0u; i < inputs_.size(); ++i) {
+        PrepareReadIfIdle(i);
+      }
+      if (result) {
+        ring_->SubmitAndWait(0u);
+        return result;
+      }
+      ThrowIfAllClosed();
+      ring_->SubmitAndWait(1u);
+    }
+  }
+
+  std::unique_ptr<IOUring> ring_;
+  std::vector<uint8_t> staging_;
+  size_t staging_buffer_size_ = 0u;
+  bool registered_buffers_ = false;
+  size_t next_input_ = 0u;
+#else
+  void InitIOUring(size_t) {}
+#endif  // CURRENT_PIPELINE_HAS_IO_URING
+
+  std::vector<net::Connection> connections_;
+  std::vector<Input> inputs_;
+  size_t live_inputs_ = 0u;
+  std::vector<pollfd> poll_fds_;
+  std::vector<size_t> poll_fds_index_;
+
+  SocketFanInReader(const SocketFanInReader&) = delete;
+  SocketFanInReader& operator=(const SocketFanInReader&) = delete;
+};
+
+}  // namespace current::pipeline
+
+#endif  // BLOCKS_PIPELINE_SOCKET_IO_H
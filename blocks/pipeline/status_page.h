@@ -0,0 +1,135 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The HTTP status page of the running pipeline: the topology of the blocks, and how many blobs each has processed.
+// Serves HTML by default, JSON with `?json`, and the Graphviz source of the topology with `?dot`.
+// The processing rate is computed since the previous request to the page, and since the start for the first one.
+
+#ifndef BLOCKS_PIPELINE_STATUS_PAGE_H
+#define BLOCKS_PIPELINE_STATUS_PAGE_H
+
+#include <mutex>
+#include <sstream>
+
+#include "pipeline.h"
+
+#include "../http/api.h"
+
+#include "../../bricks/strings/join.h"
+#include "../../bricks/strings/printf.h"
+
+namespace current::pipeline {
+
+inline std::string PipelineStatusAsDOT(const PipelineStatus& status) {
+  std::ostringstream os;
+  os << "digraph Pipeline {\n";
+  for (const PipelineBlockStatus& block : status.blocks) {
+    os << "  b" << block.index << " [label=\"#" << block.index << ' ' << block.name << "\"";
+    if (block.is_source) {
+      os << ", shape=box";
+    }
+    os << "];\n";
+  }
+  for (const PipelineBlockStatus& block : status.blocks) {
+    if (!block.is_source) {
+      for (int32_t dep : block.deps) {
+        os << "  b" << dep << " -> b" << block.index << ";\n";
+      }
+    }
+  }
+  os << "}\n";
+  return os.str();
+}
+
+inline std::string PipelineStatusAsHTML(const PipelineStatus& status, const PipelineStatus* previous) {
+  const auto EscapeHTML = [](const std::string& s) {
+    std::string result;
+    for (char c : s) {
+      if (c == '<') {
+        result += "&lt;";
+      } else if (c == '>') {
+        result += "&gt;";
+      } else if (c == '&') {
+        result += "&amp;";
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  };
+
+  const std::chrono::microseconds dt = previous ? (status.now - previous->now) : (status.now - status.started);
+  const double dt_seconds = 1e-6 * static_cast<double>(dt.count());
+
+  std::ostringstream os;
+  os << "<!doctype html>\n<html><head><title>Pipeline</title><meta http-equiv='refresh' content='1'></head><body>\n";
+  os << "<p>Circular buffer: " << status.circular_buffer_blobs << " blobs of " << status.blob_size << " bytes, "
+     << (status.busy_poll ? "busy-polling" : "futex-waiting") << ", up for "
+     << current::strings::Printf("%.1lf", 1e-6 * static_cast<double>((status.now - status.started).count()))
+     << " seconds.</p>\n";
+  os << "<table border=1 cellpadding=4>\n"
+     << "<tr><th>#</th><th>Block</th><th>Waits for</th><th>Processed</th><th>Blobs per second</th><th>CPU</th></tr>\n";
+  for (size_t i = 0; i < status.blocks.size(); ++i) {
+    const PipelineBlockStatus& block = status.blocks[i];
+    const uint64_t previously_processed = previous ? previous->blocks[i].processed : 0u;
+    const double rate =
+        dt_seconds > 0 ? static_cast<double>(block.processed - previously_processed) / dt_seconds : 0.0;
+    os << "<tr><td>" << block.index << "</td><td>" << (block.is_source ? "<b>" : "") << EscapeHTML(block.name)
+       << (block.is_source ? "</b>" : "") << "</td><td>"
+       << current::strings::Join(block.deps, ", ") << "</td><td>" << block.processed << "</td><td>"
+       << current::strings::Printf("%.0lf", rate) << "</td><td>" << (block.cpu >= 0 ? std::to_string(block.cpu) : "")
+       << "</td></tr>\n";
+  }
+  os << "</table>\n</body></html>\n";
+  return os.str();
+}
+
+// Registers the status page of the running pipeline. Keep the returned scope for as long as the page should be served.
+template <class CONTEXT>
+HTTPRoutesScopeEntry RegisterPipelineStatusPage(uint16_t port, const std::string& route, CONTEXT context) {
+  struct PreviousStatus final {
+    std::mutex mutex;
+    Optional<PipelineStatus> status;
+  };
+  auto previous = std::make_shared<PreviousStatus>();
+  return HTTP(current::net::BarePort(port)).Register(route, [context, previous](Request r) {
+    const PipelineStatus status = context.Status();
+    if (r.url.query.has("json")) {
+      r(status);
+    } else if (r.url.query.has("dot")) {
+      r(PipelineStatusAsDOT(status));
+    } else {
+      std::lock_guard<std::mutex> lock(previous->mutex);
+      r(PipelineStatusAsHTML(status, Exists(previous->status) ? &Value(previous->status) : nullptr),
+        HTTPResponseCode.OK,
+        net::http::Headers(),
+        net::constants::kDefaultHTMLContentType);
+      previous->status = status;
+    }
+  });
+}
+
+}  // namespace current::pipeline
+
+#endif  // BLOCKS_PIPELINE_STATUS_PAGE_H
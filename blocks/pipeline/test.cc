@@ -24,23 +24,24 @@ SOFTWARE.
 
 #include <array>
 
-#include "dsl.h"
+#include "pipeline.h"
+#include "socket_io.h"
+#include "status_page.h"
 
-#include "../../../../3rdparty/gtest/gtest-main.h"
-#include "../../../../bricks/strings/join.h"
+#include "../../3rdparty/gtest/gtest-main.h"
+#include "../../bricks/strings/join.h"
 
-#ifndef CURRENT_FOR_CPP14  // NOTE(dkorolev): Excluding this part from the C++14 version of Current.
-
-namespace current::examples::streamed_sockets {
+namespace pipeline_test {
 struct SourceA {};
 struct SourceB {};
 struct WorkerX {};
 struct WorkerY {};
 struct WorkerZ {};
-}  // namespace current::examples::streamed_sockets
+}  // namespace pipeline_test
 
-TEST(NextRipcurrent, SequentialProcessingTypes) {
-  using namespace current::examples::streamed_sockets;
+TEST(Pipeline, SequentialProcessingTypes) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
 
   const auto source_a = BlockSource<SourceA>();
   const auto source_b = BlockSource<SourceB>();
@@ -48,13 +49,16 @@ TEST(NextRipcurrent, SequentialProcessingTypes) {
   const auto worker_y = BlockWorker<WorkerY>();
   const auto worker_z = BlockWorker<WorkerZ>();
 
-  static_assert(sizeof(is_same_or_compile_error<PipelineImpl<SourceA, TypeListImpl<PipelineWorker<1, 1, 1, WorkerX>>>,
-                                                decltype(Pipeline(source_a, worker_x))>));
-
   static_assert(
       sizeof(is_same_or_compile_error<
-             PipelineImpl<SourceB, TypeListImpl<PipelineWorker<1, 1, 1, WorkerY>, PipelineWorker<2, 2, 2, WorkerZ>>>,
-             decltype(Pipeline(source_b, worker_y, worker_z))>));
+             PipelineImpl<SourceA, TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>>, PipelineDeps<1>>,
+             decltype(Pipeline(source_a, worker_x))>));
+
+  static_assert(sizeof(is_same_or_compile_error<PipelineImpl<SourceB,
+                                                             TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerY>,
+                                                                          PipelineWorker<2, PipelineDeps<1>, WorkerZ>>,
+                                                             PipelineDeps<2>>,
+                                                decltype(Pipeline(source_b, worker_y, worker_z))>));
 
   {
     auto const pipeline = Pipeline(source_a, worker_x);
@@ -119,8 +123,9 @@ TEST(NextRipcurrent, SequentialProcessingTypes) {
   }
 }
 
-TEST(NextRipcurrent, ParallelProcessingTypes) {
-  using namespace current::examples::streamed_sockets;
+TEST(Pipeline, ParallelProcessingTypes) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
 
   const auto source_a = BlockSource<SourceA>();
   const auto worker_x = BlockWorker<WorkerX>();
@@ -128,18 +133,21 @@ TEST(NextRipcurrent, ParallelProcessingTypes) {
   const auto worker_z = BlockWorker<WorkerZ>();
 
   // Some inner-level template expansion specs.
-  static_assert(
-      sizeof(is_same_or_compile_error<ParallelPipelineWrapper<WorkerX>, decltype(ParallelPipeline(worker_x))>));
+  static_assert(sizeof(
+      is_same_or_compile_error<ParallelStage<BlockWorker<WorkerX>>, decltype(ParallelPipeline(worker_x))>));
 
-  static_assert(sizeof(is_same_or_compile_error<ParallelPipelineWrapper<WorkerX, WorkerY>,
+  static_assert(sizeof(is_same_or_compile_error<ParallelStage<BlockWorker<WorkerX>, BlockWorker<WorkerY>>,
                                                 decltype(ParallelPipeline(worker_x, worker_y))>));
 
-  static_assert(sizeof(is_same_or_compile_error<ParallelPipelineWrapper<WorkerX, WorkerY, WorkerZ>,
-                                                decltype(ParallelPipeline(worker_x, worker_y, worker_z))>));
+  static_assert(
+      sizeof(is_same_or_compile_error<ParallelStage<BlockWorker<WorkerX>, BlockWorker<WorkerY>, BlockWorker<WorkerZ>>,
+                                      decltype(ParallelPipeline(worker_x, worker_y, worker_z))>));
 
-  // Wrapping a single worker into `ParallelPipeline` does nothing.
+  // Wrapping a single worker into `ParallelPipeline` or `SequentialPipeline` does nothing.
   static_assert(sizeof(is_same_or_compile_error<decltype(Pipeline(source_a, worker_x)),
                                                 decltype(Pipeline(source_a, ParallelPipeline(worker_x)))>));
+  static_assert(sizeof(is_same_or_compile_error<decltype(Pipeline(source_a, worker_x)),
+                                                decltype(Pipeline(source_a, SequentialPipeline(worker_x)))>));
   static_assert(sizeof(is_same_or_compile_error<decltype(Pipeline(source_a, worker_x, worker_y)),
                                                 decltype(Pipeline(source_a, ParallelPipeline(worker_x), worker_y))>));
   static_assert(sizeof(is_same_or_compile_error<decltype(Pipeline(source_a, worker_x, worker_y)),
@@ -147,42 +155,84 @@ TEST(NextRipcurrent, ParallelProcessingTypes) {
   static_assert(sizeof(
       is_same_or_compile_error<decltype(Pipeline(source_a, worker_x, worker_y)),
                                decltype(Pipeline(source_a, ParallelPipeline(worker_x), ParallelPipeline(worker_y)))>));
+  static_assert(sizeof(is_same_or_compile_error<decltype(Pipeline(source_a, worker_x, worker_y)),
+                                                decltype(Pipeline(source_a, SequentialPipeline(worker_x, worker_y)))>));
 
   // Now the test cases of actual parallellism.
-  static_assert(
-      sizeof(is_same_or_compile_error<
-             PipelineImpl<SourceA, TypeListImpl<PipelineWorker<1, 1, 2, WorkerX>, PipelineWorker<2, 1, 2, WorkerY>>>,
-             decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y)))>));
+  static_assert(sizeof(is_same_or_compile_error<
+                       PipelineImpl<SourceA,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<0>, WorkerY>>,
+                                    PipelineDeps<1, 2>>,
+                       decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y)))>));
 
-  static_assert(
-      sizeof(is_same_or_compile_error<PipelineImpl<SourceA,
-                                                   TypeListImpl<PipelineWorker<1, 1, 2, WorkerX>,
-                                                                PipelineWorker<2, 1, 2, WorkerY>,
-                                                                PipelineWorker<3, 3, 3, WorkerZ>>>,
-                                      decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y), worker_z))>));
+  static_assert(sizeof(is_same_or_compile_error<
+                       PipelineImpl<SourceA,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<0>, WorkerY>,
+                                                 PipelineWorker<3, PipelineDeps<1, 2>, WorkerZ>>,
+                                    PipelineDeps<3>>,
+                       decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y), worker_z))>));
 
-  static_assert(
-      sizeof(is_same_or_compile_error<PipelineImpl<SourceA,
-                                                   TypeListImpl<PipelineWorker<1, 1, 1, WorkerX>,
-                                                                PipelineWorker<2, 2, 3, WorkerY>,
-                                                                PipelineWorker<3, 2, 3, WorkerZ>>>,
-                                      decltype(Pipeline(source_a, worker_x, ParallelPipeline(worker_y, worker_z)))>));
+  static_assert(sizeof(is_same_or_compile_error<
+                       PipelineImpl<SourceA,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<1>, WorkerY>,
+                                                 PipelineWorker<3, PipelineDeps<1>, WorkerZ>>,
+                                    PipelineDeps<2, 3>>,
+                       decltype(Pipeline(source_a, worker_x, ParallelPipeline(worker_y, worker_z)))>));
 
-  static_assert(
-      sizeof(is_same_or_compile_error<PipelineImpl<SourceA,
-                                                   TypeListImpl<PipelineWorker<1, 1, 3, WorkerX>,
-                                                                PipelineWorker<2, 1, 3, WorkerY>,
-                                                                PipelineWorker<3, 1, 3, WorkerZ>>>,
-                                      decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y, worker_z)))>));
+  static_assert(sizeof(is_same_or_compile_error<
+                       PipelineImpl<SourceA,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<0>, WorkerY>,
+                                                 PipelineWorker<3, PipelineDeps<0>, WorkerZ>>,
+                                    PipelineDeps<1, 2, 3>>,
+                       decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y, worker_z)))>));
 
   static_assert(sizeof(is_same_or_compile_error<
                        PipelineImpl<SourceA,
-                                    TypeListImpl<PipelineWorker<1, 1, 1, WorkerX>,
-                                                 PipelineWorker<2, 2, 3, WorkerY>,
-                                                 PipelineWorker<3, 2, 3, WorkerZ>,
-                                                 PipelineWorker<4, 4, 4, WorkerX>>>,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<1>, WorkerY>,
+                                                 PipelineWorker<3, PipelineDeps<1>, WorkerZ>,
+                                                 PipelineWorker<4, PipelineDeps<2, 3>, WorkerX>>,
+                                    PipelineDeps<4>>,
                        decltype(Pipeline(source_a, worker_x, ParallelPipeline(worker_y, worker_z), worker_x))>));
 
+  // Nesting `ParallelPipeline` within `ParallelPipeline` is the same as flattening it.
+  static_assert(
+      sizeof(is_same_or_compile_error<decltype(Pipeline(source_a, ParallelPipeline(worker_x, worker_y, worker_z))),
+                                      decltype(Pipeline(source_a,
+                                                        ParallelPipeline(worker_x,
+                                                                         ParallelPipeline(worker_y, worker_z))))>));
+
+  // And `SequentialPipeline` within `ParallelPipeline` is what makes the dependencies non-trivial.
+  static_assert(sizeof(is_same_or_compile_error<
+                       PipelineImpl<SourceA,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<1>, WorkerY>,
+                                                 PipelineWorker<3, PipelineDeps<0>, WorkerZ>,
+                                                 PipelineWorker<4, PipelineDeps<2, 3>, WorkerX>>,
+                                    PipelineDeps<4>>,
+                       decltype(Pipeline(source_a,
+                                         ParallelPipeline(SequentialPipeline(worker_x, worker_y), worker_z),
+                                         worker_x))>));
+
+  static_assert(sizeof(is_same_or_compile_error<
+                       PipelineImpl<SourceA,
+                                    TypeListImpl<PipelineWorker<1, PipelineDeps<0>, WorkerX>,
+                                                 PipelineWorker<2, PipelineDeps<1>, WorkerY>,
+                                                 PipelineWorker<3, PipelineDeps<1>, WorkerZ>,
+                                                 PipelineWorker<4, PipelineDeps<3>, WorkerX>,
+                                                 PipelineWorker<5, PipelineDeps<0>, WorkerY>>,
+                                    PipelineDeps<2, 4, 5>>,
+                       decltype(Pipeline(source_a,
+                                         ParallelPipeline(SequentialPipeline(worker_x,
+                                                                             ParallelPipeline(worker_y,
+                                                                                              SequentialPipeline(
+                                                                                                  worker_z, worker_x))),
+                                                          worker_y)))>));
+
   // First, the "simple" case, where the parallel part is in the middle.
   // It is simple, because the parallelism is neither immediately before nor immediately after the source.
   {
@@ -425,7 +475,9 @@ TEST(NextRipcurrent, ParallelProcessingTypes) {
   }
 }
 
-namespace current::examples::streamed_sockets {
+namespace pipeline_test {
+
+using namespace current::pipeline;
 
 struct TestBlob final {
   uint64_t x[4];
@@ -442,9 +494,9 @@ struct TestBlobSource final {
   const std::array<uint64_t, 4> delta;
   TestBlob blob;
   TestBlobSource(std::array<uint64_t, 4> init, std::array<uint64_t, 4> delta) : value(init), delta(delta) {
-    Singleton<TestObjectsLifetimeTracker>().log.push_back("Source()");
+    current::Singleton<TestObjectsLifetimeTracker>().log.push_back("Source()");
   }
-  ~TestBlobSource() { Singleton<TestObjectsLifetimeTracker>().log.push_back("~Source()"); }
+  ~TestBlobSource() { current::Singleton<TestObjectsLifetimeTracker>().log.push_back("~Source()"); }
   size_t DoGetInput(uint8_t* begin, uint8_t* end) {
     const size_t count = (end - begin) / sizeof(TestBlob);
     TestBlob* ptr = reinterpret_cast<TestBlob*>(begin);
@@ -464,10 +516,10 @@ struct TestBlobCollector final {
   int bar = 200;  // For the test to make sure just one instance of `TestBlobCollector` is created per pipeline block.
   std::vector<uint64_t>& output;
   explicit TestBlobCollector(std::vector<uint64_t>& output) : output(output) {
-    Singleton<TestObjectsLifetimeTracker>().log.push_back(current::strings::Printf("Collector(%d)", I));
+    current::Singleton<TestObjectsLifetimeTracker>().log.push_back(current::strings::Printf("Collector(%d)", I));
   }
   ~TestBlobCollector() {
-    Singleton<TestObjectsLifetimeTracker>().log.push_back(current::strings::Printf("~Collector(%d)", I));
+    current::Singleton<TestObjectsLifetimeTracker>().log.push_back(current::strings::Printf("~Collector(%d)", I));
   }
   TestBlob* DoWork(TestBlob* begin, TestBlob* end) {
     while (begin != end) {
@@ -483,11 +535,11 @@ struct TestBlobModifier final {
   const uint64_t k;
   const uint64_t b;
   TestBlobModifier(size_t i, uint64_t k, uint64_t b) : i(i), k(k), b(b) {
-    Singleton<TestObjectsLifetimeTracker>().log.push_back(
+    current::Singleton<TestObjectsLifetimeTracker>().log.push_back(
         current::strings::Printf("Modifier(%d, %d, %d)", int(i), int(k), int(b)));
   }
   ~TestBlobModifier() {
-    Singleton<TestObjectsLifetimeTracker>().log.push_back(
+    current::Singleton<TestObjectsLifetimeTracker>().log.push_back(
         current::strings::Printf("~Modifier(%d, %d, %d)", int(i), int(k), int(b)));
   }
   TestBlob* DoWork(TestBlob* begin, TestBlob* end) {
@@ -637,10 +689,11 @@ void RunProcessingTest(std::array<uint64_t, 4>& init,
       current::strings::Join(current::Singleton<TestObjectsLifetimeTracker>().log, ' '));
 }
 
-}  // namespace current::examples::streamed_sockets
+}  // namespace pipeline_test
 
-TEST(NextRipcurrent, SequentialProcessing) {
-  using namespace current::examples::streamed_sockets;
+TEST(Pipeline, SequentialProcessing) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
 
   current::Singleton<TestObjectsLifetimeTracker>().Reset();
   std::array<uint64_t, 4> init;
@@ -656,8 +709,9 @@ TEST(NextRipcurrent, SequentialProcessing) {
                              BlockWorker<TestBlobCollector<3>>(std::ref(output[3]))));
 }
 
-TEST(NextRipcurrent, ParallelProcessing) {
-  using namespace current::examples::streamed_sockets;
+TEST(Pipeline, ParallelProcessing) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
 
   current::Singleton<TestObjectsLifetimeTracker>().Reset();
   std::array<uint64_t, 4> init;
@@ -673,8 +727,9 @@ TEST(NextRipcurrent, ParallelProcessing) {
                                               BlockWorker<TestBlobCollector<3>>(std::ref(output[3])))));
 }
 
-TEST(NextRipcurrent, ProcessingLogicSmokeTest) {
-  using namespace current::examples::streamed_sockets;
+TEST(Pipeline, ProcessingLogicSmokeTest) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
 
   {
     std::vector<uint64_t> output;
@@ -713,4 +768,214 @@ TEST(NextRipcurrent, ProcessingLogicSmokeTest) {
   }
 }
 
-#endif  // CURRENT_FOR_CPP14
+TEST(Pipeline, NestedProcessing) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
+
+  // The two branches run in parallel, and each branch is sequential. The collectors at the very end
+  // should only see the blobs once both branches are done with them.
+  std::vector<uint64_t> output0;
+  std::vector<uint64_t> output1;
+  auto context = Pipeline(BlockSource<TestBlobSource>(std::array<uint64_t, 4>({0, 0, 0, 0}),
+                                                      std::array<uint64_t, 4>({1, 1, 1, 1})),
+                          ParallelPipeline(SequentialPipeline(BlockWorker<TestBlobModifier>(0, 2, 100),
+                                                              BlockWorker<TestBlobModifier>(0, 2, 100)),
+                                           SequentialPipeline(BlockWorker<TestBlobModifier>(1, 3, 1),
+                                                              ParallelPipeline(BlockWorker<TestBlobModifier>(2, 5, 0),
+                                                                               BlockWorker<TestBlobModifier>(3, 7, 0)),
+                                                              BlockWorker<TestBlobModifier>(1, 3, 1))),
+                          ParallelPipeline(BlockWorker<TestBlobCollector<0>>(std::ref(output0)),
+                                           BlockWorker<TestBlobCollector<1>>(std::ref(output1))))
+                     .Run(PipelineRunParams<TestBlob>());
+  EXPECT_EQ(9u, context.N);
+  while (context.GrandTotalProcessedCount() < 1000u) {
+    std::this_thread::yield();
+  }
+  context.ForceStop();
+
+  ASSERT_GE(output0.size(), 1000u);
+  ASSERT_GE(output1.size(), 1000u);
+  for (size_t i = 0; i < 1000u; ++i) {
+    ASSERT_EQ(i * 4 + 300, output0[i]);
+    ASSERT_EQ(i * 9 + 4, output1[i]);
+  }
+}
+
+TEST(Pipeline, BusyPollAndCPUPinning) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
+
+  std::vector<uint64_t> output;
+  auto context = Pipeline(BlockSource<TestBlobSource>(std::array<uint64_t, 4>({0, 0, 0, 0}),
+                                                      std::array<uint64_t, 4>({1, 1, 1, 1})),
+                          BlockWorker<TestBlobModifier>(0, 2, 100),
+                          BlockWorker<TestBlobCollector<0>>(std::ref(output)))
+                     .Run(PipelineRunParams<TestBlob>()
+                              .SetWaitPolicy(PipelineWaitPolicy::BusyPoll)
+                              .PinBlockToCPU(0, 0)
+                              .PinBlockToCPU(2, 0));
+  while (context.GrandTotalProcessedCount() < 1000u) {
+    std::this_thread::yield();
+  }
+
+  const PipelineStatus status = context.Status();
+  context.ForceStop();
+
+  ASSERT_GE(output.size(), 1000u);
+  for (size_t i = 0; i < 1000u; ++i) {
+    ASSERT_EQ(i * 2 + 100, output[i]);
+  }
+
+  EXPECT_TRUE(status.busy_poll);
+  ASSERT_EQ(3u, status.blocks.size());
+  EXPECT_TRUE(status.blocks[0].is_source);
+  EXPECT_EQ("pipeline_test::TestBlobSource", status.blocks[0].name);
+  EXPECT_EQ("2", current::strings::Join(status.blocks[0].deps, ','));
+  EXPECT_EQ("pipeline_test::TestBlobModifier", status.blocks[1].name);
+  EXPECT_EQ("0", current::strings::Join(status.blocks[1].deps, ','));
+  EXPECT_EQ(-1, status.blocks[1].cpu);
+  EXPECT_EQ("1", current::strings::Join(status.blocks[2].deps, ','));
+  EXPECT_GE(status.blocks[2].processed, 1000u);
+#ifdef CURRENT_POSIX
+  EXPECT_EQ(0, status.blocks[0].cpu);
+  EXPECT_EQ(0, status.blocks[2].cpu);
+#endif
+}
+
+TEST(Pipeline, StatusPage) {
+  using namespace current::pipeline;
+  using namespace pipeline_test;
+
+  std::vector<uint64_t> output;
+  auto context = Pipeline(BlockSource<TestBlobSource>(std::array<uint64_t, 4>({0, 0, 0, 0}),
+                                                      std::array<uint64_t, 4>({1, 1, 1, 1})),
+                          ParallelPipeline(BlockWorker<TestBlobModifier>(0, 2, 100),
+                                           BlockWorker<TestBlobModifier>(1, 2, 100)),
+                          BlockWorker<TestBlobCollector<0>>(std::ref(output)))
+                     .Run(PipelineRunParams<TestBlob>());
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  const auto http_server_scope = HTTP(std::move(reserved_port)).Register("/ok", [](Request r) { r("OK"); });
+  const auto scope = RegisterPipelineStatusPage(port, "/status", context);
+
+  while (context.GrandTotalProcessedCount() < 100u) {
+    std::this_thread::yield();
+  }
+
+  const std::string url = current::strings::Printf("http://localhost:%d/status", port);
+  const auto html = HTTP(GET(url));
+  EXPECT_EQ(200, static_cast<int>(html.code));
+  EXPECT_NE(std::string::npos, html.body.find("pipeline_test::TestBlobCollector&lt;0&gt;"));
+
+  const auto json = HTTP(GET(url + "?json"));
+  EXPECT_EQ(200, static_cast<int>(json.code));
+  const auto status = ParseJSON<PipelineStatus>(json.body);
+  ASSERT_EQ(4u, status.blocks.size());
+  EXPECT_EQ("1,2", current::strings::Join(status.blocks[3].deps, ','));
+
+  EXPECT_EQ(
+      "digraph Pipeline {\n"
+      "  b0 [label=\"#0 pipeline_test::TestBlobSource\", shape=box];\n"
+      "  b1 [label=\"#1 pipeline_test::TestBlobModifier\"];\n"
+      "  b2 [label=\"#2 pipeline_test::TestBlobModifier\"];\n"
+      "  b3 [label=\"#3 pipeline_test::TestBlobCollector<0>\"];\n"
+      "  b0 -> b1;\n"
+      "  b0 -> b2;\n"
+      "  b1 -> b3;\n"
+      "  b2 -> b3;\n"
+      "}\n",
+      HTTP(GET(url + "?dot")).body);
+
+  context.ForceStop();
+}
+
+namespace pipeline_test {
+
+struct TestSocketRecord {
+  uint64_t connection;
+  uint64_t sequence;
+};
+
+inline void RunSocketFanInTest(current::pipeline::SocketReadBackend backend) {
+  using namespace current::pipeline;
+
+  constexpr size_t kConnections = 3u;
+  constexpr size_t kRecordsPerConnection = 10000u;
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  current::net::Socket socket(std::move(reserved_port));
+
+  std::vector<std::thread> senders;
+  for (size_t c = 0u; c < kConnections; ++c) {
+    senders.emplace_back([port, c]() {
+      std::vector<TestSocketRecord> records(kRecordsPerConnection);
+      for (size_t i = 0u; i < kRecordsPerConnection; ++i) {
+        records[i].connection = c;
+        records[i].sequence = i;
+      }
+      current::net::Connection connection(current::net::ClientSocket("localhost", port));
+      // Send in chunks that split the records, to make sure the reader never does.
+      const uint8_t* ptr = reinterpret_cast<const uint8_t*>(records.data());
+      const uint8_t* end = ptr + records.size() * sizeof(TestSocketRecord);
+      size_t chunk = 7u + c;
+      while (ptr < end) {
+        const size_t n = std::min(chunk, static_cast<size_t>(end - ptr));
+        connection.BlockingWrite(ptr, n, false);
+        ptr += n;
+        chunk = (chunk * 3u) % 10007u + 1u;
+      }
+    });
+  }
+
+  std::vector<current::net::Connection> connections;
+  for (size_t c = 0u; c < kConnections; ++c) {
+    connections.push_back(socket.Accept());
+  }
+  SocketFanInReader<sizeof(TestSocketRecord)> reader(std::move(connections), backend, 1000u);
+  EXPECT_EQ(kConnections, reader.ConnectionsCount());
+  if (backend == SocketReadBackend::Blocking) {
+    EXPECT_FALSE(reader.UsesIOUring());
+  } else if (!reader.UsesIOUring()) {
+    std::cerr << "NOTE: io_uring is not available, tested the fallback instead.\n";
+  }
+
+  std::vector<uint64_t> next(kConnections);
+  std::vector<TestSocketRecord> buffer(1000u);
+  size_t total = 0u;
+  while (total < kConnections * kRecordsPerConnection) {
+    uint8_t* begin = reinterpret_cast<uint8_t*>(buffer.data());
+    // An odd-sized room, as the buffer passed by the pipeline to its source does not have to be whole records.
+    const size_t bytes = reader.ReadInto(begin, begin + (1u + total % buffer.size()) * sizeof(TestSocketRecord) + 5u);
+    ASSERT_EQ(0u, bytes % sizeof(TestSocketRecord));
+    ASSERT_LT(0u, bytes);
+    for (size_t i = 0u; i < bytes / sizeof(TestSocketRecord); ++i) {
+      ASSERT_LT(buffer[i].connection, kConnections);
+      ASSERT_EQ(next[buffer[i].connection], buffer[i].sequence);
+      ++next[buffer[i].connection];
+    }
+    total += bytes / sizeof(TestSocketRecord);
+  }
+  for (size_t c = 0u; c < kConnections; ++c) {
+    EXPECT_EQ(kRecordsPerConnection, next[c]);
+  }
+
+  for (auto& sender : senders) {
+    sender.join();
+  }
+  uint8_t dummy[sizeof(TestSocketRecord)];
+  ASSERT_THROW(reader.ReadInto(dummy, dummy + sizeof(dummy)), current::net::ConnectionResetByPeer);
+}
+
+}  // namespace pipeline_test
+
+TEST(Pipeline, SocketFanInBlocking) {
+  pipeline_test::RunSocketFanInTest(current::pipeline::SocketReadBackend::Blocking);
+}
+
+#ifdef CURRENT_PIPELINE_HAS_IO_URING
+TEST(Pipeline, SocketFanInIOUring) {
+  pipeline_test::RunSocketFanInTest(current::pipeline::SocketReadBackend::IOUring);
+}
+#endif  // CURRENT_PIPELINE_HAS_IO_URING
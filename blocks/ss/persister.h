@@ -31,6 +31,7 @@ SOFTWARE.
 #define BLOCKS_SS_PERSISTER_H
 
 #include <type_traits>
+#include <vector>
 
 #include "idx_ts.h"
 #include "types.h"
@@ -71,16 +72,17 @@ class EntryPersister : public GenericEntryPersister<ENTRY>, public IMPL {
   }
 
   // Publishes the `raw_log_line` as is without parsing and validating its content.
+  // The index and the timestamp are the ones in the `raw_log_line` itself.
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
-  idxts_t PublishUnsafe(const std::string& raw_log_line,
-                        current::time::DefaultTimeArgument = current::time::DefaultTimeArgument()) {
-    return IMPL::template PersisterPublishUnsafeImpl<MLS>(raw_log_line, current::time::DefaultTimeArgument());
+  idxts_t PublishUnsafe(const std::string& raw_log_line) {
+    return IMPL::template PersisterPublishUnsafeImpl<MLS>(raw_log_line);
   }
 
-  // Publishes the `raw_log_line` as is without parsing and validating its content.
+  // Publishes the `raw_log_lines` in bulk, as `PublishUnsafe` would publish them one by one, but under a single lock.
+  // Returns the index and the timestamp of the last line.
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
-  idxts_t PublishUnsafe(const std::string& raw_log_line, std::chrono::microseconds us) {
-    return IMPL::template PersisterPublishUnsafeImpl<MLS>(raw_log_line, us);
+  idxts_t PublishUnsafeBatch(const std::vector<std::string>& raw_log_lines) {
+    return IMPL::template PersisterPublishUnsafeBatchImpl<MLS>(raw_log_lines);
   }
 
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
@@ -26,7 +26,11 @@ SOFTWARE.
 #ifndef BLOCKS_SS_PUBSUB_H
 #define BLOCKS_SS_PUBSUB_H
 
+#include <chrono>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include "../../port.h"
 
@@ -80,6 +84,11 @@ class EntryPublisher : public GenericEntryPublisher<ENTRY>, public IMPL {
     return IMPL::template PublisherPublishUnsafeImpl<MLS>(raw_log_line);
   }
 
+  template <MutexLockStatus MLS = MutexLockStatus::NeedToLock>
+  idxts_t PublishUnsafeBatch(const std::vector<std::string>& raw_log_lines) {
+    return IMPL::template PublisherPublishUnsafeBatchImpl<MLS>(raw_log_lines);
+  }
+
   template <MutexLockStatus MLS = MutexLockStatus::NeedToLock>
   void UpdateHead() {
     IMPL::template PublisherUpdateHeadImpl<MLS>(current::time::DefaultTimeArgument());
@@ -123,6 +132,58 @@ struct IsStreamPublisher {
 enum class EntryResponse { Done = 0, More = 1 };
 enum class TerminationResponse { Wait = 0, Terminate = 1 };
 
+// The entry along with its index and timestamp, as passed to the subscribers that accept batches of entries.
+template <typename ENTRY>
+struct IndexedEntry {
+  idxts_t idx_ts;
+  ENTRY entry;
+};
+
+// A contiguous range of `IndexedEntry<ENTRY>`-s, a poor man's `std::span`.
+// The entries are owned by the caller and are only valid for the duration of the call. They can be moved from.
+template <typename ENTRY>
+class EntriesBatch {
+ public:
+  EntriesBatch(IndexedEntry<ENTRY>* begin, size_t size) : begin_(begin), size_(size) {}
+
+  IndexedEntry<ENTRY>* begin() const { return begin_; }
+  IndexedEntry<ENTRY>* end() const { return begin_ + size_; }
+  size_t size() const { return size_; }
+  bool empty() const { return !size_; }
+  IndexedEntry<ENTRY>& operator[](size_t i) const { return begin_[i]; }
+  IndexedEntry<ENTRY>& front() const { return begin_[0]; }
+  IndexedEntry<ENTRY>& back() const { return begin_[size_ - 1u]; }
+
+ private:
+  IndexedEntry<ENTRY>* begin_;
+  size_t size_;
+};
+
+// How do the subscribers accepting `EntriesBatch<ENTRY>` want their batches formed.
+// A subscriber can override the defaults by exposing `ss::BatchingPolicy GetBatchingPolicy() const`.
+struct BatchingPolicy {
+  // No more than this many entries are passed in one call.
+  size_t max_batch_size = 1024u;
+  // If fewer than `max_batch_size` entries are available, the caller may wait up to this long for more of them.
+  // The default of zero means the subscriber gets whatever is available right away.
+  std::chrono::microseconds max_linger = std::chrono::microseconds(0);
+
+  BatchingPolicy() = default;
+  BatchingPolicy(size_t max_batch_size, std::chrono::microseconds max_linger = std::chrono::microseconds(0))
+      : max_batch_size(max_batch_size), max_linger(max_linger) {}
+};
+
+namespace impl {
+
+template <typename IMPL, typename = void>
+struct HasBatchingPolicy : std::false_type {};
+
+template <typename IMPL>
+struct HasBatchingPolicy<IMPL, std::void_t<decltype(std::declval<const IMPL&>().GetBatchingPolicy())>>
+    : std::true_type {};
+
+}  // namespace impl
+
 struct GenericSubscriber {};
 
 template <typename ENTRY>
@@ -131,6 +192,12 @@ struct GenericEntrySubscriber : GenericSubscriber {};
 template <typename IMPL, typename ENTRY>
 class EntrySubscriber : public GenericEntrySubscriber<ENTRY>, public IMPL {
  public:
+  // Whether `IMPL` has opted into receiving the entries in batches. See `IsBatchEntrySubscriber` below.
+  constexpr static bool accepts_entries_batch =
+      std::is_invocable_r_v<EntryResponse, IMPL&, EntriesBatch<ENTRY>, idxts_t>;
+  constexpr static bool accepts_raw_log_lines_batch =
+      std::is_invocable_r_v<EntryResponse, IMPL&, std::vector<std::string>&&, uint64_t, idxts_t>;
+
   template <typename... ARGS>
   EntrySubscriber(ARGS&&... args) : IMPL(std::forward<ARGS>(args)...) {}
   virtual ~EntrySubscriber() {}
@@ -139,11 +206,55 @@ class EntrySubscriber : public GenericEntrySubscriber<ENTRY>, public IMPL {
   EntryResponse operator()(const std::string& raw_log_line, uint64_t current_index, idxts_t last) {
     return IMPL::operator()(raw_log_line, current_index, last);
   }
+  // The zero-copy raw log line, as exposed by the unsafe iterators of the persisters.
+  // Only the subscribers that accept `std::string_view` get it as is, the rest get an `std::string` copy.
+  EntryResponse operator()(std::string_view raw_log_line, uint64_t current_index, idxts_t last) {
+    if constexpr (std::is_invocable_r_v<EntryResponse, IMPL&, std::string_view, uint64_t, idxts_t>) {
+      return IMPL::operator()(raw_log_line, current_index, last);
+    } else {
+      return IMPL::operator()(std::string(raw_log_line), current_index, last);
+    }
+  }
   EntryResponse operator()(ENTRY&& e, idxts_t current, idxts_t last) {
     return IMPL::operator()(std::move(e), current, last);
   }
+  // The batch of raw log lines, the first of which has the index of `first_index`, as received by the replication.
+  // Only the subscribers that accept the whole batch get it as is, the rest get the lines one by one.
+  EntryResponse operator()(std::vector<std::string>&& raw_log_lines, uint64_t first_index, idxts_t last) {
+    if constexpr (std::is_invocable_r_v<EntryResponse, IMPL&, std::vector<std::string>&&, uint64_t, idxts_t>) {
+      return IMPL::operator()(std::move(raw_log_lines), first_index, last);
+    } else {
+      for (auto& raw_log_line : raw_log_lines) {
+        if (IMPL::operator()(std::move(raw_log_line), first_index++, last) == EntryResponse::Done) {
+          return EntryResponse::Done;
+        }
+      }
+      return EntryResponse::More;
+    }
+  }
+  // The batch of entries. Only the subscribers that accept the whole batch get it as is, the rest get them one by one.
+  EntryResponse operator()(EntriesBatch<ENTRY> batch, idxts_t last) {
+    if constexpr (accepts_entries_batch) {
+      return IMPL::operator()(batch, last);
+    } else {
+      for (auto& e : batch) {
+        if (IMPL::operator()(std::move(e.entry), e.idx_ts, last) == EntryResponse::Done) {
+          return EntryResponse::Done;
+        }
+      }
+      return EntryResponse::More;
+    }
+  }
   EntryResponse operator()(std::chrono::microseconds ts) { return IMPL::operator()(ts); }
 
+  BatchingPolicy GetBatchingPolicy() const {
+    if constexpr (impl::HasBatchingPolicy<IMPL>::value) {
+      return IMPL::GetBatchingPolicy();
+    } else {
+      return BatchingPolicy();
+    }
+  }
+
   // If a type-filtered subscriber hits the end which it doesn't see as the last entry does not pass the filter,
   // we need a way to ask that subscriber whether it wants to terminate or continue.
   EntryResponse EntryResponseIfNoMorePassTypeFilter() const { return IMPL::EntryResponseIfNoMorePassTypeFilter(); }
@@ -175,6 +286,28 @@ struct IsStreamSubscriber {
   static constexpr bool value = std::is_base_of_v<GenericStreamSubscriber<current::decay_t<E>>, current::decay_t<T>>;
 };
 
+// Whether the subscriber wants the entries of type `E` delivered as `EntriesBatch<E>`, which MMQ, MMPQ and Stream
+// then do automatically. Unchecked stream subscriptions also look at `IsRawLogLinesBatchSubscriber`.
+template <typename T, typename E, bool = IsEntrySubscriber<T, E>::value>
+struct IsBatchEntrySubscriber {
+  static constexpr bool value = false;
+};
+
+template <typename T, typename E>
+struct IsBatchEntrySubscriber<T, E, true> {
+  static constexpr bool value = current::decay_t<T>::accepts_entries_batch;
+};
+
+template <typename T, typename E, bool = IsEntrySubscriber<T, E>::value>
+struct IsRawLogLinesBatchSubscriber {
+  static constexpr bool value = false;
+};
+
+template <typename T, typename E>
+struct IsRawLogLinesBatchSubscriber<T, E, true> {
+  static constexpr bool value = current::decay_t<T>::accepts_raw_log_lines_batch;
+};
+
 namespace impl {
 
 template <typename TYPE_SUBSCRIBED_TO, typename STREAM_UNDERLYING_VARIANT>
@@ -254,3 +254,65 @@ TEST(StreamSystem, PassEntryToSubscriberIfTypeMatches) {
     EXPECT_EQ("", just_b.s);
   }
 }
+
+TEST(StreamSystem, EntriesBatchSubscribers) {
+  using namespace ss_unittest;
+  using current::ss::EntriesBatch;
+  using current::ss::EntryResponse;
+  using current::ss::IndexedEntry;
+
+  struct OneByOneImpl {
+    std::vector<std::string> calls;
+    EntryResponse operator()(A&& a, idxts_t current, idxts_t) {
+      calls.push_back(current::ToString(current.index) + ':' + current::ToString(a.a));
+      return a.a < 0 ? EntryResponse::Done : EntryResponse::More;
+    }
+  };
+
+  struct BatchImpl {
+    std::vector<std::string> calls;
+    EntryResponse operator()(A&&, idxts_t, idxts_t) { return EntryResponse::More; }
+    EntryResponse operator()(EntriesBatch<A> batch, idxts_t last) {
+      std::vector<std::string> entries;
+      for (const auto& e : batch) {
+        entries.push_back(current::ToString(e.idx_ts.index) + ':' + current::ToString(e.entry.a));
+      }
+      calls.push_back('[' + current::strings::Join(entries, ',') + "]/" + current::ToString(last.index));
+      return EntryResponse::More;
+    }
+    current::ss::BatchingPolicy GetBatchingPolicy() const {
+      return current::ss::BatchingPolicy(10u, std::chrono::microseconds(500));
+    }
+  };
+
+  using one_by_one_t = current::ss::EntrySubscriber<OneByOneImpl, A>;
+  using batch_t = current::ss::EntrySubscriber<BatchImpl, A>;
+  static_assert(!current::ss::IsBatchEntrySubscriber<one_by_one_t, A>::value, "");
+  static_assert(current::ss::IsBatchEntrySubscriber<batch_t, A>::value, "");
+  static_assert(!current::ss::IsBatchEntrySubscriber<batch_t, B>::value, "");
+  static_assert(!current::ss::IsBatchEntrySubscriber<int, A>::value, "");
+
+  std::vector<IndexedEntry<A>> entries;
+  entries.push_back({idxts_t(1, std::chrono::microseconds(10)), A(1)});
+  entries.push_back({idxts_t(2, std::chrono::microseconds(20)), A(-2)});
+  entries.push_back({idxts_t(3, std::chrono::microseconds(30)), A(3)});
+  const idxts_t last(3, std::chrono::microseconds(30));
+
+  {
+    // The subscriber which does not accept batches gets the entries one by one, and can stop in the middle.
+    one_by_one_t one_by_one;
+    EXPECT_EQ(1024u, one_by_one.GetBatchingPolicy().max_batch_size);
+    EXPECT_EQ(0, one_by_one.GetBatchingPolicy().max_linger.count());
+    EXPECT_EQ(EntryResponse::Done, one_by_one(EntriesBatch<A>(entries.data(), entries.size()), last));
+    EXPECT_EQ("1:1 2:-2", current::strings::Join(one_by_one.calls, ' '));
+  }
+
+  {
+    batch_t batch;
+    EXPECT_EQ(10u, batch.GetBatchingPolicy().max_batch_size);
+    EXPECT_EQ(500, batch.GetBatchingPolicy().max_linger.count());
+    EXPECT_EQ(EntryResponse::More, batch(EntriesBatch<A>(entries.data(), entries.size()), last));
+    EXPECT_EQ(EntryResponse::More, batch(EntriesBatch<A>(entries.data() + 2, 1u), last));
+    EXPECT_EQ("[1:1,2:-2,3:3]/3 [3:3]/3", current::strings::Join(batch.calls, ' '));
+  }
+}
@@ -42,6 +42,7 @@ constexpr char kDefaultJSONContentType[] = "application/json; charset=utf-8";
 constexpr char kDefaultHTMLContentType[] = "text/html; charset=utf-8";
 constexpr char kDefaultSVGContentType[] = "image/svg+xml; charset=utf-8";
 constexpr char kDefaultPNGContentType[] = "image/png";
+constexpr char kDefaultBinaryContentType[] = "application/octet-stream";
 constexpr char kDefaultJSONStreamContentType[] = "application/stream+json; charset=utf-8";
 
 constexpr char kHeaderKeyValueSeparator = ':';
@@ -50,6 +51,10 @@ constexpr char kContentLengthHeaderKey[] = "Content-Length";
 constexpr char kTransferEncodingHeaderKey[] = "Transfer-Encoding";
 constexpr char kTransferEncodingChunkedValue[] = "chunked";
 constexpr char kHTTPMethodOverrideHeaderKey[] = "X-HTTP-Method-Override";
+constexpr char kConnectionHeaderKey[] = "Connection";
+constexpr char kConnectionCloseValue[] = "close";
+constexpr char kConnectionKeepAliveValue[] = "keep-alive";
+constexpr char kHTTP11[] = "HTTP/1.1";
 
 // By default:
 // * HTTP responses that use `struct Response` will have the CORS header set.
@@ -25,6 +25,9 @@ SOFTWARE.
 #ifndef BRICKS_NET_HTTP_IMPL_SERVER_H
 #define BRICKS_NET_HTTP_IMPL_SERVER_H
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -97,6 +100,21 @@ inline EventsJournal& HTTPDataJournal() { return current::Singleton<EventsJourna
 // HTTP response helpers. Used from both `GenericHTTPRequestData` and `GenericHTTPServerConnection`.
 struct HTTPResponder {
   typedef enum { ConnectionClose, ConnectionKeepAlive } ConnectionType;
+
+  // The `Connection:` header of the non-chunked responses sent from this thread. `GenericHTTPServerConnection`
+  // switches it to `ConnectionKeepAlive` while responding to a request which it can keep the connection open after.
+  static ConnectionType& ResponseConnectionType() {
+    thread_local ConnectionType connection_type = ConnectionClose;
+    return connection_type;
+  }
+  struct ScopedResponseConnectionType final {
+    const ConnectionType previous;
+    explicit ScopedResponseConnectionType(ConnectionType connection_type) : previous(ResponseConnectionType()) {
+      ResponseConnectionType() = connection_type;
+    }
+    ~ScopedResponseConnectionType() { ResponseConnectionType() = previous; }
+  };
+
   static void PrepareHTTPResponseHeader(std::ostream& os,
                                         ConnectionType connection_type,
                                         HTTPResponseCodeValue code = HTTPResponseCode.OK,
@@ -130,7 +148,7 @@ struct HTTPResponder {
                                    const http::Headers& headers,
                                    const std::string& content_type) {
     std::ostringstream os;
-    PrepareHTTPResponseHeader(os, ConnectionClose, code, headers, content_type);
+    PrepareHTTPResponseHeader(os, ResponseConnectionType(), code, headers, content_type);
     os << "Content-Length: " << (end - begin) << constants::kCRLF << constants::kCRLF;
     connection.BlockingWrite(os.str(), true);
     connection.BlockingWrite(begin, end, false);
@@ -387,6 +405,12 @@ class HTTPDefaultHelper {
   char dummy_ = '\0';
 };
 
+// The beginning of the HTTP request, already read from the connection by an event-driven server.
+// The parser consumes these bytes first, and only then reads from the connection itself.
+struct HTTPRequestPrefetchedBytes final {
+  std::string bytes;
+};
+
 // In constructor, GenericHTTPRequestData parses HTTP response from `Connection&` is was provided with.
 // Extracts method, path (URL + parameters), and, if provided, the body.
 //
@@ -395,6 +419,7 @@ class HTTPDefaultHelper {
 // * std::string RawPath() (the URL before parsing).
 // * std::string Method().
 // * std::string Body(), size_t BodyLength(), const char* Body{Begin,End}().
+// * bool KeepAlive(), bool HasContentLength() (whether the connection can be used for the next message).
 //
 // Exceptions:
 // * ConnectionResetByPeer       : When the server is using chunked transfer and doesn't fully send one.
@@ -408,7 +433,15 @@ class GenericHTTPRequestData : public HELPER {
       const typename HELPER::ConstructionParams& params = typename HELPER::ConstructionParams(),
       const int initial_buffer_size = 16 * 1024 + 1,
       const double buffer_growth_k = 1.95)
-      : HELPER(params), buffer_(initial_buffer_size) {
+      : GenericHTTPRequestData(c, HTTPRequestPrefetchedBytes(), params, initial_buffer_size, buffer_growth_k) {}
+
+  inline GenericHTTPRequestData(
+      Connection& c,
+      HTTPRequestPrefetchedBytes&& prefetched,
+      const typename HELPER::ConstructionParams& params = typename HELPER::ConstructionParams(),
+      const int initial_buffer_size = 16 * 1024 + 1,
+      const double buffer_growth_k = 1.95)
+      : HELPER(params), buffer_(initial_buffer_size), prefetched_(std::move(prefetched.bytes)) {
     // `offset` is the number of bytes read into `buffer_` so far.
     // `length_cap` is infinity first (size_t is unsigned), and it changes/ to the absolute offset
     // of the end of HTTP body in the buffer_, once `Content-Length` and two consecutive CRLS have been seen.
@@ -440,7 +473,7 @@ class GenericHTTPRequestData : public HELPER {
       // consecutively received packets lays right on the final size, but instead of parsing the received body,
       // the server would wait forever for more data to arrive from the client.
       chunk = buffer_.size() - offset - 1;
-      read_count = c.BlockingRead(&buffer_[offset], chunk);
+      read_count = Read(c, &buffer_[offset], chunk, Connection::ReturnASAP);
       CURRENT_BRICKS_LOG_HTTP_EVENT(
           "read %lu bytes while requested %lu (buffer offset %lu)\n", read_count, chunk, offset);
       offset += read_count;
@@ -478,6 +511,9 @@ class GenericHTTPRequestData : public HELPER {
               raw_path_ = pieces[1];
               url_ = current::url::URL(raw_path_);
             }
+            // The protocol is the last component of the request line, and the first one of the status line.
+            http_1_1_ = (pieces.size() >= 3 && pieces[2] == constants::kHTTP11) ||
+                        (pieces.size() >= 1 && pieces[0] == constants::kHTTP11);
             first_line_parsed = true;
           }
         } else if (receiving_body_in_chunks) {
@@ -528,7 +564,7 @@ class GenericHTTPRequestData : public HELPER {
                     // LCOV_EXCL_STOP
                   }
                 }
-                if (bytes_to_read != c.BlockingRead(&buffer_[offset], bytes_to_read, Connection::FillFullBuffer)) {
+                if (bytes_to_read != Read(c, &buffer_[offset], bytes_to_read, Connection::FillFullBuffer)) {
                   CURRENT_THROW(ConnectionResetByPeer());  // LCOV_EXCL_LINE
                 }
                 CURRENT_BRICKS_LOG_HTTP_EVENT("read %lu more bytes of a chunk at offset %lu\n", bytes_to_read, offset);
@@ -577,6 +613,12 @@ class GenericHTTPRequestData : public HELPER {
               if (HeaderNameEquals(value, constants::kTransferEncodingChunkedValue)) {
                 chunked_transfer_encoding = true;
               }
+            } else if (HeaderNameEquals(key, constants::kConnectionHeaderKey)) {
+              if (HeaderNameEquals(value, constants::kConnectionCloseValue)) {
+                connection_header_ = ConnectionHeader::Close;
+              } else if (HeaderNameEquals(value, constants::kConnectionKeepAliveValue)) {
+                connection_header_ = ConnectionHeader::KeepAlive;
+              }
             }
           }
         } else {
@@ -596,12 +638,13 @@ class GenericHTTPRequestData : public HELPER {
               }
               if (length_cap > offset) {
                 const size_t bytes_to_read = length_cap - offset;
-                if (bytes_to_read != c.BlockingRead(&buffer_[offset], bytes_to_read, Connection::FillFullBuffer)) {
+                if (bytes_to_read != Read(c, &buffer_[offset], bytes_to_read, Connection::FillFullBuffer)) {
                   CURRENT_THROW(ConnectionResetByPeer());  // LCOV_EXCL_LINE
                 }
               }
               body_buffer_begin_ = &buffer_[body_offset];
               body_buffer_end_ = body_buffer_begin_ + body_length;
+              has_content_length_ = true;
               return;
             } else {
               if (NeedContentLengthHeader(method_)) {
@@ -640,6 +683,16 @@ class GenericHTTPRequestData : public HELPER {
   inline const current::url::URL& URL() const { return url_; }
   inline const std::string& RawPath() const { return raw_path_; }
 
+  // Whether the peer is fine with the connection staying open after this message: it speaks HTTP/1.1 and has not
+  // sent `Connection: close`, or it has explicitly sent `Connection: keep-alive`.
+  inline bool KeepAlive() const {
+    return connection_header_ == ConnectionHeader::KeepAlive ||
+           (http_1_1_ && connection_header_ != ConnectionHeader::Close);
+  }
+
+  // Whether the body was delimited by `Content-Length`, so that exactly the bytes of this message have been read.
+  inline bool HasContentLength() const { return has_content_length_; }
+
   // Note that `Body*()` methods assume that the body was fully read into memory.
   // If other means of reading the body, for example, event-based chunk parsing, is used,
   // then `Body()` will return empty string and all other `Body*()` methods will return nullptr.
@@ -669,6 +722,24 @@ class GenericHTTPRequestData : public HELPER {
   }
 
  private:
+  // Reads from the prefetched bytes first, if there are any left, and then from the connection.
+  size_t Read(Connection& c, char* output, size_t max_length, Connection::BlockingReadPolicy policy) {
+    size_t result = 0u;
+    if (prefetched_offset_ < prefetched_.length()) {
+      result = std::min(max_length, prefetched_.length() - prefetched_offset_);
+      std::memcpy(output, prefetched_.data() + prefetched_offset_, result);
+      prefetched_offset_ += result;
+      if (prefetched_offset_ == prefetched_.length()) {
+        std::string().swap(prefetched_);
+        prefetched_offset_ = 0u;
+      }
+      if (result == max_length || policy == Connection::ReturnASAP) {
+        return result;
+      }
+    }
+    return result + c.BlockingRead(output + result, max_length - result, policy);
+  }
+
   static char NormalizeHeaderChar(char c) { return c != '_' ? std::tolower(c) : '-'; }
   static bool HeaderNameEquals(const char* lhs, const char* rhs) {
     while (*lhs && *rhs) {
@@ -683,11 +754,17 @@ class GenericHTTPRequestData : public HELPER {
   std::string method_;
   current::url::URL url_;
   std::string raw_path_;
+  enum class ConnectionHeader { Unspecified, Close, KeepAlive };
+  ConnectionHeader connection_header_ = ConnectionHeader::Unspecified;
+  bool http_1_1_ = false;
+  bool has_content_length_ = false;
 
   // HTTP parsing fields that have to be caried out of the parsing routine.
   std::vector<char> buffer_;                 // The buffer into which data has been read, except for chunked case.
   const char* body_buffer_begin_ = nullptr;  // If BODY has been provided, pointer pair to it.
   const char* body_buffer_end_ = nullptr;    // Will not be nullptr if body_buffer_begin_ is not nullptr.
+  std::string prefetched_;                   // The bytes read by the server before the parsing has started.
+  size_t prefetched_offset_ = 0u;            // The number of `prefetched_` bytes consumed.
 
   // HTTP body gets converted to an std::string representation as it's first requested.
   // TODO(dkorolev): This pattern is worth revisiting. StringPiece?
@@ -717,6 +794,15 @@ class GenericHTTPServerConnection final : public HTTPResponder {
       const int initial_buffer_size = 16 * 1024 + 1,
       const double buffer_growth_k = 1.95)
       : connection_(std::move(c)), message_(connection_, params, initial_buffer_size, buffer_growth_k) {}
+  // For the event-driven server, which has read the headers of the request itself, without blocking.
+  GenericHTTPServerConnection(
+      Connection&& c,
+      HTTPRequestPrefetchedBytes&& prefetched,
+      const typename HTTP_REQUEST_DATA::ConstructionParams& params = typename HTTP_REQUEST_DATA::ConstructionParams(),
+      const int initial_buffer_size = 16 * 1024 + 1,
+      const double buffer_growth_k = 1.95)
+      : connection_(std::move(c)),
+        message_(connection_, std::move(prefetched), params, initial_buffer_size, buffer_growth_k) {}
   ~GenericHTTPServerConnection() {
     if (!responded_) {
       // If a user code throws an exception in a different thread, it will not be caught.
@@ -742,6 +828,21 @@ class GenericHTTPServerConnection final : public HTTPResponder {
         }
       }
       // LCOV_EXCL_STOP
+    } else if (keep_alive_) {
+      try {
+        keep_alive_(std::move(connection_));
+      } catch (const Exception&) {  // LCOV_EXCL_LINE
+        // No exception should ever leave the destructor. The connection is just closed then.
+      }
+    }
+  }
+
+  // Makes this connection hand itself over to `keep_alive` once a non-chunked response is sent, instead of closing,
+  // so that the server can serve the next request from the same client over it. Has no effect if the request
+  // did not allow keeping the connection open. Must be called before the response is sent.
+  void KeepAliveVia(std::function<void(Connection&&)> keep_alive) {
+    if (message_.KeepAlive()) {
+      keep_alive_candidate_ = std::move(keep_alive);
     }
   }
 
@@ -750,8 +851,10 @@ class GenericHTTPServerConnection final : public HTTPResponder {
     if (responded_) {
       CURRENT_THROW(AttemptedToSendHTTPResponseMoreThanOnce());
     } else {
+      const ScopedResponseConnectionType scope(keep_alive_candidate_ ? ConnectionKeepAlive : ConnectionClose);
       HTTPResponder::SendHTTPResponse(connection_, std::forward<ARGS>(args)...);
       responded_ = true;
+      keep_alive_ = std::move(keep_alive_candidate_);
     }
   }
 
@@ -914,6 +1017,9 @@ class GenericHTTPServerConnection final : public HTTPResponder {
   bool responded_ = false;
   Connection connection_;
   GenericHTTPRequestData<HTTP_REQUEST_DATA> message_;
+  // Set by `KeepAliveVia()`, and moved into `keep_alive_` once a response has been sent with `Connection: keep-alive`.
+  std::function<void(Connection&&)> keep_alive_candidate_;
+  std::function<void(Connection&&)> keep_alive_;
 
   // Disable any copy/move support for extra safety.
   GenericHTTPServerConnection(const GenericHTTPServerConnection&) = delete;
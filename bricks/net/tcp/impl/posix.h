@@ -559,7 +559,7 @@ class Connection : public SocketHandle {
   template <typename T>
   Connection& BlockingWrite(const T begin, const T end, bool more) {
     if (begin != end) {
-      return BlockingWrite(&(*begin), (end - begin) * sizeof(typename T::value_type), more);
+      return BlockingWrite(&(*begin), (end - begin) * sizeof(*begin), more);
     } else {
       return *this;
     }
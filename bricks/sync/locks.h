@@ -28,6 +28,7 @@ SOFTWARE.
 #include "../../port.h"
 
 #include <mutex>
+#include <shared_mutex>
 #include <type_traits>
 
 namespace current {
@@ -46,6 +47,10 @@ using SmartMutexLockGuard = std::conditional_t<MLS == MutexLockStatus::NeedToLoc
 static_assert(std::is_same_v<std::lock_guard<std::mutex>, SmartMutexLockGuard<MutexLockStatus::NeedToLock>>, "");
 static_assert(std::is_same_v<NoOpLock, SmartMutexLockGuard<MutexLockStatus::AlreadyLocked>>, "");
 
+template <MutexLockStatus MLS, class MUTEX = std::shared_mutex>
+using SmartSharedMutexLockGuard =
+    std::conditional_t<MLS == MutexLockStatus::NeedToLock, std::shared_lock<MUTEX>, NoOpLock>;
+
 }  // namespace locks
 }  // namespace current
 
@@ -37,6 +37,10 @@ SOFTWARE.
 #include <mutex>
 #include <thread>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#endif
+
 #include "../exception.h"
 
 #include "../util/singleton.h"
@@ -76,6 +80,9 @@ inline const std::chrono::microseconds Now() {
   return now;
 }
 
+// The mock clock is globally monotonic as is.
+inline std::chrono::microseconds GloballyMonotonicNow() { return Now(); }
+
 inline void SetNow(std::chrono::microseconds us, std::chrono::microseconds max_us = std::chrono::microseconds(0)) {
   auto& impl = Singleton<MockNowImpl>();
   std::lock_guard<std::mutex> lock(impl.mutex);
@@ -99,8 +106,17 @@ void SleepUntil(T) {}
 
 #else
 
+inline int64_t WallClockMicroseconds() {
+  // On Linux, `std::chrono::system_clock::now()` is `clock_gettime(CLOCK_REALTIME)`, served by the vDSO
+  // without entering the kernel.
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
 // Since chrono::system_clock is not monotonic, and chrono::steady_clock is not guaranteed to be Epoch,
 // use a simple wrapper around chrono::system_clock to make it strictly increasing.
+// This one is strictly increasing globally, across all threads, at the cost of a CAS on a single shared atomic.
+// Only the implicit timestamps of the published entries need this, see `TimestampAsMicroseconds()` below.
 struct EpochClockGuaranteeingMonotonicity {
   mutable std::atomic<int64_t> monotonic_now_us;
 
@@ -109,8 +125,7 @@ struct EpochClockGuaranteeingMonotonicity {
   inline std::chrono::microseconds Now() const {
     int64_t now, previous_now;
     do {
-      now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
-                .count();
+      now = WallClockMicroseconds();
       previous_now = monotonic_now_us.load();
       if (!(now > previous_now)) {
         now = previous_now + 1;
@@ -120,7 +135,85 @@ struct EpochClockGuaranteeingMonotonicity {
   }
 };
 
-inline std::chrono::microseconds Now() { return Singleton<EpochClockGuaranteeingMonotonicity>().Now(); }
+// Same as above, but strictly increasing within one thread only, so it needs no shared state whatsoever.
+struct PerThreadEpochClockGuaranteeingMonotonicity {
+  int64_t monotonic_now_us = 0ll;
+
+  inline std::chrono::microseconds Now() {
+    int64_t now = WallClockMicroseconds();
+    if (!(now > monotonic_now_us)) {
+      now = monotonic_now_us + 1;
+    }
+    monotonic_now_us = now;
+    return std::chrono::microseconds(now);
+  }
+};
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#define CURRENT_TIME_HAS_TSC_CLOCK
+
+// Extrapolates the wall clock from the CPU timestamp counter, which is cheaper to read than even the vDSO clock.
+// Each thread calibrates the counter against the wall clock on its own, and re-calibrates every 100ms,
+// as well as whenever the counter goes back, which may happen if the thread migrates across CPU sockets.
+// Assumes the invariant TSC, which all x86-64 CPUs of the past decade have. Opt in with `CURRENT_TIME_USE_TSC`.
+struct PerThreadTSCClockGuaranteeingMonotonicity {
+  constexpr static int64_t kRecalibrationIntervalUs = 100000;
+  constexpr static uint64_t kInitialCalibrationTicks = 1ull << 22;
+
+  int64_t monotonic_now_us = 0ll;
+  uint64_t base_tsc = 0ull;
+  int64_t base_us = 0ll;
+  double us_per_tick = 0.0;
+  uint64_t recalibrate_at_tsc = 0ull;
+
+  inline std::chrono::microseconds Now() {
+    const uint64_t tsc = __rdtsc();
+    int64_t now;
+    if (tsc < base_tsc || tsc >= recalibrate_at_tsc) {
+      now = Calibrate(tsc);
+    } else if (us_per_tick > 0.0) {
+      now = base_us + static_cast<int64_t>(static_cast<double>(tsc - base_tsc) * us_per_tick);
+    } else {
+      now = WallClockMicroseconds();  // Not calibrated yet.
+    }
+    if (!(now > monotonic_now_us)) {
+      now = monotonic_now_us + 1;
+    }
+    monotonic_now_us = now;
+    return std::chrono::microseconds(now);
+  }
+
+  int64_t Calibrate(uint64_t tsc) {
+    const int64_t now = WallClockMicroseconds();
+    if (base_tsc && tsc > base_tsc && now > base_us) {
+      us_per_tick = static_cast<double>(now - base_us) / static_cast<double>(tsc - base_tsc);
+    }
+    base_tsc = tsc;
+    base_us = now;
+    recalibrate_at_tsc = tsc + (us_per_tick > 0.0 ? static_cast<uint64_t>(kRecalibrationIntervalUs / us_per_tick)
+                                                  : kInitialCalibrationTicks);
+    return now;
+  }
+};
+
+#endif  // defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+// `Now()` is strictly increasing within each thread, and does not touch any state shared between threads.
+// Timestamps obtained by different threads are as comparable as the wall clock readings are,
+// but two threads can get the same value. Use `GloballyMonotonicNow()` where this is not acceptable.
+inline std::chrono::microseconds Now() {
+#if defined(CURRENT_TIME_USE_TSC) && defined(CURRENT_TIME_HAS_TSC_CLOCK)
+  thread_local PerThreadTSCClockGuaranteeingMonotonicity clock;
+#else
+  thread_local PerThreadEpochClockGuaranteeingMonotonicity clock;
+#endif
+  return clock.Now();
+}
+
+inline std::chrono::microseconds GloballyMonotonicNow() {
+  return Singleton<EpochClockGuaranteeingMonotonicity>().Now();
+}
 
 template <typename T>
 inline void SleepUntil(T moment) {
@@ -170,7 +263,9 @@ enum class SecondsToMicrosecondsPadding : bool { Lower = false, Upper = true };
 
 struct DefaultTimeArgument {};
 
-inline std::chrono::microseconds TimestampAsMicroseconds(DefaultTimeArgument) { return Now(); }
+// The implicit timestamps of the entries published into streams, MMQ-s, etc., must strictly increase across
+// all the publishing threads, so they come from the globally monotonic clock.
+inline std::chrono::microseconds TimestampAsMicroseconds(DefaultTimeArgument) { return GloballyMonotonicNow(); }
 inline std::chrono::microseconds TimestampAsMicroseconds(std::chrono::microseconds us) { return us; }
 
 template <typename>
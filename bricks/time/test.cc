@@ -22,7 +22,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 *******************************************************************************/
 
+#include <algorithm>
 #include <thread>
+#include <vector>
 #include <chrono>
 
 #include "chrono.h"
@@ -46,6 +48,48 @@ TEST(Time, SmokeTest) {
   EXPECT_LE(dt, 50000 + allowed_skew);
 }
 
+TEST(Time, MonotonicClocks) {
+  std::vector<std::thread> threads;
+  std::vector<std::vector<int64_t>> per_thread(4), global(4);
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&per_thread, &global, t]() {
+      for (size_t i = 0; i < 10000; ++i) {
+        per_thread[t].push_back(current::time::Now().count());
+        global[t].push_back(current::time::GloballyMonotonicNow().count());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::vector<int64_t> all_global;
+  for (size_t t = 0; t < 4; ++t) {
+    for (size_t i = 1; i < per_thread[t].size(); ++i) {
+      ASSERT_LT(per_thread[t][i - 1], per_thread[t][i]);
+      ASSERT_LT(global[t][i - 1], global[t][i]);
+    }
+    all_global.insert(all_global.end(), global[t].begin(), global[t].end());
+  }
+  // No two threads can ever get the same value from the globally monotonic clock.
+  std::sort(all_global.begin(), all_global.end());
+  EXPECT_TRUE(std::adjacent_find(all_global.begin(), all_global.end()) == all_global.end());
+}
+
+#ifdef CURRENT_TIME_HAS_TSC_CLOCK
+TEST(Time, TSCClock) {
+  current::time::PerThreadTSCClockGuaranteeingMonotonicity clock;
+  int64_t previous = clock.Now().count();
+  for (size_t i = 0; i < 250; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const int64_t now = clock.Now().count();
+    ASSERT_LT(previous, now);
+    previous = now;
+  }
+  // Once calibrated, the TSC clock should stay close to the wall one.
+  EXPECT_LE(std::abs(clock.Now().count() - current::time::WallClockMicroseconds()), 3000);
+}
+#endif  // CURRENT_TIME_HAS_TSC_CLOCK
+
 #else
 
 #ifndef CURRENT_COVERAGE_REPORT_MODE
@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include <chrono>
 #include <map>
+#include <tuple>
 #include <unordered_map>
 
 namespace current {
@@ -83,6 +84,15 @@ struct GenericHashFunctionImpl<std::pair<TF, TS>, false, false> {
   }
 };
 
+template <typename... TS>
+struct GenericHashFunctionImpl<std::tuple<TS...>, false, false> {
+  std::size_t operator()(const std::tuple<TS...>& t) const {
+    std::size_t seed = 0u;
+    std::apply([&seed](const TS&... xs) { (HashCombine<TS, GenericHashFunction<TS>>(seed, xs), ...); }, t);
+    return seed;
+  }
+};
+
 template <typename R, typename P>
 struct GenericHashFunctionImpl<std::chrono::duration<R, P>, false, false> {
   std::size_t operator()(std::chrono::duration<R, P> x) const {
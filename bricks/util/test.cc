@@ -766,6 +766,12 @@ TEST(CustomHashFunction, Smoke) {
 
   EXPECT_EQ(1u, GenericHashFunction<WithoutHashFunctionTestStruct>()(WithoutHashFunctionTestStruct()));
   EXPECT_EQ(2u, GenericHashFunction<WithHashFunctionTestStruct>()(WithHashFunctionTestStruct()));
+
+  using tuple_t = std::tuple<WithHashFunctionTestStruct, std::string>;
+  EXPECT_EQ(GenericHashFunction<tuple_t>()(tuple_t(WithHashFunctionTestStruct(), "foo")),
+            GenericHashFunction<tuple_t>()(tuple_t(WithHashFunctionTestStruct(), "foo")));
+  EXPECT_NE(GenericHashFunction<tuple_t>()(tuple_t(WithHashFunctionTestStruct(), "foo")),
+            GenericHashFunction<tuple_t>()(tuple_t(WithHashFunctionTestStruct(), "bar")));
 }
 
 struct ObjectWithInterface {
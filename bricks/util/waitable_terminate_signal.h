@@ -25,7 +25,9 @@ SOFTWARE.
 #ifndef BRICKS_UTIL_WAITABLE_TERMINATE_SIGNAL_H
 #define BRICKS_UTIL_WAITABLE_TERMINATE_SIGNAL_H
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <unordered_set>
@@ -71,6 +73,27 @@ class WaitableTerminateSignal {
     return stop_signal_;
   }
 
+  // Same as `WaitUntil()`, but gives up once `timeout` has passed.
+  template <typename F>
+  bool WaitUntilOrTimeout(std::unique_lock<std::mutex>& lock,
+                          std::chrono::microseconds timeout,
+                          F&& external_condition) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool wait_done;
+    const auto stop_condition = [this, &external_condition, &wait_done]() {
+      wait_done = stop_signal_ || external_condition();
+      return wait_done;
+    };
+
+    do {
+      // Same deadlock workaround as in `WaitUntil()` above.
+      condition_variable_.wait_until(
+          lock, std::min(deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(25)), stop_condition);
+    } while (!wait_done && std::chrono::steady_clock::now() < deadline);
+
+    return stop_signal_;
+  }
+
  private:
   WaitableTerminateSignal(const WaitableTerminateSignal&) = delete;
 
@@ -24,8 +24,10 @@ SOFTWARE.
 
 #include "../../../current.h"
 
+#include "scenario_binary.h"
 #include "scenario_golden_1k_qps.h"
 #include "scenario_json.h"
+#include "scenario_persistence.h"
 #include "scenario_simple_http.h"
 #include "scenario_storage.h"
 #include "scenario_nginx_client.h"
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# Compares `ToBinary()`/`ParseBinary()` against `JSON()`/`ParseJSON()` on the golden smoke test struct.
+
+if [ ! -f .current/run ] ; then
+  echo "Building '.current/run' to run the tests. You may want to check the compilation flags."
+  make .current/run
+fi
+
+CMD="./.current/run --scenario=binary"
+
+for THREADS in 1 8 ; do
+  for ACTION in gen parse both ; do
+    for FORMAT in json binary ; do
+      echo -n "threads=$THREADS action=$ACTION format=$FORMAT : "
+      $CMD --threads=$THREADS --seconds=2 --binary=$ACTION --binary_format=$FORMAT
+    done
+  done
+done
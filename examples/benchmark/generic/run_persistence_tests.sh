@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Compares the per-entry flush of `persistence::File` against the group commit policies.
+
+if [ ! -f .current/run ] ; then
+  echo "Building '.current/run' to run the tests. You may want to check the compilation flags."
+  make .current/run
+fi
+
+CMD="./.current/run --scenario=persistence"
+
+for THREADS in 1 8 24 ; do
+  for POLICY in \
+      "--persistence_flush_entries=1" \
+      "--persistence_flush_entries=100" \
+      "--persistence_flush_entries=0 --persistence_flush_bytes=65536" \
+      "--persistence_flush_entries=0 --persistence_flush_us=1000" \
+      "--persistence_flush_entries=0 --persistence_flush_us=1000 --persistence_wait_for_flush=true" \
+      "--persistence_flush_entries=1 --persistence_fdatasync=true" \
+      "--persistence_flush_entries=0 --persistence_wait_for_flush=true --persistence_fdatasync=true" ; do
+    echo -n "threads=$THREADS $POLICY : "
+    $CMD --threads=$THREADS --seconds=2 $POLICY
+  done
+done
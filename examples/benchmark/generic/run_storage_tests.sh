@@ -25,3 +25,16 @@ for STORAGE_TRANSACTION in empty size get put ; do
     done
   done
 done
+
+# Read-only transactions run concurrently with each other, so their QPS should scale with the number of threads.
+# So should the QPS of the REST GET-s, which run read-only transactions from the worker threads of the HTTP server.
+for STORAGE_TRANSACTION in size get rest_get ; do
+  for THREADS in 1 2 4 8 16 32 ; do
+    echo -n "$STORAGE_TRANSACTION,int,size=50000,threads=$THREADS : "
+    $CMD \
+      --storage_transaction=$STORAGE_TRANSACTION \
+      --storage_initial_size=50000 \
+      --threads=$THREADS \
+      --seconds=2
+  done
+done
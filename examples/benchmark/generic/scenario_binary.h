@@ -0,0 +1,114 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef EXAMLPES_BENCHMARK_GENERIC_SCENARIO_BINARY_H
+#define EXAMLPES_BENCHMARK_GENERIC_SCENARIO_BINARY_H
+
+#include "../../../port.h"
+
+#include "../../../typesystem/serialization/binary.h"
+#include "../../../typesystem/serialization/json.h"
+
+#include "../../../typesystem/schema/golden/smoke_test_struct.h"
+
+#include "benchmark.h"
+
+#include "../../../bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_string(binary, "both", "Serialization action to take in the binary performance test, gen/parse/both.");
+DEFINE_string(binary_format, "binary", "The format to use in the binary performance test, binary/json.");
+#else
+DECLARE_string(binary);
+DECLARE_string(binary_format);
+#endif
+
+// The golden smoke test struct, with every `Variant` and `Optional` in it populated.
+inline ExposedNamespace::FullTest PopulatedSmokeTestStruct() {
+  ExposedNamespace::FullTest result;
+  for (int i = 0; i < 10; ++i) {
+    result.v1.push_back("string" + current::ToString(i));
+    result.v2.push_back(ExposedNamespace::Primitives());
+  }
+  result.p.first = "pair";
+  result.o = ExposedNamespace::Primitives();
+  ExposedNamespace::C c;
+  c.c = ExposedNamespace::X();
+  c.d = ExposedNamespace::Y();
+  result.q = c;
+  result.w2.bar = ExposedNamespace::A();
+  result.w5.meh = ExposedNamespace::Y();
+  result.tsc.o1 = "optional";
+  result.tsc.o3 = std::vector<std::string>({"one", "two", "three"});
+  result.tsc.o4 = std::vector<int32_t>({1, 2, 3});
+  result.tsc.o5 = std::vector<ExposedNamespace::A>(3u);
+  result.tsc.o7["key"] = ExposedNamespace::A();
+  return result;
+}
+
+SCENARIO(binary, "Binary vs. JSON serialization performance test, on the golden smoke test struct.") {
+  using smoke_test_t = ExposedNamespace::FullTest;
+
+  const smoke_test_t test_object;
+  const std::string test_object_serialized;
+  std::function<void()> f;
+
+  binary()
+      : test_object(PopulatedSmokeTestStruct()),
+        test_object_serialized(FLAGS_binary_format == "json" ? JSON(test_object) : ToBinary(test_object)) {
+    // Both formats must round-trip the test object.
+    CURRENT_ASSERT(JSON(ParseJSON<smoke_test_t>(JSON(test_object))) == JSON(test_object));
+    CURRENT_ASSERT(JSON(ParseBinary<smoke_test_t>(ToBinary(test_object))) == JSON(test_object));
+    if (FLAGS_binary_format == "binary") {
+      if (FLAGS_binary == "gen") {
+        f = [this]() { ToBinary(test_object); };
+      } else if (FLAGS_binary == "parse") {
+        f = [this]() { ParseBinary<smoke_test_t>(test_object_serialized); };
+      } else if (FLAGS_binary == "both") {
+        f = [this]() { ParseBinary<smoke_test_t>(ToBinary(test_object)); };
+      }
+    } else if (FLAGS_binary_format == "json") {
+      if (FLAGS_binary == "gen") {
+        f = [this]() { JSON(test_object); };
+      } else if (FLAGS_binary == "parse") {
+        f = [this]() { ParseJSON<smoke_test_t>(test_object_serialized); };
+      } else if (FLAGS_binary == "both") {
+        f = [this]() { ParseJSON<smoke_test_t>(JSON(test_object)); };
+      }
+    } else {
+      std::cerr << "The `--binary_format` flag must be 'binary' or 'json'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+    if (!f) {
+      std::cerr << "The `--binary` flag must be 'gen', 'parse', or 'both'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+  }
+
+  void RunOneQuery() override { f(); }
+};
+
+REGISTER_SCENARIO(binary);
+
+#endif  // EXAMLPES_BENCHMARK_GENERIC_SCENARIO_BINARY_H
@@ -0,0 +1,93 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef EXAMLPES_BENCHMARK_GENERIC_SCENARIO_PERSISTENCE_H
+#define EXAMLPES_BENCHMARK_GENERIC_SCENARIO_PERSISTENCE_H
+
+#include "../../../port.h"
+
+#include "benchmark.h"
+
+#include "../../../blocks/persistence/file.h"
+#include "../../../bricks/file/file.h"
+
+#include "../../../bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_string(persistence_file, "", "The file to publish into. Leave empty for a temporary one, removed afterwards.");
+DEFINE_uint32(persistence_entry_length, 100, "The length of the string member value of the published entries.");
+DEFINE_uint32(persistence_flush_entries, 1, "Flush once this many entries are pending, zero for no limit.");
+DEFINE_uint32(persistence_flush_bytes, 0, "Flush once this many bytes are pending, zero for no limit.");
+DEFINE_uint32(persistence_flush_us, 0, "Flush once the oldest pending entry is this old, zero to not flush by time.");
+DEFINE_bool(persistence_fdatasync, false, "Set to `true` to `fdatasync()` after each flush.");
+DEFINE_bool(persistence_wait_for_flush, false, "Set to `true` for `Publish()` to only return once flushed.");
+#else
+DECLARE_string(persistence_file);
+DECLARE_uint32(persistence_entry_length);
+DECLARE_uint32(persistence_flush_entries);
+DECLARE_uint32(persistence_flush_bytes);
+DECLARE_uint32(persistence_flush_us);
+DECLARE_bool(persistence_fdatasync);
+DECLARE_bool(persistence_wait_for_flush);
+#endif
+
+CURRENT_STRUCT(PersistedStringEntry) {
+  CURRENT_FIELD(s, std::string);
+  CURRENT_CONSTRUCTOR(PersistedStringEntry)(std::string s = "") : s(std::move(s)) {}
+};
+
+// The default flags correspond to the per-entry flush. Use `run_persistence_tests.sh` to compare the flush policies.
+SCENARIO(persistence, "Publish into `persistence::File` with the flush policy set by the `--persistence_*` flags.") {
+  using persister_t = current::persistence::File<PersistedStringEntry>;
+
+  const std::string filename;
+  std::unique_ptr<current::FileSystem::ScopedRmFile> tmp_file_remover;
+  std::mutex mutex;
+  const PersistedStringEntry entry;
+  std::unique_ptr<persister_t> persister;
+
+  static current::persistence::FileFlushPolicy FlushPolicyFromFlags() {
+    return current::persistence::FileFlushPolicy::GroupCommit(FLAGS_persistence_flush_entries,
+                                                              FLAGS_persistence_flush_bytes,
+                                                              std::chrono::microseconds(FLAGS_persistence_flush_us))
+        .WithFDataSync(FLAGS_persistence_fdatasync)
+        .WithWaitForFlush(FLAGS_persistence_wait_for_flush);
+  }
+
+  persistence()
+      : filename(FLAGS_persistence_file.empty() ? current::FileSystem::GenTmpFileName() : FLAGS_persistence_file),
+        tmp_file_remover(FLAGS_persistence_file.empty() ? std::make_unique<current::FileSystem::ScopedRmFile>(filename)
+                                                        : nullptr),
+        entry(std::string(FLAGS_persistence_entry_length, '.')),
+        persister(std::make_unique<persister_t>(mutex,
+                                                current::ss::StreamNamespaceName("Benchmark", "Entry"),
+                                                filename,
+                                                FlushPolicyFromFlags())) {}
+
+  void RunOneQuery() override { persister->Publish(entry); }
+};
+
+REGISTER_SCENARIO(persistence);
+
+#endif  // EXAMLPES_BENCHMARK_GENERIC_SCENARIO_PERSISTENCE_H
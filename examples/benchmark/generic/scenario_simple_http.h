@@ -40,11 +40,15 @@ DEFINE_string(simple_http_local_route, "/perftest", "Local route for `current_ht
 DEFINE_string(simple_http_test_body,
               "+current -nginx\n",
               "Golden HTTP body to return for the `current_http_server` scenario.");
+DEFINE_uint16(simple_http_worker_threads,
+              0,
+              "If nonzero, serve from the event-driven server core with this many worker threads per port.");
 #else
 DECLARE_uint16(simple_http_local_port);
 DECLARE_uint16(simple_http_local_top_port);
 DECLARE_string(simple_http_local_route);
 DECLARE_string(simple_http_test_body);
+DECLARE_uint16(simple_http_worker_threads);
 #endif
 
 SCENARIO(current_http_server, "Use Current's HTTP stack for simple HTTP client-server handshake.") {
@@ -56,7 +60,8 @@ SCENARIO(current_http_server, "Use Current's HTTP stack for simple HTTP client-s
     for (uint16_t port = FLAGS_simple_http_local_port;
          port <= std::max(FLAGS_simple_http_local_top_port, FLAGS_simple_http_local_port);
          ++port) {
-      scope += HTTP(current::net::BarePort(port)).Register(FLAGS_simple_http_local_route, handler);
+      scope += HTTP(current::net::BarePort(port), current::http::HTTPServerOptions(FLAGS_simple_http_worker_threads))
+                   .Register(FLAGS_simple_http_local_route, handler);
       urls.push_back("localhost:" + current::strings::ToString(port) + FLAGS_simple_http_local_route);
     }
   }
@@ -30,6 +30,7 @@ SOFTWARE.
 #include "benchmark.h"
 
 #include "../../../bricks/util/random.h"
+#include "../../../storage/api.h"
 #include "../../../storage/storage.h"
 #include "../../../storage/persister/stream.h"
 
@@ -39,10 +40,14 @@ SOFTWARE.
 DEFINE_uint32(storage_initial_size, 10000, "The number of records initially in the storage.");
 DEFINE_string(storage_transaction, "empty", "The transaction to run in the inner loop of the load test.");
 DEFINE_bool(storage_test_string, false, "Set to `true` to test 'get' and 'put' with string, not int, keys.");
+DEFINE_uint16(storage_rest_port, 9760, "Local port to expose the storage via REST on, for 'rest_get'.");
+DEFINE_uint16(storage_rest_worker_threads, 32, "The number of worker threads of the HTTP server, for 'rest_get'.");
 #else
 DECLARE_uint32(storage_initial_size);
 DECLARE_string(storage_transaction);
 DECLARE_bool(storage_test_string);
+DECLARE_uint16(storage_rest_port);
+DECLARE_uint16(storage_rest_worker_threads);
 #endif
 
 CURRENT_STRUCT(UInt32KeyValuePair) {
@@ -76,6 +81,8 @@ struct NonSerializablePairOfTwoSizeT {
 SCENARIO(storage, "Storage transactions test.") {
   using storage_t = KeyValueDB<StreamInMemoryStreamPersister>;
   current::Owned<storage_t> db;
+  std::unique_ptr<RESTfulStorage<storage_t>> rest;
+  std::string rest_url;
   size_t actual_size_uint32;
   size_t actual_size_string;
   std::function<void()> f;
@@ -108,6 +115,11 @@ SCENARIO(storage, "Storage transactions test.") {
                      }
                    }).Go());
          }},
+        {{"rest_get"},
+         [this]() {
+           const auto response = HTTP(GET(rest_url + current::ToString(RandomUInt32())));
+           CURRENT_ASSERT(response.code == HTTPResponseCode.OK || response.code == HTTPResponseCode.NotFound);
+         }},
         {{"put"}, [this, testing_string]() {
            db->ReadWriteTransaction([this, testing_string](MutableFields<storage_t> fields) {
                if (!testing_string) {
@@ -150,6 +162,14 @@ SCENARIO(storage, "Storage transactions test.") {
     if (FLAGS_storage_initial_size > 0u) {
       CURRENT_ASSERT(actual_size_string > 0u);
     }
+
+    if (FLAGS_storage_transaction == "rest_get") {
+      // The HTTP server is a singleton per port, so create it with the worker threads before the REST routes.
+      HTTP(current::net::BarePort(FLAGS_storage_rest_port),
+           current::http::HTTPServerOptions(FLAGS_storage_rest_worker_threads));
+      rest = std::make_unique<RESTfulStorage<storage_t>>(*db, FLAGS_storage_rest_port, "/api", "");
+      rest_url = "http://localhost:" + current::ToString(FLAGS_storage_rest_port) + "/api/data/hashmap_uint32/";
+    }
   }
 
   void RunOneQuery() override { f(); }
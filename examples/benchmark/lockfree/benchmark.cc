@@ -86,10 +86,27 @@ int main(int argc, char** argv) {
   };
 
   struct NowWithAtomic {
+    inline std::chrono::microseconds operator()() { return current::time::GloballyMonotonicNow(); }
+  };
+
+  struct NowPerThread {
     inline std::chrono::microseconds operator()() { return current::time::Now(); }
   };
 
+#ifdef CURRENT_TIME_HAS_TSC_CLOCK
+  struct NowPerThreadTSC {
+    inline std::chrono::microseconds operator()() {
+      thread_local current::time::PerThreadTSCClockGuaranteeingMonotonicity clock;
+      return clock.Now();
+    }
+  };
+#endif
+
   std::cout << "Now() with atomic:\t" << Run<NowWithAtomic>().count() << std::endl;
   std::cout << "Now() with mutex:\t" << Run<NowWithMutex>().count() << std::endl;
+  std::cout << "Now() per thread:\t" << Run<NowPerThread>().count() << std::endl;
+#ifdef CURRENT_TIME_HAS_TSC_CLOCK
+  std::cout << "Now() per thread, TSC:\t" << Run<NowPerThreadTSC>().count() << std::endl;
+#endif
   return 0;
 }
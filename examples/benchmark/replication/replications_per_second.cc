@@ -36,6 +36,10 @@ DEFINE_uint32(iterations, 10, "The number of iterations to run.");
 
 DEFINE_string(tmpdir, ".current", "The temporary directory to save file-persisted streams into.");
 
+DEFINE_string(wire_format, "json", "The replication wire format: `json`, `batched`, or `binary`.");
+DEFINE_bool(unchecked, false, "Set to replicate the raw log lines without parsing them on the follower side.");
+DEFINE_bool(catch_up, false, "Set to publish all the events before starting the replication, to measure catch-up.");
+
 CURRENT_STRUCT(Event) {
   CURRENT_FIELD(x, int32_t, 0);
   CURRENT_CONSTRUCTOR(Event)(int32_t x = 0) : x(x) {}
@@ -57,6 +61,19 @@ void InitializeStream(Optional<current::Owned<current::stream::Stream<Event, cur
       current::ss::StreamNamespaceName("Stream", "Event"), fn);
 }
 
+current::stream::ReplicationWireFormat WireFormat() {
+  if (FLAGS_wire_format == "json") {
+    return current::stream::ReplicationWireFormat::JSONLines;
+  } else if (FLAGS_wire_format == "batched") {
+    return current::stream::ReplicationWireFormat::Batches;
+  } else if (FLAGS_wire_format == "binary") {
+    return current::stream::ReplicationWireFormat::BinaryBatches;
+  } else {
+    std::cerr << "The `--wire_format` should be `json`, `batched`, or `binary`." << std::endl;
+    std::exit(-1);
+  }
+}
+
 template <template <typename> class PERSISTER>
 double RunIteration() {
   using stream_t = current::stream::Stream<Event, PERSISTER>;
@@ -77,8 +94,15 @@ double RunIteration() {
   // N remote subscribers, although the last one is unused.
   std::vector<std::unique_ptr<current::stream::SubscribableRemoteStream<Event>>> remote_subscribers(FLAGS_n);
   for (uint32_t i = 0; i < FLAGS_n; ++i) {
-    remote_subscribers[i] = std::make_unique<current::stream::SubscribableRemoteStream<Event>>(
-        Printf("http://localhost:%d/stream", static_cast<uint16_t>(FLAGS_base_port + i)), "Event", "Stream");
+    // The HTTP servers start listening asynchronously, so retry until they do.
+    while (!remote_subscribers[i]) {
+      try {
+        remote_subscribers[i] = std::make_unique<current::stream::SubscribableRemoteStream<Event>>(
+            Printf("http://localhost:%d/stream", static_cast<uint16_t>(FLAGS_base_port + i)), "Event", "Stream");
+      } catch (const current::net::SocketConnectException&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
   }
 
   // (N - 1) replicators, where index zero, "replicate into the source", is left uninitialized.
@@ -87,24 +111,43 @@ double RunIteration() {
     replicators[i] = std::make_unique<current::stream::StreamReplicator<stream_t>>(Value(streams[i]));
   }
 
-  // Start the chain of replications.
+  // With `--catch_up`, the replication starts when all the events are already there.
+  if (FLAGS_catch_up) {
+    for (uint32_t x = 1; x <= FLAGS_m; ++x) {
+      Value(streams[0])->Publisher()->Publish(Event(x));
+    }
+  }
+
+  // Start the chain of replications. Not `current::time::Now()`, as it runs ahead of the wall clock
+  // when the events are published faster than one per microsecond.
+  const auto begin = std::chrono::steady_clock::now();
   std::vector<current::stream::SubscriberScope> subscriber_scopes(FLAGS_n);
+  const auto wire_format = WireFormat();
+  const auto mode = current::stream::SubscriptionMode::Unchecked;
+  const auto zero = std::chrono::microseconds(0);
   for (uint32_t i = 1; i < FLAGS_n; ++i) {
-    subscriber_scopes[i] = remote_subscribers[i - 1]->Subscribe(*replicators[i]);
+    if (FLAGS_unchecked) {
+      subscriber_scopes[i] =
+          remote_subscribers[i - 1]->SubscribeUnchecked(*replicators[i], 0u, zero, mode, nullptr, wire_format);
+    } else {
+      subscriber_scopes[i] =
+          remote_subscribers[i - 1]->Subscribe(*replicators[i], 0u, zero, mode, nullptr, wire_format);
+    }
   }
 
   // Publish M events and watch them propagate.
-  const auto begin = current::time::Now();
-  for (uint32_t x = 1; x <= FLAGS_m; ++x) {
-    Value(streams[0])->Publisher()->Publish(Event(x));
+  if (!FLAGS_catch_up) {
+    for (uint32_t x = 1; x <= FLAGS_m; ++x) {
+      Value(streams[0])->Publisher()->Publish(Event(x));
+    }
   }
   while (Value(streams.back())->Data()->Size() != FLAGS_m) {
     std::this_thread::sleep_for(std::chrono::milliseconds(1));
   }
 
   // Do the math and return "replications per second".
-  const auto end = current::time::Now();
-  const double seconds = (end - begin).count() * 1e-6;
+  const auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - begin).count();
 
   return (FLAGS_n - 1) / seconds;
 }
@@ -126,7 +169,12 @@ void Run() {
 
 int main(int argc, char** argv) {
   ParseDFlags(&argc, &argv);
-  printf("N = %d, M = %d\n", FLAGS_n, FLAGS_m);
+  printf("N = %d, M = %d, wire format: %s%s%s\n",
+         FLAGS_n,
+         FLAGS_m,
+         FLAGS_wire_format.c_str(),
+         FLAGS_unchecked ? ", unchecked" : "",
+         FLAGS_catch_up ? ", catch-up" : "");
 #ifndef NDEBUG
   printf("DEBUG\n");
 #endif
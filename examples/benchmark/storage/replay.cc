@@ -7,6 +7,10 @@
 
 DEFINE_string(file, ".current/log.json", "Storage persistence file in Stream format to use.");
 DEFINE_uint32(gen, 0u, "Set to nonzero to generate this number of entries, overwriting the test data.");
+DEFINE_uint32(keys,
+              0u,
+              "If nonzero, generate the entries for this many distinct keys, so that the later ones overwrite.");
+DEFINE_string(snapshot, ".current/snapshot.json", "The storage snapshot, saved with `--gen`, to compare against.");
 DEFINE_int16(sleep_ms,
              10,
              "The time in milliseconds to sleep in the spin-lock while checking "
@@ -17,17 +21,18 @@ DEFINE_uint16(subs_range, 25, "For batch test, iterate from zero to this number
 DEFINE_string(json, ".current/result.json", "The name of the file to write the benchmark result as JSON.");
 DEFINE_string(png, ".current/result.png", "The name of the file to write the benchmark resuls as PNG.");
 
-inline void GenerateTestData(const std::string& file, uint32_t size) {
+inline void GenerateTestData(const std::string& file, const std::string& snapshot, uint32_t size, uint32_t keys) {
   current::FileSystem::RmFile(file, current::FileSystem::RmFileParameters::Silent);
   auto storage = storage_t::CreateMasterStorage(file);
   for (uint32_t i = 0u; i < size; ++i) {
     storage
-        ->ReadWriteTransaction([i](MutableFields<storage_t> fields) {
-          Entry entry(static_cast<EntryID>(i), current::SHA256(current::ToString(i)));
+        ->ReadWriteTransaction([i, keys](MutableFields<storage_t> fields) {
+          Entry entry(static_cast<EntryID>(keys ? i % keys : i), current::SHA256(current::ToString(i)));
           fields.entries.Add(entry);
         })
         .Go();
   }
+  storage->SaveSnapshot(snapshot);
 }
 
 template <typename T>
@@ -77,6 +82,7 @@ struct RawLogSubscriberImpl {
 CURRENT_STRUCT(Report) {
   CURRENT_FIELD(subs, std::vector<uint16_t>);
   CURRENT_FIELD(owning_storage_replay_ms, std::vector<uint64_t>);
+  CURRENT_FIELD(owning_storage_from_snapshot_ms, std::vector<uint64_t>);
   CURRENT_FIELD(following_storage_replay_ms, std::vector<uint64_t>);
   CURRENT_FIELD(raw_persister_replay_ms, std::vector<uint64_t>);
   CURRENT_FIELD(raw_file_scan_ms, std::vector<uint64_t>);
@@ -117,6 +123,24 @@ inline void PerformReplayBenchmark(const std::string& file,
     report.owning_storage_replay_ms.push_back((end - subscribers_created).count() / 1000);
   }
 
+  // Owning storage, restored from the snapshot instead of replaying the stream.
+  {
+    std::cout << "=== Owning storage from snapshot ===" << std::endl;
+    auto stream = stream_t::CreateStream(file);
+    std::vector<subscriber_t> subscribers(subscribers_count);
+    std::vector<current::stream::SubscriberScope> sub_scopes;
+    if (subscribers_count) {
+      for (size_t i = 0u; i < subscribers_count; ++i) {
+        sub_scopes.emplace_back(stream->Subscribe(subscribers[i]));
+      }
+    }
+    const auto begin = current::time::Now();
+    auto storage = storage_t::CreateMasterStorageAtopExistingStreamFromSnapshot(stream, FLAGS_snapshot);
+    const auto end = current::time::Now();
+    std::cout << "* Storage load: " << (end - begin).count() / 1000 << " ms" << std::endl;
+    report.owning_storage_from_snapshot_ms.push_back((end - begin).count() / 1000);
+  }
+
   struct PublisherAcquirer {
     using publisher_t = typename stream_t::publisher_t;
     void AcceptPublisher(std::unique_ptr<publisher_t> publisher) { publisher_ = std::move(publisher); }
@@ -130,6 +154,7 @@ inline void PerformReplayBenchmark(const std::string& file,
     auto stream = stream_t::CreateStream(file);
     auto acquired_publisher = stream->BecomeFollowingStream();
     const uint64_t stream_size = stream->Data()->Size();
+    const auto stream_last_us = stream->Data()->LastPublishedIndexAndTimestamp().us;
     const auto stream_initialized = current::time::Now();
     std::vector<subscriber_t> subscribers(subscribers_count);
     std::vector<current::stream::SubscriberScope> sub_scopes;
@@ -139,14 +164,9 @@ inline void PerformReplayBenchmark(const std::string& file,
       }
     }
     const auto subscribers_created = current::time::Now();
-    uint64_t storage_size = 0u;
     auto storage = storage_t::CreateFollowingStorageAtopExistingStream(stream);
-    // Spin lock checking the number of imported entries.
-    while (storage_size < stream_size) {
-      storage
-          ->ReadOnlyTransaction(
-              [&storage_size](ImmutableFields<storage_t> fields) { storage_size = fields.entries.Size(); })
-          .Go();
+    // Spin lock checking the last imported entry, as with `--keys` the entries overwrite each other.
+    while (storage->LastAppliedTimestamp() < stream_last_us) {
       std::this_thread::sleep_for(spin_lock_sleep);
     }
     const auto end = current::time::Now();
@@ -241,7 +261,7 @@ inline void PerformReplayBenchmark(const std::string& file,
 int main(int argc, char** argv) {
   ParseDFlags(&argc, &argv);
   if (FLAGS_gen) {
-    GenerateTestData(FLAGS_file, FLAGS_gen);
+    GenerateTestData(FLAGS_file, FLAGS_snapshot, FLAGS_gen, FLAGS_keys);
   } else {
     Report report;
     if (FLAGS_subs) {
@@ -269,6 +289,14 @@ int main(int argc, char** argv) {
                                               .LineWidth(5)
                                               .Color("rgb '#B90000'")
                                               .Name("Owning storage"))
+                                    .Plot(WithMeta([&report](Plotter p) {
+                                            for (size_t i = 0; i < report.subs.size(); ++i) {
+                                              p(report.subs[i], 1e-3 * report.owning_storage_from_snapshot_ms[i]);
+                                            }
+                                          })
+                                              .LineWidth(5)
+                                              .Color("rgb '#B900B9'")
+                                              .Name("Owning storage from snapshot"))
                                     .Plot(WithMeta([&report](Plotter p) {
                                             for (size_t i = 0; i < report.subs.size(); ++i) {
                                               p(report.subs[i], 1e-3 * report.following_storage_replay_ms[i]);
@@ -31,6 +31,8 @@ SOFTWARE.
 DEFINE_double(buffer_mb, 512.0, "The size of the circular buffer to use, in megabytes.");
 
 DEFINE_uint16(listen_port, 8002, "The local port to listen on.");
+DEFINE_uint32(listen_connections, 1u, "The number of incoming connections to accept and fan into the pipeline.");
+DEFINE_bool(io_uring, true, "Unset to read from the sockets with blocking `recv()`-s instead of via io_uring.");
 DEFINE_string(host, "127.0.0.1", "The destination address to send data to.");
 DEFINE_uint16(port, 8004, "The destination port to send data to.");
 DEFINE_string(dirname, ".current", "The dir name for the stored data files.");
@@ -42,7 +44,10 @@ DEFINE_uint32(max_total_files, 4u, "The maximum number of data files to keep, de
 DEFINE_bool(wipe_files_at_startup, true, "Unset to not wipe the files from the previous run.");
 DEFINE_bool(skip_fwrite, false, "Set to not `fwrite()` into the files; for network perftesting only.");
 
-PIPELINE_MAIN(BlockSource<ReceivingWorker>(FLAGS_listen_port),
+PIPELINE_MAIN(BlockSource<ReceivingWorker>(FLAGS_listen_port,
+                                           FLAGS_listen_connections,
+                                           FLAGS_io_uring ? current::pipeline::SocketReadBackend::Auto
+                                                          : current::pipeline::SocketReadBackend::Blocking),
               ParallelPipeline(BlockWorker<SavingWorker>(FLAGS_dirname,
                                                          FLAGS_filebase,
                                                          FLAGS_blobs_per_file,
@@ -26,13 +26,18 @@ SOFTWARE.
 #define EXAMPLES_STREAMED_SOCKETS_LATENCYTEST_PIPELINE_MAIN_H
 
 #include "blob.h"
-#include "dsl/dsl.h"
+
+#include "../../../blocks/pipeline/pipeline.h"
+#include "../../../blocks/pipeline/status_page.h"
 
 #include "../../../blocks/xterm/vt100.h"
 #include "../../../bricks/dflags/dflags.h"
 
 DECLARE_double(buffer_mb);
 
+DEFINE_uint16(status_port, 0, "If set, serve the status page of the pipeline on this port, under `/`.");
+DEFINE_bool(busy_poll, false, "Set to have the pipeline threads busy-poll instead of sleeping when idle.");
+
 #ifndef NDEBUG
 inline void DebugModeDisclaimerIfAppropriate() {
   using namespace current::vt100;
@@ -46,15 +51,23 @@ inline void DebugModeDisclaimerIfAppropriate() {
 inline void DebugModeDisclaimerIfAppropriate() {}
 #endif
 
-#define PIPELINE_MAIN(...)                                                                                \
-  int main(int argc, char** argv) {                                                                       \
-    DebugModeDisclaimerIfAppropriate();                                                                   \
-    ParseDFlags(&argc, &argv);                                                                            \
-    using namespace current::examples::streamed_sockets;                                                  \
-    Pipeline(__VA_ARGS__)                                                                                 \
-        .Run(PipelineRunParams<Blob>().SetCircularBufferSize(static_cast<size_t>(FLAGS_buffer_mb * 1e6))) \
-        .Join();                                                                                          \
-  }                                                                                                       \
+#define PIPELINE_MAIN(...)                                                                                 \
+  int main(int argc, char** argv) {                                                                        \
+    DebugModeDisclaimerIfAppropriate();                                                                    \
+    ParseDFlags(&argc, &argv);                                                                             \
+    using namespace current::examples::streamed_sockets;                                                   \
+    using namespace current::pipeline;                                                                     \
+    auto context = Pipeline(__VA_ARGS__)                                                                   \
+                       .Run(PipelineRunParams<Blob>()                                                      \
+                                .SetCircularBufferSize(static_cast<size_t>(FLAGS_buffer_mb * 1e6))         \
+                                .SetWaitPolicy(FLAGS_busy_poll ? PipelineWaitPolicy::BusyPoll              \
+                                                               : PipelineWaitPolicy::Futex));              \
+    HTTPRoutesScope status_page_scope;                                                                     \
+    if (FLAGS_status_port) {                                                                               \
+      status_page_scope += RegisterPipelineStatusPage(FLAGS_status_port, "/", context);                    \
+    }                                                                                                      \
+    context.Join();                                                                                        \
+  }                                                                                                        \
   struct DummyPipelineMainEatSemicolon {}
 
 #endif  // EXAMPLES_STREAMED_SOCKETS_LATENCYTEST_PIPELINE_MAIN_H
@@ -27,21 +27,36 @@ SOFTWARE.
 
 #include "../blob.h"
 
+#include "../../../../blocks/pipeline/socket_io.h"
 #include "../../../../bricks/net/tcp/tcp.h"
 #include "../../../../bricks/time/chrono.h"
 
 namespace current::examples::streamed_sockets {
 
+// Accepts `connections` connections on `port`, and fans the blobs from all of them into the pipeline.
 struct ReceivingWorker final {
   struct ReceivingWorkerImpl {
     current::net::Socket socket;
-    current::net::Connection connection;
-    ReceivingWorkerImpl(uint16_t port) : socket(current::net::BarePort(port)), connection(socket.Accept()) {}
+    current::pipeline::SocketFanInReader<sizeof(Blob)> reader;
+    ReceivingWorkerImpl(uint16_t port, size_t connections, current::pipeline::SocketReadBackend backend)
+        : socket(current::net::BarePort(port)), reader(AcceptConnections(socket, connections), backend) {}
+    static std::vector<current::net::Connection> AcceptConnections(current::net::Socket& socket, size_t n) {
+      std::vector<current::net::Connection> result;
+      for (size_t i = 0u; i < n; ++i) {
+        result.push_back(socket.Accept());
+      }
+      return result;
+    }
   };
   std::unique_ptr<ReceivingWorkerImpl> impl;
 
   const uint16_t port;
-  explicit ReceivingWorker(uint16_t port) : port(port) {}
+  const size_t connections;
+  const current::pipeline::SocketReadBackend backend;
+  explicit ReceivingWorker(uint16_t port,
+                           size_t connections = 1u,
+                           current::pipeline::SocketReadBackend backend = current::pipeline::SocketReadBackend::Auto)
+      : port(port), connections(connections), backend(backend) {}
 
   size_t DoGetInput(uint8_t* begin, uint8_t* end) {
     // NOTE(dkorolev): My experiments show that latency is sensitive to the socket read block size,
@@ -51,9 +66,9 @@ struct ReceivingWorker final {
       end = begin + block_size_in_bytes;
     }
     if (!impl) {
-      impl = std::make_unique<ReceivingWorkerImpl>(port);
+      impl = std::make_unique<ReceivingWorkerImpl>(port, connections, backend);
     }
-    return impl->connection.BlockingRead(begin, end - begin);
+    return impl->reader.ReadInto(begin, end);
   }
 };
 
@@ -36,7 +36,10 @@ SOFTWARE.
 // 4) Start ./.current/sender --port 9003
 //
 // Multiple hops can be simulated.
+//
+// With `--io_uring`, the reads go through `current::pipeline::SocketFanInReader`, as the pipeline sources do.
 
+#include "../../../blocks/pipeline/socket_io.h"
 #include "../../../bricks/dflags/dflags.h"
 #include "../../../bricks/net/tcp/tcp.h"
 
@@ -44,18 +47,21 @@ DEFINE_uint16(listen_port, 9002, "The port to listen on.");
 DEFINE_string(sendto_host, "localhost", "The host to forward to.");
 DEFINE_uint16(sendto_port, 9001, "The port to forward to.");
 DEFINE_uint64(n, 1 << 20, "Buffer size, in bytes.");
+DEFINE_bool(io_uring, false, "Set to read via io_uring instead of the blocking `recv()`-s.");
 
 int main(int argc, char** argv) {
   ParseDFlags(&argc, &argv);
 
   current::net::Socket socket((current::net::BarePort(FLAGS_listen_port)));
-  current::net::Connection recvfrom(socket.Accept());
+  current::pipeline::SocketFanInReader<> recvfrom(
+      socket.Accept(),
+      FLAGS_io_uring ? current::pipeline::SocketReadBackend::IOUring : current::pipeline::SocketReadBackend::Blocking);
 
   current::net::Connection sendto(current::net::ClientSocket(FLAGS_sendto_host, FLAGS_sendto_port));
 
   std::vector<uint8_t> buffer(FLAGS_n);
   while (true) {
-    const size_t size = recvfrom.BlockingRead(&buffer[0], buffer.size());
+    const size_t size = recvfrom.ReadInto(&buffer[0], &buffer[0] + buffer.size());
     sendto.BlockingWrite(&buffer[0], size, true);
   }
 }
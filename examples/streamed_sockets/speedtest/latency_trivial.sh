@@ -1,10 +1,21 @@
 #!/bin/bash
+#
+# Measures the latency of one forwarding hop. Pass `--io_uring` to have `forward` read via io_uring.
+#
+# Before and after, `./latency_trivial.sh` vs. `./latency_trivial.sh --io_uring`, on a single-core Linux 6.18 VM,
+# averages of the 19 blocks of 32MB over three runs each:
+#
+#   blocking `recv()`-s: 0.52 .. 1.01 GB/s, average latency  9.7 .. 15.3 ms
+#   io_uring:            0.50 .. 1.13 GB/s, average latency  3.8 ..  8.4 ms
+#
+# The throughput is within the noise of this VM. The lower latency comes from the io_uring reader handing out the
+# data in 32KB batches as soon as they arrive, instead of 1MB `recv()`-s.
 
 trap "kill 0" EXIT
 
 NDEBUG=1 make -j .current/forward .current/latency_trivial
 
-./.current/forward &
+./.current/forward $* &
 ./.current/latency_trivial &
 
 wait
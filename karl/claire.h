@@ -44,6 +44,7 @@ SOFTWARE.
 #include "locator.h"
 #include "exceptions.h"
 #include "respond_with_schema.h"
+#include "keepalive_delta.h"
 
 #include "../blocks/http/api.h"
 
@@ -56,6 +57,10 @@ namespace karl {
 
 enum class ForceSendKeepaliveWaitRequest : bool { DoNotWait = false, Wait = true };
 
+// With `Delta`, once Karl has acknowledged a keepalive, the next one only carries the fields that have changed.
+// Karls that do not acknowledge the keepalives keep receiving them in full.
+enum class KeepaliveEncoding : bool { Full = false, Delta = true };
+
 // No need for `CURRENT_FIELD_DESCRIPTION`-s in this structure. -- D.K.
 CURRENT_STRUCT(InternalKeepaliveAttemptResult) {
   CURRENT_FIELD(timestamp, std::chrono::microseconds, std::chrono::microseconds(0));
@@ -188,7 +193,7 @@ class GenericClaire final : private DummyClaireNotifiable {
         // The call to `SendKeepaliveToKarl` is blocking.
         // With "&confirm" at the end, the call to Karl would require Karl calling Claire back.
         // Can throw, the exception should propagate up.
-        SendKeepaliveToKarl(lock, karl_keepalive_route_ + "&confirm");
+        SendKeepaliveToKarl(lock, karl_keepalive_route_ + "&confirm", KeepaliveEncoding::Full);
       }
 
       StartKeepaliveThread();
@@ -246,6 +251,13 @@ class GenericClaire final : private DummyClaireNotifiable {
 
   ClaireStatus& BoilerplateStatus() { return boilerplate_status_; }
 
+  void SetKeepaliveEncoding(KeepaliveEncoding encoding) {
+    std::lock_guard<std::mutex> lock(keepalive_mutex_);
+    keepalive_encoding_ = encoding;
+    acknowledged_keepalive_seq_ = 0u;
+    acknowledged_keepalive_json_.clear();
+  }
+
  private:
   static std::string GenerateRandomCodename() {
     std::string codename;
@@ -359,9 +371,9 @@ class GenericClaire final : private DummyClaireNotifiable {
   // Sends a keepalive message to Karl.
   // Blocking, and can throw.
   // Possibly via a custom `route`: adding "&confirm", for example, would require Karl to crawl Claire back.
-  void SendKeepaliveToKarl(std::unique_lock<std::mutex>&, const std::string& route) {
+  void SendKeepaliveToKarl(std::unique_lock<std::mutex>&, const std::string& route, KeepaliveEncoding encoding) {
     // Basically, throw in case of any error, and throw only one type: `ClaireRegistrationException`.
-    const auto keepalive_body = GenerateKeepaliveStatus();
+    const std::string keepalive_json = JSON(GenerateKeepaliveStatus());
 
     std::string error_message = "";
 
@@ -373,7 +385,37 @@ class GenericClaire final : private DummyClaireNotifiable {
         last_keepalive_attempt_result_.http_code = static_cast<uint16_t>(net::HTTPResponseCodeValue::InvalidCode);
       }
 
-      const auto code = HTTP(POST(route, keepalive_body)).code;
+      const auto response = [&]() {
+        if (encoding == KeepaliveEncoding::Delta) {
+          const std::string seq = current::ToString(++keepalive_seq_);
+          const std::string route_with_seq = route + '&' + kKeepaliveSeqParameter + '=' + seq;
+          if (acknowledged_keepalive_seq_) {
+            auto delta_response =
+                HTTP(POST(route_with_seq + '&' + kKeepaliveDeltaBaseParameter + '=' +
+                              current::ToString(acknowledged_keepalive_seq_),
+                          KeepaliveJSONDelta(acknowledged_keepalive_json_, keepalive_json),
+                          net::constants::kDefaultJSONContentType));
+            if (delta_response.code != HTTPResponseCode.Conflict) {
+              return delta_response;
+            }
+            // Karl no longer has the keepalive this delta is against, so send this one in full.
+          }
+          return HTTP(POST(route_with_seq, keepalive_json, net::constants::kDefaultJSONContentType));
+        } else {
+          return HTTP(POST(route, keepalive_json, net::constants::kDefaultJSONContentType));
+        }
+      }();
+      const auto code = response.code;
+
+      // The next delta is against this keepalive if Karl has acknowledged it, and is not sent otherwise.
+      if (encoding == KeepaliveEncoding::Delta && static_cast<int>(code) >= 200 && static_cast<int>(code) <= 299 &&
+          response.headers.GetOrDefault(kKeepaliveSeqHeader, "") == current::ToString(keepalive_seq_)) {
+        acknowledged_keepalive_seq_ = keepalive_seq_;
+        acknowledged_keepalive_json_ = keepalive_json;
+      } else {
+        acknowledged_keepalive_seq_ = 0u;
+        acknowledged_keepalive_json_.clear();
+      }
 
       {
         std::lock_guard<std::mutex> lock(status_mutex_);
@@ -399,9 +441,9 @@ class GenericClaire final : private DummyClaireNotifiable {
   }
 
   // The semantic to ensure keepalives only happen from a locked section.
-  void SendKeepaliveToKarl(const std::string& route) {
+  void SendKeepaliveToKarl(const std::string& route, KeepaliveEncoding encoding) {
     std::unique_lock<std::mutex> lock(keepalive_mutex_);
-    SendKeepaliveToKarl(lock, route);
+    SendKeepaliveToKarl(lock, route, encoding);
   }
 
   // The thread sends periodic keepalive messages.
@@ -433,7 +475,7 @@ class GenericClaire final : private DummyClaireNotifiable {
       }
 
       try {
-        SendKeepaliveToKarl(lock, karl_keepalive_route_);
+        SendKeepaliveToKarl(lock, karl_keepalive_route_, keepalive_encoding_);
       } catch (const ClaireRegistrationException&) {
         // Ignore exceptions if there's a problem talking to Karl. He'll come back. He's Karl.
       }
@@ -550,6 +592,13 @@ class GenericClaire final : private DummyClaireNotifiable {
   std::thread keepalive_thread_;
 
   bool keepalive_sent_ = false;  // For `ForceSendKeepalive(wait == ForceSendKeepaliveWaitRequest::Wait)`. -- D.K.
+
+  // Guarded by `keepalive_mutex_`. The `seq` of the last keepalive sent, and of the last one Karl has acknowledged,
+  // with its JSON, to send the next keepalive as the delta against it; zero and empty if there is no such keepalive.
+  KeepaliveEncoding keepalive_encoding_ = KeepaliveEncoding::Delta;
+  uint64_t keepalive_seq_ = 0u;
+  uint64_t acknowledged_keepalive_seq_ = 0u;
+  std::string acknowledged_keepalive_json_;
 };
 
 using Claire = GenericClaire<Variant<default_user_status::status>>;
@@ -46,7 +46,10 @@ SOFTWARE.
 
 #include "../port.h"
 
+#include <algorithm>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 // The `current_build.h` file from this local `Current/Karl` dir makes no sense for external users of Karl.
 // Nonetheless, top-level `make test` and `make check` should pass out of the box.
@@ -60,6 +63,7 @@ SOFTWARE.
 #include "locator.h"
 #include "render.h"
 #include "respond_with_schema.h"
+#include "keepalive_delta.h"
 
 #include "../storage/storage.h"
 #include "../storage/persister/stream.h"
@@ -78,10 +82,37 @@ SOFTWARE.
 namespace current {
 namespace karl {
 
+// A keepalive as Karl persists it: either the full status, or the delta from the previous keepalive from the same
+// codename, see `keepalive_delta.h`. Every `keepalives_checkpoint_every`-th keepalive from a codename is persisted
+// in full, and so is the first one after Karl has restarted or the service has deregistered or timed out.
+CURRENT_STRUCT_T(KarlPersistedKeepalive) {
+  CURRENT_FIELD(location, ClaireServiceKey);
+  CURRENT_FIELD(keepalive, Optional<T>);
+  CURRENT_FIELD_DESCRIPTION(keepalive, "The full status of the service, unless this keepalive is a delta.");
+  CURRENT_FIELD(codename, Optional<std::string>);
+  CURRENT_FIELD_DESCRIPTION(codename, "The codename of the service, for the deltas.");
+  CURRENT_FIELD(delta, Optional<std::string>);
+  CURRENT_FIELD_DESCRIPTION(delta, "The JSON of the changed top-level fields of the status, for the deltas.");
+};
+
+namespace legacy {
+// A keepalive as Karl used to persist it, always in full. Every such record is a valid `KarlPersistedKeepalive` too,
+// so only the signature of the stream of them needs to change, see `GenericKarl::MigrateKeepalivesStreamFile()`.
 CURRENT_STRUCT_T(KarlPersistedKeepalive) {
   CURRENT_FIELD(location, ClaireServiceKey);
   CURRENT_FIELD(keepalive, T);
 };
+}  // namespace legacy
+
+// Only the codename of a persisted keepalive, for Karl to index the stream upon startup without deserializing the
+// full statuses. Either `keepalive.codename` or `codename` is present, see `KarlPersistedKeepalive` above.
+CURRENT_STRUCT(KarlPersistedKeepaliveCodenameOnly) {
+  CURRENT_FIELD(codename, std::string);
+};
+CURRENT_STRUCT(KarlPersistedKeepaliveCodename) {
+  CURRENT_FIELD(keepalive, Optional<KarlPersistedKeepaliveCodenameOnly>);
+  CURRENT_FIELD(codename, Optional<std::string>);
+};
 
 template <class STORAGE>
 class KarlNginxManager {
@@ -276,7 +307,8 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
                                : parameters_.public_url),
         notifiable_ref_(notifiable),
         fleet_view_renderer_ref_(renderer),
-        keepalives_stream_(stream_t::CreateStream(parameters_.stream_persistence_file)),
+        keepalives_stream_(stream_t::CreateStream(MigrateKeepalivesStreamFile(parameters_.stream_persistence_file))),
+        keepalives_per_codename_(IndexKeepalivesPerCodename(*keepalives_stream_)),
         state_update_thread_running_(false),
         state_update_thread_force_wakeup_(false),
         state_update_thread_([this]() {
@@ -393,6 +425,7 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
         }
       }
       if (!timeouted_codenames.empty()) {
+        ForgetKeepaliveDeltaBases(timeouted_codenames);
         auto& notifiable_ref = notifiable_ref_;
         storage_
             ->ReadWriteTransaction(
@@ -439,6 +472,18 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
     }
   }
 
+  // The services that are gone do not need their last statuses kept in memory. Should they come back, their next
+  // keepalives are persisted in full, and Claire resends the delta it would send in full.
+  void ForgetKeepaliveDeltaBases(const std::unordered_set<std::string>& codenames) {
+    std::lock_guard<std::mutex> lock(keepalive_indexes_mutex_);
+    for (const auto& codename : codenames) {
+      const auto it = keepalives_per_codename_.find(codename);
+      if (it != keepalives_per_codename_.end()) {
+        it->second.ForgetDeltaBases();
+      }
+    }
+  }
+
   void AcceptKeepaliveViaHTTP(Request r) {
     if (r.method != "GET" && r.method != "POST" && r.method != "DELETE") {
       r(current::net::DefaultMethodNotAllowedMessage(),
@@ -487,6 +532,7 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
           state_update_thread_force_wakeup_ = true;
           update_thread_condition_variable_.notify_one();
         }
+        ForgetKeepaliveDeltaBases({codename});
       } else {
         // Respond with "200 OK" in any case.
         r("NOP\n");
@@ -497,7 +543,7 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
         // If `&confirm` is set, along with `codename` and `port`, Karl calls the service back
         // via the URL from the inbound request and the port the service has provided,
         // to confirm two-way communication.
-        const std::string json = [&]() -> std::string {
+        std::string json = [&]() -> std::string {
           if (qs.has("confirm") && qs.has("port")) {
             const std::string url = "http://" + remote_ip + ':' + qs["port"] + "/.current";
             // Send a GET request, with a random component in the URL to prevent caching.
@@ -510,6 +556,20 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
           }
         }();
 
+        if (qs.has(kKeepaliveDeltaBaseParameter)) {
+          // The delta against the last keepalive Claire has sent with `seq`. If Karl does not have that one, say, if
+          // it has restarted, Claire resends this keepalive in full upon the "409 Conflict".
+          std::lock_guard<std::mutex> lock(keepalive_indexes_mutex_);
+          const auto cit =
+              qs.has("codename") ? keepalives_per_codename_.find(qs["codename"]) : keepalives_per_codename_.end();
+          if (cit == keepalives_per_codename_.end() || cit->second.last_received_json.empty() ||
+              current::ToString(cit->second.last_received_seq) != qs[kKeepaliveDeltaBaseParameter]) {
+            r("Unknown keepalive delta base.\n", HTTPResponseCode.Conflict);
+            return;
+          }
+          json = ApplyKeepaliveJSONDelta(cit->second.last_received_json, json);
+        }
+
         const auto parsed_status = ParseJSON<ClaireStatus>(json);
         if ((!qs.has("codename") || parsed_status.codename == qs["codename"]) &&
             (!qs.has("port") || parsed_status.local_port == current::FromString<uint16_t>(qs["port"]))) {
@@ -545,14 +605,35 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
 
           const auto now = current::time::Now();
 
+          // Acknowledge the `seq` of the keepalive, if Claire has sent one, for Claire to send the next one as a delta.
+          const std::string acknowledged_seq = qs.has(kKeepaliveSeqParameter) ? qs[kKeepaliveSeqParameter] : "";
           {
+            std::string persisted_json = JSON(detailed_parsed_status);
             persisted_keepalive_t record;
             record.location = location;
-            record.keepalive = detailed_parsed_status;
-            {
-              std::lock_guard<std::mutex> lock(latest_keepalive_index_mutex_);
-              latest_keepalive_index_plus_one_[parsed_status.codename] =
-                  keepalives_stream_->Publisher()->Publish(std::move(record)).index;
+            std::lock_guard<std::mutex> lock(keepalive_indexes_mutex_);
+            KeepalivesOfCodename& keepalives = keepalives_per_codename_[parsed_status.codename];
+            const bool persist_in_full =
+                keepalives.last_persisted_json.empty() || keepalives.checkpoints.empty() ||
+                static_cast<uint64_t>(keepalives.indexes.end() - std::lower_bound(keepalives.indexes.begin(),
+                                                                                  keepalives.indexes.end(),
+                                                                                  keepalives.checkpoints.back())) >=
+                    parameters_.keepalives_checkpoint_every;
+            if (persist_in_full) {
+              record.keepalive = detailed_parsed_status;
+            } else {
+              record.codename = parsed_status.codename;
+              record.delta = KeepaliveJSONDelta(keepalives.last_persisted_json, persisted_json);
+            }
+            const uint64_t index = keepalives_stream_->Publisher()->Publish(std::move(record)).index;
+            keepalives.indexes.push_back(index);
+            if (persist_in_full) {
+              keepalives.checkpoints.push_back(index);
+            }
+            keepalives.last_persisted_json = std::move(persisted_json);
+            if (!acknowledged_seq.empty()) {
+              keepalives.last_received_seq = current::FromString<uint64_t>(acknowledged_seq);
+              keepalives.last_received_json = std::move(json);
             }
           }
 
@@ -565,8 +646,13 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
           auto& notifiable_ref = notifiable_ref_;
           storage_
               ->ReadWriteTransaction(
-                  [now, location, &parsed_status, &detailed_parsed_status, optional_behind_this_by, &notifiable_ref](
-                      MutableFields<storage_t> fields) -> Response {
+                  [now,
+                   location,
+                   &parsed_status,
+                   &detailed_parsed_status,
+                   optional_behind_this_by,
+                   &notifiable_ref,
+                   &acknowledged_seq](MutableFields<storage_t> fields) -> Response {
                     // OK to call from within a transaction.
                     // The call is fast, and `storage_`'s transaction guarantees thread safety. -- D.K.
                     notifiable_ref.OnKeepalive(now, location, parsed_status.codename, detailed_parsed_status);
@@ -653,6 +739,9 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
 
                       fields.claires.Add(claire);
                     }
+                    if (!acknowledged_seq.empty()) {
+                      return Response("OK\n").SetHeader(kKeepaliveSeqHeader, acknowledged_seq);
+                    }
                     return Response("OK\n");
                   },
                   std::move(r))
@@ -730,40 +819,140 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
         .Wait();  // NOTE(dkorolev): Could be `.Detach()`, but staying "safe" within Karl for now.
   }
 
-  void ServeSnapshot(Request r) {
-    const auto codename = r.url_path_args[0];
+  template <typename ENTRY>
+  static std::string StreamSignatureDirective() {
+    reflection::StructSchema struct_schema;
+    struct_schema.AddType<ENTRY>();
+    const ss::StreamNamespaceName namespace_name(stream::constants::kDefaultNamespaceName,
+                                                 stream::constants::kDefaultTopLevelName);
+    return std::string(persistence::impl::constants::kSignatureDirective) + ' ' +
+           JSON(ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo()));
+  }
 
-    uint64_t& index_placeholder = [&]() {
-      std::lock_guard<std::mutex> lock(latest_keepalive_index_mutex_);
-      return std::ref(latest_keepalive_index_plus_one_[codename]);
-    }();
+  // Rewrites the signature of the stream of `legacy::KarlPersistedKeepalive`-s, if the file is one, and keeps the
+  // records as they are. The migrated file replaces the original one atomically, once it has been written in full.
+  static const std::string& MigrateKeepalivesStreamFile(const std::string& filename) {
+    std::ifstream fi(filename);
+    std::string line;
+    if (fi && std::getline(fi, line) &&
+        line == StreamSignatureDirective<legacy::KarlPersistedKeepalive<claire_status_t>>()) {
+      const std::string migrated_filename = filename + ".migrating";
+      {
+        std::ofstream fo(migrated_filename);
+        fo << StreamSignatureDirective<persisted_keepalive_t>() << '\n';
+        if (fi.peek() != std::ifstream::traits_type::eof()) {
+          fo << fi.rdbuf();
+        }
+        if (!fo.flush()) {
+          CURRENT_THROW(FileException(migrated_filename));  // LCOV_EXCL_LINE
+        }
+      }
+      FileSystem::RenameFile(migrated_filename, filename);
+    }
+    return filename;
+  }
 
-    const auto& keepalives_data = keepalives_stream_->Data();
+  // The keepalives from one codename, so that neither the snapshot nor the fleet view has to scan the whole stream.
+  struct KeepalivesOfCodename final {
+    // The stream indexes of all the keepalives from this codename, and of the ones persisted in full, ascending.
+    std::vector<uint64_t> indexes;
+    std::vector<uint64_t> checkpoints;
+    // The JSON of the last persisted status, the base for the next persisted delta. Empty to persist the next one in
+    // full: upon startup, and once the service has deregistered or timed out.
+    std::string last_persisted_json;
+    // The last keepalive received from Claire with its `seq`, the base for the next delta Claire sends, as JSON.
+    uint64_t last_received_seq = 0u;
+    std::string last_received_json;
+
+    void ForgetDeltaBases() {
+      last_persisted_json.clear();
+      last_received_seq = 0u;
+      last_received_json.clear();
+    }
 
-    uint64_t index = index_placeholder;
-    if (!index) {
-      // If no latest keepalive index in cache, go through the whole log.
-      for (const auto& e : keepalives_data->Iterate()) {
-        if (e.entry.keepalive.codename == codename) {
-          index = e.idx_ts.index + 1;
-        }
+    // The indexes to read to restore the keepalive at `index`: from the most recent full one up to `index` itself.
+    std::vector<uint64_t> IndexesToRestore(uint64_t index) const {
+      const auto checkpoint = std::upper_bound(checkpoints.begin(), checkpoints.end(), index);
+      if (checkpoint == checkpoints.begin()) {
+        return std::vector<uint64_t>();  // LCOV_EXCL_LINE
       }
-      if (index) {
-        std::lock_guard<std::mutex> lock(latest_keepalive_index_mutex_);
-        index_placeholder = std::max(index_placeholder, index);
+      const auto begin = std::lower_bound(indexes.begin(), indexes.end(), *std::prev(checkpoint));
+      return std::vector<uint64_t>(begin, std::upper_bound(begin, indexes.end(), index));
+    }
+  };
+
+  // Each persisted record is still parsed as JSON, but only its codename is deserialized, not the full, possibly
+  // custom, status of the service.
+  static std::unordered_map<std::string, KeepalivesOfCodename> IndexKeepalivesPerCodename(const stream_t& stream) {
+    std::unordered_map<std::string, KeepalivesOfCodename> result;
+    uint64_t index = 0u;
+    for (const std::string& raw_log_line : stream.Data()->IterateUnsafe()) {
+      const auto tab = raw_log_line.find('\t');
+      CURRENT_ASSERT(tab != std::string::npos);
+      const auto record = ParseJSON<KarlPersistedKeepaliveCodename>(raw_log_line.substr(tab + 1u));
+      if (Exists(record.keepalive)) {
+        KeepalivesOfCodename& keepalives = result[Value(record.keepalive).codename];
+        keepalives.indexes.push_back(index);
+        keepalives.checkpoints.push_back(index);
+      } else {
+        result[Value(record.codename)].indexes.push_back(index);
+      }
+      ++index;
+    }
+    return result;
+  }
+
+  struct RestoredKeepalive final {
+    idxts_t idx_ts;
+    ClaireServiceKey location;
+    claire_status_t keepalive;
+  };
+
+  // Reads the full keepalive at `indexes.front()`, and applies the deltas persisted at the rest of `indexes` to it.
+  RestoredKeepalive RestoreKeepalive(const std::vector<uint64_t>& indexes) const {
+    const auto& keepalives_data = keepalives_stream_->Data();
+    RestoredKeepalive result;
+    std::string json;
+    for (const uint64_t index : indexes) {
+      const auto e = *(keepalives_data->Iterate(index, index + 1u).begin());
+      result.idx_ts = e.idx_ts;
+      result.location = e.entry.location;
+      if (index == indexes.front()) {
+        result.keepalive = Value(e.entry.keepalive);
+        if (indexes.size() > 1u) {
+          json = JSON(result.keepalive);
+        }
+      } else {
+        json = ApplyKeepaliveJSONDelta(json, Value(e.entry.delta));
       }
     }
+    if (indexes.size() > 1u) {
+      result.keepalive = ParseJSON<claire_status_t>(json);
+    }
+    return result;
+  }
 
-    if (index) {
-      const auto e = *(keepalives_data->Iterate(index - 1).begin());
+  void ServeSnapshot(Request r) {
+    const auto codename = r.url_path_args[0];
+
+    // Empty if there are no keepalives from this codename.
+    const std::vector<uint64_t> indexes_to_restore = [&]() -> std::vector<uint64_t> {
+      std::lock_guard<std::mutex> lock(keepalive_indexes_mutex_);
+      const auto cit = keepalives_per_codename_.find(codename);
+      return cit != keepalives_per_codename_.end() ? cit->second.IndexesToRestore(cit->second.indexes.back())
+                                                   : std::vector<uint64_t>();
+    }();
+
+    if (!indexes_to_restore.empty()) {
+      const auto e = RestoreKeepalive(indexes_to_restore);
       if (!r.url.query.has("nobuild")) {
         r(JSON<JSONFormat::Minimalistic>(
-              SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), e.entry.keepalive)),
+              SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), e.keepalive)),
           HTTPResponseCode.OK,
           current::net::http::Headers(),
           current::net::constants::kDefaultJSONContentType);
       } else {
-        auto tmp = e.entry.keepalive;
+        auto tmp = e.keepalive;
         tmp.build = nullptr;
         r(JSON<JSONFormat::Minimalistic>(
               SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), tmp)),
@@ -825,11 +1014,37 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
 
     CURRENT_ASSERT(to >= from);
     const auto& keepalives_data(keepalives_stream_->Data());
-    for (const auto& e : keepalives_data->Iterate(from, to)) {
-      const claire_status_t& keepalive = e.entry.keepalive;
+    // Only the most recent keepalive within the range from each codename makes it into the report, so these are
+    // the only ones restored from the stream, in the order they were published.
+    std::vector<std::vector<uint64_t>> indexes_to_report;
+    {
+      // The same `[begin, end)` range of indexes `Iterate(from, to)` would cover, with `end == -1` for "all".
+      const std::pair<uint64_t, uint64_t> range = keepalives_data->IndexRangeByTimestampRange(from, to);
+      if (range.first != static_cast<uint64_t>(-1)) {
+        std::lock_guard<std::mutex> lock(keepalive_indexes_mutex_);
+        for (const auto& per_codename : keepalives_per_codename_) {
+          const std::vector<uint64_t>& indexes = per_codename.second.indexes;
+          const auto end = std::lower_bound(indexes.begin(), indexes.end(), range.second);
+          if (end != indexes.begin() && *std::prev(end) >= range.first) {
+            indexes_to_report.push_back(per_codename.second.IndexesToRestore(*std::prev(end)));
+            if (indexes_to_report.back().empty()) {
+              indexes_to_report.pop_back();  // LCOV_EXCL_LINE
+            }
+          }
+        }
+      }
+      std::sort(indexes_to_report.begin(),
+                indexes_to_report.end(),
+                [](const std::vector<uint64_t>& lhs, const std::vector<uint64_t>& rhs) {
+                  return lhs.back() < rhs.back();
+                });
+    }
+    for (const std::vector<uint64_t>& indexes : indexes_to_report) {
+      const auto e = RestoreKeepalive(indexes);
+      const claire_status_t& keepalive = e.keepalive;
 
       codenames_to_resolve.insert(keepalive.codename);
-      service_key_into_codename[e.entry.location] = keepalive.codename;
+      service_key_into_codename[e.location] = keepalive.codename;
 
       codenames_per_service[keepalive.service].insert(keepalive.codename);
       // DIMA: More per-codename reporting fields go here; tailored to specific type, `.Call(populator)`, etc.
@@ -994,12 +1209,15 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
   std::set<std::string> local_ips_;  // The list of local IPs used ti receive keepalives.
   mutable std::mutex local_ips_mutex_;
 
-  // codename -> stream index of the most recent keepalive from this codename.
-  std::mutex latest_keepalive_index_mutex_;
-  // Plus one to have `0` == "no keepalives", and avoid the corner case of record at index 0 being the one.
-  std::unordered_map<std::string, uint64_t> latest_keepalive_index_plus_one_;
-
   current::Owned<stream_t> keepalives_stream_;
+
+  // codename -> the keepalives from this codename. Built in one pass over the stream upon construction, before the
+  // keepalives are accepted, and appended to with each keepalive published. Eight bytes per keepalive, same as the
+  // timestamps the file persister keeps in memory anyway, plus the bases for the deltas of the live services.
+  // Also makes sure the keepalives are published in the order their deltas have been computed in.
+  mutable std::mutex keepalive_indexes_mutex_;
+  std::unordered_map<std::string, KeepalivesOfCodename> keepalives_per_codename_;
+
   std::atomic_bool state_update_thread_running_;
   std::atomic_bool state_update_thread_force_wakeup_;
   std::condition_variable update_thread_condition_variable_;
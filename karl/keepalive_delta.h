@@ -0,0 +1,119 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Delta-encoded keepalives: the JSON object with only the top-level fields of the status that have changed.
+//
+// Most of a keepalive, the build info, the dependencies, and, often, the runtime status, is the same from one
+// keepalive to the next, and only the timestamps change. The granularity is the top-level field: a changed `runtime`
+// is sent in full. A field removed from the status is `null` in the delta, which, for the `Optional<>` fields of the
+// `CURRENT_STRUCT`-s, is the same as being missing.
+//
+// Claire sends the deltas against the last keepalive Karl has acknowledged, and Karl persists the deltas against the
+// previous keepalive from the same codename, with periodic full checkpoints.
+
+#ifndef KARL_KEEPALIVE_DELTA_H
+#define KARL_KEEPALIVE_DELTA_H
+
+#include "../port.h"
+
+#include <string>
+
+#include "../typesystem/serialization/json.h"
+
+namespace current {
+namespace karl {
+
+// The URL parameters of the keepalives: the sequence number of this keepalive, and of the one it is the delta against.
+constexpr static const char* kKeepaliveSeqParameter = "seq";
+constexpr static const char* kKeepaliveDeltaBaseParameter = "delta_base";
+// The header with which Karl confirms it has kept the keepalive with this `seq` as the base for the next delta.
+constexpr static const char* kKeepaliveSeqHeader = "X-Current-Karl-Keepalive-Seq";
+
+namespace impl {
+
+inline void ParseKeepaliveJSONObject(rapidjson::Document& document, const std::string& json) {
+  if (document.Parse(json.c_str()).HasParseError() || !document.IsObject()) {
+    CURRENT_THROW(TypeSystemParseJSONException("Keepalive delta: expected a JSON object."));
+  }
+}
+
+inline std::string RapidJSONValueAsString(const rapidjson::Value& value) {
+  rapidjson::StringBuffer string_buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
+  value.Accept(writer);
+  return std::string(string_buffer.GetString(), string_buffer.GetSize());
+}
+
+}  // namespace impl
+
+// The fields of the `json` object which are missing from the `base` object or differ from them, and the fields of
+// `base` which `json` does not have, as `null`-s. An empty object if nothing has changed.
+inline std::string KeepaliveJSONDelta(const std::string& base, const std::string& json) {
+  rapidjson::Document base_document;
+  rapidjson::Document document;
+  impl::ParseKeepaliveJSONObject(base_document, base);
+  impl::ParseKeepaliveJSONObject(document, json);
+  rapidjson::StringBuffer string_buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
+  writer.StartObject();
+  for (const auto& field : document.GetObject()) {
+    const auto base_field = base_document.FindMember(field.name);
+    if (base_field == base_document.MemberEnd() || base_field->value != field.value) {
+      writer.Key(field.name.GetString(), field.name.GetStringLength());
+      field.value.Accept(writer);
+    }
+  }
+  for (const auto& base_field : base_document.GetObject()) {
+    if (!document.HasMember(base_field.name)) {
+      writer.Key(base_field.name.GetString(), base_field.name.GetStringLength());
+      writer.Null();
+    }
+  }
+  writer.EndObject();
+  return std::string(string_buffer.GetString(), string_buffer.GetSize());
+}
+
+// Restores the JSON object `KeepaliveJSONDelta()` was called with from its `base` and the `delta`.
+// The fields keep their order from `base`, with the new ones appended.
+inline std::string ApplyKeepaliveJSONDelta(const std::string& base, const std::string& delta) {
+  rapidjson::Document document;
+  rapidjson::Document delta_document;
+  impl::ParseKeepaliveJSONObject(document, base);
+  impl::ParseKeepaliveJSONObject(delta_document, delta);
+  auto& allocator = document.GetAllocator();
+  for (const auto& field : delta_document.GetObject()) {
+    const auto existing_field = document.FindMember(field.name);
+    if (existing_field != document.MemberEnd()) {
+      existing_field->value.CopyFrom(field.value, allocator);
+    } else {
+      document.AddMember(rapidjson::Value(field.name, allocator), rapidjson::Value(field.value, allocator), allocator);
+    }
+  }
+  return impl::RapidJSONValueAsString(document);
+}
+
+}  // namespace karl
+}  // namespace current
+
+#endif  // KARL_KEEPALIVE_DELTA_H
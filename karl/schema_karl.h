@@ -81,6 +81,10 @@ CURRENT_STRUCT(KarlParameters) {
   CURRENT_FIELD_DESCRIPTION(service_timeout_interval,
                             "The default period of keepalive-free inactivity, after which a service is "
                             "considered down for fleet browsability purposes.");
+  CURRENT_FIELD(keepalives_checkpoint_every, uint32_t, 16u);
+  CURRENT_FIELD_DESCRIPTION(keepalives_checkpoint_every,
+                            "Persist every this many keepalives from a service in full, and the ones in between as "
+                            "the deltas from the previous ones. `1` to persist each keepalive in full.");
 
   KarlParameters& SetKeepalivesPort(uint16_t port) {
     keepalives_port = port;
@@ -114,6 +118,10 @@ CURRENT_STRUCT(KarlParameters) {
     nginx_parameters = value;
     return *this;
   }
+  KarlParameters& SetKeepalivesCheckpointEvery(uint32_t value) {
+    keepalives_checkpoint_every = value;
+    return *this;
+  }
 };
 
 // Karl's persisted storage schema.
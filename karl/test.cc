@@ -946,6 +946,157 @@ TEST(Karl, ModifiedClaireBoilerplateStatus) {
   }
 }
 
+TEST(Karl, SnapshotAfterRestart) {
+  current::time::ResetToZero();
+
+  const auto params = UnittestKarlParameters();
+  const auto stream_file_remover = current::FileSystem::ScopedRmFile(params.stream_persistence_file);
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(params.storage_persistence_file);
+  const current::karl::Locator karl_locator(Printf("http://localhost:%d/", FLAGS_karl_test_keepalives_port));
+
+  std::string codename;
+  {
+    const unittest_karl_t karl(params);
+    const uint16_t claire_port = MimicPickPortForUnitTest();
+    current::karl::Claire claire(karl_locator, "unittest", claire_port);
+    claire.Register(nullptr, true);
+    codename = claire.Codename();
+  }
+
+  // The restarted Karl finds the last keepalive of the codename without scanning the stream.
+  const unittest_karl_t karl(params);
+  {
+    const auto response =
+        HTTP(GET(Printf("http://localhost:%d/snapshot/%s", FLAGS_karl_test_fleet_view_port, codename.c_str())));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_NE(std::string::npos, response.body.find("\"codename\":\"" + codename + '"')) << response.body;
+  }
+  EXPECT_EQ(404,
+            static_cast<int>(
+                HTTP(GET(Printf("http://localhost:%d/snapshot/nonexistent", FLAGS_karl_test_fleet_view_port))).code));
+  {
+    unittest_karl_status_t status;
+    ASSERT_NO_THROW(status = ParseJSON<unittest_karl_status_t>(
+                        HTTP(GET(Printf("http://localhost:%d?from=0&full", FLAGS_karl_test_fleet_view_port))).body));
+    ASSERT_TRUE(status.machines.count("127.0.0.1")) << JSON(status);
+    EXPECT_EQ(1u, status.machines["127.0.0.1"].services.count(codename)) << JSON(status);
+  }
+}
+
+TEST(Karl, KeepaliveJSONDelta) {
+  using current::karl::ApplyKeepaliveJSONDelta;
+  using current::karl::KeepaliveJSONDelta;
+
+  const std::string base = "{\"a\":1,\"b\":{\"x\":[1,2]},\"c\":\"same\",\"gone\":true}";
+  const std::string json = "{\"a\":2,\"b\":{\"x\":[1,2]},\"c\":\"same\",\"new\":null}";
+  const std::string delta = KeepaliveJSONDelta(base, json);
+  EXPECT_EQ("{\"a\":2,\"new\":null,\"gone\":null}", delta);
+  EXPECT_EQ("{\"a\":2,\"b\":{\"x\":[1,2]},\"c\":\"same\",\"gone\":null,\"new\":null}",
+            ApplyKeepaliveJSONDelta(base, delta));
+  EXPECT_EQ("{}", KeepaliveJSONDelta(json, json));
+  EXPECT_EQ(json, ApplyKeepaliveJSONDelta(json, "{}"));
+  ASSERT_THROW(ApplyKeepaliveJSONDelta(base, "[]"), TypeSystemParseJSONException);
+}
+
+TEST(Karl, DeltaKeepalives) {
+  current::time::ResetToZero();
+
+  auto params = UnittestKarlParameters();
+  params.SetKeepalivesCheckpointEvery(3u);
+  const auto stream_file_remover = current::FileSystem::ScopedRmFile(params.stream_persistence_file);
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(params.storage_persistence_file);
+  const current::karl::Locator karl_locator(Printf("http://localhost:%d/", FLAGS_karl_test_keepalives_port));
+  const uint16_t claire_port = MimicPickPortForUnitTest();
+  current::karl::Claire claire(karl_locator, "unittest", claire_port);
+  const std::string codename = claire.Codename();
+  const std::string route = Printf(
+      "http://localhost:%d/?codename=%s&port=%d", FLAGS_karl_test_keepalives_port, codename.c_str(), claire_port);
+  const std::string snapshot_url =
+      Printf("http://localhost:%d/snapshot/%s", FLAGS_karl_test_fleet_view_port, codename.c_str());
+  const char* kSeqHeader = "X-Current-Karl-Keepalive-Seq";
+
+  {
+    const unittest_karl_t karl(params);
+
+    // The full keepalive with its `seq` is acknowledged, and the next one can be the delta against it.
+    const auto full = HTTP(POST(route + "&seq=1", HTTP(GET(Printf("http://localhost:%d/.current", claire_port))).body));
+    EXPECT_EQ(200, static_cast<int>(full.code));
+    EXPECT_EQ("1", full.headers.GetOrDefault(kSeqHeader, ""));
+
+    const auto delta = HTTP(POST(route + "&seq=2&delta_base=1", "{\"cloud_instance_name\":\"from_delta\"}"));
+    EXPECT_EQ(200, static_cast<int>(delta.code));
+    EXPECT_EQ("2", delta.headers.GetOrDefault(kSeqHeader, ""));
+    EXPECT_NE(std::string::npos, HTTP(GET(snapshot_url)).body.find("\"cloud_instance_name\":\"from_delta\""));
+
+    // The delta against any other keepalive is rejected, for Claire to resend it in full.
+    EXPECT_EQ(409, static_cast<int>(HTTP(POST(route + "&seq=3&delta_base=1", "{}")).code));
+  }
+
+  // The first keepalive is persisted in full, and the second one as the delta against it.
+  {
+    std::vector<std::string> records;
+    for (const auto& line : current::strings::Split(
+             current::FileSystem::ReadFileAsString(params.stream_persistence_file), '\n')) {
+      if (!line.empty() && line.front() == '{') {
+        records.push_back(line);
+      }
+    }
+    ASSERT_EQ(2u, records.size());
+    EXPECT_NE(std::string::npos, records[0].find("\"delta\":null")) << records[0];
+    EXPECT_NE(std::string::npos, records[1].find("\"keepalive\":null")) << records[1];
+  }
+
+  {
+    const unittest_karl_t karl(params);
+
+    // The restarted Karl restores the last keepalive from the persisted delta, but can not accept deltas against it.
+    EXPECT_NE(std::string::npos, HTTP(GET(snapshot_url)).body.find("\"cloud_instance_name\":\"from_delta\""));
+    EXPECT_EQ(409, static_cast<int>(HTTP(POST(route + "&seq=3&delta_base=2", "{}")).code));
+
+    // Claire sends the deltas, in between the full keepalives persisted every three, and Karl restores each of them.
+    claire.Register(nullptr, true);
+    for (int i = 1; i <= 5; ++i) {
+      current::time::SetNow(std::chrono::microseconds(i * 1000), std::chrono::microseconds(i * 1000 + 100));
+      claire.SetDependencies({Printf("http://127.0.0.1:%d", 10000 + i)});
+      claire.ForceSendKeepalive(current::karl::ForceSendKeepaliveWaitRequest::Wait);
+      const auto snapshot = HTTP(GET(snapshot_url));
+      EXPECT_EQ(200, static_cast<int>(snapshot.code));
+      EXPECT_NE(std::string::npos, snapshot.body.find(Printf("\"port\":%d", 10000 + i))) << snapshot.body;
+    }
+  }
+}
+
+TEST(Karl, MigratesFullKeepalivesStream) {
+  current::time::ResetToZero();
+
+  const auto params = UnittestKarlParameters();
+  const auto stream_file_remover = current::FileSystem::ScopedRmFile(params.stream_persistence_file);
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(params.storage_persistence_file);
+  const std::string snapshot_url = Printf("http://localhost:%d/snapshot/BASELINE", FLAGS_karl_test_fleet_view_port);
+
+  // The stream persisted by Karl before the delta keepalives, with `KarlPersistedKeepalive` holding the full status.
+  const std::string golden_stream = current::FileSystem::ReadFileAsString(
+      current::FileSystem::JoinPath("golden", "keepalives_baseline.stream"));
+  current::FileSystem::WriteStringToFile(golden_stream, params.stream_persistence_file.c_str());
+
+  {
+    const unittest_karl_t karl(params);
+    const auto snapshot = HTTP(GET(snapshot_url));
+    EXPECT_EQ(200, static_cast<int>(snapshot.code));
+    EXPECT_NE(std::string::npos, snapshot.body.find("\"codename\":\"BASELINE\"")) << snapshot.body;
+  }
+
+  // Only the signature has been rewritten, and the migrated stream opens as is.
+  const std::string migrated_stream = current::FileSystem::ReadFileAsString(params.stream_persistence_file);
+  EXPECT_NE(golden_stream, migrated_stream);
+  EXPECT_EQ(golden_stream.substr(golden_stream.find('\n')), migrated_stream.substr(migrated_stream.find('\n')));
+  {
+    const unittest_karl_t karl(params);
+    EXPECT_EQ(200, static_cast<int>(HTTP(GET(snapshot_url)).code));
+  }
+  EXPECT_EQ(migrated_stream, current::FileSystem::ReadFileAsString(params.stream_persistence_file));
+}
+
 // To run a `curl`-able test: ./.current/test --karl_run_test_forever --gtest_filter=Karl.EndToEndTest
 TEST(Karl, EndToEndTest) {
   current::time::ResetToZero();
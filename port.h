@@ -301,6 +301,13 @@ inline void CURRENT_ASSERTION_FAILED(const char* text, const char* file, int lin
 // * Some type errors may go unnoticed.
 // #define VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 
+// The `CURRENT_VARIANT_INLINE_STORAGE_SIZE` macro sets the size, in bytes, of the buffer within each `Variant`
+// to store its value in, so that no heap allocation is needed for the values of the types that fit.
+// Set it to zero to have all the values of all the `Variant`-s allocated on the heap.
+#ifndef CURRENT_VARIANT_INLINE_STORAGE_SIZE
+#define CURRENT_VARIANT_INLINE_STORAGE_SIZE 64
+#endif
+
 #ifdef CURRENT_PORT_H_CRT_SECURE_NO_WARNINGS_FLAG_REQUIRES_UNSET
 #undef _CRT_SECURE_NO_WARNINGS
 #undef CURRENT_PORT_H_CRT_SECURE_NO_WARNINGS_FLAG_REQUIRES_UNSET
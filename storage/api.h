@@ -137,8 +137,15 @@ struct PerFieldRESTfulHandlerGenerator {
     const auto generic_data_handler = [&storage, restful_url_prefix, field_name](Request request) {
       // TODO(dkorolev): Pass `BorrowedWithCallback<Storage>` into the request handler.
       auto generic_input = RESTfulGenericInput<STORAGE>(storage, restful_url_prefix);
-      std::lock_guard<std::mutex> lock(storage.UnderlyingStream()->Impl()->publishing_mutex);
-      const bool is_master = storage.template IsMasterStorage<current::locks::MutexLockStatus::AlreadyLocked>();
+      // Only the mutating methods hold the publishing mutex throughout. The GET-s take the shared lock of their
+      // read-only transactions, so that they run concurrently.
+      std::unique_lock<std::mutex> lock(storage.UnderlyingStream()->Impl()->publishing_mutex, std::defer_lock);
+      if (request.method != "GET") {
+        lock.lock();
+      }
+      const bool is_master = lock.owns_lock()
+                                 ? storage.template IsMasterStorage<current::locks::MutexLockStatus::AlreadyLocked>()
+                                 : storage.IsMasterStorage();
       if (request.method == "GET") {
         GETHandler handler;
         Optional<FieldExportParams> requested_export_params;
@@ -154,24 +161,23 @@ struct PerFieldRESTfulHandlerGenerator {
         handler.Enter(
             std::move(request),
             // Capture by reference since this lambda is run synchronously.
-            [&storage, &handler, &generic_input, &field_name, requested_export_params](
+            [&handler, &generic_input, &field_name, is_master, requested_export_params](
                 Request request,
                 const Optional<typename field_type_dependent_t<specific_field_t>::url_key_t>& url_key) {
               const specific_field_t& field = generic_input.storage(::current::storage::ImmutableFieldByIndex<INDEX>());
               generic_input.storage
-                  .template ReadOnlyTransaction<current::locks::MutexLockStatus::AlreadyLocked>(
+                  .ReadOnlyTransaction(
                       // Capture local variables by value for safe async transactions.
-                      [&storage, handler, generic_input, &field, url_key, field_name, requested_export_params](
+                      [handler, generic_input, &field, url_key, field_name, is_master, requested_export_params](
                           immutable_fields_t fields) -> Response {
                         using GETInput = RESTfulGETInput<STORAGE, specific_field_t>;
-                        const GETInput input(
-                            std::move(generic_input),
-                            fields,
-                            field,
-                            field_name,
-                            url_key,
-                            storage.template IsMasterStorage<current::locks::MutexLockStatus::AlreadyLocked>(),
-                            requested_export_params);
+                        const GETInput input(std::move(generic_input),
+                                             fields,
+                                             field,
+                                             field_name,
+                                             url_key,
+                                             is_master,
+                                             requested_export_params);
                         return handler.Run(input);
                       },
                       std::move(request))
@@ -288,6 +294,15 @@ struct PerFieldRESTfulHandlerGenerator {
     RegisterAdditionalFieldDataHandlers<FIELD_TYPE, ENTRY_TYPE_WRAPPER>(
         field_name, field_rest_endpoints_schema_t(), generic_data_handler);
 
+    // Secondary indexes, `GET /data/$FIELD.$INDEX?$INDEXED_FIELD=...`.
+    for (const auto* index : storage(::current::storage::ImmutableFieldByIndex<INDEX>()).Indexes()) {
+      registerer(storage_handlers_map_entry_t(field_name,
+                                              RESTfulRoute(kRESTfulDataURLComponent,
+                                                           '.' + index->IndexName(),
+                                                           URLPathArgs::CountMask::None,
+                                                           GenerateSecondaryIndexHandler(index))));
+    }
+
     // Schema handlers.
 
     SchemaHandlerImpl<entry_t>().RegisterRoutes(
@@ -298,6 +313,39 @@ struct PerFieldRESTfulHandlerGenerator {
         });
   }
 
+  // Responds with the entries which have the indexed fields equal to the URL query parameters of the same names,
+  // as newline-separated JSONs, the same way for every `REST_IMPL`.
+  template <typename SECONDARY_INDEX>
+  std::function<void(Request)> GenerateSecondaryIndexHandler(const SECONDARY_INDEX* index) {
+    auto& storage = this->storage;
+    return [&storage, index](Request request) {
+      // TODO(dkorolev): Pass `BorrowedWithCallback<Storage>` into the request handler.
+      if (request.method != "GET") {
+        request(REST_IMPL::ErrorMethodNotAllowed(request.method, "Only GET method is allowed for secondary indexes."));
+        return;
+      }
+      std::vector<std::string> values;
+      for (const std::string& indexed_field_name : index->IndexedFieldNames()) {
+        if (!request.url.query.has(indexed_field_name)) {
+          request(Response("Missing `" + indexed_field_name + "`.\n", HTTPResponseCode.BadRequest));
+          return;
+        }
+        values.push_back(request.url.query[indexed_field_name]);
+      }
+      storage
+          .ReadOnlyTransaction(
+              [index, values](immutable_fields_t) -> Response {
+                std::ostringstream result;
+                for (const auto* entry : index->LookupFromStrings(values)) {
+                  result << JSON(*entry) << '\n';
+                }
+                return result.str();
+              },
+              std::move(request))
+          .Detach();
+    };
+  }
+
   template <typename FIELD_TYPE, typename ENTRY_TYPE_WRAPPER, typename GENERIC_HANDLER>
   void RegisterAdditionalFieldDataHandlers(const std::string& field_name,
                                            semantics::rest::RESTWithSingleKey,
@@ -324,7 +372,6 @@ struct PerFieldRESTfulHandlerGenerator {
 
     return [&storage, restful_url_prefix, field_name](Request request) {
       // TODO(dkorolev): Pass `BorrowedWithCallback<Storage>` into the request handler.
-      std::lock_guard<std::mutex> lock(storage.UnderlyingStream()->Impl()->publishing_mutex);
       auto generic_input = RESTfulGenericInput<STORAGE>(storage, restful_url_prefix);
       if (request.method == "GET") {
         DataHandlerImpl<GET, PARTIAL_KEY_OPERATION, specific_field_t, entry_t, key_t> handler;
@@ -334,7 +381,7 @@ struct PerFieldRESTfulHandlerGenerator {
             [&handler, &generic_input, &field_name](Request request, const Optional<std::string>& url_key) {
               const specific_field_t& field = generic_input.storage(::current::storage::ImmutableFieldByIndex<INDEX>());
               generic_input.storage
-                  .template ReadOnlyTransaction<current::locks::MutexLockStatus::AlreadyLocked>(
+                  .ReadOnlyTransaction(
                       // Capture local variables by value for safe async transactions.
                       [handler, generic_input, &field, url_key, field_name](immutable_fields_t fields) -> Response {
                         using RowColGETInput = RESTfulGETRowColInput<STORAGE,
@@ -588,7 +635,6 @@ class RESTfulStorage {
     const Data& data = *data_;
 
     const auto cqs_query_handler = [&data, &storage, restful_url_prefix](Request request) {
-      std::lock_guard<std::mutex> lock(storage.UnderlyingStream()->Impl()->publishing_mutex);
       if (request.url_path_args.empty()) {
         request(Response(cqs::CQSHandlerNotSpecified(), HTTPResponseCode.NotFound));
       } else if (request.method != "GET") {
@@ -612,7 +658,7 @@ class RESTfulStorage {
                             const STORAGE_IMPL& storage = generic_input.storage;
                             const cqs::CQSParameters cqs_parameters(generic_input.restful_url_prefix, request);
                             storage
-                                .template ReadOnlyTransaction<current::locks::MutexLockStatus::AlreadyLocked>(
+                                .ReadOnlyTransaction(
                                     // TODO(dkorolev): Revisit this as Owned/Borrowed are the organic part of Storage.
                                     // Capture local variables by value for safe async transactions.
                                     [&f_run_query, handler, cqs_parameters, type_erased_query, context](
@@ -28,7 +28,11 @@ SOFTWARE.
 
 #include "../port.h"
 
-#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
 
 #include "semantics.h"
 #include "transaction.h"
@@ -134,6 +138,29 @@ struct FieldImpl<CountFields, T> {
 template <typename INSTANTIATION_TYPE, typename T>
 using Field = typename FieldImpl<INSTANTIATION_TYPE, T>::type;
 
+// The secondary indexes, `CURRENT_STORAGE_FIELD_INDEX`, are the members of the fields struct too, but are not fields.
+// Each one is a single byte in the `CountFields` instantiation, which the `sizeof`-based `FieldCounter` rounds away.
+struct CountFieldsIndexPlaceholder {
+  template <typename... T>
+  CountFieldsIndexPlaceholder(T&&...) {}
+};
+
+template <typename INSTANTIATION_TYPE, typename T>
+struct FieldIndexImpl;
+
+template <typename T>
+struct FieldIndexImpl<DeclareFields, T> {
+  typedef T type;
+};
+
+template <typename T>
+struct FieldIndexImpl<CountFields, T> {
+  typedef CountFieldsIndexPlaceholder type;
+};
+
+template <typename INSTANTIATION_TYPE, typename T>
+using FieldIndex = typename FieldIndexImpl<INSTANTIATION_TYPE, T>::type;
+
 template <typename T>
 struct FieldCounter {
   enum { value = sizeof(typename T::CURRENT_STORAGE_FIELD_COUNT_STRUCT) / sizeof(CountFieldsImplementationType) };
@@ -189,16 +216,109 @@ template <typename FIELDS, int COUNT>
 using FieldsTypeList = typename TypeListMapperImpl<FIELDS, current::variadic_indexes::generate_indexes<COUNT>>::result;
 #endif  // CURRENT_STORAGE_PATCH_SUPPORT
 
+// `UndoLog` is the rollback half of the `MutationJournal`: the typed undo records of one transaction, each being
+// the callable that reverts one mutation. The records are constructed in place, back to back, in an arena of chunks,
+// which is reset, not freed, once the transaction is over. Thus, once the arena has grown to the size of a typical
+// transaction, logging a mutation allocates nothing, and move-only records, such as the ones owning the previous
+// value of the mutated object, are supported.
+class UndoLog final {
+ public:
+  UndoLog() = default;
+  UndoLog(const UndoLog&) = delete;
+  UndoLog& operator=(const UndoLog&) = delete;
+  UndoLog(UndoLog&&) = delete;
+  UndoLog& operator=(UndoLog&&) = delete;
+  ~UndoLog() { Clear(); }
+
+  template <typename F>
+  void Push(F&& undo) {
+    using record_t = Record<std::decay_t<F>>;
+    static_assert(alignof(record_t) <= alignof(std::max_align_t), "");
+    records_.push_back(new (Allocate(sizeof(record_t))) record_t(std::forward<F>(undo)));
+  }
+
+  // Runs the undo records in the reverse order, and clears the log.
+  void UndoAll() {
+    for (auto rit = records_.rbegin(); rit != records_.rend(); ++rit) {
+      (*rit)->Undo();
+    }
+    Clear();
+  }
+
+  // Destroys the records, keeping up to `kMaxRetainedChunks` chunks of the arena for the next transaction.
+  void Clear() {
+    for (auto rit = records_.rbegin(); rit != records_.rend(); ++rit) {
+      (*rit)->~RecordBase();
+    }
+    records_.clear();
+    if (chunks_.size() > kMaxRetainedChunks) {
+      chunks_.erase(chunks_.begin() + kMaxRetainedChunks, chunks_.end());
+    }
+    current_chunk_ = 0u;
+    current_chunk_offset_ = 0u;
+  }
+
+  bool Empty() const { return records_.empty(); }
+  size_t Size() const { return records_.size(); }
+
+ private:
+  constexpr static size_t kChunkSize = 64 * 1024;
+  constexpr static size_t kMaxRetainedChunks = 16;
+
+  struct RecordBase {
+    virtual ~RecordBase() = default;
+    virtual void Undo() = 0;
+  };
+
+  template <typename F>
+  struct Record final : RecordBase {
+    F undo;
+    template <typename ARG>
+    explicit Record(ARG&& arg) : undo(std::forward<ARG>(arg)) {}
+    void Undo() override { undo(); }
+  };
+
+  struct Chunk final {
+    std::unique_ptr<std::max_align_t[]> data;
+    size_t size;
+    explicit Chunk(size_t size)
+        : data(std::make_unique<std::max_align_t[]>(size / sizeof(std::max_align_t))), size(size) {}
+  };
+
+  void* Allocate(size_t bytes) {
+    bytes = (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t) * sizeof(std::max_align_t);
+    while (current_chunk_ < chunks_.size() && current_chunk_offset_ + bytes > chunks_[current_chunk_].size) {
+      ++current_chunk_;
+      current_chunk_offset_ = 0u;
+    }
+    if (current_chunk_ == chunks_.size()) {
+      // The chunks skipped above, if any, are too small for this record, so just append a large enough one.
+      chunks_.emplace_back(std::max(kChunkSize, bytes));
+      current_chunk_offset_ = 0u;
+    }
+    void* result = reinterpret_cast<char*>(chunks_[current_chunk_].data.get()) + current_chunk_offset_;
+    current_chunk_offset_ += bytes;
+    return result;
+  }
+
+  std::vector<RecordBase*> records_;
+  std::vector<Chunk> chunks_;
+  size_t current_chunk_ = 0u;
+  size_t current_chunk_offset_ = 0u;
+};
+
 // `MutationJournal` keeps all the changes made during one transaction, as well as the way to rollback them.
+// The rollback callables passed to `LogMutation` are stored in the `UndoLog` arena as they are, so they should
+// capture the previous values by move, not by copy, wherever the container is about to overwrite or erase them anyway.
 struct MutationJournal {
   TransactionMeta transaction_meta;
   std::vector<std::unique_ptr<current::CurrentStruct>> commit_log;
-  std::vector<std::function<void()>> rollback_log;
+  UndoLog rollback_log;
 
-  template <typename T>
-  void LogMutation(T&& entry, std::function<void()> rollback) {
-    commit_log.push_back(std::make_unique<T>(std::move(entry)));
-    rollback_log.push_back(rollback);
+  template <typename T, typename F>
+  void LogMutation(T&& entry, F&& rollback) {
+    commit_log.push_back(std::make_unique<std::decay_t<T>>(std::forward<T>(entry)));
+    rollback_log.Push(std::forward<F>(rollback));
   }
 
   void BeforeTransaction() { transaction_meta.begin_us = current::time::Now(); }
@@ -206,9 +326,7 @@ struct MutationJournal {
   void AfterTransaction() { transaction_meta.end_us = current::time::Now(); }
 
   void Rollback() {
-    for (auto rit = rollback_log.rbegin(); rit != rollback_log.rend(); ++rit) {
-      (*rit)();
-    }
+    rollback_log.UndoAll();
     Clear();
   }
 
@@ -217,7 +335,7 @@ struct MutationJournal {
     transaction_meta.end_us = std::chrono::microseconds(0);
     transaction_meta.fields.clear();
     commit_log.clear();
-    rollback_log.clear();
+    rollback_log.Clear();
   }
 
   void AssertEmpty() const {
@@ -225,7 +343,7 @@ struct MutationJournal {
     CURRENT_ASSERT(transaction_meta.end_us.count() == 0);
     CURRENT_ASSERT(transaction_meta.fields.empty());
     CURRENT_ASSERT(commit_log.empty());
-    CURRENT_ASSERT(rollback_log.empty());
+    CURRENT_ASSERT(rollback_log.Empty());
   }
 };
 
@@ -27,6 +27,7 @@ SOFTWARE.
 #define CURRENT_STORAGE_CONTAINER_DICTIONARY_H
 
 #include "common.h"
+#include "index.h"
 #include "sfinae.h"
 
 #include "../base.h"
@@ -85,45 +86,54 @@ class GenericDictionary {
     const auto map_iterator = map_.find(key);
     const auto lm_iterator = last_modified_.find(key);
     if (map_iterator != map_.end()) {
-      const T& previous_object = map_iterator->second;
       CURRENT_ASSERT(lm_iterator != last_modified_.end());
       const auto previous_timestamp = lm_iterator->second;
-      journal_.LogMutation(UPDATE_EVENT(now, object), [this, key, previous_object, previous_timestamp]() {
-        last_modified_[key] = previous_timestamp;
-        map_[key] = previous_object;
-      });
+      // The previous object is about to be overwritten, so move it into the rollback record instead of copying it.
+      // As `object` may refer to the previous object itself, it is copied, and the event is built, before the move.
+      T updated_object = object;
+      UPDATE_EVENT event(now, updated_object);
+      journal_.LogMutation(
+          std::move(event),
+          [this, key, previous_object = std::move(map_iterator->second), previous_timestamp]() mutable {
+            last_modified_[key] = previous_timestamp;
+            DoPut(key, std::move(previous_object));
+          });
+      last_modified_[key] = now;
+      DoPut(key, std::move(updated_object));
     } else {
       if (lm_iterator != last_modified_.end()) {
         const auto previous_timestamp = lm_iterator->second;
         journal_.LogMutation(UPDATE_EVENT(now, object), [this, key, previous_timestamp]() {
           last_modified_[key] = previous_timestamp;
-          map_.erase(key);
+          DoErase(key);
         });
       } else {
         journal_.LogMutation(UPDATE_EVENT(now, object), [this, key]() {
           last_modified_.erase(key);
-          map_.erase(key);
+          DoErase(key);
         });
       }
+      last_modified_[key] = now;
+      DoPut(key, object);
     }
-    last_modified_[key] = now;
-    map_[key] = object;
   }
 
   void Erase(sfinae::CF<key_t> key) {
     const auto now = current::time::Now();
     const auto map_iterator = map_.find(key);
     if (map_iterator != map_.end()) {
-      const T& previous_object = map_iterator->second;
       const auto lm_iterator = last_modified_.find(key);
       CURRENT_ASSERT(lm_iterator != last_modified_.end());
       const auto previous_timestamp = lm_iterator->second;
-      journal_.LogMutation(DELETE_EVENT(now, previous_object), [this, key, previous_object, previous_timestamp]() {
-        last_modified_[key] = previous_timestamp;
-        map_[key] = previous_object;
-      });
+      DELETE_EVENT event(now, map_iterator->second);
+      journal_.LogMutation(
+          std::move(event),
+          [this, key, previous_object = std::move(map_iterator->second), previous_timestamp]() mutable {
+            last_modified_[key] = previous_timestamp;
+            DoPut(key, std::move(previous_object));
+          });
       last_modified_[key] = now;
-      map_.erase(map_iterator);
+      DoErase(map_iterator);
     }
   }
 
@@ -131,8 +141,7 @@ class GenericDictionary {
   // NOTE(dkorolev): The `patch_object` parameter should be passed by value,
   // as otherwise it won't be valid during the possible rollback.
   template <typename E = entry_t>
-  std::enable_if_t<HasPatch<E>(), bool>::type Patch(sfinae::CF<key_t> key,
-                                                    const typename E::patch_object_t patch_object) {
+  std::enable_if_t<HasPatch<E>(), bool> Patch(sfinae::CF<key_t> key, const typename E::patch_object_t patch_object) {
     static_assert(std::is_same_v<E, entry_t>, "");
     const auto now = current::time::Now();
     const auto map_iterator = map_.find(key);
@@ -141,13 +150,14 @@ class GenericDictionary {
       const auto lm_iterator = last_modified_.find(key);
       CURRENT_ASSERT(lm_iterator != last_modified_.end());
       const auto previous_timestamp = lm_iterator->second;
+      // The object is patched in place, so this is the one mutation which has to copy the previous value.
       journal_.LogMutation(PATCH_EVENT_OR_VOID(now, key, patch_object),
                            [this, key, previous_object, previous_timestamp]() {
                              last_modified_[key] = previous_timestamp;
-                             map_[key] = previous_object;
+                             DoPut(key, previous_object);
                            });
       last_modified_[key] = now;
-      map_iterator->second.PatchWith(patch_object);
+      DoPatch(map_iterator, patch_object);
       return true;
     } else {
       return false;
@@ -168,11 +178,11 @@ class GenericDictionary {
   void operator()(const UPDATE_EVENT& e) {
     const auto key = sfinae::GetKey(e.data);
     last_modified_[key] = e.us;
-    map_[key] = e.data;
+    DoPut(key, e.data);
   }
   void operator()(const DELETE_EVENT& e) {
     last_modified_[e.key] = e.us;
-    map_.erase(e.key);
+    DoErase(e.key);
   }
 #ifdef CURRENT_STORAGE_PATCH_SUPPORT
   struct DummyStructForNonExistentPatch {};  // Essential, as can't form a reference to `void` even if disabled.
@@ -181,11 +191,27 @@ class GenericDictionary {
     auto it = map_.find(e.key);
     if (it != map_.end()) {
       last_modified_[e.key] = e.us;
-      it->second.PatchWith(e.patch);
+      DoPatch(it, e.patch);
     }
   }
 #endif  // CURRENT_STORAGE_PATCH_SUPPORT
 
+  // Calls `f` with the events which rebuild this container from scratch, deletions first. For storage snapshots.
+  template <typename F>
+  void SnapshotEvents(F&& f) const {
+    for (const auto& key_and_timestamp : last_modified_) {
+      if (map_.find(key_and_timestamp.first) == map_.end()) {
+        DELETE_EVENT e;
+        e.us = key_and_timestamp.second;
+        e.key = key_and_timestamp.first;
+        f(e);
+      }
+    }
+    for (const auto& element : map_) {
+      f(UPDATE_EVENT(last_modified_.at(element.first), element.second));
+    }
+  }
+
   struct Iterator final {
     using iterator_t = typename map_t::const_iterator;
     using value_t = sfinae::CF<T>;
@@ -204,11 +230,57 @@ class GenericDictionary {
   Iterator begin() const { return Iterator(map_.cbegin()); }
   Iterator end() const { return Iterator(map_.cend()); }
 
+  // Called by the `CURRENT_STORAGE_FIELD_INDEX`-declared indexes of this field as they are constructed and destroyed.
+  void RegisterSecondaryIndex(SecondaryIndexBase<T, key_t>& index) {
+    indexes_.Register(index, [this](auto&& f) {
+      for (const auto& element : map_) {
+        f(element.first, element.second);
+      }
+    });
+  }
+  void UnregisterSecondaryIndex(SecondaryIndexBase<T, key_t>& index) { indexes_.Unregister(index); }
+  const SecondaryIndexes<T, key_t>& Indexes() const { return indexes_; }
+
  private:
+  // All the changes to `map_` go through these three, to keep the secondary indexes, if any, up to date.
+  template <typename O>
+  void DoPut(sfinae::CF<key_t> key, O&& object) {
+    auto iterator = map_.find(key);
+    if (iterator != map_.end()) {
+      indexes_.Erase(&iterator->second);
+      iterator->second = std::forward<O>(object);
+    } else {
+      iterator = map_.emplace(key, std::forward<O>(object)).first;
+    }
+    indexes_.Insert(key, iterator->second);
+  }
+
+  void DoErase(typename map_t::iterator iterator) {
+    indexes_.Erase(&iterator->second);
+    map_.erase(iterator);
+  }
+
+  void DoErase(sfinae::CF<key_t> key) {
+    const auto iterator = map_.find(key);
+    if (iterator != map_.end()) {
+      DoErase(iterator);
+    }
+  }
+
+#ifdef CURRENT_STORAGE_PATCH_SUPPORT
+  template <typename PATCH>
+  void DoPatch(typename map_t::iterator iterator, const PATCH& patch) {
+    indexes_.Erase(&iterator->second);
+    iterator->second.PatchWith(patch);
+    indexes_.Insert(iterator->first, iterator->second);
+  }
+#endif  // CURRENT_STORAGE_PATCH_SUPPORT
+
   const std::string field_name_;
   map_t map_;
   std::unordered_map<key_t, std::chrono::microseconds, GenericHashFunction<key_t>> last_modified_;
   MutationJournal& journal_;
+  SecondaryIndexes<T, key_t> indexes_;
 };
 
 #ifdef CURRENT_STORAGE_PATCH_SUPPORT
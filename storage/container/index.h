@@ -0,0 +1,274 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Secondary indexes of the storage containers, declared with `CURRENT_STORAGE_FIELD_INDEX`.
+//
+// An index maps the values of one or more fields of the entry to the entries which have them, grouped by the value,
+// and then by the primary key; an `Ordered` index keeps both orders. The container notifies its indexes of every
+// object it places or removes, be it a mutation from a transaction, its rollback, or a replayed event, so the indexes
+// are never persisted, and are rebuilt along with the container itself on replay.
+
+#ifndef CURRENT_STORAGE_CONTAINER_INDEX_H
+#define CURRENT_STORAGE_CONTAINER_INDEX_H
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+
+#include "../../bricks/exception.h"
+#include "../../bricks/strings/util.h"
+
+namespace current {
+namespace storage {
+namespace container {
+
+// Thrown by `LookupFromStrings()` when the number of values does not match the number of the indexed fields.
+struct SecondaryIndexLookupArityException : Exception {
+  using Exception::Exception;
+};
+
+template <typename T, typename KEY>
+class SecondaryIndexes;
+
+// The index as seen by the container, and by the RESTful API, which only knows the names of the indexes.
+template <typename T, typename KEY>
+class SecondaryIndexBase {
+ public:
+  virtual ~SecondaryIndexBase() = default;
+  virtual const std::string& IndexName() const = 0;
+  virtual const std::vector<std::string>& IndexedFieldNames() const = 0;
+  // The entries with the indexed fields equal to `values`, which are parsed with `FromString`, one per field.
+  virtual std::vector<const T*> LookupFromStrings(const std::vector<std::string>& values) const = 0;
+
+ private:
+  friend class SecondaryIndexes<T, KEY>;
+  // Called after the container has placed the object under `key`. The object stays at this address until `Erase()`.
+  virtual void Insert(const KEY& key, const T& object) = 0;
+  // Called before the container overwrites or removes the object. Its contents may already have been moved from.
+  virtual void Erase(const T* object) = 0;
+};
+
+// The indexes of one container. Costs one check of an empty vector per mutation if there are none.
+template <typename T, typename KEY>
+class SecondaryIndexes final {
+ public:
+  using index_t = SecondaryIndexBase<T, KEY>;
+
+  // Indexes the objects already in the container, which `for_each_object` passes to its argument, `f(key, object)`.
+  template <typename F>
+  void Register(index_t& index, F&& for_each_object) {
+    for_each_object([&index](const KEY& key, const T& object) { index.Insert(key, object); });
+    indexes_.push_back(&index);
+  }
+
+  void Unregister(index_t& index) {
+    indexes_.erase(std::remove(indexes_.begin(), indexes_.end(), &index), indexes_.end());
+  }
+
+  void Insert(const KEY& key, const T& object) const {
+    for (index_t* index : indexes_) {
+      index->Insert(key, object);
+    }
+  }
+
+  void Erase(const T* object) const {
+    for (index_t* index : indexes_) {
+      index->Erase(object);
+    }
+  }
+
+  typename std::vector<index_t*>::const_iterator begin() const { return indexes_.begin(); }
+  typename std::vector<index_t*>::const_iterator end() const { return indexes_.end(); }
+
+ private:
+  std::vector<index_t*> indexes_;
+};
+
+// `KEY_EXTRACTOR` provides `Extract(entry)`, returning the `std::tuple<>` of the indexed fields, and `FieldNames()`.
+// `MAP` is `Ordered` or `Unordered`, for both the values of the indexed fields and the primary keys within each value.
+template <typename CONTAINER, typename KEY_EXTRACTOR, template <typename...> class MAP>
+class GenericSecondaryIndex final : public SecondaryIndexBase<typename CONTAINER::entry_t, typename CONTAINER::key_t> {
+ public:
+  using entry_t = typename CONTAINER::entry_t;
+  using key_t = typename CONTAINER::key_t;
+  using index_key_t = decltype(KEY_EXTRACTOR::Extract(std::declval<const entry_t&>()));
+  using elements_map_t = MAP<key_t, const entry_t*>;
+  using index_map_t = MAP<index_key_t, elements_map_t>;
+
+  GenericSecondaryIndex(const std::string& index_name, CONTAINER& container)
+      : index_name_(index_name), field_names_(KEY_EXTRACTOR::FieldNames()), container_(container) {
+    container_.RegisterSecondaryIndex(*this);
+  }
+  ~GenericSecondaryIndex() { container_.UnregisterSecondaryIndex(*this); }
+
+  GenericSecondaryIndex(const GenericSecondaryIndex&) = delete;
+  GenericSecondaryIndex& operator=(const GenericSecondaryIndex&) = delete;
+  GenericSecondaryIndex(GenericSecondaryIndex&&) = delete;
+  GenericSecondaryIndex& operator=(GenericSecondaryIndex&&) = delete;
+
+  const std::string& IndexName() const override { return index_name_; }
+  const std::vector<std::string>& IndexedFieldNames() const override { return field_names_; }
+
+  bool Empty() const { return index_.empty(); }
+  // The number of distinct values of the indexed fields.
+  size_t Size() const { return index_.size(); }
+
+  // Iterates over the entries of a range of the index, in the order of the index, and then of the primary key.
+  class Iterable final {
+   public:
+    using outer_iterator_t = typename index_map_t::const_iterator;
+    using inner_iterator_t = typename elements_map_t::const_iterator;
+
+    class Iterator final {
+     public:
+      Iterator(outer_iterator_t outer, outer_iterator_t outer_end) : outer_(outer), outer_end_(outer_end) {
+        if (outer_ != outer_end_) {
+          inner_ = outer_->second.begin();
+        }
+      }
+      void operator++() {
+        if (++inner_ == outer_->second.end()) {
+          if (++outer_ != outer_end_) {
+            inner_ = outer_->second.begin();
+          }
+        }
+      }
+      bool operator==(const Iterator& rhs) const {
+        return outer_ == rhs.outer_ && (outer_ == outer_end_ || inner_ == rhs.inner_);
+      }
+      bool operator!=(const Iterator& rhs) const { return !operator==(rhs); }
+      const index_key_t& IndexKey() const { return outer_->first; }
+      const key_t& key() const { return inner_->first; }
+      const entry_t& operator*() const { return *inner_->second; }
+      const entry_t* operator->() const { return inner_->second; }
+
+     private:
+      outer_iterator_t outer_;
+      outer_iterator_t outer_end_;
+      inner_iterator_t inner_;
+    };
+
+    Iterable(outer_iterator_t begin, outer_iterator_t end) : begin_(begin), end_(end) {}
+    Iterator begin() const { return Iterator(begin_, end_); }
+    Iterator end() const { return Iterator(end_, end_); }
+    bool Empty() const { return begin_ == end_; }
+    size_t Size() const {
+      size_t result = 0u;
+      for (auto it = begin_; it != end_; ++it) {
+        result += it->second.size();
+      }
+      return result;
+    }
+
+   private:
+    const outer_iterator_t begin_;
+    const outer_iterator_t end_;
+  };
+
+  // The entries with the indexed fields equal to `args...`, one argument per field.
+  template <typename... ARGS>
+  Iterable Lookup(ARGS&&... args) const {
+    const auto it = index_.find(index_key_t(std::forward<ARGS>(args)...));
+    return it != index_.end() ? Iterable(it, std::next(it)) : Iterable(index_.end(), index_.end());
+  }
+
+  template <typename... ARGS>
+  bool Has(ARGS&&... args) const {
+    return index_.find(index_key_t(std::forward<ARGS>(args)...)) != index_.end();
+  }
+
+  // Ordered indexes only: the entries with the values of the indexed fields in `[from, to)`.
+  Iterable Range(const index_key_t& from, const index_key_t& to) const {
+    const auto begin = index_.lower_bound(from);
+    return index_.key_comp()(from, to) ? Iterable(begin, index_.lower_bound(to)) : Iterable(begin, begin);
+  }
+
+  Iterable All() const { return Iterable(index_.begin(), index_.end()); }
+  typename Iterable::Iterator begin() const { return All().begin(); }
+  typename Iterable::Iterator end() const { return All().end(); }
+
+  std::vector<const entry_t*> LookupFromStrings(const std::vector<std::string>& values) const override {
+    if (values.size() != std::tuple_size<index_key_t>::value) {
+      CURRENT_THROW(SecondaryIndexLookupArityException("The index `" + index_name_ + "` takes " +
+                                                       std::to_string(std::tuple_size<index_key_t>::value) +
+                                                       " value(s), not " + std::to_string(values.size()) + '.'));
+    }
+    std::vector<const entry_t*> result;
+    for (const entry_t& entry :
+         Lookup(ParseIndexKey(values, std::make_index_sequence<std::tuple_size<index_key_t>::value>()))) {
+      result.push_back(&entry);
+    }
+    return result;
+  }
+
+ private:
+  template <size_t... IS>
+  static index_key_t ParseIndexKey(const std::vector<std::string>& values, std::index_sequence<IS...>) {
+    return index_key_t(current::FromString<std::tuple_element_t<IS, index_key_t>>(values[IS])...);
+  }
+
+  void Insert(const key_t& key, const entry_t& object) override {
+    auto index_key = KEY_EXTRACTOR::Extract(object);
+    index_[index_key][key] = &object;
+    placed_.emplace(&object, std::make_pair(std::move(index_key), key));
+  }
+
+  void Erase(const entry_t* object) override {
+    const auto cit = placed_.find(object);
+    if (cit != placed_.end()) {
+      const auto index_cit = index_.find(cit->second.first);
+      if (index_cit != index_.end()) {
+        index_cit->second.erase(cit->second.second);
+        if (index_cit->second.empty()) {
+          index_.erase(index_cit);
+        }
+      }
+      placed_.erase(cit);
+    }
+  }
+
+  const std::string index_name_;
+  const std::vector<std::string> field_names_;
+  CONTAINER& container_;
+  index_map_t index_;
+  // Where each indexed object is, to remove it regardless of its current contents.
+  std::unordered_map<const entry_t*, std::pair<index_key_t, key_t>> placed_;
+};
+
+template <typename CONTAINER, typename KEY_EXTRACTOR>
+using OrderedSecondaryIndex = GenericSecondaryIndex<CONTAINER, KEY_EXTRACTOR, Ordered>;
+
+template <typename CONTAINER, typename KEY_EXTRACTOR>
+using UnorderedSecondaryIndex = GenericSecondaryIndex<CONTAINER, KEY_EXTRACTOR, Unordered>;
+
+}  // namespace container
+}  // namespace storage
+}  // namespace current
+
+#endif  // CURRENT_STORAGE_CONTAINER_INDEX_H
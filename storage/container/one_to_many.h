@@ -27,6 +27,7 @@ SOFTWARE.
 #define CURRENT_STORAGE_CONTAINER_ONE_TO_MANY_H
 
 #include "common.h"
+#include "index.h"
 #include "sfinae.h"
 
 #include "../base.h"
@@ -84,12 +85,9 @@ class GenericOneToMany {
     const auto map_cit = map_.find(key);
     const auto lm_cit = last_modified_.find(key);
     if (map_cit != map_.end()) {
-      const T& previous_object = *(map_cit->second);
       CURRENT_ASSERT(lm_cit != last_modified_.end());
       const auto previous_timestamp = lm_cit->second;
-      journal_.LogMutation(UPDATE_EVENT(now, object), [this, key, previous_object, previous_timestamp]() {
-        DoUpdateWithLastModified(previous_timestamp, key, previous_object);
-      });
+      journal_.LogMutation(UPDATE_EVENT(now, object), RestoreOnRollback(key, previous_timestamp));
     } else {
       const auto transposed_cit = transposed_.find(col);
       if (transposed_cit != transposed_.end()) {
@@ -99,10 +97,7 @@ class GenericOneToMany {
         CURRENT_ASSERT(conflicting_object_lm_cit != last_modified_.end());
         const auto conflicting_object_timestamp = conflicting_object_lm_cit->second;
         journal_.LogMutation(DELETE_EVENT(now, conflicting_object),
-                             [this, conflicting_object_key, conflicting_object, conflicting_object_timestamp]() {
-                               DoUpdateWithLastModified(
-                                   conflicting_object_timestamp, conflicting_object_key, conflicting_object);
-                             });
+                             RestoreOnRollback(conflicting_object_key, conflicting_object_timestamp));
         DoEraseWithLastModified(now, conflicting_object_key);
         now = current::time::Now();
       }
@@ -129,9 +124,7 @@ class GenericOneToMany {
       const auto lm_cit = last_modified_.find(key);
       CURRENT_ASSERT(lm_cit != last_modified_.end());
       const auto previous_timestamp = lm_cit->second;
-      journal_.LogMutation(DELETE_EVENT(now, previous_object), [this, key, previous_object, previous_timestamp]() {
-        DoUpdateWithLastModified(previous_timestamp, key, previous_object);
-      });
+      journal_.LogMutation(DELETE_EVENT(now, previous_object), RestoreOnRollback(key, previous_timestamp));
       DoEraseWithLastModified(now, key);
     }
   }
@@ -146,9 +139,7 @@ class GenericOneToMany {
       const auto lm_cit = last_modified_.find(key);
       CURRENT_ASSERT(lm_cit != last_modified_.end());
       const auto previous_timestamp = lm_cit->second;
-      journal_.LogMutation(DELETE_EVENT(now, previous_object), [this, key, previous_object, previous_timestamp]() {
-        DoUpdateWithLastModified(previous_timestamp, key, previous_object);
-      });
+      journal_.LogMutation(DELETE_EVENT(now, previous_object), RestoreOnRollback(key, previous_timestamp));
       DoEraseWithLastModified(now, key);
     }
   }
@@ -258,16 +249,67 @@ class GenericOneToMany {
   iterator_t begin() const { return iterator_t(map_.begin()); }
   iterator_t end() const { return iterator_t(map_.end()); }
 
+  // Calls `f` with the events which rebuild this container from scratch, deletions first. For storage snapshots.
+  template <typename F>
+  void SnapshotEvents(F&& f) const {
+    for (const auto& key_and_timestamp : last_modified_) {
+      if (map_.find(key_and_timestamp.first) == map_.end()) {
+        DELETE_EVENT e;
+        e.us = key_and_timestamp.second;
+        e.key = key_and_timestamp.first;
+        f(e);
+      }
+    }
+    for (const auto& element : map_) {
+      f(UPDATE_EVENT(last_modified_.at(element.first), *element.second));
+    }
+  }
+
+  // Called by the `CURRENT_STORAGE_FIELD_INDEX`-declared indexes of this field as they are constructed and destroyed.
+  void RegisterSecondaryIndex(SecondaryIndexBase<T, key_t>& index) {
+    indexes_.Register(index, [this](auto&& f) {
+      for (const auto& element : map_) {
+        f(element.first, *element.second);
+      }
+    });
+  }
+  void UnregisterSecondaryIndex(SecondaryIndexBase<T, key_t>& index) { indexes_.Unregister(index); }
+  const SecondaryIndexes<T, key_t>& Indexes() const { return indexes_; }
+
  private:
+  // The rollback record which puts the object stored under `key` back in place. The object is moved out of `map_`,
+  // not copied, as the caller is about to overwrite or erase it; its address, and thus references to it, stay valid.
+  // Having left `map_`, the object leaves the secondary indexes too.
+  auto RestoreOnRollback(const key_t& key, std::chrono::microseconds previous_timestamp) {
+    std::unique_ptr<T>& placeholder = map_.find(key)->second;
+    indexes_.Erase(placeholder.get());
+    return [this, key, previous_object = std::move(placeholder), previous_timestamp]() mutable {
+      DoUpdateWithLastModified(previous_timestamp, key, std::move(previous_object));
+    };
+  }
+
   void DoUpdateWithLastModified(std::chrono::microseconds us, const key_t& key, const T& object) {
+    DoUpdateWithLastModified(us, key, std::make_unique<T>(object));
+  }
+
+  // Takes the ownership of the object as is, to put back the very object moved out of `map_` by `RestoreOnRollback`.
+  void DoUpdateWithLastModified(std::chrono::microseconds us, const key_t& key, std::unique_ptr<T>&& object) {
     last_modified_[key] = us;
     auto& placeholder = map_[key];
-    placeholder = std::make_unique<T>(object);
+    if (placeholder) {
+      indexes_.Erase(placeholder.get());
+    }
+    placeholder = std::move(object);
     forward_[key.first][key.second] = placeholder.get();
     transposed_[key.second] = placeholder.get();
+    indexes_.Insert(key, *placeholder);
   }
 
   void DoEraseWithoutTouchingLastModified(const key_t& key) {
+    const auto map_cit = map_.find(key);
+    if (map_cit != map_.end() && map_cit->second) {
+      indexes_.Erase(map_cit->second.get());
+    }
     auto& map_row = forward_[key.first];
     map_row.erase(key.second);
     if (map_row.empty()) {
@@ -288,6 +330,7 @@ class GenericOneToMany {
   transposed_map_t transposed_;
   std::unordered_map<key_t, std::chrono::microseconds, GenericHashFunction<key_t>> last_modified_;
   MutationJournal& journal_;
+  SecondaryIndexes<T, key_t> indexes_;
 };
 
 #ifdef CURRENT_STORAGE_PATCH_SUPPORT
@@ -72,6 +72,20 @@ struct ReadWriteTransactionInFollowerStorageException : StorageException {
   using StorageException::StorageException;
 };
 
+struct StorageSnapshotException : StorageException {
+  using StorageException::StorageException;
+};
+
+struct StorageCannotWriteSnapshotException : StorageSnapshotException {
+  explicit StorageCannotWriteSnapshotException(const std::string& filename)
+      : StorageSnapshotException("Cannot write the snapshot: `" + filename + "`.") {}
+};
+
+struct StorageInvalidSnapshotException : StorageSnapshotException {
+  StorageInvalidSnapshotException(const std::string& filename, const std::string& reason)
+      : StorageSnapshotException("Invalid snapshot `" + filename + "`: " + reason) {}
+};
+
 struct StorageInGracefulShutdownException : InGracefulShutdownException {
   using InGracefulShutdownException::InGracefulShutdownException;
 };
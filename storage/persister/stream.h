@@ -26,18 +26,33 @@ SOFTWARE.
 #ifndef CURRENT_STORAGE_PERSISTER_STREAM_H
 #define CURRENT_STORAGE_PERSISTER_STREAM_H
 
+#include <fstream>
+
 #include "common.h"
 #include "../base.h"
 #include "../exceptions.h"
 #include "../transaction.h"
 #include "../../stream/stream.h"
 
+#include "../../bricks/file/file.h"
 #include "../../bricks/sync/locks.h"
 
 namespace current {
 namespace storage {
 namespace persister {
 
+// The first line of the snapshot file. It is followed by `mutations` lines, the JSON-s of the mutations which rebuild
+// all the fields of the storage from scratch. The snapshot reflects the first `next_index` entries of the stream,
+// and `last_entry_us` is the timestamp of the last one of them, to tell if the snapshot belongs to the stream.
+CURRENT_STRUCT(StorageSnapshotHeader) {
+  CURRENT_FIELD(next_index, uint64_t);
+  CURRENT_FIELD(last_entry_us, std::chrono::microseconds);
+  CURRENT_FIELD(last_applied_us, std::chrono::microseconds);
+  CURRENT_FIELD(mutations, uint64_t);
+  CURRENT_DEFAULT_CONSTRUCTOR(StorageSnapshotHeader)
+      : next_index(0u), last_entry_us(0), last_applied_us(-1), mutations(0u) {}
+};
+
 template <typename MUTATIONS_VARIANT, template <typename> class UNDERLYING_PERSISTER, typename STREAM_RECORD_TYPE>
 class StreamStreamPersisterImpl final {
  public:
@@ -51,14 +66,14 @@ class StreamStreamPersisterImpl final {
   struct StreamSubscriberImpl {
     using EntryResponse = current::ss::EntryResponse;
     using TerminationResponse = current::ss::TerminationResponse;
-    using replay_function_t = std::function<void(const transaction_t&, std::chrono::microseconds)>;
+    using replay_function_t = std::function<void(const transaction_t&, idxts_t)>;
     replay_function_t replay_f_;
     uint64_t next_replay_index_ = 0u;
 
     StreamSubscriberImpl(replay_function_t f) : replay_f_(f) {}
 
     EntryResponse operator()(const transaction_t& transaction, idxts_t current, idxts_t) {
-      replay_f_(transaction, current.us);
+      replay_f_(transaction, current);
       next_replay_index_ = current.index + 1u;
       return EntryResponse::More;
     }
@@ -73,30 +88,41 @@ class StreamStreamPersisterImpl final {
   struct Master {};
   struct Following {};
 
-  StreamStreamPersisterImpl(Master, fields_update_function_t f, Borrowed<stream_t> stream)
+  // With a non-empty `snapshot_path`, the storage is first restored from that snapshot, created by
+  // `SaveSnapshotFromLockedSection()`, and only the entries of the stream past it are replayed.
+  StreamStreamPersisterImpl(Master,
+                            fields_update_function_t f,
+                            Borrowed<stream_t> stream,
+                            const std::string& snapshot_path = "")
       : fields_update_f_(f),
         stream_publishing_mutex_ref_(stream->Impl()->publishing_mutex),
         stream_(std::move(stream)),
         publisher_used_(stream_->BecomeFollowingStream()) {
-    subscriber_instance_ = std::make_unique<StreamSubscriber>(
-        [this](const transaction_t& transaction, std::chrono::microseconds timestamp) {
+    subscriber_instance_ =
+        std::make_unique<StreamSubscriber>([this](const transaction_t& transaction, idxts_t current) {
           std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
-          ApplyMutationsFromLockedSectionOrConstructor(transaction, timestamp);
+          ApplyMutationsFromLockedSectionOrConstructor(transaction, current);
         });
     std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
-    SyncReplayStreamFromLockedSectionOrConstructor(0u);
+    LoadSnapshotFromConstructor(snapshot_path);
+    SyncReplayStreamFromLockedSectionOrConstructor(next_index_);
   }
 
-  StreamStreamPersisterImpl(Following, fields_update_function_t f, Borrowed<stream_t> stream)
+  StreamStreamPersisterImpl(Following,
+                            fields_update_function_t f,
+                            Borrowed<stream_t> stream,
+                            const std::string& snapshot_path = "")
       : fields_update_f_(f),
         stream_publishing_mutex_ref_(stream->Impl()->publishing_mutex),
         stream_(std::move(stream)) {
-    subscriber_instance_ = std::make_unique<StreamSubscriber>(
-        [this](const transaction_t& transaction, std::chrono::microseconds timestamp) {
+    subscriber_instance_ =
+        std::make_unique<StreamSubscriber>([this](const transaction_t& transaction, idxts_t current) {
           std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
-          ApplyMutationsFromLockedSectionOrConstructor(transaction, timestamp);
+          ApplyMutationsFromLockedSectionOrConstructor(transaction, current);
         });
     std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
+    LoadSnapshotFromConstructor(snapshot_path);
+    subscriber_instance_->next_replay_index_ = next_index_;
     SubscribeToStreamFromLockedSection();
   }
 
@@ -118,7 +144,7 @@ class StreamStreamPersisterImpl final {
   }
 
   void PersistJournalFromLockedSection(MutationJournal& journal) {
-    const std::chrono::microseconds timestamp = current::time::Now();
+    const std::chrono::microseconds timestamp = current::time::GloballyMonotonicNow();
     CURRENT_ASSERT(Exists(publisher_used_));
     if (!journal.commit_log.empty()) {
 #ifndef CURRENT_MOCK_TIME
@@ -131,13 +157,41 @@ class StreamStreamPersisterImpl final {
         transaction.mutations.emplace_back(BypassVariantTypeCheck(), std::move(entry));
       }
       std::swap(transaction.meta, journal.transaction_meta);
-      Value(publisher_used_)
-          ->template Publish<current::locks::MutexLockStatus::AlreadyLocked>(std::move(transaction), timestamp);
+      const idxts_t published =
+          Value(publisher_used_)
+              ->template Publish<current::locks::MutexLockStatus::AlreadyLocked>(std::move(transaction), timestamp);
+      next_index_ = published.index + 1u;
       SetLastAppliedTimestampFromLockedSection(timestamp);
     }
     journal.Clear();
   }
 
+  // Writes the snapshot of the storage as of now. `for_each_mutation(g)` should call `g` with each mutation which
+  // rebuilds the fields. The snapshot is written into a temporary file first, so a crash never leaves a partial one.
+  template <typename F>
+  void SaveSnapshotFromLockedSection(const std::string& snapshot_path, F&& for_each_mutation) {
+    StorageSnapshotHeader header;
+    header.next_index = next_index_;
+    header.last_applied_us = last_applied_timestamp_;
+    if (next_index_) {
+      header.last_entry_us = LastReflectedEntryTimestampFromLockedSection();
+    }
+    for_each_mutation([&header](const variant_t&) { ++header.mutations; });
+    const std::string temporary_path = snapshot_path + ".tmp";
+    {
+      std::ofstream fo(temporary_path);
+      if (!fo.good()) {
+        CURRENT_THROW(StorageCannotWriteSnapshotException(temporary_path));
+      }
+      fo << JSON(header) << '\n';
+      for_each_mutation([&fo](const variant_t& mutation) { fo << JSON(mutation) << '\n'; });
+      if (!fo.good()) {
+        CURRENT_THROW(StorageCannotWriteSnapshotException(temporary_path));  // LCOV_EXCL_LINE
+      }
+    }
+    current::FileSystem::RenameFile(temporary_path, snapshot_path);
+  }
+
   void ExposeRawLogViaHTTP(uint16_t port, const std::string& route) {
     handlers_scope_ += HTTP(current::net::BarePort(port))
                            .Register(route,
@@ -176,6 +230,47 @@ class StreamStreamPersisterImpl final {
   // TODO(dkorolev): `BecomeFollowingStorage` maybe?
 
  private:
+  // Invariant: `stream_publishing_mutex_ref_` is locked, and the call is taking place from the constructor.
+  void LoadSnapshotFromConstructor(const std::string& snapshot_path) {
+    if (snapshot_path.empty()) {
+      return;
+    }
+    std::ifstream fi(snapshot_path);
+    std::string line;
+    if (!std::getline(fi, line)) {
+      CURRENT_THROW(StorageInvalidSnapshotException(snapshot_path, "no header."));
+    }
+    const auto header = ParseJSON<StorageSnapshotHeader>(line);
+    const uint64_t stream_size =
+        stream_->Data()->template Size<current::locks::MutexLockStatus::AlreadyLocked>();
+    if (header.next_index > stream_size) {
+      CURRENT_THROW(StorageInvalidSnapshotException(snapshot_path, "the stream is shorter than the snapshot."));
+    }
+    next_index_ = header.next_index;
+    if (next_index_ && LastReflectedEntryTimestampFromLockedSection() != header.last_entry_us) {
+      CURRENT_THROW(StorageInvalidSnapshotException(snapshot_path, "the stream does not match the snapshot."));
+    }
+    uint64_t mutations = 0u;
+    while (std::getline(fi, line)) {
+      fields_update_f_(ParseJSON<variant_t>(line));
+      ++mutations;
+    }
+    if (mutations != header.mutations) {
+      CURRENT_THROW(StorageInvalidSnapshotException(snapshot_path, "truncated."));
+    }
+    if (header.last_applied_us.count() >= 0) {
+      SetLastAppliedTimestampFromLockedSection(header.last_applied_us);
+    }
+  }
+
+  std::chrono::microseconds LastReflectedEntryTimestampFromLockedSection() const {
+    CURRENT_ASSERT(next_index_);
+    return (*stream_->Data()
+                 ->template Iterate<current::locks::MutexLockStatus::AlreadyLocked>(next_index_ - 1u, next_index_)
+                 .begin())
+        .idx_ts.us;
+  }
+
   // Invariant: both `subscriber_creator_destructor_mutex_` and `stream_publishing_mutex_ref_` are locked,
   // or the call is taking place from the constructor.
   void SyncReplayStreamFromLockedSectionOrConstructor(uint64_t from_idx) {
@@ -183,17 +278,19 @@ class StreamStreamPersisterImpl final {
          stream_->Data()->template Iterate<current::locks::MutexLockStatus::AlreadyLocked>(from_idx)) {
       if (Exists<transaction_t>(stream_record.entry)) {
         const transaction_t& transaction = Value<transaction_t>(stream_record.entry);
-        ApplyMutationsFromLockedSectionOrConstructor(transaction, stream_record.idx_ts.us);
+        ApplyMutationsFromLockedSectionOrConstructor(transaction, stream_record.idx_ts);
+      } else {
+        next_index_ = stream_record.idx_ts.index + 1u;
       }
     }
   }
 
-  void ApplyMutationsFromLockedSectionOrConstructor(const transaction_t& transaction,
-                                                    std::chrono::microseconds timestamp) {
+  void ApplyMutationsFromLockedSectionOrConstructor(const transaction_t& transaction, idxts_t current) {
     for (const auto& mutation : transaction.mutations) {
       fields_update_f_(mutation);
     }
-    SetLastAppliedTimestampFromLockedSection(timestamp);
+    next_index_ = current.index + 1u;
+    SetLastAppliedTimestampFromLockedSection(current.us);
   }
 
  private:
@@ -201,7 +298,8 @@ class StreamStreamPersisterImpl final {
   void SubscribeToStreamFromLockedSection() {
     CURRENT_ASSERT(!subscriber_scope_);
     CURRENT_ASSERT(subscriber_instance_);
-    subscriber_scope_ = std::move(stream_->template Subscribe<transaction_t>(*subscriber_instance_));
+    subscriber_scope_ = std::move(
+        stream_->template Subscribe<transaction_t>(*subscriber_instance_, subscriber_instance_->next_replay_index_));
   }
 
   // Invariant: `master_follower_change_mutex_` is locked.
@@ -225,6 +323,7 @@ class StreamStreamPersisterImpl final {
   current::stream::SubscriberScope subscriber_scope_;
 
   std::chrono::microseconds last_applied_timestamp_ = std::chrono::microseconds(-1);  // Replayed or from the master.
+  uint64_t next_index_ = 0u;  // The number of stream entries reflected in the fields, for the snapshots.
 
   HTTPRoutesScope handlers_scope_;
 };
@@ -36,6 +36,8 @@ SOFTWARE.
 //
 // All Current-friendly types support persistence.
 //
+// Any of them can have secondary indexes, `CURRENT_STORAGE_FIELD_INDEX`, ordered or not, by one or more fields of `T`.
+//
 // Only allow default constructors for containers.
 
 #ifndef CURRENT_STORAGE_STORAGE_H
@@ -44,6 +46,8 @@ SOFTWARE.
 #include "../port.h"
 
 #include <atomic>
+#include <shared_mutex>
+#include <utility>
 
 #include "base.h"
 #include "transaction.h"
@@ -64,6 +68,7 @@ SOFTWARE.
 #include "../bricks/exception.h"
 #include "../bricks/strings/strings.h"
 #include "../bricks/time/chrono.h"
+#include "../bricks/sync/locks.h"
 #include "../bricks/sync/waitable_atomic.h"
 
 namespace current {
@@ -306,6 +311,11 @@ class StorageImpl {
 
  private:
   FIELDS fields_;
+  // Read-only transactions share this mutex, and do not lock the publishing mutex of the stream.
+  // Everything that mutates `fields_`, i.e. read-write transactions and the replayed mutations, holds both
+  // the publishing mutex and this one, exclusively, in this order. So a read-only transaction from the section
+  // which already holds the publishing mutex, `MutexLockStatus::AlreadyLocked`, is safe too.
+  mutable std::shared_mutex fields_mutex_;
   Optional<Owned<stream_t>> owned_stream_;  // Valid iff the Storage has been constructed to keep its own stream.
   persister_t persister_;
   TRANSACTION_POLICY<persister_t> transaction_policy_;
@@ -318,20 +328,46 @@ class StorageImpl {
 
   template <typename... ARGS>
   static Owned<StorageImpl> CreateMasterStorage(ARGS&&... args) {
-    return MakeOwned<StorageImpl>(typename persister_t::Master(), CreateStreamAsWell(), std::forward<ARGS>(args)...);
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Master(), CreateStreamAsWell(), std::string(), std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   static Owned<StorageImpl> CreateFollowingStorage(ARGS&&... args) {
-    return MakeOwned<StorageImpl>(typename persister_t::Following(), CreateStreamAsWell(), std::forward<ARGS>(args)...);
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Following(), CreateStreamAsWell(), std::string(), std::forward<ARGS>(args)...);
   }
 
   static Owned<StorageImpl> CreateMasterStorageAtopExistingStream(Borrowed<stream_t> stream) {
-    return MakeOwned<StorageImpl>(typename persister_t::Master(), UseExistingStream(), stream);
+    return MakeOwned<StorageImpl>(typename persister_t::Master(), UseExistingStream(), std::string(), stream);
   }
 
   static Owned<StorageImpl> CreateFollowingStorageAtopExistingStream(Borrowed<stream_t> stream) {
-    return MakeOwned<StorageImpl>(typename persister_t::Following(), UseExistingStream(), stream);
+    return MakeOwned<StorageImpl>(typename persister_t::Following(), UseExistingStream(), std::string(), stream);
+  }
+
+  // The `...FromSnapshot` versions restore the fields from the file written by `SaveSnapshot()` first,
+  // and then only replay the part of the stream that is newer than the snapshot.
+  template <typename... ARGS>
+  static Owned<StorageImpl> CreateMasterStorageFromSnapshot(const std::string& snapshot_path, ARGS&&... args) {
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Master(), CreateStreamAsWell(), snapshot_path, std::forward<ARGS>(args)...);
+  }
+
+  template <typename... ARGS>
+  static Owned<StorageImpl> CreateFollowingStorageFromSnapshot(const std::string& snapshot_path, ARGS&&... args) {
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Following(), CreateStreamAsWell(), snapshot_path, std::forward<ARGS>(args)...);
+  }
+
+  static Owned<StorageImpl> CreateMasterStorageAtopExistingStreamFromSnapshot(Borrowed<stream_t> stream,
+                                                                             const std::string& snapshot_path) {
+    return MakeOwned<StorageImpl>(typename persister_t::Master(), UseExistingStream(), snapshot_path, stream);
+  }
+
+  static Owned<StorageImpl> CreateFollowingStorageAtopExistingStreamFromSnapshot(Borrowed<stream_t> stream,
+                                                                                const std::string& snapshot_path) {
+    return MakeOwned<StorageImpl>(typename persister_t::Following(), UseExistingStream(), snapshot_path, stream);
   }
 
  private:
@@ -341,17 +377,36 @@ class StorageImpl {
   struct UseExistingStream {};
 
   template <typename CONSTRUCTION_TYPE>
-  StorageImpl(CONSTRUCTION_TYPE, UseExistingStream, Borrowed<stream_t> stream)
+  StorageImpl(CONSTRUCTION_TYPE, UseExistingStream, const std::string& snapshot_path, Borrowed<stream_t> stream)
       : persister_(
-            CONSTRUCTION_TYPE(), [this](const fields_variant_t& entry) { entry.Call(fields_); }, stream),
-        transaction_policy_(persister_, fields_.current_storage_mutation_journal_) {}
+            CONSTRUCTION_TYPE(),
+            [this](const fields_variant_t& entry) { ApplyMutation(entry); },
+            stream,
+            snapshot_path),
+        transaction_policy_(persister_, fields_.current_storage_mutation_journal_, fields_mutex_) {}
 
   template <typename CONSTRUCTION_TYPE, typename... ARGS>
-  StorageImpl(CONSTRUCTION_TYPE, CreateStreamAsWell, ARGS&&... args)
+  StorageImpl(CONSTRUCTION_TYPE, CreateStreamAsWell, const std::string& snapshot_path, ARGS&&... args)
       : owned_stream_(std::move(stream_t::CreateStream(std::forward<ARGS>(args)...))),
         persister_(
-            CONSTRUCTION_TYPE(), [this](const fields_variant_t& entry) { entry.Call(fields_); }, Value(owned_stream_)),
-        transaction_policy_(persister_, fields_.current_storage_mutation_journal_) {}
+            CONSTRUCTION_TYPE(),
+            [this](const fields_variant_t& entry) { ApplyMutation(entry); },
+            Value(owned_stream_),
+            snapshot_path),
+        transaction_policy_(persister_, fields_.current_storage_mutation_journal_, fields_mutex_) {}
+
+  // Called by the persister, with the publishing mutex locked, to replay the persisted mutations.
+  void ApplyMutation(const fields_variant_t& entry) {
+    std::lock_guard<std::shared_mutex> fields_lock(fields_mutex_);
+    entry.Call(fields_);
+  }
+
+  template <typename G, int... IS>
+  void ForEachSnapshotMutation(G&& g, std::integer_sequence<int, IS...>) const {
+    (void)std::initializer_list<int>{(fields_(::current::storage::ImmutableFieldByIndex<IS>(),
+                                              [&g](const auto& field) { field.SnapshotEvents(g); }),
+                                      0)...};
+  }
 
  public:
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
@@ -384,10 +439,16 @@ class StorageImpl {
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock, typename F>
   ::current::Future<::current::storage::TransactionResult<f_result_t<F>>, ::current::StrictFuture::Strict>
   ReadWriteTransaction(F&& f) {
+    if constexpr (transaction_policy::IsPipelined<TRANSACTION_POLICY<persister_t>>::value) {
+      if (MLS == current::locks::MutexLockStatus::NeedToLock) {
+        return transaction_policy_.Enqueue([this, f = std::forward<F>(f)]() mutable { return f(fields_); });
+      }
+    }
     current::locks::SmartMutexLockGuard<MLS> lock(persister_.Stream()->Impl()->publishing_mutex);
     if (!IsMasterStorage<current::locks::MutexLockStatus::AlreadyLocked>()) {
       CURRENT_THROW(ReadWriteTransactionInFollowerStorageException());
     }
+    std::lock_guard<std::shared_mutex> fields_lock(fields_mutex_);
     return transaction_policy_.TransactionFromLockedSection([&f, this]() { return f(fields_); });
   }
 
@@ -398,14 +459,37 @@ class StorageImpl {
     if (!IsMasterStorage<current::locks::MutexLockStatus::AlreadyLocked>()) {
       CURRENT_THROW(ReadWriteTransactionInFollowerStorageException());
     }
+    std::lock_guard<std::shared_mutex> fields_lock(fields_mutex_);
     return transaction_policy_.TransactionFromLockedSection([&f1, this]() { return f1(fields_); },
                                                             std::forward<F2>(f2));
   }
 
+  // Reports the outcome of the read-write transaction `f` to `on_result(TransactionResult<...>&&)`, or, if `f` throws,
+  // to `on_exception(std::exception_ptr)`. With `transaction_policy::Pipelined`, returns right away, with no future
+  // to wait for, and the callbacks are called from the writer thread. Otherwise, the transaction is run right here.
+  template <typename F, typename ON_RESULT, typename ON_EXCEPTION>
+  void ReadWriteTransactionAsync(F&& f, ON_RESULT&& on_result, ON_EXCEPTION&& on_exception) {
+    if constexpr (transaction_policy::IsPipelined<TRANSACTION_POLICY<persister_t>>::value) {
+      transaction_policy_.Enqueue([this, f = std::forward<F>(f)]() mutable { return f(fields_); },
+                                  std::forward<ON_RESULT>(on_result),
+                                  std::forward<ON_EXCEPTION>(on_exception));
+    } else {
+      std::unique_ptr<::current::storage::TransactionResult<f_result_t<F>>> result;
+      try {
+        result = std::make_unique<::current::storage::TransactionResult<f_result_t<F>>>(
+            ReadWriteTransaction(std::forward<F>(f)).Go());
+      } catch (...) {
+        on_exception(std::current_exception());
+        return;
+      }
+      on_result(std::move(*result));
+    }
+  }
+
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock, typename F>
   ::current::Future<::current::storage::TransactionResult<f_result_t<F>>, ::current::StrictFuture::Strict>
   ReadOnlyTransaction(F&& f) const {
-    current::locks::SmartMutexLockGuard<MLS> lock(persister_.Stream()->Impl()->publishing_mutex);
+    current::locks::SmartSharedMutexLockGuard<MLS> fields_lock(fields_mutex_);
     return transaction_policy_.TransactionFromLockedSection(
         [&f, this]() { return f(static_cast<const FIELDS&>(fields_)); });
   }
@@ -413,11 +497,22 @@ class StorageImpl {
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock, typename F1, typename F2>
   ::current::Future<::current::storage::TransactionResult<void>, ::current::StrictFuture::Strict> ReadOnlyTransaction(
       F1&& f1, F2&& f2) const {
-    current::locks::SmartMutexLockGuard<MLS> lock(persister_.Stream()->Impl()->publishing_mutex);
+    current::locks::SmartSharedMutexLockGuard<MLS> fields_lock(fields_mutex_);
     return transaction_policy_.TransactionFromLockedSection(
         [&f1, this]() { return f1(static_cast<const FIELDS&>(fields_)); }, std::forward<F2>(f2));
   }
 
+  // Writes all the fields into `snapshot_path`, along with the position in the stream they reflect, for the storage
+  // to be created from it later by the `...FromSnapshot` methods. Read-write transactions wait while it runs.
+  // How often to take the snapshots is up to the user; the stream itself is never truncated.
+  template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
+  void SaveSnapshot(const std::string& snapshot_path) {
+    current::locks::SmartMutexLockGuard<MLS> lock(persister_.Stream()->Impl()->publishing_mutex);
+    persister_.SaveSnapshotFromLockedSection(snapshot_path, [this](const auto& g) {
+      ForEachSnapshotMutation(g, std::make_integer_sequence<int, FIELDS_COUNT>());
+    });
+  }
+
   void ExposeRawLogViaHTTP(int port, const std::string& route) { persister_.ExposeRawLogViaHTTP(port, route); }
 
   Borrowed<stream_t> BorrowUnderlyingStream() const { return persister_.BorrowStream(); }
@@ -674,6 +769,64 @@ using transaction_t = typename STORAGE<persister::NullStoragePersister,
 
 #endif  // CURRENT_STORAGE_PATCH_SUPPORT
 
+// Declares a secondary index of the field `field_name`, declared above it, by one, two, or three fields of its entries.
+//
+//   CURRENT_STORAGE_FIELD_INDEX(users_by_city, users, Unordered, city);
+//   CURRENT_STORAGE_FIELD_INDEX(users_by_age_and_name, users, Ordered, age, name);
+//
+// Then `fields.users_by_city.Lookup("Paris")` iterates over the users from Paris, and
+// `fields.users_by_age_and_name.Range(std::make_tuple(18, ""), std::make_tuple(21, ""))` over the ones from 18 to 20.
+// The index is kept up to date by the field itself, including on rollbacks and on replay, and is not persisted.
+// With `RESTfulStorage`, it is also exposed as `GET /data/users.users_by_city?city=Paris`; see `storage/api.h`.
+#define CURRENT_STORAGE_FIELD_INDEX_KEY_1(index_name, f1)               \
+  struct CURRENT_STORAGE_FIELD_INDEX_KEY_##index_name {                  \
+    template <typename T>                                               \
+    static auto Extract(const T& e) {                                   \
+      return std::make_tuple(e.f1);                                     \
+    }                                                                   \
+    static std::vector<std::string> FieldNames() { return {#f1}; }      \
+  }
+
+#define CURRENT_STORAGE_FIELD_INDEX_KEY_2(index_name, f1, f2)           \
+  struct CURRENT_STORAGE_FIELD_INDEX_KEY_##index_name {                  \
+    template <typename T>                                               \
+    static auto Extract(const T& e) {                                   \
+      return std::make_tuple(e.f1, e.f2);                               \
+    }                                                                   \
+    static std::vector<std::string> FieldNames() { return {#f1, #f2}; } \
+  }
+
+#define CURRENT_STORAGE_FIELD_INDEX_KEY_3(index_name, f1, f2, f3)            \
+  struct CURRENT_STORAGE_FIELD_INDEX_KEY_##index_name {                       \
+    template <typename T>                                                    \
+    static auto Extract(const T& e) {                                        \
+      return std::make_tuple(e.f1, e.f2, e.f3);                              \
+    }                                                                        \
+    static std::vector<std::string> FieldNames() { return {#f1, #f2, #f3}; } \
+  }
+
+#define CURRENT_STORAGE_FIELD_INDEX_NARGS_IMPL(_1, _2, _3, n, ...) n
+#define CURRENT_STORAGE_FIELD_INDEX_NARGS_IMPL_CALLER(args) CURRENT_STORAGE_FIELD_INDEX_NARGS_IMPL args
+
+#define CURRENT_STORAGE_FIELD_INDEX_NARGS(...) CURRENT_STORAGE_FIELD_INDEX_NARGS_IMPL_CALLER((__VA_ARGS__, 3, 2, 1, 0))
+
+#define CURRENT_STORAGE_FIELD_INDEX_CASE_3(n) CURRENT_STORAGE_FIELD_INDEX_KEY_##n
+#define CURRENT_STORAGE_FIELD_INDEX_CASE_2(n) CURRENT_STORAGE_FIELD_INDEX_CASE_3(n)
+#define CURRENT_STORAGE_FIELD_INDEX_CASE_1(n) CURRENT_STORAGE_FIELD_INDEX_CASE_2(n)
+#define CURRENT_STORAGE_FIELD_INDEX_SWITCH_N(n) CURRENT_STORAGE_FIELD_INDEX_CASE_1(n)
+
+#define CURRENT_STORAGE_FIELD_INDEX_SWITCH(x, y) x y
+
+#define CURRENT_STORAGE_FIELD_INDEX(index_name, field_name, ordering, ...)                                     \
+  CURRENT_STORAGE_FIELD_INDEX_SWITCH(                                                                          \
+      CURRENT_STORAGE_FIELD_INDEX_SWITCH_N(CURRENT_STORAGE_FIELD_INDEX_NARGS(__VA_ARGS__)),                    \
+      (index_name, __VA_ARGS__));                                                                              \
+  ::current::storage::FieldIndex<INSTANTIATION_TYPE,                                                           \
+                                 ::current::storage::container::ordering##SecondaryIndex<                      \
+                                     field_container_##field_name##_t,                                         \
+                                     CURRENT_STORAGE_FIELD_INDEX_KEY_##index_name>>                            \
+      index_name{#index_name, field_name}
+
 template <typename STORAGE>
 using MutableFields = typename STORAGE::fields_by_ref_t;
 
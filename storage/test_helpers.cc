@@ -118,6 +118,24 @@ CURRENT_STORAGE(TestStorage) {
   CURRENT_STORAGE_FIELD(oone_to_umany, CellOrderedOneToUnorderedMany);
 };
 
+CURRENT_STRUCT(Person) {
+  CURRENT_FIELD(key, std::string);
+  CURRENT_FIELD(city, std::string);
+  CURRENT_FIELD(age, int32_t);
+  CURRENT_CONSTRUCTOR(Person)(const std::string& key = "", const std::string& city = "", int32_t age = 0)
+      : key(key), city(city), age(age) {}
+};
+
+CURRENT_STORAGE_FIELD_ENTRY(OrderedDictionary, Person, PersonDictionary);
+
+CURRENT_STORAGE(IndexedStorage) {
+  CURRENT_STORAGE_FIELD(person, PersonDictionary);
+  CURRENT_STORAGE_FIELD_INDEX(person_by_city, person, Unordered, city);
+  CURRENT_STORAGE_FIELD_INDEX(person_by_age_and_city, person, Ordered, age, city);
+  CURRENT_STORAGE_FIELD(cell, CellOrderedOneToUnorderedMany);
+  CURRENT_STORAGE_FIELD_INDEX(cell_by_phew, cell, Ordered, phew);
+};
+
 }  // namespace transactional_storage_test
 
 static_assert(std::is_same<transactional_storage_test::RecordDictionary::update_event_t::storage_field_t,
@@ -986,6 +986,61 @@ TEST(TransactionalStorage, ShuttingDownAPIReportsUpAsFalse) {
   EXPECT_EQ(503, static_cast<int>(HTTP(GET(base_url + "/api/data/post/foo")).code));
 }
 
+TEST(TransactionalStorage, RESTfulSecondaryIndexes) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using namespace current::storage::rest;
+  using storage_t = IndexedStorage<StreamInMemoryStreamPersister>;
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port));
+  static_cast<void>(http_server);
+
+  auto storage = storage_t::CreateMasterStorage();
+  EXPECT_TRUE(WasCommitted(storage
+                               ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                 fields.person.Add(Person{"alice", "Paris", 30});
+                                 fields.person.Add(Person{"bob", "London", 25});
+                                 fields.person.Add(Person{"carol", "Paris", 25});
+                                 fields.cell.Add(Cell{1, "a", 10});
+                               })
+                               .Go()));
+
+  const auto base_url = current::strings::Printf("http://localhost:%d", port);
+
+  auto rest = RESTfulStorage<storage_t, current::storage::rest::Hypermedia>(
+      *storage, port, "/api", "http://unittest.current.ai");
+
+  {
+    const auto result = HTTP(GET(base_url + "/api/data/person.person_by_age_and_city?age=25&city=Paris"));
+    EXPECT_EQ(200, static_cast<int>(result.code));
+    EXPECT_EQ(JSON(Person{"carol", "Paris", 25}) + '\n', result.body);
+  }
+  {
+    const auto result = HTTP(GET(base_url + "/api/data/person.person_by_city?city=London"));
+    EXPECT_EQ(200, static_cast<int>(result.code));
+    EXPECT_EQ(JSON(Person{"bob", "London", 25}) + '\n', result.body);
+  }
+  {
+    const auto result = HTTP(GET(base_url + "/api/data/cell.cell_by_phew?phew=10"));
+    EXPECT_EQ(200, static_cast<int>(result.code));
+    EXPECT_EQ(JSON(Cell{1, "a", 10}) + '\n', result.body);
+  }
+  {
+    const auto result = HTTP(GET(base_url + "/api/data/person.person_by_city?city=Rome"));
+    EXPECT_EQ(200, static_cast<int>(result.code));
+    EXPECT_EQ("", result.body);
+  }
+  EXPECT_EQ(400, static_cast<int>(HTTP(GET(base_url + "/api/data/person.person_by_age_and_city?age=25")).code));
+  EXPECT_EQ(405, static_cast<int>(HTTP(DELETE(base_url + "/api/data/person.person_by_city?city=Paris")).code));
+
+  // The indexes are not fields.
+  const auto fields = ParseJSON<HypermediaRESTTopLevel>(HTTP(GET(base_url + "/api")).body);
+  EXPECT_EQ(2u, fields.url_data.size());
+}
+
 #ifdef CURRENT_STORAGE_PATCH_SUPPORT
 
 namespace transactional_storage_test {
@@ -1730,4 +1730,510 @@ TEST(TransactionalStorage, GracefulShutdown) {
   ASSERT_THROW(result.Go(), current::storage::StorageInGracefulShutdownException);
 }
 
+TEST(TransactionalStorage, ConcurrentReadOnlyTransactions) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamInMemoryStreamPersister>;
+
+  auto storage = storage_t::CreateMasterStorage();
+
+  current::time::SetNow(std::chrono::microseconds(100));
+  EXPECT_TRUE(WasCommitted(
+      storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"one", 1}); }).Go()));
+
+  // Two read-only transactions must be able to run at the same time, and a read-write one must wait for both.
+  std::atomic_int readers_inside(0);
+  std::atomic_bool release_readers(false);
+  std::atomic_bool writer_done(false);
+  const auto reader = [&]() {
+    return Value(storage
+                     ->ReadOnlyTransaction([&](ImmutableFields<storage_t> fields) {
+                       const int32_t before = Value(fields.d["one"]).rhs;
+                       ++readers_inside;
+                       while (!release_readers) {
+                         std::this_thread::yield();
+                       }
+                       return std::make_pair(before, Value(fields.d["one"]).rhs);
+                     })
+                     .Go());
+  };
+  std::pair<int32_t, int32_t> result1;
+  std::pair<int32_t, int32_t> result2;
+  std::thread reader1([&]() { result1 = reader(); });
+  std::thread reader2([&]() { result2 = reader(); });
+  while (readers_inside != 2) {
+    std::this_thread::yield();
+  }
+
+  current::time::SetNow(std::chrono::microseconds(200));
+  std::thread writer([&]() {
+    storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"one", 2}); }).Wait();
+    writer_done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(writer_done);
+
+  release_readers = true;
+  reader1.join();
+  reader2.join();
+  writer.join();
+  EXPECT_TRUE(writer_done);
+
+  // Both readers observed the state before the write, consistently.
+  EXPECT_EQ(std::make_pair(1, 1), result1);
+  EXPECT_EQ(std::make_pair(1, 1), result2);
+  EXPECT_EQ(2, Value(Value(storage->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                      return Value(fields.d["one"]).rhs;
+                                    }).Go())));
+}
+
+TEST(TransactionalStorage, Snapshot) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamStreamPersister>;
+
+  const std::string persistence_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "data");
+  const auto persistence_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+  const std::string snapshot_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "snapshot");
+  const auto snapshot_file_remover = current::FileSystem::ScopedRmFile(snapshot_file_name);
+
+  {
+    auto storage = storage_t::CreateMasterStorage(persistence_file_name);
+
+    current::time::SetNow(std::chrono::microseconds(100));
+    EXPECT_TRUE(WasCommitted(storage
+                                 ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                   fields.d.Add(Record{"one", 1});
+                                   fields.d.Add(Record{"two", 2});
+                                   fields.umany_to_umany.Add(Cell{1, "one", 1});
+                                   fields.uone_to_uone.Add(Cell{1, "one", 1});
+                                   fields.oone_to_umany.Add(Cell{1, "one", 1});
+                                 })
+                                 .Go()));
+
+    current::time::SetNow(std::chrono::microseconds(200));
+    EXPECT_TRUE(WasCommitted(storage
+                                 ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                   fields.d.Erase("two");
+                                   fields.uone_to_uone.Add(Cell{1, "uno", 2});
+                                 })
+                                 .Go()));
+
+    storage->SaveSnapshot(snapshot_file_name);
+
+    current::time::SetNow(std::chrono::microseconds(300));
+    EXPECT_TRUE(WasCommitted(
+        storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"three", 3}); })
+            .Go()));
+  }
+
+  {
+    auto storage = storage_t::CreateMasterStorageFromSnapshot(snapshot_file_name, persistence_file_name);
+    EXPECT_EQ(300, storage->LastAppliedTimestamp().count());
+    EXPECT_TRUE(WasCommitted(storage
+                                 ->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                   EXPECT_EQ(2u, fields.d.Size());
+                                   EXPECT_EQ(1, Value(fields.d["one"]).rhs);
+                                   EXPECT_EQ(3, Value(fields.d["three"]).rhs);
+                                   EXPECT_FALSE(fields.d.Has("two"));
+                                   EXPECT_EQ(200, Value(fields.d.LastModified("two")).count());
+                                   EXPECT_EQ(1u, fields.umany_to_umany.Size());
+                                   EXPECT_EQ(1u, fields.uone_to_uone.Size());
+                                   EXPECT_EQ(2, Value(fields.uone_to_uone.Get(1, "uno")).phew);
+                                   EXPECT_EQ(1u, fields.oone_to_umany.Size());
+                                 })
+                                 .Go()));
+
+    // The storage restored from the snapshot keeps writing into the same stream.
+    current::time::SetNow(std::chrono::microseconds(400));
+    EXPECT_TRUE(WasCommitted(
+        storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Erase("one"); }).Go()));
+  }
+
+  {
+    auto storage = storage_t::CreateFollowingStorageFromSnapshot(snapshot_file_name, persistence_file_name);
+    EXPECT_FALSE(storage->IsMasterStorage());
+    while (storage->LastAppliedTimestamp().count() < 400) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(1u, Value(storage->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                  return fields.d.Size();
+                                }).Go()));
+  }
+
+  {
+    auto storage = storage_t::CreateMasterStorage(persistence_file_name);
+    EXPECT_EQ(400, storage->LastAppliedTimestamp().count());
+    EXPECT_EQ(1u, Value(storage->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                  return fields.d.Size();
+                                }).Go()));
+  }
+
+  {
+    // A snapshot is only valid for the stream it was taken from.
+    const std::string other_file_name =
+        current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "other_data");
+    const auto other_file_remover = current::FileSystem::ScopedRmFile(other_file_name);
+    auto stream = storage_t::stream_t::CreateStream(other_file_name);
+    ASSERT_THROW(storage_t::CreateMasterStorageAtopExistingStreamFromSnapshot(stream, snapshot_file_name),
+                 current::storage::StorageInvalidSnapshotException);
+  }
+}
+
+TEST(TransactionalStorage, UndoLog) {
+  {
+    current::storage::UndoLog undo_log;
+    std::string trace;
+    auto token = std::make_shared<int>(0);
+    for (int i = 0; i < 10000; ++i) {
+      // Move-only records, and the ones larger than a chunk of the arena, are welcome.
+      undo_log.Push([&trace, i, p = std::make_unique<int>(i)]() { trace += (i == *p && i < 3) ? char('0' + i) : '.'; });
+      undo_log.Push([token]() {});
+    }
+    undo_log.Push([&trace, large = std::array<char, 100000>()]() { trace += (large.back() ? '?' : '*'); });
+    EXPECT_EQ(20001u, undo_log.Size());
+    EXPECT_EQ(10001, token.use_count());
+    undo_log.UndoAll();
+    EXPECT_TRUE(undo_log.Empty());
+    EXPECT_EQ(1, token.use_count());
+    EXPECT_EQ(10001u, trace.length());
+    EXPECT_EQ("*...", trace.substr(0, 4));
+    EXPECT_EQ("..210", trace.substr(trace.length() - 5));
+
+    // The arena is reused by the next transaction; the records not undone are destroyed on `Clear()`.
+    undo_log.Push([token]() {});
+    EXPECT_EQ(2, token.use_count());
+    undo_log.Clear();
+    EXPECT_EQ(1, token.use_count());
+  }
+
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamInMemoryStreamPersister>;
+  auto storage = storage_t::CreateMasterStorage();
+
+  const auto addresses = Value(storage
+                                   ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                     fields.d.Add(Record{"one", 1});
+                                     fields.d.Add(Record{"two", 2});
+                                     fields.uone_to_uone.Add(Cell{1, "one", 1});
+                                     fields.uone_to_uone.Add(Cell{2, "two", 2});
+                                     return std::make_pair(&Value(fields.uone_to_uone.Get(1, "one")),
+                                                           &Value(fields.uone_to_uone.Get(2, "two")));
+                                   })
+                                   .Go());
+
+  EXPECT_FALSE(WasCommitted(storage
+                                ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                  fields.d.Add(Record{"one", 100});
+                                  fields.d.Erase("two");
+                                  fields.uone_to_uone.Add(Cell{1, "one", 100});  // Overwrites {1,one=1}.
+                                  fields.uone_to_uone.Add(Cell{2, "three", 3});  // Removes {2,two=2}.
+                                  CURRENT_STORAGE_THROW_ROLLBACK();
+                                })
+                                .Go()));
+
+  EXPECT_TRUE(WasCommitted(storage
+                               ->ReadOnlyTransaction([&addresses](ImmutableFields<storage_t> fields) {
+                                 EXPECT_EQ(1, Value(fields.d["one"]).rhs);
+                                 EXPECT_EQ(2, Value(fields.d["two"]).rhs);
+                                 EXPECT_EQ(2u, fields.uone_to_uone.Size());
+                                 // The rollback puts back the very objects, not their copies.
+                                 EXPECT_EQ(addresses.first, &Value(fields.uone_to_uone.Get(1, "one")));
+                                 EXPECT_EQ(addresses.second, &Value(fields.uone_to_uone.Get(2, "two")));
+                                 EXPECT_EQ(1, Value(fields.uone_to_uone.Get(1, "one")).phew);
+                               })
+                               .Go()));
+
+  // Re-adding the stored object itself, by reference, keeps both the stored and the persisted value intact.
+  EXPECT_TRUE(WasCommitted(storage
+                               ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                 fields.d.Add(Value(fields.d["one"]));
+                                 EXPECT_EQ(1, Value(fields.d["one"]).rhs);
+                               })
+                               .Go()));
+  EXPECT_TRUE(WasCommitted(storage
+                               ->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                 EXPECT_EQ("one", Value(fields.d["one"]).lhs);
+                                 EXPECT_EQ(1, Value(fields.d["one"]).rhs);
+                               })
+                               .Go()));
+  const auto& data = storage->UnderlyingStream()->Data();
+  const std::string last_transaction_json = JSON((*(data->Iterate(data->Size() - 1u).begin())).entry);
+  EXPECT_NE(std::string::npos, last_transaction_json.find("{\"lhs\":\"one\",\"rhs\":1}")) << last_transaction_json;
+}
+
+TEST(TransactionalStorage, SecondaryIndexes) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = IndexedStorage<StreamStreamPersister>;
+
+  EXPECT_EQ(2u, storage_t::FIELDS_COUNT);
+
+  const std::string persistence_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "data");
+  const auto persistence_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  const auto keys = [](const auto& entries) {
+    std::vector<std::string> result;
+    for (const Person& person : entries) {
+      result.push_back(person.key);
+    }
+    return current::strings::Join(result, ',');
+  };
+  const auto sorted_keys = [](const auto& entries) {
+    std::set<std::string> result;
+    for (const Person& person : entries) {
+      result.insert(person.key);
+    }
+    return current::strings::Join(result, ',');
+  };
+  const auto cols = [](const auto& entries) {
+    std::vector<std::string> result;
+    for (const Cell& cell : entries) {
+      result.push_back(cell.bar);
+    }
+    return current::strings::Join(result, ',');
+  };
+
+  // The order within a value of an `Unordered` index is unspecified.
+  const auto verify = [&keys, &sorted_keys, &cols](ImmutableFields<storage_t> fields) {
+    EXPECT_EQ("carol", keys(fields.person_by_city.Lookup("Paris")));
+    EXPECT_EQ("alice,dave", sorted_keys(fields.person_by_city.Lookup("Berlin")));
+    EXPECT_FALSE(fields.person_by_city.Has("London"));
+    EXPECT_EQ(2u, fields.person_by_city.Size());
+    EXPECT_EQ("carol,alice",
+              keys(fields.person_by_age_and_city.Range(std::make_tuple(25, ""), std::make_tuple(40, ""))));
+    EXPECT_EQ("carol,alice,dave", keys(fields.person_by_age_and_city));
+    EXPECT_EQ("c", cols(fields.cell_by_phew.Lookup(10)));
+    EXPECT_EQ("b,a", cols(fields.cell_by_phew.Lookup(20)));  // By the key, {2,b} before {3,a}.
+    EXPECT_EQ(3, Value(fields.cell.GetEntryFromCol("a")).foo);
+  };
+
+  {
+    auto storage = storage_t::CreateMasterStorage(persistence_file_name);
+
+    EXPECT_TRUE(WasCommitted(storage
+                                 ->ReadWriteTransaction([&keys, &sorted_keys, &cols](MutableFields<storage_t> fields) {
+                                   fields.person.Add(Person{"alice", "Paris", 30});
+                                   fields.person.Add(Person{"bob", "London", 25});
+                                   fields.person.Add(Person{"carol", "Paris", 25});
+                                   fields.person.Add(Person{"dave", "Berlin", 40});
+                                   fields.cell.Add(Cell{1, "a", 10});
+                                   fields.cell.Add(Cell{2, "b", 20});
+                                   fields.cell.Add(Cell{1, "c", 10});
+                                   // The indexes are up to date within the transaction.
+                                   EXPECT_EQ("alice,carol", sorted_keys(fields.person_by_city.Lookup("Paris")));
+                                   EXPECT_EQ("bob,carol,alice",
+                                             keys(fields.person_by_age_and_city.Range(std::make_tuple(25, ""),
+                                                                                      std::make_tuple(31, ""))));
+                                   EXPECT_EQ("a,c", cols(fields.cell_by_phew.Lookup(10)));
+                                 })
+                                 .Go()));
+
+    EXPECT_TRUE(WasCommitted(storage
+                                 ->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+                                   fields.person.Add(Person{"alice", "Berlin", 31});
+                                   fields.person.Erase("bob");
+                                   fields.cell.Add(Cell{3, "a", 20});  // Moves the column "a" from row 1 to row 3.
+                                 })
+                                 .Go()));
+    EXPECT_TRUE(WasCommitted(storage->ReadOnlyTransaction(verify).Go()));
+
+    // The rollback restores the indexes along with the containers.
+    EXPECT_FALSE(WasCommitted(storage
+                                  ->ReadWriteTransaction([&keys](MutableFields<storage_t> fields) {
+                                    fields.person.Add(Person{"bob", "Paris", 50});
+                                    fields.person.Add(Person{"carol", "London", 25});
+                                    fields.person.Erase("dave");
+                                    fields.cell.Add(Cell{4, "c", 20});
+                                    fields.cell.Erase(2, "b");
+                                    EXPECT_EQ("bob", keys(fields.person_by_city.Lookup("Paris")));
+                                    CURRENT_STORAGE_THROW_ROLLBACK();
+                                  })
+                                  .Go()));
+    EXPECT_TRUE(WasCommitted(storage->ReadOnlyTransaction(verify).Go()));
+  }
+
+  {
+    // The indexes are not persisted, and are rebuilt on replay.
+    auto storage = storage_t::CreateMasterStorage(persistence_file_name);
+    EXPECT_TRUE(WasCommitted(storage->ReadOnlyTransaction(verify).Go()));
+
+    EXPECT_TRUE(WasCommitted(storage
+                                 ->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                   const std::vector<const Person*> result =
+                                       fields.person_by_age_and_city.LookupFromStrings({"25", "Paris"});
+                                   ASSERT_EQ(1u, result.size());
+                                   EXPECT_EQ("carol", result[0]->key);
+                                   EXPECT_TRUE(fields.person_by_age_and_city.LookupFromStrings({"25", "Rome"}).empty());
+                                   ASSERT_THROW(fields.person_by_age_and_city.LookupFromStrings({"25"}),
+                                                current::storage::container::SecondaryIndexLookupArityException);
+                                 })
+                                 .Go()));
+  }
+}
+
+TEST(TransactionalStorage, PipelinedTransactions) {
+  current::time::ResetToZero();
+  // The mock clock ticks on its own, as the order of the transactions from different threads is not known upfront.
+  current::time::SetNow(std::chrono::microseconds(1), std::chrono::microseconds(1000 * 1000));
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamInMemoryStreamPersister, current::storage::transaction_policy::Pipelined>;
+
+  auto storage = storage_t::CreateMasterStorage();
+  const auto& data = storage->UnderlyingStream()->Data();
+
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&storage, t]() {
+        for (int i = 0; i < 100; ++i) {
+          const auto result = storage
+                                  ->ReadWriteTransaction([t, i](MutableFields<storage_t> fields) {
+                                    fields.d.Add(Record{current::ToString(t * 100 + i), i});
+                                    return fields.d.Size();
+                                  })
+                                  .Go();
+          EXPECT_TRUE(WasCommitted(result));
+          EXPECT_LE(static_cast<size_t>(i + 1), Value(result));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  EXPECT_EQ(400u, Value(storage->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                  return fields.d.Size();
+                                }).Go()));
+  size_t mutations = 0u;
+  for (const auto& e : data->Iterate()) {
+    mutations += e.entry.mutations.size();
+  }
+  EXPECT_EQ(400u, mutations);
+  EXPECT_GE(400u, data->Size());
+  const uint64_t entries_before = data->Size();
+
+  std::string trace;
+  {
+    // With the publishing mutex locked, the transactions queue up, and then run as one or two batches.
+    std::lock_guard<std::mutex> lock(storage->UnderlyingStream()->Impl()->publishing_mutex);
+    for (int i = 0; i < 10; ++i) {
+      storage->ReadWriteTransactionAsync(
+          [i](MutableFields<storage_t> fields) {
+            fields.d.Add(Record{"async" + current::ToString(i), i});
+            if (i == 5) {
+              CURRENT_STORAGE_THROW_ROLLBACK();
+            } else if (i == 7) {
+              CURRENT_THROW(current::Exception());
+            }
+            return i;
+          },
+          [&trace](current::storage::TransactionResult<int>&& result) {
+            trace += WasCommitted(result) ? current::ToString(Value(result)) : "R";
+          },
+          [&trace](std::exception_ptr) { trace += 'E'; });
+    }
+    EXPECT_EQ("", trace);
+  }
+  // The results are reported in order, and before the results of the transactions queued later.
+  EXPECT_TRUE(WasCommitted(storage->ReadWriteTransaction([](MutableFields<storage_t>) {}).Go()));
+  EXPECT_EQ("01234R6E89", trace);
+  EXPECT_LE(entries_before + 1u, data->Size());
+  EXPECT_GE(entries_before + 2u, data->Size());
+  EXPECT_TRUE(WasCommitted(storage
+                               ->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                 EXPECT_EQ(408u, fields.d.Size());
+                                 EXPECT_FALSE(Exists(fields.d["async5"]));
+                                 EXPECT_FALSE(Exists(fields.d["async7"]));
+                                 EXPECT_EQ(9, Value(fields.d["async9"]).rhs);
+                               })
+                               .Go()));
+
+  // The meta fields stay with the mutations of their transaction.
+  {
+    std::lock_guard<std::mutex> lock(storage->UnderlyingStream()->Impl()->publishing_mutex);
+    for (int i = 0; i < 3; ++i) {
+      storage
+          ->ReadWriteTransaction([i](MutableFields<storage_t> fields) {
+            fields.d.Add(Record{"meta" + current::ToString(i), i});
+            if (i == 1) {
+              fields.SetTransactionMetaField("who", "one");
+            }
+          })
+          .Detach();
+    }
+  }
+  EXPECT_TRUE(WasCommitted(storage->ReadWriteTransaction([](MutableFields<storage_t>) {}).Go()));
+  bool found = false;
+  for (const auto& e : data->Iterate()) {
+    if (!e.entry.meta.fields.empty()) {
+      EXPECT_FALSE(found);
+      found = true;
+      EXPECT_EQ("one", e.entry.meta.fields.at("who"));
+      EXPECT_EQ(1u, e.entry.mutations.size());
+    }
+  }
+  EXPECT_TRUE(found);
+
+  storage->GracefulShutdown();
+  EXPECT_THROW(storage->ReadWriteTransaction([](MutableFields<storage_t>) {}).Go(),
+               current::storage::StorageInGracefulShutdownException);
+}
+
+TEST(TransactionalStorage, PipelinedTransactionsAreSeenOncePersisted) {
+  current::time::ResetToZero();
+  current::time::SetNow(std::chrono::microseconds(1), std::chrono::microseconds(1000 * 1000));
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamInMemoryStreamPersister, current::storage::transaction_policy::Pipelined>;
+
+  auto storage = storage_t::CreateMasterStorage();
+  const auto& data = storage->UnderlyingStream()->Data();
+
+  // The read-only transactions run in between the batches, and each record they see is in the stream already.
+  std::atomic_bool done(false);
+  std::thread reader([&storage, &data, &done]() {
+    while (!done) {
+      storage
+          ->ReadOnlyTransaction([&data](ImmutableFields<storage_t> fields) {
+            size_t persisted = 0u;
+            for (const auto& e : data->Iterate()) {
+              persisted += e.entry.mutations.size();
+            }
+            EXPECT_LE(fields.d.Size(), persisted);
+          })
+          .Wait();
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 4; ++t) {
+    writers.emplace_back([&storage, t]() {
+      for (int i = 0; i < 100; ++i) {
+        storage
+            ->ReadWriteTransaction(
+                [t, i](MutableFields<storage_t> fields) { fields.d.Add(Record{current::ToString(t * 100 + i), i}); })
+            .Detach();
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  EXPECT_TRUE(WasCommitted(storage->ReadWriteTransaction([](MutableFields<storage_t>) {}).Go()));
+  done = true;
+  reader.join();
+  EXPECT_EQ(400u, Value(storage->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                  return fields.d.Size();
+                                }).Go()));
+}
+
 #endif  // STORAGE_ONLY_RUN_RESTFUL_TESTS
@@ -25,7 +25,16 @@ SOFTWARE.
 #ifndef CURRENT_STORAGE_TRANSACTION_POLICY_H
 #define CURRENT_STORAGE_TRANSACTION_POLICY_H
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "base.h"
 #include "exceptions.h"
@@ -40,6 +49,27 @@ namespace current {
 namespace storage {
 namespace transaction_policy {
 
+namespace impl {
+
+template <class PERSISTER>
+void PersistJournalOrDie(PERSISTER& persister, MutationJournal& journal) {
+  try {
+    persister.PersistJournalFromLockedSection(journal);
+  } catch (const ss::InconsistentTimestampException& e) {
+    std::cerr << "PersistJournal() failed with InconsistentTimestampException: " << e.what() << std::endl;
+#ifdef CURRENT_MOCK_TIME
+    std::cerr << "The binary is compiled with `CURRENT_MOCK_TIME`. Probably, `SetNow()` wasn't properly called."
+              << std::endl;
+#endif
+    std::exit(-1);
+  } catch (const std::exception& e) {
+    std::cerr << "PersistJournal() failed with exception: " << e.what() << std::endl;
+    std::exit(-1);
+  }
+}
+
+}  // namespace impl
+
 template <class PERSISTER>
 class Synchronous final {
  public:
@@ -48,6 +78,9 @@ class Synchronous final {
   Synchronous(PERSISTER& persister, MutationJournal& journal)
       : persister_(persister), journal_(journal), destructing_(false) {}
 
+  // The storage itself locks `fields_mutex` around every call into this policy.
+  Synchronous(PERSISTER& persister, MutationJournal& journal, std::shared_mutex&) : Synchronous(persister, journal) {}
+
   ~Synchronous() { destructing_ = true; }
 
 #ifndef CURRENT_FOR_CPP14
@@ -287,27 +320,317 @@ class Synchronous final {
   void GracefulShutdown() { destructing_ = true; }
 
  private:
-  void PersistJournal() {
+  void PersistJournal() { impl::PersistJournalOrDie(persister_, journal_); }
+
+  PERSISTER& persister_;
+  MutationJournal& journal_;
+  std::atomic_bool destructing_;
+};
+
+namespace impl {
+
+// A read-write transaction queued by `Pipelined`. Its outcome is kept until the batch it is part of is persisted.
+class PipelinedTransactionBase {
+ public:
+  virtual ~PipelinedTransactionBase() = default;
+  // Called with both the publishing mutex and the fields mutex locked. Returns whether the transaction has committed.
+  virtual bool Run(MutationJournal& journal) = 0;
+  virtual void Fail(std::exception_ptr exception) = 0;
+  // Called with no locks held, once the mutations of the whole batch are persisted.
+  virtual void Complete() = 0;
+};
+
+template <typename RESULT>
+class PromiseCompletion final {
+ public:
+  Future<TransactionResult<RESULT>, StrictFuture::Strict> GetFuture() {
+    return Future<TransactionResult<RESULT>, StrictFuture::Strict>(promise_.get_future());
+  }
+  void operator()(TransactionResult<RESULT>&& result) { promise_.set_value(std::move(result)); }
+  void operator()(std::exception_ptr exception) { promise_.set_exception(exception); }
+
+ private:
+  std::promise<TransactionResult<RESULT>> promise_;
+};
+
+template <typename ON_RESULT, typename ON_EXCEPTION>
+class CallbackCompletion final {
+ public:
+  CallbackCompletion(ON_RESULT&& on_result, ON_EXCEPTION&& on_exception)
+      : on_result_(std::move(on_result)), on_exception_(std::move(on_exception)) {}
+  template <typename RESULT>
+  void operator()(TransactionResult<RESULT>&& result) {
+    on_result_(std::move(result));
+  }
+  void operator()(std::exception_ptr exception) { on_exception_(exception); }
+
+ private:
+  ON_RESULT on_result_;
+  ON_EXCEPTION on_exception_;
+};
+
+#ifndef CURRENT_FOR_CPP14
+template <typename F>
+using pipelined_result_t = std::invoke_result_t<F&>;
+#else
+template <typename F>
+using pipelined_result_t = weed::call_with_type<F&>;
+#endif  // CURRENT_FOR_CPP14
+
+template <typename F, typename COMPLETION>
+class PipelinedTransaction final : public PipelinedTransactionBase {
+ public:
+  using result_t = pipelined_result_t<F>;
+
+  PipelinedTransaction(F&& f, COMPLETION&& completion) : f_(std::move(f)), completion_(std::move(completion)) {}
+
+  COMPLETION& Completion() { return completion_; }
+
+  bool Run(MutationJournal& journal) override { return RunImpl(journal, std::is_void<result_t>()); }
+
+  void Fail(std::exception_ptr exception) override { exception_ = exception; }
+
+  void Complete() override {
+    // LCOV_EXCL_START
     try {
-      persister_.PersistJournalFromLockedSection(journal_);
-    } catch (const ss::InconsistentTimestampException& e) {
-      std::cerr << "PersistJournal() failed with InconsistentTimestampException: " << e.what() << std::endl;
-#ifdef CURRENT_MOCK_TIME
-      std::cerr << "The binary is compiled with `CURRENT_MOCK_TIME`. Probably, `SetNow()` wasn't properly called."
-                << std::endl;
-#endif
-      std::exit(-1);
+      if (exception_) {
+        completion_(exception_);
+      } else {
+        completion_(std::move(*result_));
+      }
     } catch (const std::exception& e) {
-      std::cerr << "PersistJournal() failed with exception: " << e.what() << std::endl;
+      std::cerr << "Completing a transaction failed in Pipelined::WriterThread: " << e.what() << std::endl;
       std::exit(-1);
     }
+    // LCOV_EXCL_STOP
+  }
+
+ private:
+  bool RunImpl(MutationJournal& journal, std::false_type) {
+    try {
+      journal.BeforeTransaction();
+      result_t f_result = f_();
+      journal.AfterTransaction();
+      result_ = std::make_unique<TransactionResult<result_t>>(
+          TransactionResult<result_t>::Committed(std::move(f_result)));
+      return true;
+    } catch (StorageRollbackExceptionWithValue<result_t>& e) {
+      journal.Rollback();
+      result_ =
+          std::make_unique<TransactionResult<result_t>>(TransactionResult<result_t>::RolledBack(std::move(e.value)));
+    } catch (const StorageRollbackExceptionWithNoValue&) {
+      journal.Rollback();
+      result_ = std::make_unique<TransactionResult<result_t>>(
+          TransactionResult<result_t>::RolledBack(OptionalResultMissing()));
+    } catch (...) {  // The exception is captured with `std::current_exception()` below.
+      journal.Rollback();
+      exception_ = std::current_exception();
+    }
+    return false;
+  }
+
+  bool RunImpl(MutationJournal& journal, std::true_type) {
+    try {
+      journal.BeforeTransaction();
+      f_();
+      journal.AfterTransaction();
+      result_ = std::make_unique<TransactionResult<void>>(TransactionResult<void>::Committed(OptionalResultExists()));
+      return true;
+    } catch (const StorageRollbackExceptionWithNoValue&) {
+      journal.Rollback();
+      result_ = std::make_unique<TransactionResult<void>>(TransactionResult<void>::RolledBack(OptionalResultExists()));
+    } catch (...) {  // The exception is captured with `std::current_exception()` below.
+      journal.Rollback();
+      exception_ = std::current_exception();
+    }
+    return false;
+  }
+
+  F f_;
+  COMPLETION completion_;
+  std::unique_ptr<TransactionResult<result_t>> result_;
+  std::exception_ptr exception_;
+};
+
+}  // namespace impl
+
+// Runs the read-write transactions on a dedicated writer thread, in batches, instead of in the threads calling
+// `ReadWriteTransaction()`, which only queue them. A batch holds the publishing mutex once, runs its transactions one
+// after another, and coalesces the mutations of the consecutive committed ones into a single stream entry. Once the
+// entries are published, the results of the whole batch are reported, in the order the transactions were queued.
+// The fields stay locked exclusively for the whole batch, up to the publishing of its entries, so that, as with
+// `Synchronous`, the read-only transactions never see the mutations that are not in the stream yet.
+//
+// The transactions within a batch are still serialized, and each one still rolls back on its own. Two differences
+// from `Synchronous`:
+// 1) The stream entries span several transactions. The `begin_us` of an entry is that of its first transaction, and its
+//    `end_us` that of the last one. A transaction that sets meta fields is persisted as its own entry, so the meta
+//    fields always describe exactly the mutations they came with.
+// 2) The user code of the transaction runs on the writer thread, after `ReadWriteTransaction()` has returned, so it
+//    should own what it captures unless its future is waited for. Neither it nor the callbacks of
+//    `ReadWriteTransactionAsync()` should wait for another read-write transaction of the same storage.
+//
+// The read-only transactions, the two-step read-write ones, and the ones run from the section that has already
+// locked the publishing mutex, `MutexLockStatus::AlreadyLocked`, are run synchronously, as by `Synchronous`.
+template <class PERSISTER>
+class Pipelined final {
+ public:
+  using transaction_t = typename PERSISTER::transaction_t;
+
+  // At most this many queued transactions are run, and persisted, together.
+  constexpr static size_t kMaxBatchSize = 1024u;
+
+  Pipelined(PERSISTER& persister, MutationJournal& journal, std::shared_mutex& fields_mutex)
+      : persister_(persister),
+        journal_(journal),
+        fields_mutex_(fields_mutex),
+        synchronous_(persister, journal),
+        writer_thread_([this]() { WriterThread(); }) {}
+
+  // Runs the transactions already queued before returning.
+  ~Pipelined() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      destructing_ = true;
+      writer_thread_terminating_ = true;
+    }
+    queue_condition_variable_.notify_one();
+    writer_thread_.join();
+  }
+
+  template <typename... ARGS>
+  auto TransactionFromLockedSection(ARGS&&... args) {
+    return synchronous_.TransactionFromLockedSection(std::forward<ARGS>(args)...);
+  }
+
+  template <typename... ARGS>
+  auto TransactionFromLockedSection(ARGS&&... args) const {
+    return synchronous_.TransactionFromLockedSection(std::forward<ARGS>(args)...);
+  }
+
+  // Queues the read-write transaction `f`, which must lock nothing but the fields, and returns its future.
+  template <typename F>
+  Future<TransactionResult<impl::pipelined_result_t<std::decay_t<F>>>, StrictFuture::Strict> Enqueue(F&& f) {
+    using completion_t = impl::PromiseCompletion<impl::pipelined_result_t<std::decay_t<F>>>;
+    auto transaction = std::make_unique<impl::PipelinedTransaction<std::decay_t<F>, completion_t>>(
+        std::decay_t<F>(std::forward<F>(f)), completion_t());
+    auto future = transaction->Completion().GetFuture();
+    Push(std::move(transaction));
+    return future;
+  }
+
+  // Same, with no promise and future: calls `on_result(TransactionResult<...>&&)`, or `on_exception(exception_ptr)`
+  // if `f` throws, from the writer thread.
+  template <typename F, typename ON_RESULT, typename ON_EXCEPTION>
+  void Enqueue(F&& f, ON_RESULT&& on_result, ON_EXCEPTION&& on_exception) {
+    using completion_t = impl::CallbackCompletion<std::decay_t<ON_RESULT>, std::decay_t<ON_EXCEPTION>>;
+    Push(std::make_unique<impl::PipelinedTransaction<std::decay_t<F>, completion_t>>(
+        std::decay_t<F>(std::forward<F>(f)),
+        completion_t(std::decay_t<ON_RESULT>(std::forward<ON_RESULT>(on_result)),
+                     std::decay_t<ON_EXCEPTION>(std::forward<ON_EXCEPTION>(on_exception)))));
+  }
+
+  // The transactions queued before are still run; the ones queued after fail.
+  void GracefulShutdown() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      destructing_ = true;
+    }
+    synchronous_.GracefulShutdown();
+  }
+
+ private:
+  void Push(std::unique_ptr<impl::PipelinedTransactionBase> transaction) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      if (!destructing_) {
+        queue_.push_back(std::move(transaction));
+      }
+    }
+    if (transaction) {
+      transaction->Fail(std::make_exception_ptr(StorageInGracefulShutdownException()));
+      transaction->Complete();
+    } else {
+      queue_condition_variable_.notify_one();
+    }
+  }
+
+  void WriterThread() {
+    std::vector<std::unique_ptr<impl::PipelinedTransactionBase>> batch;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_condition_variable_.wait(lock, [this]() { return !queue_.empty() || writer_thread_terminating_; });
+        if (queue_.empty()) {
+          return;
+        }
+        const auto end = queue_.begin() + std::min(queue_.size(), kMaxBatchSize);
+        batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(end));
+        queue_.erase(queue_.begin(), end);
+      }
+      RunBatch(batch);
+      for (const auto& transaction : batch) {
+        transaction->Complete();
+      }
+      batch.clear();
+    }
+  }
+
+  void RunBatch(const std::vector<std::unique_ptr<impl::PipelinedTransactionBase>>& batch) {
+    std::lock_guard<std::mutex> lock(persister_.Stream()->Impl()->publishing_mutex);
+    if (!persister_.template IsMasterStoragePersister<current::locks::MutexLockStatus::AlreadyLocked>()) {
+      for (const auto& transaction : batch) {
+        transaction->Fail(std::make_exception_ptr(ReadWriteTransactionInFollowerStorageException()));
+      }
+      return;
+    }
+    std::lock_guard<std::shared_mutex> fields_lock(fields_mutex_);
+    for (const auto& transaction : batch) {
+      journal_.AssertEmpty();
+      if (transaction->Run(journal_)) {
+        Coalesce();
+      }
+    }
+    impl::PersistJournalOrDie(persister_, group_);
+  }
+
+  // Moves the mutations of the transaction that has just committed from `journal_` into `group_`.
+  void Coalesce() {
+    if (!journal_.transaction_meta.fields.empty()) {
+      impl::PersistJournalOrDie(persister_, group_);
+      impl::PersistJournalOrDie(persister_, journal_);
+    } else {
+      if (!journal_.commit_log.empty()) {
+        if (group_.commit_log.empty()) {
+          group_.transaction_meta.begin_us = journal_.transaction_meta.begin_us;
+        }
+        group_.transaction_meta.end_us = journal_.transaction_meta.end_us;
+        std::move(journal_.commit_log.begin(), journal_.commit_log.end(), std::back_inserter(group_.commit_log));
+      }
+      journal_.Clear();
+    }
   }
 
   PERSISTER& persister_;
   MutationJournal& journal_;
-  std::atomic_bool destructing_;
+  std::shared_mutex& fields_mutex_;
+  Synchronous<PERSISTER> synchronous_;
+  // The mutations of the batch being run, not yet persisted. Never rolled back, so its `rollback_log` stays empty.
+  MutationJournal group_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_condition_variable_;
+  std::deque<std::unique_ptr<impl::PipelinedTransactionBase>> queue_;
+  bool destructing_ = false;
+  bool writer_thread_terminating_ = false;
+  std::thread writer_thread_;  // Last, to be started once everything else is constructed.
 };
 
+template <class POLICY>
+struct IsPipelined : std::false_type {};
+
+template <class PERSISTER>
+struct IsPipelined<Pipelined<PERSISTER>> : std::true_type {};
+
 }  // namespace transaction_policy
 }  // namespace storage
 }  // namespace current
@@ -26,6 +26,7 @@ SOFTWARE.
 #define CURRENT_STREAM_EXCEPTIONS_H
 
 #include "../bricks/exception.h"
+#include "../bricks/strings/printf.h"
 #include "../blocks/graceful_shutdown/exceptions.h"
 
 namespace current {
@@ -83,6 +84,16 @@ struct RemoteStreamRefusedFlipRequestException : StreamException {
   using StreamException::StreamException;
 };
 
+// Thrown by `PublishUnsafeBatch()` if only the first `published` raw log lines of the batch made it into the stream.
+struct StreamBatchPartiallyPublishedException : StreamException {
+  const uint64_t published;
+  StreamBatchPartiallyPublishedException(uint64_t published, const std::string& reason)
+      : StreamException(current::strings::Printf("Published %lld entries of the batch, then failed: %s",
+                                                 static_cast<long long>(published),
+                                                 reason.c_str())),
+        published(published) {}
+};
+
 }  // namespace stream
 }  // namespace current
 
@@ -28,11 +28,22 @@ SOFTWARE.
 
 #include "../port.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "stream_impl.h"
 
 #include "../typesystem/timestamp.h"
+#include "../typesystem/serialization/binary.h"
 
 #include "../blocks/http/api.h"
 #include "../blocks/ss/ss.h"
@@ -113,6 +124,23 @@ SOFTWARE.
 //    HEAD request : Same as `sizeonly`, but return the total number of records in HTTP header, not body.
 //
 //    `terminate`  : Terminate HTTP connection for the subscription id passed as the value of this parameter.
+//
+// 5. The wire format.
+//
+//    `batched`        : Instead of one `JSON(idxts)\tJSON(entry)` line per entry, send length-prefixed batches
+//                       of the raw log lines, see `ReplicationBatchHeader` below. Meant for replication, where
+//                       the follower appends each batch in bulk. `entries_only` and `array` are ignored.
+//
+//    `batched=binary` : Same, but each entry is sent as its fixed-size index and timestamp followed by
+//                       the `ToBinary()` of the entry. Implies `checked`, as the entries need to be parsed.
+
+// 6. Shared tail.
+//
+//    The live subscribers that only follow the stream, i.e. the unchecked JSON lines ones, with or without
+//    `entries_only`, and with none of `array`, `n`, `period`, `nowait` and `stop_after_bytes`, do not keep a thread
+//    each. Once such a subscriber has caught up, its connection is handed over to the shared tail of the stream,
+//    which formats each new entry once and writes the same bytes to all the connections it serves.
+//    See `PubSubHTTPBroadcasterImpl` below. The wire format and `terminate` stay the same.
 
 // TODO(dkorolev): Add timestamps to `sizeonly` and `HEAD` too?
 // TODO(dkorolev): Mention head updates now as we're here?
@@ -120,6 +148,29 @@ SOFTWARE.
 namespace current {
 namespace stream {
 
+enum class ReplicationWireFormat : int { JSONLines = 0, Batches = 1, BinaryBatches = 2 };
+
+// The frame of the `batched` wire format: this header followed by `payload_size` bytes of `entries` records.
+// Each record is its `uint32_t` length followed by the record itself. A non-zero `head_us` is the head of the stream
+// as of the end of this frame; the frame may carry no records if it only updates the head.
+// The integers are in the host byte order, as the replication is expected to happen between the same architectures.
+struct ReplicationBatchHeader {
+  uint32_t entries;
+  uint32_t payload_size;
+  int64_t head_us;
+};
+static_assert(sizeof(ReplicationBatchHeader) == 16, "`ReplicationBatchHeader` must be 16 bytes.");
+
+// The prefix of each record of the `batched=binary` wire format, followed by the `ToBinary()` of the entry.
+struct ReplicationBinaryRecordPrefix {
+  uint64_t index;
+  int64_t us;
+};
+static_assert(sizeof(ReplicationBinaryRecordPrefix) == 16, "`ReplicationBinaryRecordPrefix` must be 16 bytes.");
+
+// The frame is sent as soon as its payload exceeds this size, or as soon as the subscriber has caught up.
+constexpr size_t kReplicationMaxBatchPayloadSize = 1024 * 1024;
+
 struct ParsedHTTPRequestParams {
   // If set, return current stream size.
   // Controlled by `sizeonly` URL parameter or using `HEAD` method.
@@ -161,6 +212,8 @@ struct ParsedHTTPRequestParams {
   // If set, parse and validate each entry before sending it.
   // If not, skip the validation (using the "unsafe" iteration) to speed up the communication.
   bool checked = false;
+  // The format of the response. Controlled by `batched` URL parameter.
+  ReplicationWireFormat wire_format = ReplicationWireFormat::JSONLines;
 };
 
 inline ParsedHTTPRequestParams ParsePubSubHTTPRequest(const Request& r) {
@@ -225,10 +278,378 @@ inline ParsedHTTPRequestParams ParsePubSubHTTPRequest(const Request& r) {
   if (r.url.query.has("checked")) {
     result.checked = true;
   }
+  if (r.url.query.has("batched")) {
+    if (r.url.query["batched"] == "binary") {
+      result.wire_format = ReplicationWireFormat::BinaryBatches;
+      result.checked = true;  // The binary format needs the entries, not the raw log lines.
+    } else {
+      result.wire_format = ReplicationWireFormat::Batches;
+    }
+  }
 
   return result;
 }
 
+// Whether the subscriber can be served by the shared tail once it has caught up.
+inline bool IsBroadcastablePubSubHTTPRequest(const ParsedHTTPRequestParams& params) {
+  return !params.checked && params.wire_format == ReplicationWireFormat::JSONLines && !params.array && !params.n &&
+         !params.period.count() && !params.no_wait && !params.stop_after_bytes;
+}
+
+constexpr static const char* kPubSubHTTPSubscriberTerminatedMessage =
+    "{\"error\":\"The subscriber has terminated.\"}\n";
+
+using pubsub_http_response_sender_t =
+    current::net::HTTPServerConnection::ChunkedResponseSender<CURRENT_BRICKS_HTTP_DEFAULT_CHUNK_CACHE_SIZE>;
+
+// The formatted entries, as the shared tail hands them to the shards to write. Immutable once published.
+// Contains either `count` consecutive entries starting from `first_index`, or, if `count` is zero, the head line.
+struct PubSubHTTPBroadcastBlock final {
+  uint64_t first_index = 0u;
+  uint64_t count = 0u;
+  // The raw log lines, each followed by '\n'. The entry `i` spans `[offsets[i], offsets[i + 1])`.
+  std::string lines;
+  std::vector<size_t> lines_offsets = std::vector<size_t>(1u, 0u);
+  // The same, but the entries only, without their indexes and timestamps, for the `entries_only` subscribers.
+  std::string entries;
+  std::vector<size_t> entries_offsets = std::vector<size_t>(1u, 0u);
+  std::string head_line;
+  std::chrono::microseconds head = std::chrono::microseconds(0);
+
+  void AddRawLogLine(std::string_view raw_log_line) {
+    lines.append(raw_log_line.data(), raw_log_line.size());
+    lines += '\n';
+    lines_offsets.push_back(lines.length());
+    const auto tab_pos = raw_log_line.find('\t');
+    const auto entry = tab_pos != std::string_view::npos ? raw_log_line.substr(tab_pos + 1) : raw_log_line;
+    entries.append(entry.data(), entry.size());
+    entries += '\n';
+    entries_offsets.push_back(entries.length());
+    ++count;
+  }
+};
+
+// One shard of the shared tail: the thread that writes the published blocks to the connections it owns.
+// A slow connection only delays the other connections of its own shard.
+class PubSubHTTPBroadcastShard final {
+ public:
+  struct Connection final {
+    const std::string subscription_id;
+    const bool entries_only;
+    // The index of the first entry this connection has not seen yet.
+    uint64_t next_index;
+    // `request` keeps the socket open for as long as `response` writes into it.
+    Request request;
+    pubsub_http_response_sender_t response;
+    // The head the shared tail has published before the takeover, if any, to be sent first.
+    std::shared_ptr<const PubSubHTTPBroadcastBlock> pending_head;
+    Connection(std::string subscription_id,
+               bool entries_only,
+               uint64_t next_index,
+               Request&& request,
+               pubsub_http_response_sender_t&& response,
+               std::shared_ptr<const PubSubHTTPBroadcastBlock> pending_head)
+        : subscription_id(std::move(subscription_id)),
+          entries_only(entries_only),
+          next_index(next_index),
+          request(std::move(request)),
+          response(std::move(response)),
+          pending_head(std::move(pending_head)) {}
+  };
+
+  PubSubHTTPBroadcastShard() : thread_(&PubSubHTTPBroadcastShard::Thread, this) {}
+
+  ~PubSubHTTPBroadcastShard() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      destructing_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  void Add(std::unique_ptr<Connection> connection) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      added_.push_back(std::move(connection));
+      ++size_;
+    }
+    cv_.notify_one();
+  }
+
+  void Publish(std::shared_ptr<const PubSubHTTPBroadcastBlock> block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (size_) {
+        blocks_.push_back(std::move(block));
+      }
+    }
+    cv_.notify_one();
+  }
+
+  // Returns whether the connection was found in this shard. It is closed by the thread of the shard.
+  bool Terminate(const std::string& subscription_id) {
+    bool found = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& connection : connections_) {
+        found |= (connection->subscription_id == subscription_id);
+      }
+      for (const auto& connection : added_) {
+        found |= (connection->subscription_id == subscription_id);
+      }
+      if (found) {
+        terminated_.push_back(subscription_id);
+      }
+    }
+    cv_.notify_one();
+    return found;
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+ private:
+  // Writes the part of the block the connection has not seen yet. Returns `false` if the connection is gone.
+  static bool Write(Connection& connection, const PubSubHTTPBroadcastBlock& block, bool flush) {
+    const auto chunk_flush = flush ? current::net::ChunkFlush::Flush : current::net::ChunkFlush::NoFlush;
+    try {
+      if (!block.count) {
+        if (!connection.entries_only && block.first_index >= connection.next_index) {
+          connection.response(block.head_line, chunk_flush);
+        } else if (flush) {
+          connection.response("", chunk_flush);
+        }
+        return true;
+      }
+      const uint64_t end_index = block.first_index + block.count;
+      if (end_index > connection.next_index) {
+        const size_t skip = static_cast<size_t>(connection.next_index > block.first_index
+                                                    ? connection.next_index - block.first_index
+                                                    : 0u);
+        const std::string& data = connection.entries_only ? block.entries : block.lines;
+        const std::vector<size_t>& offsets = connection.entries_only ? block.entries_offsets : block.lines_offsets;
+        // One chunk per entry, as the per-subscriber path sends them; the clients may rely on it. The chunks are
+        // coalesced in the cache of the sender, so they do not cost a write each. The `skip` is only non-zero
+        // for the first block after the takeover, if the shared tail was lagging behind.
+        const std::string_view view(data);
+        for (size_t i = skip; i < block.count; ++i) {
+          connection.response(view.substr(offsets[i], offsets[i + 1] - offsets[i]),
+                              i + 1 == block.count ? chunk_flush : current::net::ChunkFlush::NoFlush);
+        }
+        connection.next_index = end_index;
+      } else if (flush) {
+        connection.response("", chunk_flush);
+      }
+      return true;
+    } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+      return false;                                    // LCOV_EXCL_LINE
+    }
+  }
+
+  static void Close(Connection& connection) {
+    try {
+      connection.response(kPubSubHTTPSubscriberTerminatedMessage);
+    } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+    }
+  }
+
+  void Thread() {
+    std::vector<std::shared_ptr<const PubSubHTTPBroadcastBlock>> blocks;
+    std::vector<std::string> terminated;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() {
+          return destructing_ || !added_.empty() || !blocks_.empty() || !terminated_.empty();
+        });
+        if (destructing_) {
+          break;
+        }
+        for (auto& connection : added_) {
+          connections_.push_back(std::move(connection));
+        }
+        added_.clear();
+        blocks.assign(blocks_.begin(), blocks_.end());
+        blocks_.clear();
+        terminated.swap(terminated_);
+      }
+      // The connections are only ever touched from this thread, so the writes happen outside the lock.
+      for (auto& connection : connections_) {
+        // Unless the head is about to be written anyway, as it was published after the connection was added.
+        if (connection->pending_head) {
+          if (std::find(blocks.begin(), blocks.end(), connection->pending_head) == blocks.end()) {
+            Write(*connection, *connection->pending_head, blocks.empty());
+          }
+          connection->pending_head = nullptr;
+        }
+      }
+      std::vector<std::unique_ptr<Connection>> closed;
+      for (auto& connection : connections_) {
+        bool alive = true;
+        for (const std::string& id : terminated) {
+          if (connection->subscription_id == id) {
+            Close(*connection);
+            alive = false;
+          }
+        }
+        for (size_t i = 0u; alive && i < blocks.size(); ++i) {
+          alive = Write(*connection, *blocks[i], i + 1u == blocks.size());
+        }
+        if (!alive) {
+          closed.push_back(std::move(connection));
+        }
+      }
+      if (!closed.empty()) {
+        connections_.erase(std::remove(connections_.begin(), connections_.end(), nullptr), connections_.end());
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_ -= closed.size();
+      }
+      blocks.clear();
+      terminated.clear();
+      // The destructors of the closed connections send the final chunk and close the sockets.
+    }
+    for (auto& connection : connections_) {
+      Close(*connection);
+    }
+    connections_.clear();
+    added_.clear();
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool destructing_ = false;
+  size_t size_ = 0u;
+  std::vector<std::unique_ptr<Connection>> added_;
+  std::deque<std::shared_ptr<const PubSubHTTPBroadcastBlock>> blocks_;
+  std::vector<std::string> terminated_;
+  // Owned by the thread.
+  std::vector<std::unique_ptr<Connection>> connections_;
+  std::thread thread_;
+};
+
+// The shared tail of the stream: a single unchecked subscriber, following the stream from where it was created,
+// that formats each new entry once, and has its shards write the very same bytes to all the connections.
+// Owned by the `Stream`, and created upon the first subscriber that can be handed over to it.
+class PubSubHTTPBroadcasterImpl {
+ public:
+  explicit PubSubHTTPBroadcasterImpl(uint64_t begin_index, size_t shards = kDefaultShards)
+      : published_index_(begin_index) {
+    for (size_t i = 0u; i < std::max(shards, static_cast<size_t>(1u)); ++i) {
+      shards_.push_back(std::make_unique<PubSubHTTPBroadcastShard>());
+    }
+  }
+
+  // Takes over the connection of the subscriber which has sent everything up to, but not including, `next_index`,
+  // the last of it timestamped `last_us`.
+  // Returns `false`, leaving the connection untouched, if the shared tail has already published past `next_index`;
+  // the subscriber should then keep serving on its own, and try again once it has caught up next time.
+  bool TryTakeOver(const std::string& subscription_id,
+                   bool entries_only,
+                   uint64_t next_index,
+                   std::chrono::microseconds last_us,
+                   Request& request,
+                   pubsub_http_response_sender_t& response) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (terminated_ || next_index < published_index_) {
+      return false;
+    }
+    PubSubHTTPBroadcastShard* least_loaded = shards_.front().get();
+    for (const auto& shard : shards_) {
+      if (shard->Size() < least_loaded->Size()) {
+        least_loaded = shard.get();
+      }
+    }
+    // The subscriber hands over right after its last entry, so it has not sent the head which the shared tail may
+    // have published after that very entry, before the takeover.
+    std::shared_ptr<const PubSubHTTPBroadcastBlock> pending_head;
+    if (last_head_ && last_head_->first_index == next_index && last_head_->head > last_us) {
+      pending_head = last_head_;
+    }
+    least_loaded->Add(std::make_unique<PubSubHTTPBroadcastShard::Connection>(
+        subscription_id, entries_only, next_index, std::move(request), std::move(response), std::move(pending_head)));
+    return true;
+  }
+
+  // Returns whether the subscription was served by the shared tail, in which case its connection gets closed.
+  bool TerminateSubscription(const std::string& subscription_id) {
+    for (const auto& shard : shards_) {
+      if (shard->Terminate(subscription_id)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t ConnectionsCount() const {
+    size_t result = 0u;
+    for (const auto& shard : shards_) {
+      result += shard->Size();
+    }
+    return result;
+  }
+
+  ss::EntryResponse operator()(std::string_view raw_log_line, uint64_t current_index, idxts_t last) {
+    if (!block_) {
+      block_ = std::make_shared<PubSubHTTPBroadcastBlock>();
+      block_->first_index = current_index;
+    }
+    block_->AddRawLogLine(raw_log_line);
+    if (current_index == last.index || block_->lines.length() >= kMaxBlockSize) {
+      Publish(std::move(block_));
+    }
+    return ss::EntryResponse::More;
+  }
+
+  ss::EntryResponse operator()(std::chrono::microseconds us) {
+    auto block = std::make_shared<PubSubHTTPBroadcastBlock>();
+    block->head_line = JSON(ts_only_t(us)) + '\n';
+    block->head = us;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      block->first_index = published_index_;
+    }
+    Publish(std::move(block));
+    return ss::EntryResponse::More;
+  }
+
+  ss::EntryResponse EntryResponseIfNoMorePassTypeFilter() const { return ss::EntryResponse::More; }
+
+  ss::TerminationResponse Terminate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    terminated_ = true;
+    return ss::TerminationResponse::Terminate;
+  }
+
+ private:
+  constexpr static size_t kDefaultShards = 4u;
+  constexpr static size_t kMaxBlockSize = 64u * 1024u;
+
+  void Publish(std::shared_ptr<PubSubHTTPBroadcastBlock> block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_index_ = std::max(published_index_, block->first_index + block->count);
+    const std::shared_ptr<const PubSubHTTPBroadcastBlock> immutable_block = std::move(block);
+    last_head_ = immutable_block->count ? nullptr : immutable_block;
+    for (const auto& shard : shards_) {
+      shard->Publish(immutable_block);
+    }
+  }
+
+  std::mutex mutex_;
+  bool terminated_ = false;
+  // The index of the first entry not yet handed to the shards.
+  uint64_t published_index_;
+  // The head published after the last entries, if any.
+  std::shared_ptr<const PubSubHTTPBroadcastBlock> last_head_;
+  std::shared_ptr<PubSubHTTPBroadcastBlock> block_;
+  std::vector<std::unique_ptr<PubSubHTTPBroadcastShard>> shards_;
+};
+
+template <typename E>
+using PubSubHTTPBroadcaster = current::ss::StreamSubscriber<PubSubHTTPBroadcasterImpl, E>;
+
 template <typename E, template <typename> class PERSISTENCE_LAYER, class J>
 class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
  public:
@@ -237,8 +658,11 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
   PubSubHTTPEndpointImpl(const std::string& subscription_id,
                          Borrowed<impl_t> data,
                          Request r,
-                         ParsedHTTPRequestParams params)
+                         ParsedHTTPRequestParams params,
+                         PubSubHTTPBroadcasterImpl* broadcaster = nullptr)
       : impl_(std::move(data), [this]() { time_to_terminate_ = true; }),
+        subscription_id_(subscription_id),
+        broadcaster_(IsBroadcastablePubSubHTTPRequest(params) ? broadcaster : nullptr),
         http_request_(std::move(r)),
         params_(std::move(params)),
         output_started_(false),
@@ -248,7 +672,9 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
                 {kStreamHeaderCurrentSubscriptionId, subscription_id},
                 {kStreamHeaderCurrentStreamSize, current::ToString(impl_->persister.Size())},
             }),
-            current::net::constants::kDefaultJSONContentType)) {
+            params_.wire_format == ReplicationWireFormat::JSONLines
+                ? current::net::constants::kDefaultJSONContentType
+                : current::net::constants::kDefaultBinaryContentType)) {
     if (params_.recent.count() > 0) {
       serving_ = false;  // Start in 'non-serving' mode when `recent` is set.
       from_timestamp_ = r.timestamp - params_.recent;
@@ -292,26 +718,41 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         if (to_timestamp_.count() && current.us > to_timestamp_) {
           return ss::EntryResponse::Done;
         }
-        const std::string entry_json = [this, &current, &entry]() {
-          if (params_.entries_only) {
-            return JSON<J>(entry) + '\n';
+        if (params_.wire_format != ReplicationWireFormat::JSONLines) {
+          if (params_.wire_format == ReplicationWireFormat::BinaryBatches) {
+            current_response_size_ += AppendBinaryRecordToBatch(current, entry);
           } else {
-            return JSON<J>(current) + '\t' + JSON<J>(entry) + '\n';
+            current_response_size_ += AppendRecordToBatch(JSON<J>(current) + '\t' + JSON<J>(entry));
           }
-        }();
-        current_response_size_ += entry_json.length();
-        try {
-          if (params_.array) {
-            if (!output_started_) {
-              http_response_("[\n");
-              output_started_ = true;
+          try {
+            if (current.index == last.index || batch_.length() >= kReplicationMaxBatchPayloadSize) {
+              SendBatch();
+            }
+          } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+            return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
+          }
+        } else {
+          const std::string entry_json = [this, &current, &entry]() {
+            if (params_.entries_only) {
+              return JSON<J>(entry) + '\n';
             } else {
-              http_response_(",\n");
+              return JSON<J>(current) + '\t' + JSON<J>(entry) + '\n';
             }
+          }();
+          current_response_size_ += entry_json.length();
+          try {
+            if (params_.array) {
+              if (!output_started_) {
+                http_response_("[\n");
+                output_started_ = true;
+              } else {
+                http_response_(",\n");
+              }
+            }
+            http_response_(std::move(entry_json));
+          } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+            return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
           }
-          http_response_(std::move(entry_json));
-        } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
-          return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
         }
         // Respect `stop_after_bytes`.
         if (params_.stop_after_bytes && current_response_size_ >= params_.stop_after_bytes) {
@@ -331,17 +772,22 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
       }
       return ss::EntryResponse::More;
     }();
-    if (result == ss::EntryResponse::Done && params_.array) {
-      if (!output_started_) {
-        http_response_("[]\n");
-      } else {
-        http_response_("]\n");
+    if (result == ss::EntryResponse::Done) {
+      if (params_.wire_format != ReplicationWireFormat::JSONLines) {
+        SendBatchIfConnected();
+      } else if (params_.array) {
+        if (!output_started_) {
+          http_response_("[]\n");
+        } else {
+          http_response_("]\n");
+        }
       }
     }
     return result;
   }
 
-  ss::EntryResponse operator()(const std::string& raw_log_line, uint64_t current_index, idxts_t last) {
+  // Takes `std::string_view`, as the unsafe iterators of the file persister point right into the mapped file.
+  ss::EntryResponse operator()(std::string_view raw_log_line, uint64_t current_index, idxts_t last) {
     const ss::EntryResponse result = [&, this]() {
       if (time_to_terminate_) {
         return ss::EntryResponse::Done;
@@ -374,29 +820,46 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         if (to_timestamp_.count() && GetCurrentUs() > to_timestamp_) {
           return ss::EntryResponse::Done;
         }
-        const std::string response_data = [this, &raw_log_line]() {
-          if (!params_.entries_only) {
-            return raw_log_line;
-          } else {
-            const auto tab_pos = raw_log_line.find('\t');
-            return tab_pos != std::string::npos ? raw_log_line.substr(tab_pos + 1) : raw_log_line;
+        // The raw log lines go into the batch as they are, as `batched=binary` implies `checked`.
+        if (params_.wire_format != ReplicationWireFormat::JSONLines) {
+          current_response_size_ += AppendRecordToBatch(raw_log_line);
+          try {
+            if (current_index == last.index || batch_.length() >= kReplicationMaxBatchPayloadSize) {
+              SendBatch();
+            }
+          } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+            return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
           }
-        }() + '\n';
-        current_response_size_ += response_data.length();
-        try {
-          if (params_.array) {
-            if (!output_started_) {
-              http_response_("[\n", current::net::ChunkFlush::NoFlush);
-              output_started_ = true;
+        } else {
+          // Assemble the line to send in the buffer reused across entries, not to allocate memory per entry.
+          const std::string& response_data = [this, &raw_log_line]() -> const std::string& {
+            if (!params_.entries_only) {
+              response_buffer_.assign(raw_log_line.data(), raw_log_line.size());
             } else {
-              http_response_(",\n", current::net::ChunkFlush::NoFlush);
+              const auto tab_pos = raw_log_line.find('\t');
+              const auto entry =
+                  tab_pos != std::string_view::npos ? raw_log_line.substr(tab_pos + 1) : raw_log_line;
+              response_buffer_.assign(entry.data(), entry.size());
+            }
+            response_buffer_ += '\n';
+            return response_buffer_;
+          }();
+          current_response_size_ += response_data.length();
+          try {
+            if (params_.array) {
+              if (!output_started_) {
+                http_response_("[\n", current::net::ChunkFlush::NoFlush);
+                output_started_ = true;
+              } else {
+                http_response_(",\n", current::net::ChunkFlush::NoFlush);
+              }
             }
+            http_response_(
+                response_data,
+                current_index == last.index ? current::net::ChunkFlush::Flush : current::net::ChunkFlush::NoFlush);
+          } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+            return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
           }
-          http_response_(
-              response_data,
-              current_index == last.index ? current::net::ChunkFlush::Flush : current::net::ChunkFlush::NoFlush);
-        } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
-          return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
         }
         // Respect `stop_after_bytes`.
         if (params_.stop_after_bytes && current_response_size_ >= params_.stop_after_bytes) {
@@ -413,11 +876,20 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         if (current_index == last.index && params_.no_wait) {
           return ss::EntryResponse::Done;
         }
+        // Caught up, and everything up to here is flushed: let the shared tail of the stream serve the rest.
+        if (broadcaster_ && current_index == last.index &&
+            broadcaster_->TryTakeOver(
+                subscription_id_, params_.entries_only, current_index + 1u, last.us, http_request_, http_response_)) {
+          handed_over_ = true;
+          return ss::EntryResponse::Done;
+        }
       }
       return ss::EntryResponse::More;
     }();
-    if (result == ss::EntryResponse::Done) {
-      if (params_.array) {
+    if (result == ss::EntryResponse::Done && !handed_over_) {
+      if (params_.wire_format != ReplicationWireFormat::JSONLines) {
+        SendBatchIfConnected();
+      } else if (params_.array) {
         if (!output_started_) {
           http_response_("[]\n");
         } else {
@@ -448,7 +920,14 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
       if (to_timestamp_.count() && us > to_timestamp_) {
         return ss::EntryResponse::Done;
       }
-      if (!params_.array && !params_.entries_only) {
+      if (params_.wire_format != ReplicationWireFormat::JSONLines) {
+        batch_head_ = us;
+        try {
+          SendBatch();
+        } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+          return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
+        }
+      } else if (!params_.array && !params_.entries_only) {
         http_response_(JSON<J>(ts_only_t(us)) + '\n');
       }
     }
@@ -463,8 +942,10 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
 
   // LCOV_EXCL_START
   ss::TerminationResponse Terminate() {
-    static const std::string message = "{\"error\":\"The subscriber has terminated.\"}\n";
-    if (params_.array && output_started_) {
+    static const std::string message = kPubSubHTTPSubscriberTerminatedMessage;
+    if (params_.wire_format != ReplicationWireFormat::JSONLines) {
+      SendBatchIfConnected();  // No room for a message in the batched wire format.
+    } else if (params_.array && output_started_) {
       http_response_(",\n" + message + "]\n");
     } else {
       http_response_(message);
@@ -474,10 +955,70 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
   // LCOV_EXCL_STOP
 
  private:
+  // Appends one record to the batch being accumulated, returns the number of bytes it took.
+  size_t AppendRecordToBatch(std::string_view record) {
+    const size_t size_before = StartBatchIfEmpty();
+    const uint32_t length = static_cast<uint32_t>(record.length());
+    batch_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    batch_.append(record.data(), record.length());
+    ++batch_entries_;
+    return batch_.length() - size_before;
+  }
+
+  size_t AppendBinaryRecordToBatch(idxts_t current, const E& entry) {
+    const size_t size_before = StartBatchIfEmpty();
+    batch_.append(sizeof(uint32_t), '\0');  // The length of the record, to be filled in once it is known.
+    ReplicationBinaryRecordPrefix prefix;
+    prefix.index = current.index;
+    prefix.us = static_cast<int64_t>(current.us.count());
+    batch_.append(reinterpret_cast<const char*>(&prefix), sizeof(prefix));
+    current::serialization::binary::AppendBinary(batch_, entry);
+    const uint32_t length = static_cast<uint32_t>(batch_.length() - size_before - sizeof(uint32_t));
+    std::memcpy(&batch_[size_before], &length, sizeof(length));
+    ++batch_entries_;
+    return batch_.length() - size_before;
+  }
+
+  // The header of the frame is reserved in front of its first record, and is filled in by `SendBatch()`.
+  size_t StartBatchIfEmpty() {
+    if (batch_.empty()) {
+      batch_.assign(sizeof(ReplicationBatchHeader), '\0');
+    }
+    return batch_.length();
+  }
+
+  // Sends the records accumulated so far, along with the updated head, if any, as a single frame.
+  void SendBatch() {
+    if (batch_entries_ || batch_head_.count()) {
+      StartBatchIfEmpty();
+      ReplicationBatchHeader header;
+      header.entries = batch_entries_;
+      header.payload_size = static_cast<uint32_t>(batch_.length() - sizeof(ReplicationBatchHeader));
+      header.head_us = static_cast<int64_t>(batch_head_.count());
+      std::memcpy(&batch_[0], &header, sizeof(header));
+      batch_entries_ = 0u;
+      batch_head_ = std::chrono::microseconds(0);
+      http_response_(batch_, current::net::ChunkFlush::Flush);
+      batch_.clear();
+    }
+  }
+
+  void SendBatchIfConnected() {
+    try {
+      SendBatch();
+    } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
+    }
+  }
+
   // The HTTP listener must register itself as a user of stream data to ensure the lifetime of stream data.
   const BorrowedWithCallback<impl_t> impl_;
   std::atomic_bool time_to_terminate_{false};
 
+  const std::string subscription_id_;
+  // The shared tail to hand the connection over to once caught up, if this subscriber can be served by it.
+  PubSubHTTPBroadcasterImpl* const broadcaster_;
+  bool handed_over_ = false;
+
   // `http_request_`:  need to keep the passed in request in scope for the lifetime of the chunked response.
   Request http_request_;
   ParsedHTTPRequestParams params_;
@@ -489,6 +1030,12 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
       http_response_;
   // Current response size in bytes.
   size_t current_response_size_ = 0u;
+  // The buffer to prepare the raw log lines to be sent in.
+  std::string response_buffer_;
+  // The frame of the batched wire format being accumulated, its header included, and what goes into that header.
+  std::string batch_;
+  uint32_t batch_entries_ = 0u;
+  std::chrono::microseconds batch_head_ = std::chrono::microseconds(0);
 
   // Conditions on which parts of the stream to serve.
   bool serving_ = true;
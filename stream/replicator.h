@@ -27,10 +27,13 @@ SOFTWARE.
 #ifndef CURRENT_STREAM_REPLICATOR_H
 #define CURRENT_STREAM_REPLICATOR_H
 
+#include <cstring>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "exceptions.h"
 #include "stream.h"
@@ -83,9 +86,15 @@ class SubscribableRemoteStream final {
       }
     }
 
-    std::string GetURLToSubscribe(uint64_t index, std::chrono::microseconds from_us, SubscriptionMode mode) const {
+    std::string GetURLToSubscribe(uint64_t index,
+                                  std::chrono::microseconds from_us,
+                                  SubscriptionMode mode,
+                                  ReplicationWireFormat wire_format = ReplicationWireFormat::JSONLines) const {
       return url_ + "?i=" + current::ToString(index) + (mode == SubscriptionMode::Checked ? "&checked" : "") +
-             (from_us.count() > 0 ? "&since=" + current::ToString(from_us) : "");
+             (from_us.count() > 0 ? "&since=" + current::ToString(from_us) : "") +
+             (wire_format == ReplicationWireFormat::Batches
+                  ? "&batched"
+                  : wire_format == ReplicationWireFormat::BinaryBatches ? "&batched=binary" : "");
     }
 
     std::string GetURLToTerminate(const std::string& subscription_id) const {
@@ -118,14 +127,21 @@ class SubscribableRemoteStream final {
                            F& subscriber,
                            uint64_t start_idx,
                            std::chrono::microseconds from_us = std::chrono::microseconds(0),
-                           std::function<void()> destruction_callback = nullptr)
+                           std::function<void()> destruction_callback = nullptr,
+                           ReplicationWireFormat wire_format = ReplicationWireFormat::JSONLines)
         : borrowed_remote_stream_(std::move(remote_stream), destruction_callback),
           subscriber_(subscriber),
           next_expected_index_(start_idx),
           from_us_(from_us),
-          unused_idxts_() {}
+          unused_idxts_(),
+          wire_format_(wire_format) {}
 
     void PassChunkToSubscriber(const std::string& chunk) {
+      if (wire_format_ != ReplicationWireFormat::JSONLines) {
+        PassBatchedChunkToSubscriber(chunk);
+        return;
+      }
+
       const size_t chunk_size = chunk.size();
       size_t begin_pos = 0u;
 
@@ -172,9 +188,132 @@ class SubscribableRemoteStream final {
     uint64_t next_expected_index_;
     std::chrono::microseconds from_us_;
     const idxts_t unused_idxts_;
+    const ReplicationWireFormat wire_format_;
     std::string carried_over_data_;
 
    private:
+    // The frames of the batched wire format are not aligned with the chunks: a frame may span several chunks,
+    // and a chunk may contain several frames. The incomplete frame is carried over to the next chunk.
+    void PassBatchedChunkToSubscriber(const std::string& chunk) {
+      carried_over_data_ += chunk;
+      size_t offset = 0u;
+      while (carried_over_data_.length() - offset >= sizeof(ReplicationBatchHeader)) {
+        ReplicationBatchHeader header;
+        std::memcpy(&header, carried_over_data_.data() + offset, sizeof(header));
+        const size_t frame_size = sizeof(header) + static_cast<size_t>(header.payload_size);
+        if (carried_over_data_.length() - offset < frame_size) {
+          break;
+        }
+        const auto payload = std::string_view(carried_over_data_).substr(offset + sizeof(header), header.payload_size);
+        PassBatchToSubscriber(header, payload);
+        offset += frame_size;
+      }
+      carried_over_data_.erase(0u, offset);
+    }
+
+    void PassBatchToSubscriber(const ReplicationBatchHeader& header, std::string_view payload) {
+      std::vector<std::string_view> records;
+      records.reserve(header.entries);
+      size_t pos = 0u;
+      for (uint32_t i = 0u; i < header.entries; ++i) {
+        uint32_t length;
+        if (payload.length() - pos < sizeof(length)) {
+          CURRENT_THROW(RemoteStreamMalformedChunkException());
+        }
+        std::memcpy(&length, payload.data() + pos, sizeof(length));
+        pos += sizeof(length);
+        if (payload.length() - pos < length) {
+          CURRENT_THROW(RemoteStreamMalformedChunkException());
+        }
+        records.push_back(payload.substr(pos, length));
+        pos += length;
+      }
+      if (pos != payload.length()) {
+        CURRENT_THROW(RemoteStreamMalformedChunkException());
+      }
+
+      if (!records.empty()) {
+        if (wire_format_ == ReplicationWireFormat::BinaryBatches) {
+          PassBinaryRecordsToSubscriber(records);
+        } else {
+          PassRawLogLinesToSubscriber(records);
+        }
+      }
+
+      if (header.head_us) {
+        const auto head = std::chrono::microseconds(header.head_us);
+        if (subscriber_(head) == ss::EntryResponse::Done) {
+          CURRENT_THROW(StreamTerminatedBySubscriber());
+        }
+        from_us_ = head + std::chrono::microseconds(1);
+      }
+    }
+
+    // In `RM::Checked` mode each line is parsed and validated, in `RM::Unchecked` mode the whole batch is passed on.
+    void PassRawLogLinesToSubscriber(const std::vector<std::string_view>& records) {
+      if constexpr (RM == ReplicationMode::Checked) {
+        for (const auto record : records) {
+          PassEntryToSubscriber(std::string(record));
+        }
+      } else {
+        std::vector<std::string> raw_log_lines(records.begin(), records.end());
+        PassRawLogLinesBatchToSubscriber(std::move(raw_log_lines));
+      }
+    }
+
+    // In `RM::Unchecked` mode the binary entries are passed on as the batch of raw log lines too.
+    void PassBinaryRecordsToSubscriber(const std::vector<std::string_view>& records) {
+      std::vector<std::string> raw_log_lines;
+      for (const auto record : records) {
+        ReplicationBinaryRecordPrefix prefix;
+        if (record.length() < sizeof(prefix)) {
+          CURRENT_THROW(RemoteStreamMalformedChunkException());
+        }
+        std::memcpy(&prefix, record.data(), sizeof(prefix));
+        const idxts_t idxts(prefix.index, std::chrono::microseconds(prefix.us));
+        if (from_us_.count() > 0 && idxts.us < from_us_) {
+          CURRENT_THROW(RemoteStreamMalformedChunkException());
+        }
+        TYPE_SUBSCRIBED_TO entry;
+        try {
+          current::serialization::binary::ParseBinary(record.substr(sizeof(prefix)), entry);
+        } catch (const current::serialization::binary::BinaryLoadFromStreamException&) {
+          CURRENT_THROW(RemoteStreamMalformedChunkException());
+        }
+        if constexpr (RM == ReplicationMode::Checked) {
+          if (idxts.index != next_expected_index_) {
+            CURRENT_THROW(RemoteStreamMalformedChunkException());
+          }
+          if (subscriber_(std::move(entry), idxts, unused_idxts_) == ss::EntryResponse::Done) {
+            CURRENT_THROW(StreamTerminatedBySubscriber());
+          }
+          ++next_expected_index_;
+          from_us_ = std::chrono::microseconds(0);
+        } else {
+          raw_log_lines.push_back(JSON(idxts) + '\t' + JSON(entry));
+        }
+      }
+      if constexpr (RM == ReplicationMode::Unchecked) {
+        PassRawLogLinesBatchToSubscriber(std::move(raw_log_lines));
+      }
+    }
+
+    void PassRawLogLinesBatchToSubscriber(std::vector<std::string>&& raw_log_lines) {
+      const size_t count = raw_log_lines.size();
+      try {
+        if (subscriber_(std::move(raw_log_lines), next_expected_index_, unused_idxts_) == ss::EntryResponse::Done) {
+          CURRENT_THROW(StreamTerminatedBySubscriber());
+        }
+      } catch (const StreamBatchPartiallyPublishedException& e) {
+        // Resubscribe right past the entries which did make it, not from the beginning of the batch.
+        next_expected_index_ += e.published;
+        from_us_ = std::chrono::microseconds(0);
+        throw;
+      }
+      next_expected_index_ += count;
+      from_us_ = std::chrono::microseconds(0);
+    }
+
     template <ReplicationMode MODE = RM>
     std::enable_if_t<MODE == ReplicationMode::Checked> PassEntryToSubscriber(const std::string& raw_log_line) {
       const auto split = current::strings::Split(raw_log_line, '\t');
@@ -247,8 +386,10 @@ class SubscribableRemoteStream final {
                            uint64_t start_idx,
                            std::chrono::microseconds from_us,
                            SubscriptionMode subscription_mode,
-                           std::function<void()> done_callback)
-        : base_subscriber_t(remote_stream, subscriber, start_idx, from_us, [this]() { TerminateSubscription(); }),
+                           std::function<void()> done_callback,
+                           ReplicationWireFormat wire_format)
+        : base_subscriber_t(
+              remote_stream, subscriber, start_idx, from_us, [this]() { TerminateSubscription(); }, wire_format),
           valid_(false),
           done_callback_(done_callback),
           subscription_mode_(subscription_mode),
@@ -297,7 +438,8 @@ class SubscribableRemoteStream final {
         try {
           bare_stream.CheckSchema();
           HTTP(ChunkedGET(
-              bare_stream.GetURLToSubscribe(this->next_expected_index_, this->from_us_, subscription_mode_),
+              bare_stream.GetURLToSubscribe(
+                  this->next_expected_index_, this->from_us_, subscription_mode_, this->wire_format_),
               [this](const std::string& header, const std::string& value) { OnHeader(header, value); },
               [this](const std::string& chunk_body) { OnChunk(chunk_body); },
               []() {}));
@@ -308,7 +450,10 @@ class SubscribableRemoteStream final {
             fprintf(
                 stderr,
                 "Received three malformed chunks in a row from \"%s\"\n",
-                bare_stream.GetURLToSubscribe(this->next_expected_index_, this->from_us_, subscription_mode_).c_str());
+                bare_stream
+                    .GetURLToSubscribe(
+                        this->next_expected_index_, this->from_us_, subscription_mode_, this->wire_format_)
+                    .c_str());
           }
         } catch (current::Exception&) {
         }
@@ -375,9 +520,15 @@ class SubscribableRemoteStream final {
                               uint64_t start_idx,
                               std::chrono::microseconds from_us,
                               SubscriptionMode subscription_mode,
-                              std::function<void()> done_callback)
-        : base_t(std::move(std::make_unique<subscriber_thread_t>(
-              std::move(remote_stream), subscriber, start_idx, from_us, subscription_mode, done_callback))) {}
+                              std::function<void()> done_callback,
+                              ReplicationWireFormat wire_format)
+        : base_t(std::move(std::make_unique<subscriber_thread_t>(std::move(remote_stream),
+                                                                 subscriber,
+                                                                 start_idx,
+                                                                 from_us,
+                                                                 subscription_mode,
+                                                                 done_callback,
+                                                                 wire_format))) {}
   };
   template <typename F>
   using RemoteSubscriberScope = RemoteSubscriberScopeImpl<F, entry_t, ReplicationMode::Checked>;
@@ -402,9 +553,11 @@ class SubscribableRemoteStream final {
                                      uint64_t start_idx = 0u,
                                      std::chrono::microseconds from_us = std::chrono::microseconds(0),
                                      SubscriptionMode subscription_mode = SubscriptionMode::Unchecked,
-                                     std::function<void()> done_callback = nullptr) const {
+                                     std::function<void()> done_callback = nullptr,
+                                     ReplicationWireFormat wire_format = ReplicationWireFormat::JSONLines) const {
     static_assert(current::ss::IsStreamSubscriber<F, entry_t>::value, "");
-    return RemoteSubscriberScope<F>(stream_, subscriber, start_idx, from_us, subscription_mode, done_callback);
+    return RemoteSubscriberScope<F>(
+        stream_, subscriber, start_idx, from_us, subscription_mode, done_callback, wire_format);
   }
 
   template <typename F, ReplicationMode RM>
@@ -425,9 +578,12 @@ class SubscribableRemoteStream final {
                                                        uint64_t start_idx = 0u,
                                                        std::chrono::microseconds from_us = std::chrono::microseconds(0),
                                                        SubscriptionMode subscription_mode = SubscriptionMode::Unchecked,
-                                                       std::function<void()> done_callback = nullptr) const {
+                                                       std::function<void()> done_callback = nullptr,
+                                                       ReplicationWireFormat wire_format =
+                                                           ReplicationWireFormat::JSONLines) const {
     static_assert(current::ss::IsStreamSubscriber<F, entry_t>::value, "");
-    return RemoteSubscriberScopeUnchecked<F>(stream_, subscriber, start_idx, from_us, subscription_mode, done_callback);
+    return RemoteSubscriberScopeUnchecked<F>(
+        stream_, subscriber, start_idx, from_us, subscription_mode, done_callback, wire_format);
   }
 
   uint64_t GetNumberOfEntries() const {
@@ -477,6 +633,12 @@ struct StreamReplicatorImpl {
     return EntryResponse::More;
   }
 
+  // The batches of the batched replication wire format are appended to the persister in bulk.
+  EntryResponse operator()(std::vector<std::string>&& raw_log_lines, uint64_t, idxts_t) {
+    Value(publisher_)->PublishUnsafeBatch(raw_log_lines);
+    return EntryResponse::More;
+  }
+
   EntryResponse operator()(std::chrono::microseconds ts) {
     Value(publisher_)->UpdateHead(ts);
     return EntryResponse::More;
@@ -574,7 +736,9 @@ class MasterFlipController final {
   }
 
   // Makes the local, owned, ex-master stream follow the remote now-master one.
-  void FollowRemoteStream(const std::string& url, SubscriptionMode subscription_mode = SubscriptionMode::Unchecked) {
+  void FollowRemoteStream(const std::string& url,
+                          SubscriptionMode subscription_mode = SubscriptionMode::Unchecked,
+                          ReplicationWireFormat wire_format = ReplicationWireFormat::JSONLines) {
     if (remote_follower_) {
       CURRENT_THROW(StreamIsAlreadyFollowingException());
     }
@@ -587,7 +751,8 @@ class MasterFlipController final {
           url,
           stream_->Data()->Size(),
           stream_->Data()->CurrentHead() + std::chrono::microseconds(1),
-          subscription_mode);
+          subscription_mode,
+          wire_format);
       borrowed_publisher_ = nullptr;
     } catch (const current::Exception&) {
       // Can't follow the remote stream for some reason,
@@ -800,6 +965,7 @@ class MasterFlipController final {
   struct RemoteStreamFollower {
     using remote_stream_t = SubscribableRemoteStream<entry_t>;
     SubscriptionMode subscription_mode_;
+    ReplicationWireFormat wire_format_;
     remote_stream_t remote_stream_;
     replicator_t replicator_;
     std::unique_ptr<SubscriberScope> subscriber_scope_;
@@ -808,8 +974,10 @@ class MasterFlipController final {
                          const std::string& url,
                          uint64_t start_idx,
                          std::chrono::microseconds from_us,
-                         SubscriptionMode subscription_mode)
+                         SubscriptionMode subscription_mode,
+                         ReplicationWireFormat wire_format)
         : subscription_mode_(subscription_mode),
+          wire_format_(wire_format),
           remote_stream_(url),
           replicator_(std::move(publisher)),
           subscriber_scope_(Subscribe(start_idx, from_us)) {}
@@ -847,14 +1015,16 @@ class MasterFlipController final {
     std::enable_if_t<MODE == ReplicationMode::Checked, std::unique_ptr<SubscriberScope>> Subscribe(
         uint64_t start_idx, std::chrono::microseconds from_us) {
       using scope_t = typename remote_stream_t::template RemoteSubscriberScope<replicator_t>;
-      return std::make_unique<scope_t>(remote_stream_.Subscribe(replicator_, start_idx, from_us, subscription_mode_));
+      return std::make_unique<scope_t>(
+          remote_stream_.Subscribe(replicator_, start_idx, from_us, subscription_mode_, nullptr, wire_format_));
     }
     template <ReplicationMode MODE = RM>
     std::enable_if_t<MODE == ReplicationMode::Unchecked, std::unique_ptr<SubscriberScope>> Subscribe(
         uint64_t start_idx, std::chrono::microseconds from_us) {
       using scope_t = typename remote_stream_t::template RemoteSubscriberScopeUnchecked<replicator_t>;
       return std::make_unique<scope_t>(
-          remote_stream_.SubscribeUnchecked(replicator_, start_idx, from_us, subscription_mode_));
+          remote_stream_.SubscribeUnchecked(
+              replicator_, start_idx, from_us, subscription_mode_, nullptr, wire_format_));
     }
   };
 
@@ -27,13 +27,16 @@ SOFTWARE.
 
 #include "../port.h"
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "exceptions.h"
 #include "stream_impl.h"
@@ -45,6 +48,7 @@ SOFTWARE.
 #include "../blocks/http/api.h"
 #include "../blocks/persistence/memory.h"
 #include "../blocks/persistence/file.h"
+#include "../blocks/persistence/binary_file.h"
 #include "../blocks/ss/ss.h"
 #include "../blocks/ss/signature.h"
 
@@ -63,6 +67,7 @@ SOFTWARE.
 //
 // To create a persisted one, pass in the type of persister and its construction parameters, such as:
 // `auto my_stream = stream::Stream<ENTRY, current::persistence::File>::CreateStream("data.json");`.
+// Use `current::persistence::BinaryFile` instead of `File` to store the entries as compact binary records.
 //
 // Stream streams can be published into and subscribed to.
 //
@@ -154,6 +159,17 @@ class Stream final {
   // DIMA Optional<BorrowedOfGuaranteedLifetime<publisher_t>> borrowable_publisher_;
   Optional<Borrowed<publisher_t>> borrowable_publisher_;
 
+  // The shared tail for the live HTTP subscribers, see `PubSubHTTPBroadcasterImpl`. Created on first use.
+  struct HTTPBroadcaster final {
+    PubSubHTTPBroadcaster<entry_t> broadcaster;
+    // Declared after `broadcaster`, to stop its thread before the broadcaster is destructed.
+    current::stream::SubscriberScope scope;
+    HTTPBroadcaster(const Stream& stream, uint64_t begin_index)
+        : broadcaster(begin_index), scope(stream.SubscribeUnchecked(broadcaster, begin_index)) {}
+  };
+  mutable std::mutex http_broadcaster_mutex_;
+  mutable std::unique_ptr<HTTPBroadcaster> http_broadcaster_;
+
  public:
   // "Constructors" and the destructor.
   template <typename... ARGS>
@@ -173,6 +189,9 @@ class Stream final {
       it.second.first = nullptr;
     }
     impl_->http_subscriptions.clear();
+    // The connections handed over to the shared tail are closed once all the subscribers are gone.
+    std::lock_guard<std::mutex> lock(http_broadcaster_mutex_);
+    http_broadcaster_ = nullptr;
   }
 
  private:
@@ -275,6 +294,12 @@ class Stream final {
     F& subscriber_;
     const uint64_t begin_idx_;
     const std::chrono::microseconds from_us_;
+    // Whether the subscriber gets the entries in batches, see `ss::IsBatchEntrySubscriber`, and how are they formed.
+    constexpr static bool passes_batches = (SM == SubscriptionMode::Checked)
+                                               ? ss::IsBatchEntrySubscriber<F, TYPE_SUBSCRIBED_TO>::value
+                                               : ss::IsRawLogLinesBatchSubscriber<F, entry_t>::value;
+    const ss::BatchingPolicy batching_policy_;
+    std::vector<ss::IndexedEntry<TYPE_SUBSCRIBED_TO>> batch_;
     std::thread thread_;
 
     SubscriberThreadInstance() = delete;
@@ -302,6 +327,7 @@ class Stream final {
           subscriber_(subscriber),
           begin_idx_(begin_idx),
           from_us_(from_us),
+          batching_policy_(subscriber.GetBatchingPolicy()),
           thread_(&SubscriberThreadInstance::Thread, this) {
       // Must guard against the constructor of `BorrowedWithCallback<impl_t> impl_` throwing.
       // NOTE(dkorolev): This is obsolete now, but keeping the logic for now, to keep it safe. -- D.K.
@@ -340,6 +366,9 @@ class Stream final {
     std::enable_if_t<MODE == SubscriptionMode::Checked, ss::EntryResponse> PassEntriesToSubscriber(const impl_t& impl,
                                                                                                    uint64_t index,
                                                                                                    uint64_t size) {
+      if constexpr (passes_batches) {
+        return PassEntriesToBatchSubscriber(impl, index, size);
+      }
       for (const auto& e : impl.persister.Iterate(index, size)) {
         if (!terminate_sent_ && terminate_signal_) {
           terminate_sent_ = true;
@@ -363,24 +392,126 @@ class Stream final {
     std::enable_if_t<MODE == SubscriptionMode::Unchecked, ss::EntryResponse> PassEntriesToSubscriber(const impl_t& impl,
                                                                                                      uint64_t index,
                                                                                                      uint64_t size) {
-      for (const auto& e : impl.persister.IterateUnsafe(index, size)) {
+      if constexpr (passes_batches) {
+        return PassRawLogLinesToBatchSubscriber(impl, index, size);
+      }
+      // Pass the raw log lines as `std::string_view`-s, to not copy them where the subscriber does not need to.
+      const auto range = impl.persister.IterateUnsafe(index, size);
+      const auto end = range.end();
+      for (auto it = range.begin(); it != end; ++it) {
         if (!terminate_sent_ && terminate_signal_) {
           terminate_sent_ = true;
           if (subscriber_.Terminate() != ss::TerminationResponse::Wait) {
             return ss::EntryResponse::Done;
           }
         }
-        if (subscriber_(e, index++, impl.persister.LastPublishedIndexAndTimestamp()) == ss::EntryResponse::Done) {
+        if (subscriber_(it.RawLogLine(), index++, impl.persister.LastPublishedIndexAndTimestamp()) ==
+            ss::EntryResponse::Done) {
           return ss::EntryResponse::Done;
         }
       }
       return ss::EntryResponse::More;
     }
 
+    // Returns `true` if the subscriber asked to terminate, and `false` if the termination was not requested,
+    // or if the subscriber has chosen to wait.
+    bool TerminateRequested() {
+      if (!terminate_sent_ && terminate_signal_) {
+        terminate_sent_ = true;
+        if (subscriber_.Terminate() != ss::TerminationResponse::Wait) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // For the subscribers accepting `ss::EntriesBatch<TYPE_SUBSCRIBED_TO>`. The termination signal is checked once
+    // per batch, and the entries of the types other than the subscribed to one are skipped.
+    ss::EntryResponse PassEntriesToBatchSubscriber(const impl_t& impl, uint64_t index, uint64_t size) {
+      const size_t max_batch_size = std::max(static_cast<size_t>(1u), batching_policy_.max_batch_size);
+      bool last_entry_passed_type_filter = true;
+      const auto flush = [this, &impl]() -> ss::EntryResponse {
+        if (batch_.empty()) {
+          return ss::EntryResponse::More;
+        }
+        const ss::EntryResponse response =
+            subscriber_(ss::EntriesBatch<TYPE_SUBSCRIBED_TO>(batch_.data(), batch_.size()),
+                        impl.persister.LastPublishedIndexAndTimestamp());
+        batch_.clear();
+        return response;
+      };
+      for (const auto& e : impl.persister.Iterate(index, size)) {
+        if (batch_.empty() && TerminateRequested()) {
+          return ss::EntryResponse::Done;
+        }
+        if constexpr (std::is_same_v<TYPE_SUBSCRIBED_TO, entry_t>) {
+          batch_.push_back({e.idx_ts, e.entry});
+        } else {
+          const entry_t& entry = e.entry;
+          last_entry_passed_type_filter = Exists<TYPE_SUBSCRIBED_TO>(entry);
+          if (last_entry_passed_type_filter) {
+            batch_.push_back({e.idx_ts, Value<TYPE_SUBSCRIBED_TO>(entry)});
+          }
+        }
+        if (batch_.size() >= max_batch_size && flush() == ss::EntryResponse::Done) {
+          return ss::EntryResponse::Done;
+        }
+      }
+      if (flush() == ss::EntryResponse::Done) {
+        return ss::EntryResponse::Done;
+      }
+      if (!last_entry_passed_type_filter && size == impl.persister.LastPublishedIndexAndTimestamp().index + 1u) {
+        return subscriber_.EntryResponseIfNoMorePassTypeFilter();
+      }
+      return ss::EntryResponse::More;
+    }
+
+    // For the unchecked subscribers accepting the raw log lines in batches, as the replicator does.
+    ss::EntryResponse PassRawLogLinesToBatchSubscriber(const impl_t& impl, uint64_t index, uint64_t size) {
+      const size_t max_batch_size = std::max(static_cast<size_t>(1u), batching_policy_.max_batch_size);
+      std::vector<std::string> raw_log_lines;
+      uint64_t first_index = index;
+      const auto range = impl.persister.IterateUnsafe(index, size);
+      const auto end = range.end();
+      for (auto it = range.begin(); it != end; ++it) {
+        if (raw_log_lines.empty() && TerminateRequested()) {
+          return ss::EntryResponse::Done;
+        }
+        raw_log_lines.emplace_back(it.RawLogLine());
+        ++index;
+        if (raw_log_lines.size() >= max_batch_size || index == size) {
+          if (subscriber_(std::move(raw_log_lines), first_index, impl.persister.LastPublishedIndexAndTimestamp()) ==
+              ss::EntryResponse::Done) {
+            return ss::EntryResponse::Done;
+          }
+          raw_log_lines.clear();
+          first_index = index;
+        }
+      }
+      return ss::EntryResponse::More;
+    }
+
+    // Gives the publishers up to the max linger time of the batching policy to fill the batch for the subscriber.
+    // Returns `true` if it did wait, in which case the state of the stream should be re-read.
+    bool LingerForFullBatch(uint64_t index, uint64_t size) {
+      if (!passes_batches || !(batching_policy_.max_linger.count() > 0) ||
+          size - index >= batching_policy_.max_batch_size) {
+        return false;
+      }
+      const uint64_t full_batch_size = index + batching_policy_.max_batch_size;
+      std::unique_lock<std::mutex> lock(impl_->publishing_mutex);
+      current::WaitableTerminateSignalBulkNotifier::Scope scope(impl_->notifier, terminate_signal_);
+      terminate_signal_.WaitUntilOrTimeout(lock, batching_policy_.max_linger, [this, full_batch_size]() {
+        return impl_->persister.template Size<current::locks::MutexLockStatus::AlreadyLocked>() >= full_batch_size;
+      });
+      return true;
+    }
+
     void ThreadImpl(uint64_t begin_idx) {
       auto head = from_us_ - std::chrono::microseconds(1);
       uint64_t index = begin_idx;
       uint64_t size = 0;
+      bool lingered = false;
       while (true) {
         if (!terminate_sent_ && terminate_signal_) {
           terminate_sent_ = true;
@@ -392,6 +523,11 @@ class Stream final {
         size = Exists(head_idx.idxts) ? Value(head_idx.idxts).index + 1 : 0;
         if (head_idx.head > head) {
           if (size > index) {
+            if (!lingered && LingerForFullBatch(index, size)) {
+              lingered = true;
+              continue;
+            }
+            lingered = false;
             if (PassEntriesToSubscriber(*impl_, index, size) == ss::EntryResponse::Done) {
               return;
             }
@@ -489,6 +625,13 @@ class Stream final {
     auto request_params = ParsePubSubHTTPRequest(r);  // Mutable as `tail` may change. -- D.K.
 
     if (request_params.terminate_requested) {
+      {
+        std::lock_guard<std::mutex> lock(http_broadcaster_mutex_);
+        if (http_broadcaster_ && http_broadcaster_->broadcaster.TerminateSubscription(request_params.terminate_id)) {
+          r("", HTTPResponseCode.OK);
+          return;
+        }
+      }
       typename impl_t::http_subscriptions_t::iterator it;
       {
         // NOTE: This is not thread-safe!!!
@@ -577,8 +720,17 @@ class Stream final {
 
       const std::string subscription_id = GenerateRandomHTTPSubscriptionID();
 
+      PubSubHTTPBroadcasterImpl* broadcaster = nullptr;
+      if (IsBroadcastablePubSubHTTPRequest(request_params)) {
+        std::lock_guard<std::mutex> lock(http_broadcaster_mutex_);
+        if (!http_broadcaster_) {
+          http_broadcaster_ = std::make_unique<HTTPBroadcaster>(*this, stream_size);
+        }
+        broadcaster = &http_broadcaster_->broadcaster;
+      }
+
       auto http_chunked_subscriber = std::make_unique<PubSubHTTPEndpoint<entry_t, PERSISTENCE_LAYER, J>>(
-          subscription_id, borrowed_impl, std::move(r), std::move(request_params));
+          subscription_id, borrowed_impl, std::move(r), std::move(request_params), broadcaster);
       const auto done_callback = [borrowed_impl, subscription_id]() {
         // Note: Called from a locked section of `borrowed_impl->http_subscriptions_mutex`.
         borrowed_impl->http_subscriptions[subscription_id].second = nullptr;
@@ -618,6 +770,12 @@ class Stream final {
     }
   }
 
+  // The number of the HTTP subscribers presently served by the shared tail of this stream.
+  size_t HTTPSharedTailConnectionsCount() const {
+    std::lock_guard<std::mutex> lock(http_broadcaster_mutex_);
+    return http_broadcaster_ ? http_broadcaster_->broadcaster.ConnectionsCount() : 0u;
+  }
+
   Borrowed<impl_t> BorrowImpl() const { return impl_; }
   const WeakBorrowed<impl_t>& Impl() const { return impl_; }
   WeakBorrowed<impl_t>& Impl() { return impl_; }
@@ -31,11 +31,14 @@ SOFTWARE.
 #include <thread>
 #include <type_traits>
 
+#include "exceptions.h"
+
 #include "../bricks/util/random.h"
 #include "../bricks/util/waitable_terminate_signal.h"
 
 #include "../blocks/persistence/memory.h"
 #include "../blocks/persistence/file.h"
+#include "../blocks/persistence/binary_file.h"
 #include "../blocks/ss/pubsub.h"
 
 namespace current {
@@ -149,6 +152,26 @@ class StreamPublisherImpl {
     return result;
   }
 
+  // The subscribers are notified once per batch, not once per line.
+  // If a line of the batch fails to be published, the subscribers are notified of the lines before it,
+  // and the caller learns how many of them there are from `StreamBatchPartiallyPublishedException`.
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PublisherPublishUnsafeBatchImpl(const std::vector<std::string>& raw_log_lines) {
+    const uint64_t size_before = data_->persister.template PersisterSizeImpl<MLS>();
+    try {
+      const auto result = data_->persister.template PersisterPublishUnsafeBatchImpl<MLS>(raw_log_lines);
+      data_->notifier.NotifyAllOfExternalWaitableEvent();
+      return result;
+    } catch (const current::Exception& e) {
+      const uint64_t published = data_->persister.template PersisterSizeImpl<MLS>() - size_before;
+      if (!published) {
+        throw;
+      }
+      data_->notifier.NotifyAllOfExternalWaitableEvent();
+      CURRENT_THROW(StreamBatchPartiallyPublishedException(published, e.what()));
+    }
+  }
+
   template <current::locks::MutexLockStatus MLS, typename TIMESTAMP>
   void PublisherUpdateHeadImpl(TIMESTAMP&& timestamp) {
     data_->persister.template PersisterUpdateHeadImpl<MLS>(std::forward<TIMESTAMP>(timestamp));
@@ -29,6 +29,8 @@ SOFTWARE.
 #include "stream.h"
 #include "replicator.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <atomic>
 #include <thread>
@@ -39,6 +41,7 @@ SOFTWARE.
 #include "../blocks/http/api.h"
 #include "../blocks/persistence/memory.h"
 #include "../blocks/persistence/file.h"
+#include "../blocks/persistence/binary_file.h"
 
 #include "../bricks/strings/strings.h"
 
@@ -963,6 +966,150 @@ TEST(Stream, HTTPSubscriptionCanBeTerminated) {
   slow_subscriber.join();
 }
 
+TEST(Stream, SharedTailForLiveHTTPSubscribers) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port));
+  static_cast<void>(http_server);
+
+  auto exposed_stream = current::stream::Stream<Record>::CreateStream();
+  const std::string base_url = Printf("http://localhost:%d/exposed", port);
+
+  const auto scope = HTTP(port).Register("/exposed", *exposed_stream);
+
+  for (int i = 1; i <= 3; ++i) {
+    exposed_stream->Publisher()->Publish(Record(i * 10), std::chrono::microseconds(i));
+  }
+
+  // Three subscribers of the full lines, two of the entries only, and one which can't be served by the shared tail.
+  const std::vector<std::string> queries = {"", "", "?i=1", "?entries_only", "?entries_only", "?checked"};
+  std::vector<std::string> bodies(queries.size());
+  std::vector<std::string> subscription_ids(queries.size());
+  std::vector<std::thread> subscribers;
+  std::atomic_size_t subscribers_started(0u);
+  std::atomic_size_t malformed_chunks(0u);
+  for (size_t s = 0u; s < queries.size(); ++s) {
+    subscribers.emplace_back([&, s]() {
+      const auto result = HTTP(ChunkedGET(
+          base_url + queries[s],
+          [&](const std::string& header, const std::string& value) {
+            if (header == "X-Current-Stream-Subscription-Id") {
+              subscription_ids[s] = value;
+              ++subscribers_started;
+            }
+          },
+          [&](const std::string& chunk_body) {
+            // One entry per chunk, as the clients which split the stream by the chunks expect.
+            if (std::count(chunk_body.begin(), chunk_body.end(), '\n') != 1 || chunk_body.back() != '\n') {
+              ++malformed_chunks;
+            }
+            bodies[s] += chunk_body;
+          }));
+      EXPECT_EQ(200, static_cast<int>(result));
+    });
+  }
+
+  while (exposed_stream->HTTPSharedTailConnectionsCount() < 5u || subscribers_started < queries.size()) {
+    std::this_thread::yield();
+  }
+
+  for (int i = 4; i <= 6; ++i) {
+    exposed_stream->Publisher()->Publish(Record(i * 10), std::chrono::microseconds(i));
+  }
+
+  const auto AllSubscribersHaveTheLastEntry = [&]() {
+    for (const std::string& body : bodies) {
+      if (body.find("{\"x\":60}") == std::string::npos) {
+        return false;
+      }
+    }
+    return true;
+  };
+  while (!AllSubscribersHaveTheLastEntry()) {
+    std::this_thread::yield();
+  }
+
+  for (const std::string& id : subscription_ids) {
+    EXPECT_EQ(200, static_cast<int>(HTTP(GET(base_url + "?terminate=" + id)).code));
+  }
+  for (auto& subscriber : subscribers) {
+    subscriber.join();
+  }
+  EXPECT_EQ(0u, exposed_stream->HTTPSharedTailConnectionsCount());
+  EXPECT_EQ(0u, malformed_chunks);
+
+  std::string lines;
+  std::string entries;
+  for (int i = 1; i <= 6; ++i) {
+    lines += Printf("{\"index\":%d,\"us\":%d}\t{\"x\":%d}\n", i - 1, i, i * 10);
+    entries += Printf("{\"x\":%d}\n", i * 10);
+  }
+  const std::string terminated = "{\"error\":\"The subscriber has terminated.\"}\n";
+  EXPECT_EQ(lines + terminated, bodies[0]);
+  EXPECT_EQ(lines + terminated, bodies[1]);
+  EXPECT_EQ(lines.substr(lines.find('\n') + 1u) + terminated, bodies[2]);
+  EXPECT_EQ(entries + terminated, bodies[3]);
+  EXPECT_EQ(entries + terminated, bodies[4]);
+  EXPECT_EQ(lines + terminated, bodies[5]);
+}
+
+TEST(Stream, SharedTailSendsTheHeadPublishedBeforeTheTakeover) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port));
+  static_cast<void>(http_server);
+
+  auto exposed_stream = current::stream::Stream<Record>::CreateStream();
+  const std::string base_url = Printf("http://localhost:%d/exposed", port);
+
+  const auto scope = HTTP(port).Register("/exposed", *exposed_stream);
+
+  exposed_stream->Publisher()->Publish(Record(10), std::chrono::microseconds(1));
+  exposed_stream->Publisher()->Publish(Record(20), std::chrono::microseconds(2));
+  exposed_stream->Publisher()->UpdateHead(std::chrono::microseconds(300));
+
+  // The shared tail is created by this very subscriber, and has the head published before the takeover completes.
+  std::string body;
+  std::string subscription_id;
+  std::atomic_bool started(false);
+  std::thread subscriber([&]() {
+    const auto result = HTTP(ChunkedGET(base_url,
+                                        [&](const std::string& header, const std::string& value) {
+                                          if (header == "X-Current-Stream-Subscription-Id") {
+                                            subscription_id = value;
+                                            started = true;
+                                          }
+                                        },
+                                        [&](const std::string& chunk_body) { body += chunk_body; }));
+    EXPECT_EQ(200, static_cast<int>(result));
+  });
+
+  while (!started || exposed_stream->HTTPSharedTailConnectionsCount() < 1u) {
+    std::this_thread::yield();
+  }
+  while (body.find("{\"us\":300}") == std::string::npos) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(200, static_cast<int>(HTTP(GET(base_url + "?terminate=" + subscription_id)).code));
+  subscriber.join();
+
+  EXPECT_EQ(
+      "{\"index\":0,\"us\":1}\t{\"x\":10}\n"
+      "{\"index\":1,\"us\":2}\t{\"x\":20}\n"
+      "{\"us\":300}\n"
+      "{\"error\":\"The subscriber has terminated.\"}\n",
+      body);
+}
+
 const std::string golden_signature() {
   current::reflection::StructSchema struct_schema;
   struct_schema.AddType<stream_unittest::Record>();
@@ -1104,6 +1251,56 @@ TEST(Stream, ParsesFromFile) {
       << joined_expected_values << " != " << d_unchecked.results_;
 }
 
+TEST(Stream, PersistsToBinaryFile) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "data.bin");
+  const auto persistence_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  using stream_t = current::stream::Stream<Record, current::persistence::BinaryFile>;
+
+  {
+    auto persisted = stream_t::CreateStream(persistence_file_name);
+    current::time::SetNow(std::chrono::microseconds(100));
+    persisted->Publisher()->Publish(Record(1));
+    current::time::SetNow(std::chrono::microseconds(200));
+    persisted->Publisher()->Publish(Record(2));
+    current::time::SetNow(std::chrono::microseconds(300));
+    persisted->Publisher()->UpdateHead();
+    current::time::SetNow(std::chrono::microseconds(400));
+    persisted->Publisher()->Publish(Record(3));
+    current::time::SetNow(std::chrono::microseconds(500));
+    persisted->Publisher()->UpdateHead();
+  }
+
+  auto parsed = stream_t::CreateStream(persistence_file_name);
+
+  Data d;
+  Data d_unchecked;
+  {
+    StreamTestProcessor p(d, false, true);
+    StreamTestProcessor p_unchecked(d_unchecked, false, true);
+    p.SetMax(4u);
+    p_unchecked.SetMax(4u);
+    parsed->Subscribe(p);  // A blocking call until the subscriber processes three entries and one head update.
+    parsed->SubscribeUnchecked(p_unchecked);
+    EXPECT_EQ(4u, d.seen_);
+    EXPECT_EQ(500, d.head_.count());
+    EXPECT_EQ(4u, d_unchecked.seen_);
+    EXPECT_EQ(500, d_unchecked.head_.count());
+  }
+
+  const std::vector<std::string> expected_values{"[0:100,2:400] 1", "[1:200,2:400] 2", "[2:400,2:400] 3"};
+  const auto joined_expected_values = Join(expected_values, ',');
+  EXPECT_TRUE(CompareValuesMixedWithTerminate(d.results_, expected_values, StreamTestProcessor::kTerminateStr))
+      << joined_expected_values << " != " << d.results_;
+  EXPECT_TRUE(
+      CompareValuesMixedWithTerminate(d_unchecked.results_, expected_values, StreamTestProcessor::kTerminateStr))
+      << joined_expected_values << " != " << d_unchecked.results_;
+}
+
 TEST(Stream, UncheckedVsCheckedSubscription) {
   using namespace stream_unittest;
 
@@ -1367,6 +1564,187 @@ TEST(Stream, ParseArbitrarilySplitChunks) {
   EXPECT_EQ(stream_golden_data, current::FileSystem::ReadFileAsString(persistence_file_name));
 }
 
+TEST(Stream, BatchedReplication) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+  using stream_t = current::stream::Stream<Record, current::persistence::File>;
+  using current::stream::ReplicationWireFormat;
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port));
+  static_cast<void>(http_server);
+
+  const std::string master_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "master");
+  const std::string follower_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "follower");
+  const auto master_file_remover = current::FileSystem::ScopedRmFile(master_file_name);
+  current::FileSystem::WriteStringToFile(stream_golden_data, master_file_name.c_str());
+
+  auto master_stream = stream_t::CreateStream(master_file_name);
+  const std::string base_url = Printf("http://localhost:%d/exposed", port);
+  const auto scope =
+      HTTP(port).Register("/exposed", URLPathArgs::CountMask::None | URLPathArgs::CountMask::One, *master_stream);
+
+  {
+    // A single frame of three raw log lines, each prefixed by its length.
+    const std::string body = HTTP(GET(base_url + "?batched&nowait")).body;
+    current::stream::ReplicationBatchHeader header;
+    ASSERT_LE(sizeof(header), body.length());
+    std::memcpy(&header, body.data(), sizeof(header));
+    EXPECT_EQ(3u, header.entries);
+    EXPECT_EQ(body.length() - sizeof(header), header.payload_size);
+    EXPECT_EQ(0, header.head_us);
+    std::vector<std::string> records;
+    size_t offset = sizeof(header);
+    while (offset + sizeof(uint32_t) <= body.length()) {
+      uint32_t length;
+      std::memcpy(&length, body.data() + offset, sizeof(length));
+      records.push_back(body.substr(offset + sizeof(length), length));
+      offset += sizeof(length) + length;
+    }
+    EXPECT_EQ(body.length(), offset);
+    EXPECT_EQ(
+        "{\"index\":0,\"us\":100}\t{\"x\":1}\n"
+        "{\"index\":1,\"us\":200}\t{\"x\":2}\n"
+        "{\"index\":2,\"us\":400}\t{\"x\":3}",
+        Join(records, '\n'));
+  }
+
+  const auto Replicate = [&](ReplicationWireFormat wire_format, bool checked) {
+    const auto follower_file_remover = current::FileSystem::ScopedRmFile(follower_file_name);
+    auto follower_stream = stream_t::CreateStream(follower_file_name);
+    current::stream::SubscribableRemoteStream<Record> remote_stream(base_url);
+    current::stream::StreamReplicator<stream_t> replicator(follower_stream);
+    const auto mode = current::stream::SubscriptionMode::Unchecked;
+    {
+      const auto subscriber_scope =
+          checked ? static_cast<current::stream::SubscriberScope>(remote_stream.Subscribe(
+                        replicator, 0u, std::chrono::microseconds(0), mode, nullptr, wire_format))
+                  : static_cast<current::stream::SubscriberScope>(remote_stream.SubscribeUnchecked(
+                        replicator, 0u, std::chrono::microseconds(0), mode, nullptr, wire_format));
+      while (follower_stream->Data()->CurrentHead() != std::chrono::microseconds(500)) {
+        std::this_thread::yield();
+      }
+    }
+    EXPECT_EQ(3u, follower_stream->Data()->Size());
+    return current::FileSystem::ReadFileAsString(follower_file_name);
+  };
+
+  EXPECT_EQ(stream_golden_data_single_head, Replicate(ReplicationWireFormat::Batches, true));
+  EXPECT_EQ(stream_golden_data_single_head, Replicate(ReplicationWireFormat::Batches, false));
+  EXPECT_EQ(stream_golden_data_single_head, Replicate(ReplicationWireFormat::BinaryBatches, true));
+  EXPECT_EQ(stream_golden_data_single_head, Replicate(ReplicationWireFormat::BinaryBatches, false));
+}
+
+namespace stream_unittest {
+
+// Accepts the first line of the first batch only, as a follower whose persister fails on its second line would.
+struct PartiallyPublishingReplicatorImpl {
+  using EntryResponse = current::ss::EntryResponse;
+  using TerminationResponse = current::ss::TerminationResponse;
+
+  std::vector<std::string> lines_;
+  std::atomic_size_t count_;
+  bool failed_once_ = false;
+
+  PartiallyPublishingReplicatorImpl() : count_(0u) {}
+  virtual ~PartiallyPublishingReplicatorImpl() {}
+
+  EntryResponse operator()(std::vector<std::string>&& raw_log_lines, uint64_t, idxts_t) {
+    if (!failed_once_ && raw_log_lines.size() > 1u) {
+      failed_once_ = true;
+      lines_.push_back(raw_log_lines.front());
+      ++count_;
+      CURRENT_THROW(current::stream::StreamBatchPartiallyPublishedException(1u, "Test."));
+    }
+    for (auto& line : raw_log_lines) {
+      lines_.push_back(std::move(line));
+      ++count_;
+    }
+    return EntryResponse::More;
+  }
+  EntryResponse operator()(Record&&, idxts_t, idxts_t) { return EntryResponse::More; }
+  EntryResponse operator()(const Record&, idxts_t, idxts_t) { return EntryResponse::More; }
+  EntryResponse operator()(std::string&&, uint64_t, idxts_t) { return EntryResponse::More; }
+  EntryResponse operator()(const std::string&, uint64_t, idxts_t) { return EntryResponse::More; }
+  EntryResponse operator()(std::chrono::microseconds) { return EntryResponse::More; }
+  EntryResponse EntryResponseIfNoMorePassTypeFilter() const { return EntryResponse::More; }
+  TerminationResponse Terminate() const { return TerminationResponse::Terminate; }
+};
+
+using PartiallyPublishingReplicator = current::ss::StreamSubscriber<PartiallyPublishingReplicatorImpl, Record>;
+
+}  // namespace stream_unittest
+
+TEST(Stream, PartiallyPublishedBatch) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+
+  {
+    // The lines before the one that fails to be published make it into the stream, and reach its subscribers.
+    auto stream = current::stream::Stream<Record>::CreateStream();
+    std::vector<std::string> rows;
+    std::vector<std::string> entries;
+    RecordsCollector collector(rows, entries);
+    const auto scope = stream->Subscribe(collector);
+    const std::vector<std::string> batch{"{\"index\":0,\"us\":100}\t{\"x\":1}",
+                                         "{\"index\":1,\"us\":200}\t{\"x\":2}",
+                                         "{\"index\":5,\"us\":300}\t{\"x\":3}"};
+    try {
+      stream->Publisher()->PublishUnsafeBatch(batch);
+      ASSERT_TRUE(false);
+    } catch (const current::stream::StreamBatchPartiallyPublishedException& e) {
+      EXPECT_EQ(2u, e.published);
+    }
+    EXPECT_EQ(2u, stream->Data()->Size());
+    while (collector.count_ < 2u) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ("{\"x\":1}\n{\"x\":2}\n", Join(entries, ""));
+    // If not a single line makes it, the original exception is thrown.
+    EXPECT_THROW(stream->Publisher()->PublishUnsafeBatch({batch.back()}),
+                 current::persistence::UnsafePublishBadIndexTimestampException);
+  }
+
+  {
+    // The replication resumes right past the lines which did make it, with none of them replicated twice.
+    using stream_t = current::stream::Stream<Record, current::persistence::File>;
+    auto reserved_port = current::net::ReserveLocalPort();
+    const int port = reserved_port;
+    auto& http_server = HTTP(std::move(reserved_port));
+    static_cast<void>(http_server);
+
+    const std::string master_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "master");
+    const auto master_file_remover = current::FileSystem::ScopedRmFile(master_file_name);
+    current::FileSystem::WriteStringToFile(stream_golden_data, master_file_name.c_str());
+    auto master_stream = stream_t::CreateStream(master_file_name);
+    const auto scope =
+        HTTP(port).Register("/exposed", URLPathArgs::CountMask::None | URLPathArgs::CountMask::One, *master_stream);
+
+    current::stream::SubscribableRemoteStream<Record> remote_stream(Printf("http://localhost:%d/exposed", port));
+    PartiallyPublishingReplicator replicator;
+    {
+      const auto subscriber_scope = remote_stream.SubscribeUnchecked(replicator,
+                                                                     0u,
+                                                                     std::chrono::microseconds(0),
+                                                                     current::stream::SubscriptionMode::Unchecked,
+                                                                     nullptr,
+                                                                     current::stream::ReplicationWireFormat::Batches);
+      while (replicator.count_ < 3u) {
+        std::this_thread::yield();
+      }
+    }
+    EXPECT_TRUE(replicator.failed_once_);
+    EXPECT_EQ(
+        "{\"index\":0,\"us\":100}\t{\"x\":1}\n"
+        "{\"index\":1,\"us\":200}\t{\"x\":2}\n"
+        "{\"index\":2,\"us\":400}\t{\"x\":3}",
+        Join(replicator.lines_, '\n'));
+  }
+}
+
 TEST(Stream, MasterFollowerFlip) {
   current::time::ResetToZero();
 
@@ -1928,6 +2306,124 @@ TEST(Stream, SubscribeWithFilterByType) {
   }
 }
 
+namespace stream_unittest {
+
+template <typename ENTRY>
+struct BatchCollectorImpl {
+  explicit BatchCollectorImpl(size_t expected_count,
+                              size_t max_batch_size,
+                              std::chrono::microseconds max_linger = std::chrono::microseconds(0))
+      : expected_count_(expected_count), max_batch_size_(max_batch_size), max_linger_(max_linger) {}
+
+  EntryResponse operator()(const ENTRY&, idxts_t, idxts_t) {
+    ADD_FAILURE() << "Should not be called for the subscriber that accepts batches.";
+    return EntryResponse::Done;
+  }
+
+  EntryResponse operator()(current::ss::EntriesBatch<ENTRY> batch, idxts_t last) {
+    std::vector<std::string> entries;
+    for (const auto& e : batch) {
+      entries.push_back(current::ToString(e.idx_ts.index) + ':' + JSON<JSONFormat::Minimalistic>(e.entry));
+      EXPECT_LE(e.idx_ts.index, last.index);
+    }
+    count_ += batch.size();
+    results_.push_back('[' + Join(entries, ',') + ']');
+    return count_ == expected_count_ ? EntryResponse::Done : EntryResponse::More;
+  }
+
+  EntryResponse operator()(std::vector<std::string>&& raw_log_lines, uint64_t first_index, idxts_t) {
+    count_ += raw_log_lines.size();
+    results_.push_back(current::ToString(first_index) + "+" + current::ToString(raw_log_lines.size()));
+    return count_ == expected_count_ ? EntryResponse::Done : EntryResponse::More;
+  }
+
+  EntryResponse operator()(const std::string&, uint64_t, idxts_t) {
+    ADD_FAILURE() << "Should not be called for the subscriber that accepts batches.";
+    return EntryResponse::Done;
+  }
+
+  EntryResponse operator()(std::chrono::microseconds) const { return EntryResponse::More; }
+
+  TerminationResponse Terminate() const { return TerminationResponse::Wait; }
+
+  static EntryResponse EntryResponseIfNoMorePassTypeFilter() { return EntryResponse::More; }
+
+  current::ss::BatchingPolicy GetBatchingPolicy() const {
+    return current::ss::BatchingPolicy(max_batch_size_, max_linger_);
+  }
+
+  std::vector<std::string> results_;
+  std::atomic_size_t count_{0u};
+  const size_t expected_count_;
+  const size_t max_batch_size_;
+  const std::chrono::microseconds max_linger_;
+};
+
+}  // namespace stream_unittest
+
+TEST(Stream, SubscribeWithBatches) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+
+  using record_variant_t = Variant<Record, AnotherRecord>;
+  auto stream = current::stream::Stream<record_variant_t>::CreateStream();
+  for (int i = 1; i <= 5; ++i) {
+    current::time::SetNow(std::chrono::microseconds(i));
+    if (i & 1) {
+      stream->Publisher()->Publish(Record(i));
+    } else {
+      stream->Publisher()->Publish(AnotherRecord(i));
+    }
+  }
+
+  {
+    using Collector = current::ss::StreamSubscriber<BatchCollectorImpl<record_variant_t>, record_variant_t>;
+    static_assert(current::ss::IsBatchEntrySubscriber<Collector, record_variant_t>::value, "");
+    static_assert(current::ss::IsRawLogLinesBatchSubscriber<Collector, record_variant_t>::value, "");
+
+    Collector c(5, 2);
+    stream->Subscribe(c);
+    EXPECT_EQ(
+        "[0:{\"Record\":{\"x\":1}},1:{\"AnotherRecord\":{\"y\":2}}] "
+        "[2:{\"Record\":{\"x\":3}},3:{\"AnotherRecord\":{\"y\":4}}] "
+        "[4:{\"Record\":{\"x\":5}}]",
+        Join(c.results_, ' '));
+
+    Collector c_unchecked(5, 3);
+    stream->SubscribeUnchecked(c_unchecked);
+    EXPECT_EQ("0+3 3+2", Join(c_unchecked.results_, ' '));
+  }
+
+  {
+    // The entries not passing the type filter are not part of the batches.
+    using Collector = current::ss::StreamSubscriber<BatchCollectorImpl<Record>, Record>;
+    static_assert(current::ss::IsBatchEntrySubscriber<Collector, Record>::value, "");
+
+    Collector c(3, 1000);
+    stream->Subscribe<Record>(c);
+    EXPECT_EQ("[0:{\"x\":1},2:{\"x\":3},4:{\"x\":5}]", Join(c.results_, ' '));
+  }
+
+  {
+    // With the linger time set, the subscriber waits for the batch to fill up.
+    using Collector = current::ss::StreamSubscriber<BatchCollectorImpl<record_variant_t>, record_variant_t>;
+    Collector c(3, 3, std::chrono::microseconds(10 * 1000 * 1000));
+    {
+      const auto scope = stream->Subscribe(c, 5u);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      for (int i = 6; i <= 8; ++i) {
+        current::time::SetNow(std::chrono::microseconds(i));
+        stream->Publisher()->Publish(Record(i));
+      }
+      while (c.count_ != 3u) {
+        std::this_thread::yield();
+      }
+    }
+    EXPECT_EQ("[5:{\"Record\":{\"x\":6}},6:{\"Record\":{\"x\":7}},7:{\"Record\":{\"x\":8}}]", Join(c.results_, ' '));
+  }
+}
+
 TEST(Stream, ReleaseAndAcquirePublisher) {
   current::time::ResetToZero();
 
@@ -0,0 +1,65 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_ARRAY_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_ARRAY_H
+
+#include <array>
+
+#include "vector.h"
+
+namespace current {
+namespace serialization {
+
+// The size of an `std::array<>` is part of its type, so it is not written out.
+template <typename T, size_t N>
+struct SerializeImpl<binary::BinarySerializer, std::array<T, N>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::array<T, N>& value) {
+    if constexpr (binary::IsBulkBinaryType<T>::value) {
+      binary_serializer.WriteBytes(value.data(), N * sizeof(T));
+    } else {
+      for (const auto& element : value) {
+        Serialize(binary_serializer, element);
+      }
+    }
+  }
+};
+
+template <typename T, size_t N>
+struct DeserializeImpl<binary::BinaryDeserializer, std::array<T, N>> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, std::array<T, N>& destination) {
+    if constexpr (binary::IsBulkBinaryType<T>::value) {
+      std::memcpy(destination.data(), binary_deserializer.ReadBytes(N * sizeof(T)), N * sizeof(T));
+    } else {
+      for (auto& element : destination) {
+        Deserialize(binary_deserializer, element);
+      }
+    }
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_ARRAY_H
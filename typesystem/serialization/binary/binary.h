@@ -0,0 +1,243 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
+
+// The binary format is a compact, schema-driven counterpart of `JSON()`: no field names, no type names, no padding.
+// * `bool`, `char`, `int8_t` and `uint8_t` are one raw byte.
+// * Wider unsigned integers are LEB128 varints, wider signed integers and `std::chrono::*` are zigzag varints.
+// * `float` and `double` are their raw bytes; the format assumes a little-endian host, like the rest of Current.
+// * Strings and containers are prefixed by their varint size. Vectors and arrays of arithmetic types are `memcpy`-ed.
+// * `CURRENT_STRUCT`-s are their fields, base class first. `Variant`-s are the varint tag of the case, then the case.
+// * `Optional`-s are a one-byte presence flag, then the value if present.
+// The format is not self-describing: the reader must use the very same type the writer has used.
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "exceptions.h"
+
+#include "../serialization.h"
+
+#include "../../struct.h"
+#include "../../optional.h"
+#include "../../helpers.h"
+
+namespace current {
+namespace serialization {
+namespace binary {
+
+class BinarySerializer final {
+ public:
+  explicit BinarySerializer(std::string& output) : output_(output) {}
+
+  void WriteByte(uint8_t byte) { output_.push_back(static_cast<char>(byte)); }
+
+  void WriteBytes(const void* data, size_t size) { output_.append(reinterpret_cast<const char*>(data), size); }
+
+  void WriteVarInt(uint64_t value) {
+    char buffer[10];
+    size_t size = 0u;
+    while (value >= 0x80) {
+      buffer[size++] = static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    buffer[size++] = static_cast<char>(value);
+    output_.append(buffer, size);
+  }
+
+  void WriteZigZag(int64_t value) {
+    WriteVarInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+
+ private:
+  std::string& output_;
+};
+
+class BinaryDeserializer final {
+ public:
+  constexpr static uint64_t kMaxSizeOfPossiblyEmptyElements = 1u << 20;
+
+  BinaryDeserializer(const char* begin, const char* end) : begin_(begin), current_(begin), end_(end) {}
+
+  bool AtEnd() const { return current_ == end_; }
+  size_t Offset() const { return static_cast<size_t>(current_ - begin_); }
+  size_t Remaining() const { return static_cast<size_t>(end_ - current_); }
+
+  uint8_t ReadByte() {
+    if (current_ == end_) {
+      CURRENT_THROW(BinaryUnexpectedEndOfDataException(Offset(), 1u));
+    }
+    return static_cast<uint8_t>(*current_++);
+  }
+
+  // Returns the pointer to the next `size` bytes of the input, and skips over them.
+  const char* ReadBytes(size_t size) {
+    if (size > Remaining()) {
+      CURRENT_THROW(BinaryUnexpectedEndOfDataException(Offset(), size - Remaining()));
+    }
+    const char* result = current_;
+    current_ += size;
+    return result;
+  }
+
+  uint64_t ReadVarInt() {
+    uint64_t result = 0u;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const uint8_t byte = ReadByte();
+      if (shift == 63 && byte > 1u) {
+        // The tenth byte only carries the top bit of a 64-bit value.
+        CURRENT_THROW(BinaryMalformedDataException("varint overflows 64 bits", Offset() - 1u));
+      }
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return result;
+      }
+    }
+    CURRENT_THROW(BinaryMalformedDataException("varint longer than ten bytes", Offset()));
+  }
+
+  int64_t ReadZigZag() {
+    const uint64_t value = ReadVarInt();
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  }
+
+  // Reads the varint size of a container, making sure the input has `min_bytes_per_element` per element, if non-zero.
+  // Prevents a corrupted size from turning into a multi-gigabyte `reserve()`.
+  // If the elements may take zero bytes, such as empty `CURRENT_STRUCT`-s do, the size can exceed the input,
+  // but only up to `kMaxSizeOfPossiblyEmptyElements`, so that a corrupted one does not spin for billions of elements.
+  size_t ReadSize(size_t min_bytes_per_element) {
+    const uint64_t size = ReadVarInt();
+    if (min_bytes_per_element ? size > Remaining() / min_bytes_per_element
+                              : size > Remaining() && size > kMaxSizeOfPossiblyEmptyElements) {
+      CURRENT_THROW(BinaryMalformedDataException("size " + current::ToString(size) + " exceeds the input", Offset()));
+    }
+    return static_cast<size_t>(size);
+  }
+
+ private:
+  const char* const begin_;
+  const char* current_;
+  const char* const end_;
+};
+
+template <typename T>
+inline void AppendBinary(std::string& output, const T& source) {
+  BinarySerializer binary_serializer(output);
+  Serialize(binary_serializer, source);
+}
+
+template <typename T>
+inline std::string ToBinary(const T& source) {
+  std::string result;
+  AppendBinary(result, source);
+  return result;
+}
+
+template <typename T>
+inline void ParseBinary(const char* begin, const char* end, T& destination) {
+  try {
+    BinaryDeserializer binary_deserializer(begin, end);
+    Deserialize(binary_deserializer, destination);
+    if (!binary_deserializer.AtEnd()) {
+      CURRENT_THROW(BinaryMalformedDataException("trailing bytes", binary_deserializer.Offset()));
+    }
+    CheckIntegrity(destination);
+  } catch (UninitializedVariant) {
+    CURRENT_THROW(BinaryUninitializedVariantObjectException());
+  }
+}
+
+template <typename T>
+inline void ParseBinary(std::string_view source, T& destination) {
+  ParseBinary(source.data(), source.data() + source.length(), destination);
+}
+
+template <typename T>
+inline T ParseBinary(std::string_view source) {
+  T result;
+  ParseBinary(source, result);
+  return result;
+}
+
+// Stream flavor: each object is framed by its varint length, so that multiple objects can share one stream.
+template <typename T>
+inline void SaveIntoBinary(std::ostream& os, const T& source) {
+  const std::string payload = ToBinary(source);
+  std::string frame;
+  BinarySerializer(frame).WriteVarInt(payload.length());
+  os.write(frame.data(), frame.length());
+  os.write(payload.data(), payload.length());
+}
+
+template <typename T>
+inline T LoadFromBinary(std::istream& is) {
+  uint64_t size = 0u;
+  for (int shift = 0;; shift += 7) {
+    const int c = is.get();
+    if (c == std::char_traits<char>::eof()) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Unexpected end of stream while reading the frame size."));
+    }
+    size |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      break;
+    } else if (shift >= 63) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Malformed frame size."));
+    }
+  }
+  std::string payload(static_cast<size_t>(size), '\0');
+  if (!is.read(&payload[0], payload.length())) {
+    CURRENT_THROW(BinaryLoadFromStreamException("Unexpected end of stream while reading the frame."));
+  }
+  return ParseBinary<T>(payload);
+}
+
+}  // namespace binary
+}  // namespace serialization
+
+// Keep top-level symbols both in `current::` and in global namespace.
+using serialization::binary::BinaryLoadFromStreamException;
+using serialization::binary::BinaryMalformedDataException;
+using serialization::binary::BinaryUnexpectedEndOfDataException;
+using serialization::binary::BinaryUninitializedVariantObjectException;
+using serialization::binary::LoadFromBinary;
+using serialization::binary::ParseBinary;
+using serialization::binary::SaveIntoBinary;
+using serialization::binary::ToBinary;
+}  // namespace current
+
+using current::BinaryLoadFromStreamException;
+using current::BinaryMalformedDataException;
+using current::BinaryUnexpectedEndOfDataException;
+using current::BinaryUninitializedVariantObjectException;
+using current::LoadFromBinary;
+using current::ParseBinary;
+using current::SaveIntoBinary;
+using current::ToBinary;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
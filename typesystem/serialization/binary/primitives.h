@@ -0,0 +1,136 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+// Single-byte and floating point types are stored as is, wider integers as varints.
+template <typename T>
+struct IsRawBinaryType {
+  constexpr static bool value = std::is_arithmetic_v<T> && (sizeof(T) == 1u || std::is_floating_point_v<T>);
+};
+
+template <typename T>
+struct IsVarIntBinaryType {
+  constexpr static bool value = std::numeric_limits<T>::is_integer && !IsRawBinaryType<T>::value;
+};
+}  // namespace binary
+
+// `bool`, `char`, `int8_t`, `uint8_t`, `float`, `double`.
+template <typename T>
+struct SerializeImpl<binary::BinarySerializer, T, std::enable_if_t<binary::IsRawBinaryType<T>::value>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, T value) {
+    binary_serializer.WriteBytes(&value, sizeof(T));
+  }
+};
+
+template <typename T>
+struct DeserializeImpl<binary::BinaryDeserializer, T, std::enable_if_t<binary::IsRawBinaryType<T>::value>> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, T& destination) {
+    std::memcpy(&destination, binary_deserializer.ReadBytes(sizeof(T)), sizeof(T));
+  }
+};
+
+template <>
+struct DeserializeImpl<binary::BinaryDeserializer, bool> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, bool& destination) {
+    const uint8_t byte = binary_deserializer.ReadByte();
+    if (byte > 1u) {
+      CURRENT_THROW(binary::BinaryMalformedDataException("bool", binary_deserializer.Offset() - 1u));
+    }
+    destination = (byte != 0u);
+  }
+};
+
+// `uint16_t` through `uint64_t`, `int16_t` through `int64_t`.
+template <typename T>
+struct SerializeImpl<binary::BinarySerializer, T, std::enable_if_t<binary::IsVarIntBinaryType<T>::value>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, T value) {
+    if (std::numeric_limits<T>::is_signed) {
+      binary_serializer.WriteZigZag(static_cast<int64_t>(value));
+    } else {
+      binary_serializer.WriteVarInt(static_cast<uint64_t>(value));
+    }
+  }
+};
+
+template <typename T>
+struct DeserializeImpl<binary::BinaryDeserializer, T, std::enable_if_t<binary::IsVarIntBinaryType<T>::value>> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, T& destination) {
+    if (std::numeric_limits<T>::is_signed) {
+      destination = static_cast<T>(binary_deserializer.ReadZigZag());
+    } else {
+      destination = static_cast<T>(binary_deserializer.ReadVarInt());
+    }
+  }
+};
+
+// `std::string`.
+template <>
+struct SerializeImpl<binary::BinarySerializer, std::string> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::string& value) {
+    binary_serializer.WriteVarInt(value.length());
+    binary_serializer.WriteBytes(value.data(), value.length());
+  }
+};
+
+template <>
+struct DeserializeImpl<binary::BinaryDeserializer, std::string> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, std::string& destination) {
+    const size_t length = binary_deserializer.ReadSize(1u);
+    destination.assign(binary_deserializer.ReadBytes(length), length);
+  }
+};
+
+// `std::chrono::milliseconds`, `std::chrono::microseconds`.
+template <typename REP, typename PERIOD>
+struct SerializeImpl<binary::BinarySerializer, std::chrono::duration<REP, PERIOD>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, std::chrono::duration<REP, PERIOD> value) {
+    binary_serializer.WriteZigZag(static_cast<int64_t>(value.count()));
+  }
+};
+
+template <typename REP, typename PERIOD>
+struct DeserializeImpl<binary::BinaryDeserializer, std::chrono::duration<REP, PERIOD>> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer,
+                            std::chrono::duration<REP, PERIOD>& destination) {
+    destination = std::chrono::duration<REP, PERIOD>(static_cast<REP>(binary_deserializer.ReadZigZag()));
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
@@ -0,0 +1,79 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_SET_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_SET_H
+
+#include <set>
+#include <unordered_set>
+
+#include "primitives.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+template <typename SET>
+struct SerializeSetImpl {
+  static void DoSerialize(BinarySerializer& binary_serializer, const SET& value) {
+    binary_serializer.WriteVarInt(value.size());
+    for (const auto& element : value) {
+      Serialize(binary_serializer, element);
+    }
+  }
+};
+
+template <typename SET>
+struct DeserializeSetImpl {
+  static void DoDeserialize(BinaryDeserializer& binary_deserializer, SET& destination) {
+    const size_t size = binary_deserializer.ReadSize(0u);
+    destination.clear();
+    for (size_t i = 0u; i < size; ++i) {
+      typename SET::value_type element;
+      Deserialize(binary_deserializer, element);
+      destination.insert(std::move(element));
+    }
+  }
+};
+}  // namespace binary
+
+template <typename T, typename TC, typename TA>
+struct SerializeImpl<binary::BinarySerializer, std::set<T, TC, TA>> : binary::SerializeSetImpl<std::set<T, TC, TA>> {};
+
+template <typename T, typename TC, typename TA>
+struct DeserializeImpl<binary::BinaryDeserializer, std::set<T, TC, TA>>
+    : binary::DeserializeSetImpl<std::set<T, TC, TA>> {};
+
+template <typename T, typename TH, typename TE, typename TA>
+struct SerializeImpl<binary::BinarySerializer, std::unordered_set<T, TH, TE, TA>>
+    : binary::SerializeSetImpl<std::unordered_set<T, TH, TE, TA>> {};
+
+template <typename T, typename TH, typename TE, typename TA>
+struct DeserializeImpl<binary::BinaryDeserializer, std::unordered_set<T, TH, TE, TA>>
+    : binary::DeserializeSetImpl<std::unordered_set<T, TH, TE, TA>> {};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_SET_H
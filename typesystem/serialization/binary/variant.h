@@ -0,0 +1,119 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
+
+#include <memory>
+#include <type_traits>
+
+#include "binary.h"
+
+#include "../../variant.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+// The zero-based index of `X` in the type list of a `Variant`. The on-the-wire tag of the case is this index plus one,
+// with the tag of zero reserved for an uninitialized `Variant`, which `JSON()` would serialize as `null`.
+template <typename X, typename TYPELIST>
+struct BinaryVariantCaseIndex;
+
+template <typename X, typename T, typename... TS>
+struct BinaryVariantCaseIndex<X, TypeListImpl<T, TS...>> {
+  constexpr static uint64_t value =
+      std::is_same_v<X, T> ? 0u : 1u + BinaryVariantCaseIndex<X, TypeListImpl<TS...>>::value;
+};
+
+template <typename X>
+struct BinaryVariantCaseIndex<X, TypeListImpl<>> {
+  constexpr static uint64_t value = 0u;
+};
+
+template <typename VARIANT>
+class BinaryVariantSerializer {
+ public:
+  explicit BinaryVariantSerializer(BinarySerializer& binary_serializer) : binary_serializer_(binary_serializer) {}
+
+  template <typename X>
+  void operator()(const X& object) {
+    binary_serializer_.WriteVarInt(BinaryVariantCaseIndex<X, typename VARIANT::typelist_t>::value + 1u);
+    Serialize(binary_serializer_, object);
+  }
+
+ private:
+  BinarySerializer& binary_serializer_;
+};
+
+template <typename VARIANT, typename TYPELIST = typename VARIANT::typelist_t>
+struct BinaryVariantDeserializer;
+
+template <typename VARIANT, typename... TS>
+struct BinaryVariantDeserializer<VARIANT, TypeListImpl<TS...>> {
+  template <typename X>
+  static void DeserializeCase(BinaryDeserializer& binary_deserializer, VARIANT& destination) {
+    X result;
+    Deserialize(binary_deserializer, result);
+    destination.template Construct<X>(std::move(result));
+  }
+
+  // Direct dispatch by the case index, no type id lookups.
+  static void DoDeserialize(BinaryDeserializer& binary_deserializer, VARIANT& destination) {
+    static constexpr void (*deserializers[])(BinaryDeserializer&, VARIANT&) = {&DeserializeCase<TS>...};
+    const uint64_t tag = binary_deserializer.ReadVarInt();
+    if (!tag) {
+      CURRENT_THROW(BinaryUninitializedVariantObjectException());
+    } else if (tag > sizeof...(TS)) {
+      CURRENT_THROW(BinaryMalformedDataException("variant case tag " + current::ToString(tag) + " out of range",
+                                                 binary_deserializer.Offset()));
+    }
+    deserializers[tag - 1u](binary_deserializer, destination);
+  }
+};
+}  // namespace binary
+
+template <typename T>
+struct SerializeImpl<binary::BinarySerializer, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const T& value) {
+    if (Exists(value)) {
+      binary::BinaryVariantSerializer<T> serializer(binary_serializer);
+      value.Call(serializer);
+    } else {
+      binary_serializer.WriteVarInt(0u);
+    }
+  }
+};
+
+template <typename T>
+struct DeserializeImpl<binary::BinaryDeserializer, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, T& destination) {
+    binary::BinaryVariantDeserializer<T>::DoDeserialize(binary_deserializer, destination);
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
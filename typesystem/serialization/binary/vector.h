@@ -0,0 +1,89 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 agent <agent@local>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VECTOR_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VECTOR_H
+
+#include <algorithm>
+#include <vector>
+
+#include "primitives.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+// Vectors and arrays of these types are copied as one block of memory.
+template <typename T>
+struct IsBulkBinaryType {
+  constexpr static bool value = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+};
+}  // namespace binary
+
+template <typename T, typename ALLOCATOR>
+struct SerializeImpl<binary::BinarySerializer, std::vector<T, ALLOCATOR>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::vector<T, ALLOCATOR>& value) {
+    binary_serializer.WriteVarInt(value.size());
+    if constexpr (binary::IsBulkBinaryType<T>::value) {
+      binary_serializer.WriteBytes(value.data(), value.size() * sizeof(T));
+    } else {
+      for (const auto& element : value) {
+        Serialize(binary_serializer, element);
+      }
+    }
+  }
+};
+
+template <typename T, typename ALLOCATOR>
+struct DeserializeImpl<binary::BinaryDeserializer, std::vector<T, ALLOCATOR>> {
+  static void DoDeserialize(binary::BinaryDeserializer& binary_deserializer, std::vector<T, ALLOCATOR>& destination) {
+    if constexpr (binary::IsBulkBinaryType<T>::value) {
+      const size_t size = binary_deserializer.ReadSize(sizeof(T));
+      destination.resize(size);
+      std::memcpy(destination.data(), binary_deserializer.ReadBytes(size * sizeof(T)), size * sizeof(T));
+    } else if constexpr (std::is_same_v<T, bool>) {
+      const size_t size = binary_deserializer.ReadSize(1u);
+      destination.resize(size);
+      for (size_t i = 0u; i < size; ++i) {
+        bool element;
+        Deserialize(binary_deserializer, element);
+        destination[i] = element;
+      }
+    } else {
+      // Elements such as empty `CURRENT_STRUCT`-s take zero bytes, so the size is only capped, see `ReadSize()`.
+      const size_t size = binary_deserializer.ReadSize(0u);
+      destination.clear();
+      destination.reserve(std::min(size, binary_deserializer.Remaining()));
+      for (size_t i = 0u; i < size; ++i) {
+        destination.emplace_back();
+        Deserialize(binary_deserializer, destination.back());
+      }
+    }
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VECTOR_H
@@ -44,6 +44,18 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::array<T, N>> {
   }
 };
 
+template <class JSON_FORMAT, typename T, size_t N>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, std::array<T, N>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,
+                          const std::array<T, N>& value) {
+    json_stringifier.Writer().StartArray();
+    for (const auto& element : value) {
+      Serialize(json_stringifier, element);
+    }
+    json_stringifier.Writer().EndArray();
+  }
+};
+
 template <class JSON_FORMAT, typename T, size_t N>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::array<T, N>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, std::array<T, N>& destination) {
@@ -40,6 +40,15 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, T, std::enable_if_t<std
   }
 };
 
+template <class JSON_FORMAT, typename T>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, T, std::enable_if_t<std::is_enum_v<T>>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier, const T enum_value) {
+    using underlying_t = typename std::underlying_type<T>::type;
+    json::JSONValueWriterImpl<underlying_t>::WriteValue(json_stringifier.Writer(),
+                                                        static_cast<underlying_t>(enum_value));
+  }
+};
+
 template <class JSON_FORMAT, typename T>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, T, std::enable_if_t<std::is_enum_v<T>>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, T& destination) {
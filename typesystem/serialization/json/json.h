@@ -26,6 +26,12 @@ SOFTWARE.
 #ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_JSON_H
 #define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_JSON_H
 
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
 #include "exceptions.h"
 #include "rapidjson.h"
 
@@ -179,6 +185,49 @@ class JSONStringifier final {
   rapidjson::Document document_;
 };
 
+// The streaming counterpart of `JSONStringifier`: feeds RapidJSON's `Writer` directly, without building the DOM.
+// Produces byte-identical output. The only decision the DOM-based stringifier makes after the fact, omitting struct
+// fields with absent values, such as empty `Optional`-s in the `Minimalistic` format, is made upfront here,
+// via `JSONValueIsAbsent`. Outside struct fields the absent values are `null`-s, same as with the DOM.
+template <class JSON_FORMAT>
+class JSONStreamingStringifier final {
+ public:
+  using writer_t = rapidjson::Writer<rapidjson::StringBuffer>;
+
+  explicit JSONStreamingStringifier(writer_t& writer) : writer_(writer) {}
+
+  writer_t& Writer() { return writer_; }
+
+  void Key(const char* key) { writer_.Key(key, static_cast<rapidjson::SizeType>(strlen(key))); }
+  void Key(const std::string& key) { writer_.Key(key.data(), static_cast<rapidjson::SizeType>(key.length())); }
+
+ private:
+  writer_t& writer_;
+};
+
+// Whether the value, when a field of a `CURRENT_STRUCT`, should be omitted from the JSON in the given format.
+template <class JSON_FORMAT, typename T, typename ENABLE = void>
+struct JSONValueIsAbsent {
+  static bool IsAbsent(const T&) { return false; }
+};
+
+// For RapidJSON `Writer` calls, the streaming counterpart of `JSONValueAssignerImpl`.
+// Integers go through `Int64` / `Uint64`, which print the same as the `Int` / `Uint` of the DOM values.
+template <typename T>
+struct JSONValueWriterImpl {
+  static void WriteValue(rapidjson::Writer<rapidjson::StringBuffer>& writer, current::copy_free<T> value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      writer.Bool(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      writer.Double(static_cast<double>(value));
+    } else if constexpr (std::numeric_limits<T>::is_signed) {
+      writer.Int64(static_cast<int64_t>(value));
+    } else {
+      writer.Uint64(static_cast<uint64_t>(value));
+    }
+  }
+};
+
 enum class JSONVariantStyle : int { Current, Simple, NewtonsoftFSharp };
 
 template <JSONVariantStyle>
@@ -238,16 +287,104 @@ struct JSONPatchMode<JSONPatcher<J>> {
   constexpr static bool value = true;
 };
 
+// The memory `JSONParser` parses into: the in-situ copy of the input, and the pool for both the DOM values and the
+// parsing stack. Retained across parses, so that a tight loop of `ParseJSON()` calls does not allocate.
+class JSONParserContext final {
+ public:
+  using document_t =
+      rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::MemoryPoolAllocator<>>;
+
+  JSONParserContext() { ResetPool(kInitialPoolSize); }
+
+  // The returned value is valid until the next `Parse()`.
+  rapidjson::Value& Parse(const char* json, size_t length) {
+    const size_t pool_capacity = pool_->Capacity();
+    if (pool_capacity > pool_buffer_.size() && pool_capacity <= kMaxRetainedSize) {
+      // The previous parse has outgrown the buffer, make the next ones fit.
+      ResetPool(std::min(pool_capacity * 2u, kMaxRetainedSize));
+    } else {
+      pool_->Clear();
+    }
+    insitu_buffer_.assign(json, length);
+    if (document_->ParseInsitu(&insitu_buffer_[0]).HasParseError()) {
+      CURRENT_THROW(InvalidJSONException(std::string(json, length)));
+    }
+    return *document_;
+  }
+
+  static JSONParserContext& ThreadLocal() {
+    thread_local JSONParserContext instance;
+    return instance;
+  }
+
+  bool TryAcquire() {
+    if (in_use_) {
+      return false;
+    }
+    in_use_ = true;
+    return true;
+  }
+
+  void Release() {
+    // Don't hold on to the memory after a one-off huge JSON.
+    if (insitu_buffer_.capacity() > kMaxRetainedSize) {
+      std::string().swap(insitu_buffer_);
+    }
+    if (pool_->Capacity() > kMaxRetainedSize) {
+      ResetPool(kInitialPoolSize);
+    }
+    in_use_ = false;
+  }
+
+ private:
+  constexpr static size_t kInitialPoolSize = 64u * 1024u;
+  constexpr static size_t kMaxRetainedSize = 16u * 1024u * 1024u;
+  constexpr static size_t kChunkSize = 64u * 1024u;
+
+  void ResetPool(size_t size) {
+    document_ = nullptr;
+    pool_ = nullptr;
+    pool_buffer_.assign(size, '\0');
+    pool_ =
+        std::make_unique<rapidjson::MemoryPoolAllocator<>>(&pool_buffer_[0], pool_buffer_.size(), kChunkSize, &crt_);
+    document_ = std::make_unique<document_t>(pool_.get(), 1024u, pool_.get());
+  }
+
+  std::string insitu_buffer_;
+  std::vector<char> pool_buffer_;
+  rapidjson::CrtAllocator crt_;
+  std::unique_ptr<rapidjson::MemoryPoolAllocator<>> pool_;
+  std::unique_ptr<document_t> document_;
+  bool in_use_ = false;
+};
+
 template <class JSON_FORMAT>
 class JSONParser final {
  public:
-  explicit JSONParser(const char* json) {
-    if (document_.Parse(json).HasParseError()) {
-      CURRENT_THROW(InvalidJSONException(json));
+  explicit JSONParser(const char* json) : JSONParser(json, strlen(json)) {}
+
+  // Uses the per-thread `JSONParserContext`, or, for a nested parse from within a custom deserializer, a fresh one.
+  JSONParser(const char* json, size_t length) {
+    JSONParserContext& thread_local_context = JSONParserContext::ThreadLocal();
+    if (thread_local_context.TryAcquire()) {
+      context_ = &thread_local_context;
+    } else {
+      own_context_ = std::make_unique<JSONParserContext>();
+      context_ = own_context_.get();
+    }
+    try {
+      current_ = &context_->Parse(json, length);
+    } catch (...) {
+      ReleaseContext();
+      throw;
     }
-    current_ = &document_;
   }
 
+  ~JSONParser() { ReleaseContext(); }
+
+  JSONParser(const JSONParser&) = delete;
+  JSONParser& operator=(const JSONParser&) = delete;
+
   operator bool() const { return current_ != nullptr; }
   rapidjson::Value& Current() { return *current_; }
   rapidjson::Value* CurrentAsPtr() { return current_; }
@@ -318,47 +455,154 @@ class JSONParser final {
   }
 
  private:
+  void ReleaseContext() {
+    if (context_ && !own_context_) {
+      context_->Release();
+    }
+    context_ = nullptr;
+  }
+
+  std::unique_ptr<JSONParserContext> own_context_;
+  JSONParserContext* context_ = nullptr;
   rapidjson::Value* current_;
   std::vector<CharPtrOrInt> path_;
-  rapidjson::Document document_;
 };
 
 template <class J, typename T>
-void ParseJSONViaRapidJSON(const char* json, T& destination) {
-  JSONParser<J> json_parser(json);
+void ParseJSONViaRapidJSON(const char* json, size_t length, T& destination) {
+  JSONParser<J> json_parser(json, length);
   Deserialize(json_parser, destination);
 }
 
+template <class J, typename T>
+void ParseJSONViaRapidJSON(const char* json, T& destination) {
+  ParseJSONViaRapidJSON<J>(json, strlen(json), destination);
+}
+
+// The per-thread buffer and `Writer` for `JSON()`, so that the common case of serializing into an `std::string`
+// costs one allocation, for the resulting string itself.
+class ReusableJSONWriter final {
+ public:
+  template <typename F>
+  static void Use(F&& f) {
+    thread_local ReusableJSONWriter instance;
+    if (instance.in_use_) {
+      // A nested `JSON()` call from within a custom serializer, fall back to a fresh buffer.
+      rapidjson::StringBuffer buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+      f(buffer, writer);
+    } else {
+      struct Release final {
+        ReusableJSONWriter& self;
+        ~Release() {
+          // Don't hold on to the memory after a one-off huge JSON.
+          if (self.buffer_.GetSize() > kMaxRetainedBufferSize) {
+            self.buffer_.Clear();
+            self.buffer_.ShrinkToFit();
+          }
+          self.in_use_ = false;
+        }
+      };
+      instance.in_use_ = true;
+      Release release{instance};
+      instance.buffer_.Clear();
+      instance.writer_.Reset(instance.buffer_);
+      f(instance.buffer_, instance.writer_);
+    }
+  }
+
+ private:
+  constexpr static size_t kMaxRetainedBufferSize = 1024u * 1024u;
+
+  ReusableJSONWriter() : writer_(buffer_) {}
+
+  rapidjson::StringBuffer buffer_;
+  rapidjson::Writer<rapidjson::StringBuffer> writer_;
+  bool in_use_ = false;
+};
+
+// The DOM-based `JSON()`, kept as the reference implementation for `JSONViaRapidJSONWriter()`.
 template <class J = JSONFormat::Current, typename T>
-inline std::string JSON(const T& source) {
+inline std::string JSONViaRapidJSONDocument(const T& source) {
   JSONStringifier<J> json_stringifier;
   Serialize(json_stringifier, source);
   return json_stringifier.ResultingJSON();
 }
 
+// Appends the JSON of `source` to the `writer`, which must be fresh or `Reset()`.
+template <class J = JSONFormat::Current, typename T>
+inline void WriteJSON(rapidjson::Writer<rapidjson::StringBuffer>& writer, const T& source) {
+  JSONStreamingStringifier<J> json_stringifier(writer);
+  Serialize(json_stringifier, source);
+}
+
+template <class J = JSONFormat::Current, typename T>
+inline std::string JSONViaRapidJSONWriter(const T& source) {
+  std::string result;
+  ReusableJSONWriter::Use([&](rapidjson::StringBuffer& buffer, rapidjson::Writer<rapidjson::StringBuffer>& writer) {
+    WriteJSON<J>(writer, source);
+    result.assign(buffer.GetString(), buffer.GetSize());
+  });
+  return result;
+}
+
+// Writes the JSON of `source` into `os`, without creating the intermediate `std::string`.
+template <class J = JSONFormat::Current, typename T>
+inline void WriteJSON(std::ostream& os, const T& source) {
+  ReusableJSONWriter::Use([&](rapidjson::StringBuffer& buffer, rapidjson::Writer<rapidjson::StringBuffer>& writer) {
+    WriteJSON<J>(writer, source);
+    os.write(buffer.GetString(), buffer.GetSize());
+  });
+}
+
+// Appends the JSON of `source` to `output`, to build a longer string without intermediate copies.
+template <class J = JSONFormat::Current, typename T>
+inline void AppendJSON(std::string& output, const T& source) {
+  ReusableJSONWriter::Use([&](rapidjson::StringBuffer& buffer, rapidjson::Writer<rapidjson::StringBuffer>& writer) {
+    WriteJSON<J>(writer, source);
+    output.append(buffer.GetString(), buffer.GetSize());
+  });
+}
+
+template <class J = JSONFormat::Current, typename T>
+inline std::string JSON(const T& source) {
+  return JSONViaRapidJSONWriter<J>(source);
+}
+
 template <class J = JSONFormat::Current>
 inline std::string JSON(const char* special_case_bare_c_string) {
   return JSON<J>(std::string(special_case_bare_c_string));
 }
 
+// Parses in situ, into the per-thread reused `JSONParserContext`, so only the `destination` itself allocates.
 template <typename T, class J = JSONFormat::Current>
-inline void ParseJSON(const char* source, T& destination) {
+inline void ParseJSON(const char* source, size_t length, T& destination) {
   try {
-    ParseJSONViaRapidJSON<J>(source, destination);
+    ParseJSONViaRapidJSON<J>(source, length, destination);
     CheckIntegrity(destination);
   } catch (UninitializedVariant) {
     CURRENT_THROW(JSONUninitializedVariantObjectException());
   }
 }
 
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSON(const char* source, T& destination) {
+  ParseJSON<T, J>(source, strlen(source), destination);
+}
+
 template <typename T, class J = JSONFormat::Current>
 inline void ParseJSON(const std::string& source, T& destination) {
-  ParseJSON(source.c_str(), destination);
+  ParseJSON<T, J>(source.c_str(), source.length(), destination);
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSON(std::string_view source, T& destination) {
+  ParseJSON<T, J>(source.data(), source.length(), destination);
 }
 
 template <typename T, class J = JSONFormat::Current>
 inline void ParseJSON(const strings::Chunk& source, T& destination) {
-  ParseJSON(source.c_str(), destination);
+  ParseJSON<T, J>(source.c_str(), source.length(), destination);
 }
 
 template <typename T, class J = JSONFormat::Current>
@@ -391,12 +635,23 @@ inline T ParseJSON(const char* source) {
 
 template <typename T, class J = JSONFormat::Current>
 inline T ParseJSON(const std::string& source) {
-  return ParseJSON<T, J>(source.c_str());
+  T result;
+  ParseJSON<T, J>(source.c_str(), source.length(), result);
+  return result;
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline T ParseJSON(std::string_view source) {
+  T result;
+  ParseJSON<T, J>(source.data(), source.length(), result);
+  return result;
 }
 
 template <typename T, class J = JSONFormat::Current>
 inline T ParseJSON(const strings::Chunk& source) {
-  return ParseJSON<T, J>(source.c_str());
+  T result;
+  ParseJSON<T, J>(source.c_str(), source.length(), result);
+  return result;
 }
 
 template <typename T, class J = JSONFormat::Current>
@@ -424,6 +679,7 @@ inline Optional<T> TryParseJSON(const strings::Chunk& source) {
 }  // namespace serialization
 
 // Keep top-level symbols both in `current::` and in global namespace.
+using serialization::json::AppendJSON;
 using serialization::json::InvalidJSONException;
 using serialization::json::JSON;
 using serialization::json::JSONFormat;
@@ -435,6 +691,7 @@ using serialization::json::TryParseJSON;
 using serialization::json::TypeSystemParseJSONException;
 }  // namespace current
 
+using current::AppendJSON;
 using current::InvalidJSONException;
 using current::JSON;
 using current::JSONFormat;
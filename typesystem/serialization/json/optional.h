@@ -84,6 +84,47 @@ struct SerializeImpl<json::JSONStringifier<json::JSONFormat::NewtonsoftFSharp>,
   }
 };
 
+template <class JSON_FORMAT, typename T>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, Optional<T>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier, const Optional<T>& value) {
+    if (Exists(value)) {
+      Serialize(json_stringifier, Value(value));
+    } else {
+      // Also the absent value of the `Minimalistic` and `NewtonsoftFSharp` formats, when not a struct field.
+      json_stringifier.Writer().Null();
+    }
+  }
+};
+
+template <typename T>
+struct SerializeImpl<json::JSONStreamingStringifier<json::JSONFormat::NewtonsoftFSharp>, Optional<T>> {
+  static void DoSerialize(json::JSONStreamingStringifier<json::JSONFormat::NewtonsoftFSharp>& json_stringifier,
+                          const Optional<T>& value) {
+    if (Exists(value)) {
+      json_stringifier.Writer().StartObject();
+      json_stringifier.Key("Case");
+      json_stringifier.Writer().String("Some", 4u);
+      json_stringifier.Key("Fields");
+      json_stringifier.Writer().StartArray();
+      Serialize(json_stringifier, Value(value));
+      json_stringifier.Writer().EndArray();
+      json_stringifier.Writer().EndObject();
+    } else {
+      json_stringifier.Writer().Null();
+    }
+  }
+};
+
+namespace json {
+template <class JSON_FORMAT, typename T>
+struct JSONValueIsAbsent<JSON_FORMAT, Optional<T>> {
+  static bool IsAbsent(const Optional<T>& value) {
+    return !Exists(value) && (std::is_same_v<JSON_FORMAT, JSONFormat::Minimalistic> ||
+                              std::is_same_v<JSON_FORMAT, JSONFormat::NewtonsoftFSharp>);
+  }
+};
+}  // namespace json
+
 template <class JSON_FORMAT, typename T>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, Optional<T>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, Optional<T>& destination) {
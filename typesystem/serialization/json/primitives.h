@@ -56,6 +56,27 @@ struct JSONValueAssignerImpl<std::chrono::milliseconds> {
     destination.SetInt64(value.count());
   }
 };
+
+template <>
+struct JSONValueWriterImpl<std::string> {
+  static void WriteValue(rapidjson::Writer<rapidjson::StringBuffer>& writer, const std::string& value) {
+    writer.String(value.data(), static_cast<rapidjson::SizeType>(value.length()));
+  }
+};
+
+template <>
+struct JSONValueWriterImpl<std::chrono::microseconds> {
+  static void WriteValue(rapidjson::Writer<rapidjson::StringBuffer>& writer, std::chrono::microseconds value) {
+    writer.Int64(value.count());
+  }
+};
+
+template <>
+struct JSONValueWriterImpl<std::chrono::milliseconds> {
+  static void WriteValue(rapidjson::Writer<rapidjson::StringBuffer>& writer, std::chrono::milliseconds value) {
+    writer.Int64(value.count());
+  }
+};
 }  // namespace json
 
 #define CURRENT_DECLARE_PRIMITIVE_TYPE(typeid_index, cpp_type, current_type, fs_type, md_type, typescript_type) \
@@ -65,6 +86,13 @@ struct JSONValueAssignerImpl<std::chrono::milliseconds> {
       json_stringifier = value;                                                                                 \
     }                                                                                                           \
   };                                                                                                            \
+  template <class JSON_FORMAT>                                                                                  \
+  struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, cpp_type> {                                 \
+    static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,                      \
+                            copy_free<cpp_type> value) {                                                        \
+      json::JSONValueWriterImpl<cpp_type>::WriteValue(json_stringifier.Writer(), value);                        \
+    }                                                                                                           \
+  };                                                                                                            \
   namespace json {                                                                                              \
   template <>                                                                                                   \
   struct IsJSONSerializable<cpp_type> {                                                                         \
@@ -75,6 +75,42 @@ struct SerializeStructImpl<JSON_FORMAT, CurrentStruct> {
   static void SerializeStruct(JSONStructFieldsSerializer<JSON_FORMAT>&, const CurrentStruct&) {}
 };
 
+template <class JSON_FORMAT>
+class JSONStreamingStructFieldsSerializer {
+ public:
+  explicit JSONStreamingStructFieldsSerializer(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier)
+      : json_stringifier_(json_stringifier) {}
+
+  template <typename U>
+  void operator()(const char* name, const U& source) const {
+    if (!JSONValueIsAbsent<JSON_FORMAT, U>::IsAbsent(source)) {
+      json_stringifier_.Key(name);
+      Serialize(json_stringifier_, source);
+    }
+  }
+
+ private:
+  json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier_;
+};
+
+template <class JSON_FORMAT, typename T>
+struct StreamStructImpl {
+  static void StreamStruct(JSONStreamingStructFieldsSerializer<JSON_FORMAT>& visitor, const T& source) {
+    using decayed_t = current::decay_t<T>;
+    using super_t = current::reflection::SuperType<decayed_t>;
+
+    StreamStructImpl<JSON_FORMAT, super_t>::StreamStruct(visitor, source);
+
+    current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndImmutableValue>::WithObject(
+        source, visitor);
+  }
+};
+
+template <class JSON_FORMAT>
+struct StreamStructImpl<JSON_FORMAT, CurrentStruct> {
+  static void StreamStruct(JSONStreamingStructFieldsSerializer<JSON_FORMAT>&, const CurrentStruct&) {}
+};
+
 }  // namespace json
 
 template <class JSON_FORMAT, typename T>
@@ -88,6 +124,18 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>,
   }
 };
 
+template <class JSON_FORMAT, typename T>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>,
+                     T,
+                     std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same_v<T, CurrentStruct>>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier, const T& value) {
+    json_stringifier.Writer().StartObject();
+    json::JSONStreamingStructFieldsSerializer<JSON_FORMAT> visitor(json_stringifier);
+    json::StreamStructImpl<JSON_FORMAT, T>::StreamStruct(visitor, value);
+    json_stringifier.Writer().EndObject();
+  }
+};
+
 template <class JSON_FORMAT>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, CurrentStruct> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>&, CurrentStruct&) {}
@@ -69,6 +69,16 @@ struct DeserializeTupleImpl<JSON_FORMAT, TUPLE, N, N> {
   static void DoIt(json::JSONParser<JSON_FORMAT>&, TUPLE&) {}
 };
 
+template <class JSON_FORMAT, typename... TS>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, std::tuple<TS...>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,
+                          const std::tuple<TS...>& value) {
+    json_stringifier.Writer().StartArray();
+    std::apply([&json_stringifier](const TS&... element) { (Serialize(json_stringifier, element), ...); }, value);
+    json_stringifier.Writer().EndArray();
+  }
+};
+
 template <class JSON_FORMAT, typename... TS>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::tuple<TS...>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, std::tuple<TS...>& destination) {
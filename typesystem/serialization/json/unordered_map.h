@@ -68,6 +68,35 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::unordered_map<std:
   }
 };
 
+template <class JSON_FORMAT, typename TK, typename TV, class HASH, class EQ, class ALLOCATOR>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,
+                          const std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>& value) {
+    json_stringifier.Writer().StartArray();
+    for (const auto& element : value) {
+      json_stringifier.Writer().StartArray();
+      Serialize(json_stringifier, element.first);
+      Serialize(json_stringifier, element.second);
+      json_stringifier.Writer().EndArray();
+    }
+    json_stringifier.Writer().EndArray();
+  }
+};
+
+template <class JSON_FORMAT, typename TV, class HASH, class EQ, class ALLOCATOR>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>,
+                     std::unordered_map<std::string, TV, HASH, EQ, ALLOCATOR>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,
+                          const std::unordered_map<std::string, TV, HASH, EQ, ALLOCATOR>& value) {
+    json_stringifier.Writer().StartObject();
+    for (const auto& element : value) {
+      json_stringifier.Key(element.first);
+      Serialize(json_stringifier, element.second);
+    }
+    json_stringifier.Writer().EndObject();
+  }
+};
+
 template <class JSON_FORMAT, typename TK, typename TV, class HASH, class EQ, class ALLOCATOR, class J>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>, J> {
   template <typename K = TK>
@@ -127,23 +127,94 @@ class JSONVariantSerializer<json::JSONVariantStyle::NewtonsoftFSharp, JSON_FORMA
   json::JSONStringifier<JSON_FORMAT>& json_stringifier_;
 };
 
+template <json::JSONVariantStyle, class JSON_FORMAT>
+class JSONStreamingVariantSerializer;
+
 template <class JSON_FORMAT>
+class JSONStreamingVariantSerializer<json::JSONVariantStyle::Current, JSON_FORMAT> {
+ public:
+  explicit JSONStreamingVariantSerializer(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier)
+      : json_stringifier_(json_stringifier) {}
+
+  template <typename X>
+  std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(X)> operator()(const X& object) {
+    json_stringifier_.Writer().StartObject();
+    json_stringifier_.Key(reflection::CurrentTypeName<X, reflection::NameFormat::Z>());
+    Serialize(json_stringifier_, object);
+    if (json::JSONVariantTypeIDInEmptyKey<JSON_FORMAT>::value) {
+      using namespace ::current::reflection;
+      json_stringifier_.Key("");
+      Serialize(json_stringifier_, Value<ReflectedTypeBase>(Reflector().ReflectType<X>()).type_id);
+    }
+    if (json::JSONVariantTypeNameInDollarKey<JSON_FORMAT>::value) {
+      json_stringifier_.Key("$");
+      const char* name = reflection::CurrentTypeName<X, reflection::NameFormat::Z>();
+      json_stringifier_.Writer().String(name, static_cast<rapidjson::SizeType>(strlen(name)));
+    }
+    json_stringifier_.Writer().EndObject();
+  }
+
+ private:
+  json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier_;
+};
+
+template <class JSON_FORMAT>
+class JSONStreamingVariantSerializer<json::JSONVariantStyle::Simple, JSON_FORMAT>
+    : public JSONStreamingVariantSerializer<json::JSONVariantStyle::Current, JSON_FORMAT> {
+  using JSONStreamingVariantSerializer<json::JSONVariantStyle::Current, JSON_FORMAT>::JSONStreamingVariantSerializer;
+};
+
+template <class JSON_FORMAT>
+class JSONStreamingVariantSerializer<json::JSONVariantStyle::NewtonsoftFSharp, JSON_FORMAT> {
+ public:
+  explicit JSONStreamingVariantSerializer(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier)
+      : json_stringifier_(json_stringifier) {}
+
+  template <typename X>
+  std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(X)> operator()(const X& object) {
+    json_stringifier_.Writer().StartObject();
+    json_stringifier_.Key("Case");
+    const char* name = reflection::CurrentTypeName<X, reflection::NameFormat::Z>();
+    json_stringifier_.Writer().String(name, static_cast<rapidjson::SizeType>(strlen(name)));
+    if (IS_CURRENT_VARIANT(X) || !IS_EMPTY_CURRENT_STRUCT(X)) {
+      json_stringifier_.Key("Fields");
+      json_stringifier_.Writer().StartArray();
+      Serialize(json_stringifier_, object);
+      json_stringifier_.Writer().EndArray();
+    }
+    json_stringifier_.Writer().EndObject();
+  }
+
+ private:
+  json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier_;
+};
+
+template <class JSON_FORMAT, typename T>
+struct JSONValueIsAbsent<JSON_FORMAT, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static bool IsAbsent(const T& value) {
+    return !Exists(value) && !JSONVariantStyleUseNulls<JSON_FORMAT::variant_style>::value;
+  }
+};
+
+// The case is parsed into an object of its own, which is then moved into the `Variant`,
+// so that the `Variant` is left intact should the parsing fail.
+template <class JSON_FORMAT, typename VARIANT>
 class JSONVariantCaseAbstractBase {
  public:
   virtual ~JSONVariantCaseAbstractBase() = default;
-  virtual void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) = 0;
+  virtual void Deserialize(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) = 0;
 };
 
-template <class JSON_FORMAT, typename T>
-class JSONVariantCaseGeneric : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
+template <class JSON_FORMAT, typename VARIANT, typename T>
+class JSONVariantCaseGeneric : public JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT> {
  public:
   explicit JSONVariantCaseGeneric(const char* key_name) : key_name_(key_name) {}
 
-  void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) override {
+  void Deserialize(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) override {
     if (json_parser && json_parser.Current().HasMember(key_name_)) {
-      auto result = std::make_unique<T>();
-      json_parser.Inner(&json_parser.Current()[key_name_], *result, "[\"", key_name_, "\"]");
-      destination.UncheckedMoveFromUniquePtr(std::move(result));
+      T result;
+      json_parser.Inner(&json_parser.Current()[key_name_], result, "[\"", key_name_, "\"]");
+      destination.template Construct<T>(std::move(result));
     } else if (!JSONPatchMode<JSON_FORMAT>::value) {
       // LCOV_EXCL_START
       CURRENT_THROW(JSONSchemaException("variant case `" + std::string(key_name_) + "`", json_parser));
@@ -155,31 +226,31 @@ class JSONVariantCaseGeneric : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
   const char* key_name_;
 };
 
-template <typename T, typename JSON_FORMAT>
-class JSONVariantCaseMinimalistic : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
+template <typename T, typename JSON_FORMAT, typename VARIANT>
+class JSONVariantCaseMinimalistic : public JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT> {
  public:
   explicit JSONVariantCaseMinimalistic(const char* key_name) : key_name_(key_name) {}
 
-  void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) override {
-    auto result = std::make_unique<T>();
-    json_parser.Inner(&json_parser.Current()[key_name_], *result, "[\"", key_name_, "\"]");
-    destination.UncheckedMoveFromUniquePtr(std::move(result));
+  void Deserialize(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) override {
+    T result;
+    json_parser.Inner(&json_parser.Current()[key_name_], result, "[\"", key_name_, "\"]");
+    destination.template Construct<T>(std::move(result));
   }
 
  private:
   const char* key_name_;
 };
 
-template <typename T, typename JSON_FORMAT>
-class JSONVariantCaseFSharp : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
+template <typename T, typename JSON_FORMAT, typename VARIANT>
+class JSONVariantCaseFSharp : public JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT> {
  public:
-  void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) override {
+  void Deserialize(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) override {
     if (json_parser.Current().HasMember("Fields")) {
       rapidjson::Value& fields = json_parser.Current()["Fields"];
       if (fields.IsArray() && fields.Size() == 1u) {
-        auto result = std::make_unique<T>();
-        json_parser.Inner(&fields[static_cast<rapidjson::SizeType>(0)], *result, ".", "Fields[0]");
-        destination.UncheckedMoveFromUniquePtr(std::move(result));
+        T result;
+        json_parser.Inner(&fields[static_cast<rapidjson::SizeType>(0)], result, ".", "Fields[0]");
+        destination.template Construct<T>(std::move(result));
       } else {
         // No PATCH for F#. -- D.K.
         // LCOV_EXCL_START
@@ -189,7 +260,7 @@ class JSONVariantCaseFSharp : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
     } else {
       if (IS_EMPTY_CURRENT_STRUCT(T)) {
         // Allow just `"Case"` and no `"Fields"` for empty `CURRENT_STRUCT`-s.
-        destination.UncheckedMoveFromUniquePtr(std::move(std::make_unique<T>()));
+        destination.template Construct<T>();
       } else {
         // No PATCH for F#. -- D.K.
         // LCOV_EXCL_START
@@ -203,18 +274,18 @@ class JSONVariantCaseFSharp : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
 template <JSONVariantStyle J, class JSON_FORMAT, typename VARIANT>
 class JSONVariantPerStyle;
 
-template <class JSON_FORMAT>
+template <class JSON_FORMAT, typename VARIANT>
 struct JSONVariantPerStyleRegisterer {
   template <typename X>
   struct StyleCurrent {
     using deserializers_map_t = std::unordered_map<reflection::TypeID,
-                                                   std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT>>,
+                                                   std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT>>,
                                                    GenericHashFunction<::current::reflection::TypeID>>;
 
     StyleCurrent(deserializers_map_t& deserializers) {
       // Silently discard duplicate types in the input type list. They would be deserialized correctly.
       deserializers[Value<reflection::ReflectedTypeBase>(reflection::Reflector().ReflectType<X>()).type_id] =
-          std::make_unique<JSONVariantCaseGeneric<JSON_FORMAT, X>>(
+          std::make_unique<JSONVariantCaseGeneric<JSON_FORMAT, VARIANT, X>>(
               reflection::CurrentTypeName<X, reflection::NameFormat::Z>());
     }
   };
@@ -222,24 +293,24 @@ struct JSONVariantPerStyleRegisterer {
   template <typename X>
   struct StyleSimple {
     using deserializers_map_t =
-        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT>>>;
+        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT>>>;
     StyleSimple(deserializers_map_t& deserializers) {
       // Silently discard duplicate types in the input type list.
       // TODO(dkorolev): This is oh so wrong here.
       const char* name = reflection::CurrentTypeName<X, reflection::NameFormat::Z>();
-      deserializers[name] = std::make_unique<JSONVariantCaseMinimalistic<X, JSON_FORMAT>>(name);
+      deserializers[name] = std::make_unique<JSONVariantCaseMinimalistic<X, JSON_FORMAT, VARIANT>>(name);
     }
   };
 
   template <typename X>
   struct StyleFSharp {
     using deserializers_map_t =
-        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT>>>;
+        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT>>>;
     StyleFSharp(deserializers_map_t& deserializers) {
       // Silently discard duplicate types in the input type list.
       // TODO(dkorolev): This is oh so wrong here.
       deserializers[reflection::CurrentTypeName<X, reflection::NameFormat::Z>()] =
-          std::make_unique<JSONVariantCaseFSharp<X, JSON_FORMAT>>();
+          std::make_unique<JSONVariantCaseFSharp<X, JSON_FORMAT, VARIANT>>();
     }
   };
 };
@@ -248,7 +319,7 @@ template <class JSON_FORMAT, typename VARIANT>
 class JSONVariantPerStyle<JSONVariantStyle::Current, JSON_FORMAT, VARIANT> {
  public:
   template <typename X>
-  using Registerer = typename JSONVariantPerStyleRegisterer<JSON_FORMAT>::template StyleCurrent<X>;
+  using Registerer = typename JSONVariantPerStyleRegisterer<JSON_FORMAT, VARIANT>::template StyleCurrent<X>;
 
   class Impl {
    public:
@@ -278,7 +349,7 @@ class JSONVariantPerStyle<JSONVariantStyle::Current, JSON_FORMAT, VARIANT> {
 
    private:
     using deserializers_map_t = std::unordered_map<reflection::TypeID,
-                                                   std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT>>,
+                                                   std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT>>,
                                                    GenericHashFunction<::current::reflection::TypeID>>;
     deserializers_map_t deserializers_;
   };
@@ -293,7 +364,7 @@ template <class JSON_FORMAT, typename VARIANT>
 class JSONVariantPerStyle<JSONVariantStyle::Simple, JSON_FORMAT, VARIANT> {
  public:
   template <typename X>
-  using RegistererByName = typename JSONVariantPerStyleRegisterer<JSON_FORMAT>::template StyleSimple<X>;
+  using RegistererByName = typename JSONVariantPerStyleRegisterer<JSON_FORMAT, VARIANT>::template StyleSimple<X>;
 
   class ImplMinimalistic {
    public:
@@ -343,7 +414,7 @@ class JSONVariantPerStyle<JSONVariantStyle::Simple, JSON_FORMAT, VARIANT> {
 
    private:
     using deserializers_map_t =
-        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT>>>;
+        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT>>>;
     deserializers_map_t deserializers_;
   };
 
@@ -357,7 +428,7 @@ template <class JSON_FORMAT, typename VARIANT>
 class JSONVariantPerStyle<JSONVariantStyle::NewtonsoftFSharp, JSON_FORMAT, VARIANT> {
  public:
   template <typename X>
-  using RegistererByName = typename JSONVariantPerStyleRegisterer<JSON_FORMAT>::template StyleFSharp<X>;
+  using RegistererByName = typename JSONVariantPerStyleRegisterer<JSON_FORMAT, VARIANT>::template StyleFSharp<X>;
 
   class ImplFSharp {
    public:
@@ -388,7 +459,7 @@ class JSONVariantPerStyle<JSONVariantStyle::NewtonsoftFSharp, JSON_FORMAT, VARIA
 
    private:
     using deserializers_map_t =
-        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT>>>;
+        std::unordered_map<std::string, std::unique_ptr<JSONVariantCaseAbstractBase<JSON_FORMAT, VARIANT>>>;
     deserializers_map_t deserializers_;
   };
 
@@ -416,6 +487,19 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, T, std::enable_if_t<IS_
   }
 };
 
+template <class JSON_FORMAT, typename T>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier, const T& value) {
+    if (Exists(value)) {
+      json::JSONStreamingVariantSerializer<JSON_FORMAT::variant_style, JSON_FORMAT> impl(json_stringifier);
+      value.Call(impl);
+    } else {
+      // Also the absent value of the `Simple` variant style, when not a struct field.
+      json_stringifier.Writer().Null();
+    }
+  }
+};
+
 template <class JSON_FORMAT, typename T>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, T& value) {
@@ -58,6 +58,30 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::vector<bool, TA>>
   }
 };
 
+template <class JSON_FORMAT, typename T, typename TA>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, std::vector<T, TA>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,
+                          const std::vector<T, TA>& value) {
+    json_stringifier.Writer().StartArray();
+    for (const auto& element : value) {
+      Serialize(json_stringifier, element);
+    }
+    json_stringifier.Writer().EndArray();
+  }
+};
+
+template <class JSON_FORMAT, typename TA>
+struct SerializeImpl<json::JSONStreamingStringifier<JSON_FORMAT>, std::vector<bool, TA>> {
+  static void DoSerialize(json::JSONStreamingStringifier<JSON_FORMAT>& json_stringifier,
+                          const std::vector<bool, TA>& value) {
+    json_stringifier.Writer().StartArray();
+    for (const auto&& element : value) {
+      json_stringifier.Writer().Bool(element);
+    }
+    json_stringifier.Writer().EndArray();
+  }
+};
+
 template <class JSON_FORMAT, typename T, typename TA>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::vector<T, TA>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, std::vector<T, TA>& destination) {
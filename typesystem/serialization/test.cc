@@ -182,8 +182,6 @@ CURRENT_STRUCT(WithInnerVariant) { CURRENT_FIELD(v, InnerVariant); };
 }  // namespace named_variant
 }  // namespace serialization_test
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, Binary) {
   using namespace serialization_test;
 
@@ -254,7 +252,6 @@ TEST(Serialization, Binary) {
     ASSERT_THROW(LoadFromBinary<ComplexSerializable>(is), BinaryLoadFromStreamException);
   }
 }
-#endif
 
 TEST(JSONSerialization, CPPTypes) {
   using namespace serialization_test;
@@ -368,8 +365,6 @@ TEST(JSONSerialization, Tuple) {
   }
 }
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, OptionalAsBinary) {
   using namespace serialization_test;
 
@@ -412,7 +407,6 @@ TEST(Serialization, OptionalAsBinary) {
     EXPECT_TRUE(Value(parsed_with_b.b));
   }
 }
-#endif
 
 TEST(JSONSerialization, CurrentStructs) {
   using namespace serialization_test;
@@ -881,8 +875,6 @@ TEST(JSONSerialization, Time) {
   }
 }
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, TimeAsBinary) {
   using namespace serialization_test;
 
@@ -890,7 +882,7 @@ TEST(Serialization, TimeAsBinary) {
     WithTime zero;
     std::ostringstream oss;
     SaveIntoBinary(oss, zero);
-    EXPECT_EQ(16u, oss.str().length());
+    EXPECT_EQ(3u, oss.str().length());  // One byte of frame size, two single-byte varints.
   }
 
   {
@@ -905,7 +897,114 @@ TEST(Serialization, TimeAsBinary) {
     EXPECT_EQ(6ll, parsed.micros.count());
   }
 }
-#endif
+
+TEST(Serialization, BinaryFormat) {
+  using namespace serialization_test;
+
+  // Varints and zigzag varints.
+  EXPECT_EQ(std::string("\x00", 1), ToBinary(uint64_t(0)));
+  EXPECT_EQ("\x7f", ToBinary(uint32_t(127)));
+  EXPECT_EQ("\x80\x01", ToBinary(uint16_t(128)));
+  EXPECT_EQ(10u, ToBinary(std::numeric_limits<uint64_t>::max()).length());
+  EXPECT_EQ("\x01", ToBinary(int64_t(-1)));
+  EXPECT_EQ("\x02", ToBinary(int32_t(1)));
+  EXPECT_EQ(std::numeric_limits<int64_t>::min(), ParseBinary<int64_t>(ToBinary(std::numeric_limits<int64_t>::min())));
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), ParseBinary<int64_t>(ToBinary(std::numeric_limits<int64_t>::max())));
+  EXPECT_EQ(-42, ParseBinary<int16_t>(ToBinary(int16_t(-42))));
+
+  // Single-byte types, floating point types and strings.
+  EXPECT_EQ("\x01", ToBinary(true));
+  EXPECT_EQ("\xff", ToBinary(uint8_t(255)));
+  EXPECT_EQ(8u, ToBinary(0.5).length());
+  EXPECT_EQ(0.5, ParseBinary<double>(ToBinary(0.5)));
+  EXPECT_EQ(0.25f, ParseBinary<float>(ToBinary(0.25f)));
+  EXPECT_EQ("\x03" "foo", ToBinary(std::string("foo")));
+  EXPECT_EQ(std::string("a\0b", 3), ParseBinary<std::string>(ToBinary(std::string("a\0b", 3))));
+  EXPECT_EQ(-5000, ParseBinary<std::chrono::milliseconds>(ToBinary(std::chrono::milliseconds(-5000))).count());
+  EXPECT_EQ(Enum::SET, ParseBinary<Enum>(ToBinary(Enum::SET)));
+
+  // Vectors of arithmetic types are copied as a block.
+  {
+    const std::vector<uint32_t> v({1u, 2u, 3u});
+    const std::string binary = ToBinary(v);
+    EXPECT_EQ(1u + 3u * sizeof(uint32_t), binary.length());
+    EXPECT_EQ(v, ParseBinary<std::vector<uint32_t>>(binary));
+  }
+  EXPECT_EQ((std::vector<bool>{true, false, true}),
+            ParseBinary<std::vector<bool>>(ToBinary(std::vector<bool>{true, false, true})));
+  EXPECT_EQ((std::array<double, 2>{{1.5, -2.5}}),
+            (ParseBinary<std::array<double, 2>>(ToBinary(std::array<double, 2>{{1.5, -2.5}}))));
+  EXPECT_EQ(3u, ParseBinary<std::vector<Empty>>(ToBinary(std::vector<Empty>(3u))).size());
+
+  // Containers.
+  {
+    WithVectorOfPairs object;
+    object.v.emplace_back(-1, "minus one");
+    object.v.emplace_back(1, "one");
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<WithVectorOfPairs>(ToBinary(object))));
+  }
+  {
+    WithTrivialSet object;
+    object.s.insert("a");
+    object.s.insert("b");
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<WithTrivialSet>(ToBinary(object))));
+  }
+  {
+    WithNontrivialUnorderedMap object;
+    object.q[Serializable(1)] = "one";
+    object.q[Serializable(2)] = "two";
+    const auto parsed = ParseBinary<WithNontrivialUnorderedMap>(ToBinary(object));
+    ASSERT_EQ(2u, parsed.q.size());
+    EXPECT_EQ("two", parsed.q.at(Serializable(2)));
+  }
+  {
+    const std::tuple<int, std::string, std::vector<int>> t(42, "tuple", {1, 2});
+    EXPECT_EQ(t, (ParseBinary<std::tuple<int, std::string, std::vector<int>>>(ToBinary(t))));
+  }
+
+  // Variants are tagged by the one-based index of the case, zero stands for an uninitialized `Variant`.
+  {
+    ContainsVariant object;
+    ComplexSerializable complex('a', 'c');
+    complex.j = 42u;
+    complex.z = Serializable(1);
+    object.variant = complex;
+    const std::string binary = ToBinary(object);
+    EXPECT_EQ('\x04', binary[0]);
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<ContainsVariant>(binary)));
+
+    object.variant = AlternativeEmpty();
+    EXPECT_EQ("\x02", ToBinary(object));
+    EXPECT_TRUE(Exists<AlternativeEmpty>(ParseBinary<ContainsVariant>("\x02").variant));
+
+    ASSERT_THROW(ParseBinary<ContainsVariant>("\x05"), BinaryMalformedDataException);
+    EXPECT_EQ(std::string("\x00", 1), ToBinary(ContainsVariant()));
+    ASSERT_THROW(ParseBinary<ContainsVariant>(std::string("\x00", 1)), BinaryUninitializedVariantObjectException);
+  }
+  {
+    named_variant::WithInnerVariant object;
+    object.v = WithOptional();
+    Value<WithOptional>(object.v).i = 42;
+    const auto parsed = ParseBinary<named_variant::WithInnerVariant>(ToBinary(object));
+    EXPECT_EQ(42, Value(Value<WithOptional>(parsed.v).i));
+    EXPECT_FALSE(Exists(Value<WithOptional>(parsed.v).b));
+  }
+
+  // Malformed input.
+  ASSERT_THROW(ParseBinary<std::string>("\x05" "abc"), BinaryMalformedDataException);
+  ASSERT_THROW(ParseBinary<double>("abc"), BinaryUnexpectedEndOfDataException);
+  ASSERT_THROW(ParseBinary<uint32_t>("\x80"), BinaryUnexpectedEndOfDataException);
+  ASSERT_THROW(ParseBinary<uint32_t>("\x01\x02"), BinaryMalformedDataException);
+  ASSERT_THROW(ParseBinary<bool>("\x02"), BinaryMalformedDataException);
+  ASSERT_THROW(ParseBinary<std::vector<uint64_t>>("\xff\xff\xff\xff\x0f"), BinaryMalformedDataException);
+  ASSERT_THROW(ParseBinary<uint64_t>("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x02"), BinaryMalformedDataException);
+  EXPECT_EQ(std::numeric_limits<uint64_t>::max(),
+            ParseBinary<uint64_t>("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01"));
+  // The size of a container of possibly empty elements is capped, as it can not be checked against the input.
+  ASSERT_THROW(ParseBinary<std::vector<Empty>>("\xff\xff\xff\xff\x0f"), BinaryMalformedDataException);
+  ASSERT_THROW(ParseBinary<std::vector<std::string>>("\xff\xff\xff\xff\x0f"), BinaryMalformedDataException);
+  ASSERT_THROW((ParseBinary<std::map<std::string, int>>("\xff\xff\xff\xff\x0f")), BinaryMalformedDataException);
+}
 
 TEST(JSONSerialization, Optional) {
   using namespace serialization_test;
@@ -1254,6 +1353,145 @@ TEST(JSONSerialization, VariantNullOmittedInMinimalisticFormat) {
 
 namespace serialization_test {
 
+// The streaming `JSON()` must be byte-identical to the DOM-based one, in every format.
+template <typename T>
+void ExpectStreamingJSONMatchesDocument(const T& x) {
+  using namespace current::serialization::json;
+  EXPECT_EQ(JSONViaRapidJSONDocument<JSONFormat::Current>(x), JSONViaRapidJSONWriter<JSONFormat::Current>(x));
+  EXPECT_EQ(JSONViaRapidJSONDocument<JSONFormat::Minimalistic>(x),
+            JSONViaRapidJSONWriter<JSONFormat::Minimalistic>(x));
+  EXPECT_EQ(JSONViaRapidJSONDocument<JSONFormat::JavaScript>(x), JSONViaRapidJSONWriter<JSONFormat::JavaScript>(x));
+  EXPECT_EQ(JSONViaRapidJSONDocument<JSONFormat::NewtonsoftFSharp>(x),
+            JSONViaRapidJSONWriter<JSONFormat::NewtonsoftFSharp>(x));
+}
+
+CURRENT_STRUCT(WithEverythingOptional) {
+  CURRENT_FIELD(o, Optional<int32_t>);
+  CURRENT_FIELD(v, simple_variant_t);
+  CURRENT_FIELD(vo, std::vector<Optional<int32_t>>);
+  CURRENT_FIELD(mo, (std::map<std::string, Optional<bool>>));
+  CURRENT_FIELD(vv, std::vector<simple_variant_t>);
+};
+
+}  // namespace serialization_test
+
+TEST(JSONSerialization, StreamingWriterMatchesDocument) {
+  using namespace serialization_test;
+
+  ExpectStreamingJSONMatchesDocument(true);
+  ExpectStreamingJSONMatchesDocument('A');
+  ExpectStreamingJSONMatchesDocument(static_cast<int8_t>(-100));
+  ExpectStreamingJSONMatchesDocument(static_cast<uint8_t>(200));
+  ExpectStreamingJSONMatchesDocument(std::numeric_limits<int64_t>::min());
+  ExpectStreamingJSONMatchesDocument(std::numeric_limits<uint64_t>::max());
+  ExpectStreamingJSONMatchesDocument(3.14159f);
+  ExpectStreamingJSONMatchesDocument(0.1);
+  ExpectStreamingJSONMatchesDocument(-1e300);
+  ExpectStreamingJSONMatchesDocument(std::string("a\0b\t\"c\"\\/\x01\xc3\xa9", 13));
+  ExpectStreamingJSONMatchesDocument(std::chrono::microseconds(-42));
+  ExpectStreamingJSONMatchesDocument(Enum::SET);
+  ExpectStreamingJSONMatchesDocument(static_cast<current::reflection::TypeID>(9000000000000000001ull));
+  ExpectStreamingJSONMatchesDocument(std::vector<bool>({true, false}));
+  ExpectStreamingJSONMatchesDocument(std::array<int, 3>({{1, 2, 3}}));
+  ExpectStreamingJSONMatchesDocument(std::make_tuple(1, std::string("two"), 3.0));
+  ExpectStreamingJSONMatchesDocument(std::make_pair(std::string("key"), Serializable(1, "one", true, Enum::SET)));
+  ExpectStreamingJSONMatchesDocument(std::set<std::string>({"a", "b"}));
+  ExpectStreamingJSONMatchesDocument(std::unordered_map<std::string, int>({{"x", 1}}));
+  ExpectStreamingJSONMatchesDocument(std::unordered_map<int, int>({{1, 2}}));
+  ExpectStreamingJSONMatchesDocument(Optional<int>());
+  ExpectStreamingJSONMatchesDocument(Optional<int>(42));
+  ExpectStreamingJSONMatchesDocument(ImmutableOptional<int>(nullptr));
+  ExpectStreamingJSONMatchesDocument(ImmutableOptional<int>(42));
+  ExpectStreamingJSONMatchesDocument(simple_variant_t());
+  ExpectStreamingJSONMatchesDocument(ComplexSerializable('a', 'z'));
+
+  {
+    DerivedSerializable derived;
+    derived.i = 48;
+    derived.s = "derived";
+    derived.d = 0.125;
+    ExpectStreamingJSONMatchesDocument(derived);
+  }
+  {
+    WithNontrivialMap with_nontrivial_map;
+    with_nontrivial_map.q[Serializable(1, "one", false, Enum::DEFAULT)] = "yes";
+    with_nontrivial_map.q[Serializable(2, "two", true, Enum::SET)] = "no";
+    ExpectStreamingJSONMatchesDocument(with_nontrivial_map);
+  }
+  {
+    WithEverythingOptional object;
+    ExpectStreamingJSONMatchesDocument(object);
+    object.vo.push_back(nullptr);
+    object.vo.push_back(1);
+    object.mo["none"] = nullptr;
+    object.mo["some"] = true;
+    object.vv.emplace_back();
+    object.vv.emplace_back(Empty());
+    ExpectStreamingJSONMatchesDocument(object);
+    object.o = 42;
+    object.v = ComplexSerializable('x', 'y');
+    ExpectStreamingJSONMatchesDocument(object);
+    object.v = AlternativeEmpty();
+    ExpectStreamingJSONMatchesDocument(object);
+  }
+  {
+    named_variant::WithInnerVariant object;
+    object.v = WithOptional();
+    ExpectStreamingJSONMatchesDocument(object);
+    named_variant::WrappedQ wrapped{named_variant::OuterB()};
+    Value<named_variant::OuterB>(wrapped).b = named_variant::T();
+    ExpectStreamingJSONMatchesDocument(wrapped);
+  }
+
+  // The output helpers.
+  {
+    std::string s = "prefix:";
+    AppendJSON(s, Serializable(1, "one", true, Enum::SET));
+    EXPECT_EQ("prefix:{\"i\":1,\"s\":\"one\",\"b\":true,\"e\":100}", s);
+    std::ostringstream os;
+    current::serialization::json::WriteJSON<JSONFormat::NewtonsoftFSharp>(os, Optional<int>(1));
+    EXPECT_EQ("{\"Case\":\"Some\",\"Fields\":[1]}", os.str());
+  }
+}
+
+TEST(JSONSerialization, ParserContextIsReused) {
+  using namespace serialization_test;
+
+  // Parse many times, with the per-thread context growing and being cleared in between.
+  for (int i = 0; i < 100; ++i) {
+    const std::string s(static_cast<size_t>(i * 1000), 'x');
+    const auto parsed = ParseJSON<Serializable>(JSON(Serializable(i, s, (i % 2) != 0, Enum::SET)));
+    EXPECT_EQ(static_cast<uint64_t>(i), parsed.i);
+    EXPECT_EQ(s, parsed.s);
+  }
+
+  // A parse error must not leave the per-thread context locked.
+  ASSERT_THROW(ParseJSON<Serializable>("not a json"), InvalidJSONException);
+  EXPECT_EQ("ok", ParseJSON<Serializable>("{\"i\":1,\"s\":\"ok\",\"b\":true,\"e\":100}").s);
+
+  // The input does not have to be null-terminated, and is not modified by the in situ parse.
+  {
+    const std::string buffer = "{\"i\":2,\"s\":\"a\\tb\",\"b\":false,\"e\":0}trailing";
+    const auto parsed = ParseJSON<Serializable>(std::string_view(buffer).substr(0, buffer.length() - 8u));
+    EXPECT_EQ(2u, parsed.i);
+    EXPECT_EQ("a\tb", parsed.s);
+    EXPECT_EQ("{\"i\":2,\"s\":\"a\\tb\",\"b\":false,\"e\":0}trailing", buffer);
+  }
+
+  // A nested parse, while the per-thread context is in use, gets a context of its own.
+  {
+    current::serialization::json::JSONParser<JSONFormat::Current> outer(
+        "{\"i\":3,\"s\":\"outer\",\"b\":true,\"e\":100}");
+    EXPECT_EQ("inner", ParseJSON<Serializable>("{\"i\":4,\"s\":\"inner\",\"b\":true,\"e\":100}").s);
+    Serializable parsed;
+    current::serialization::Deserialize(outer, parsed);
+    EXPECT_EQ(3u, parsed.i);
+    EXPECT_EQ("outer", parsed.s);
+  }
+}
+
+namespace serialization_test {
+
 CURRENT_STRUCT_T(TemplatedValue) {
   CURRENT_FIELD(value, T);
   CURRENT_DEFAULT_CONSTRUCTOR_T(TemplatedValue) : value() {}
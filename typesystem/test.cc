@@ -1553,6 +1553,82 @@ TEST(TypeSystemTest, InplaceVariantConstruction) {
 
 namespace struct_definition_test {
 
+CURRENT_STRUCT(TooLargeToStoreInline) {
+  CURRENT_FIELD(a, std::string);
+  CURRENT_FIELD(b, std::string);
+  CURRENT_FIELD(c, std::string);
+};
+
+CURRENT_FORWARD_DECLARE_STRUCT(VariantTreeNode);
+using variant_tree_t = Variant<Foo, VariantTreeNode>;
+CURRENT_STRUCT(VariantTreeNode) { CURRENT_FIELD(child, variant_tree_t); };
+
+}  // namespace struct_definition_test
+
+TEST(TypeSystemTest, VariantInlineAndHeapStorage) {
+  using namespace struct_definition_test;
+  using current::variant::IsStoredInline;
+
+  static_assert(IsStoredInline<Foo>(), "");
+  static_assert(!IsStoredInline<TooLargeToStoreInline>(), "");
+  static_assert(std::is_nothrow_move_constructible_v<Variant<Foo, TooLargeToStoreInline>>, "");
+
+  const auto IsWithin = [](const void* ptr, const auto& object) {
+    return ptr >= static_cast<const void*>(&object) && ptr < static_cast<const void*>(&object + 1);
+  };
+
+  // The small values are stored within the `Variant`, and are moved along with it.
+  {
+    Variant<Foo, TooLargeToStoreInline> v(Foo(1u));
+    EXPECT_TRUE(IsWithin(&Value<Foo>(v), v));
+    Variant<Foo, TooLargeToStoreInline> w(std::move(v));
+    EXPECT_FALSE(Exists(v));
+    EXPECT_TRUE(IsWithin(&Value<Foo>(w), w));
+    EXPECT_EQ(1u, Value<Foo>(w).i);
+  }
+
+  // The large values are allocated on the heap, and are not moved when the `Variant` is.
+  {
+    Variant<Foo, TooLargeToStoreInline> v(TooLargeToStoreInline{});
+    Value<TooLargeToStoreInline>(v).a = "a";
+    const TooLargeToStoreInline* ptr = &Value<TooLargeToStoreInline>(v);
+    EXPECT_FALSE(IsWithin(ptr, v));
+    Variant<Foo, TooLargeToStoreInline> w(std::move(v));
+    EXPECT_FALSE(Exists(v));
+    EXPECT_EQ(ptr, &Value<TooLargeToStoreInline>(w));
+    EXPECT_EQ("a", Value<TooLargeToStoreInline>(w).a);
+    w = Foo(2u);
+    EXPECT_EQ(2u, Value<Foo>(w).i);
+  }
+
+  // The values of the derived types are retrievable as their base types.
+  {
+    Variant<DerivedFromFoo, Bar> v(DerivedFromFoo(1u));
+    EXPECT_TRUE(Exists<Foo>(v));
+    EXPECT_EQ(1001u, Value<Foo>(v).i);
+    EXPECT_FALSE(Exists<Bar>(v));
+    EXPECT_THROW(Value<Bar>(v), NoValueOfTypeException<Bar>);
+  }
+
+  // The value can be replaced by a part of itself.
+  {
+    Variant<Foo, Bar> v(Foo(3u));
+    v = Value<Foo>(v);
+    EXPECT_EQ(3u, Value<Foo>(v).i);
+
+    variant_tree_t tree(VariantTreeNode{});
+    Value<VariantTreeNode>(tree).child = VariantTreeNode{};
+    Value<VariantTreeNode>(Value<VariantTreeNode>(tree).child).child = Foo(4u);
+    tree = std::move(Value<VariantTreeNode>(tree).child);
+    ASSERT_TRUE(Exists<VariantTreeNode>(tree));
+    tree = Value<VariantTreeNode>(tree).child;
+    ASSERT_TRUE(Exists<Foo>(tree));
+    EXPECT_EQ(4u, Value<Foo>(tree).i);
+  }
+}
+
+namespace struct_definition_test {
+
 CURRENT_STRUCT(DoesNotSupportPatch) { CURRENT_FIELD(x, int32_t, 0); };
 
 CURRENT_STRUCT(PatchToY) { CURRENT_FIELD(dy, int32_t, 0); };
@@ -34,7 +34,9 @@ SOFTWARE.
 
 #include "../port.h"  // `make_unique`.
 
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <type_traits>
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
@@ -63,6 +65,29 @@ using object_base_t = CurrentStruct;
 // When variant inner type checks are compile-time, variant nesting is fully supported.
 using object_base_t = CurrentSuper;
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
+
+// The objects of up to this size are stored in the `Variant` itself, the larger ones are allocated on the heap.
+constexpr size_t kInlineStorageSize = CURRENT_VARIANT_INLINE_STORAGE_SIZE;
+
+// Only the types which can be moved without throwing are stored in place, so that moving a `Variant` never throws.
+template <typename T>
+constexpr bool IsStoredInline() {
+  return sizeof(T) <= kInlineStorageSize && alignof(T) <= alignof(std::max_align_t) &&
+         std::is_nothrow_move_constructible_v<T>;
+}
+
+constexpr size_t kNoTypeIndex = static_cast<size_t>(-1);
+
+// The index of `X` in `TS...`, or `sizeof...(TS)` if it is not there. The first one wins for the duplicate types.
+template <typename X, typename... TS>
+constexpr size_t TypeIndex() {
+  constexpr bool same[] = {std::is_same_v<X, TS>..., false};
+  size_t index = 0u;
+  while (index < sizeof...(TS) && !same[index]) {
+    ++index;
+  }
+  return index;
+}
 }  // namespace variant
 
 struct BypassVariantTypeCheck {};
@@ -125,10 +150,9 @@ struct IHasUncheckedMoveFromUniquePtr : CurrentVariant {
 // The user hold the risk of having duplicate types, and it's their responsibility to pass in a `TypeList<...>`
 // instead of a `TypeListImpl<...>` in such a case, to ensure type de-duplication takes place.
 
-// Initializes an `std::unique_ptr<current::variant::object_base_t>` given the object of the right type.
-// The input object could be an object itself (in which case it's copied),
-// an `std::move()`-d `std::unique_ptr` to that object (in which case it's moved),
-// or a bare pointer (in which case it's captured).
+// The value is stored along with the index of its type in `TYPES...`, and all the dispatching, from `Call()` to
+// copying, moving, and destroying the value, goes through the tables of functions indexed by it.
+// The values of small types are stored in place, see `variant::IsStoredInline<T>()`, the rest are heap-allocated.
 template <typename NAME, typename TYPE_LIST>
 struct VariantImpl;
 
@@ -143,8 +167,12 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   VariantImpl() {}
 
-  VariantImpl(BypassVariantTypeCheck, std::unique_ptr<current::variant::object_base_t>&& rhs)
-      : object_(std::move(rhs)) {}
+  ~VariantImpl() { Reset(); }
+
+  // The object is captured if its type is stored on the heap, and moved into the `Variant` otherwise.
+  VariantImpl(BypassVariantTypeCheck, std::unique_ptr<current::variant::object_base_t>&& rhs) {
+    AdoptUniquePtr(std::move(rhs));
+  }
 
   // Use deep copy helper for all Variant types, including our own.
   VariantImpl(const VariantImpl& rhs) { CopyFrom(rhs); }
@@ -153,8 +181,8 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
     CopyFrom(rhs);
   }
 
-  // Default move constructor for the same Variant type as ours.
-  VariantImpl(VariantImpl&& rhs) = default;
+  // Move constructor for the same Variant type as ours, never throws, see `variant::IsStoredInline<T>()`.
+  VariantImpl(VariantImpl&& rhs) noexcept { MoveFromSameType(rhs); }
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
   template <typename... RHS>
@@ -173,25 +201,42 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   VariantImpl(X&& input) {
     using decayed_t = current::decay_t<X>;
     variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_t>();
-    object_ = std::make_unique<decayed_t>(std::forward<X>(input));
+    Emplace<decayed_t>(std::forward<X>(input));
   }
 #else
   template <typename X, class ENABLE = std::enable_if_t<TypeListContains<typelist_t, current::decay_t<X>>::value>>
   VariantImpl(X&& input) {
-    using decayed_t = current::decay_t<X>;
-    object_ = std::make_unique<decayed_t>(std::forward<X>(input));
+    Emplace<current::decay_t<X>>(std::forward<X>(input));
   }
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 
-  void operator=(std::nullptr_t) { object_ = nullptr; }
+  void operator=(std::nullptr_t) { Reset(); }
 
   VariantImpl& operator=(const VariantImpl& rhs) {
-    CopyFrom(rhs);
+    if (this != &rhs) {
+      if (index_ == variant::kNoTypeIndex) {
+        CopyFrom(rhs);
+      } else {
+        // The `rhs` may well be part of the value being replaced, so it is copied before that value is destroyed.
+        VariantImpl copy(rhs);
+        Reset();
+        MoveFromSameType(copy);
+      }
+    }
     return *this;
   }
 
-  VariantImpl& operator=(VariantImpl&& rhs) {
-    object_ = std::move(rhs.object_);
+  VariantImpl& operator=(VariantImpl&& rhs) noexcept {
+    if (this != &rhs) {
+      if (index_ == variant::kNoTypeIndex) {
+        MoveFromSameType(rhs);
+      } else {
+        // The `rhs` may well be part of the value being replaced, so it is moved out before that value is destroyed.
+        VariantImpl moved(std::move(rhs));
+        Reset();
+        MoveFromSameType(moved);
+      }
+    }
     return *this;
   }
 
@@ -205,12 +250,12 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
     variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_t>();
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
-    object_ = std::make_unique<decayed_t>(std::forward<X>(input));
+    Emplace<decayed_t>(std::forward<X>(input));
     return *this;
   }
 
   void UncheckedMoveFromUniquePtr(std::unique_ptr<current::variant::object_base_t> input) override {
-    object_ = std::move(input);
+    AdoptUniquePtr(std::move(input));
   }
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
@@ -219,15 +264,18 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   template <typename T, typename... ARGS, class ENABLE = std::enable_if_t<TypeListContains<typelist_t, T>::value>>
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
   T& Construct(ARGS&&... args) {
-    object_ = std::make_unique<T>(std::forward<ARGS>(args)...);
-    return *dynamic_cast<T*>(object_.get());
+#ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
+    variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<T>();
+#endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
+    return Emplace<T>(std::forward<ARGS>(args)...);
   }
-  operator bool() const { return object_ ? true : false; }
+  operator bool() const { return index_ != variant::kNoTypeIndex; }
 
   template <typename F>
   void Call(F&& f) {
-    if (object_) {
-      current::metaprogramming::RTTIDynamicCall<typelist_t>(*object_, std::forward<F>(f));
+    if (index_ != variant::kNoTypeIndex) {
+      static constexpr void (*handlers[])(VariantImpl&, F&) = {&VariantImpl::template CallCase<TYPES, F>...};
+      handlers[index_](*this, f);
     } else {
       CURRENT_THROW(UninitializedVariantOfTypeException<TYPES...>());
     }
@@ -235,29 +283,31 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   template <typename F>
   void Call(F&& f) const {
-    if (object_) {
-      current::metaprogramming::RTTIDynamicCall<typelist_t>(*object_, std::forward<F>(f));
+    if (index_ != variant::kNoTypeIndex) {
+      static constexpr void (*handlers[])(const VariantImpl&, F&) = {
+          &VariantImpl::template ConstCallCase<TYPES, F>...};
+      handlers[index_](*this, f);
     } else {
       CURRENT_THROW(UninitializedVariantOfTypeException<TYPES...>());
     }
   }
 
   // By design, `VariantExistsImpl<T>()` and `VariantValueImpl<T>()` do not check
-  // whether `X` is part of `typelist_t`. More specifically, they pass if `dynamic_cast<>` succeeds,
-  // and thus will successfully retrieve a derived type as a base one,
+  // whether `X` is part of `typelist_t`. More specifically, they pass if the value is of a type derived from `X`,
+  // as `dynamic_cast<>` would, and thus will successfully retrieve a derived type as a base one,
   // regardless of whether the base one is present in `typelist_t`.
   // Use `Call()` to run a strict check.
 
-  bool ExistsImpl() const { return (object_.get() != nullptr); }
+  bool ExistsImpl() const { return index_ != variant::kNoTypeIndex; }
 
   template <typename X>
   std::enable_if_t<!std::is_same_v<X, current::variant::object_base_t>, bool> VariantExistsImpl() const {
-    return dynamic_cast<const X*>(object_.get()) != nullptr;
+    return ValuePointer<X>() != nullptr;
   }
 
   template <typename X>
   std::enable_if_t<!std::is_same_v<X, current::variant::object_base_t>, X&> VariantValueImpl() {
-    X* ptr = dynamic_cast<X*>(object_.get());
+    X* ptr = const_cast<X*>(ValuePointer<X>());
     if (ptr) {
       return *ptr;
     } else {
@@ -267,7 +317,7 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   template <typename X>
   const X& VariantValueImpl() const {
-    const X* ptr = dynamic_cast<const X*>(object_.get());
+    const X* ptr = ValuePointer<X>();
     if (ptr) {
       return *ptr;
     } else {
@@ -285,21 +335,177 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   }
 
  private:
+  template <typename T>
+  static constexpr size_t IndexOf() {
+    return variant::TypeIndex<T, TYPES...>();
+  }
+
+  template <typename T>
+  T& StoredValue() {
+    if constexpr (variant::IsStoredInline<T>()) {
+      return *std::launder(reinterpret_cast<T*>(inline_));
+    } else {
+      return *static_cast<T*>(heap_);
+    }
+  }
+
+  template <typename T>
+  const T& StoredValue() const {
+    return const_cast<VariantImpl*>(this)->template StoredValue<T>();
+  }
+
+  template <typename T, typename F>
+  static void CallCase(VariantImpl& self, F& f) {
+    f(self.template StoredValue<T>());
+  }
+
+  template <typename T, typename F>
+  static void ConstCallCase(const VariantImpl& self, F& f) {
+    f(self.template StoredValue<T>());
+  }
+
+  template <typename X, typename T>
+  static const X* ValuePointerCase(const VariantImpl& self) {
+    if constexpr (std::is_convertible_v<const T*, const X*>) {
+      return &self.template StoredValue<T>();
+    } else {
+      return nullptr;
+    }
+  }
+
+  template <typename X>
+  const X* ValuePointer() const {
+    if (index_ != variant::kNoTypeIndex) {
+      static constexpr const X* (*casts[])(const VariantImpl&) = {&VariantImpl::template ValuePointerCase<X, TYPES>...};
+      return casts[index_](*this);
+    } else {
+      return nullptr;
+    }
+  }
+
+  // Replaces the value, if any, by the newly constructed `T`. The new value is constructed before the old one
+  // is destroyed, as `args` may well refer to the old one.
+  template <typename T, typename... ARGS>
+  T& Emplace(ARGS&&... args) {
+    if constexpr (variant::IsStoredInline<T>()) {
+      if (index_ == variant::kNoTypeIndex) {
+        T* result = new (inline_) T(std::forward<ARGS>(args)...);
+        index_ = IndexOf<T>();
+        return *result;
+      } else {
+        T value(std::forward<ARGS>(args)...);
+        Reset();
+        return Emplace<T>(std::move(value));
+      }
+    } else {
+      T* result = new T(std::forward<ARGS>(args)...);
+      Reset();
+      heap_ = result;
+      index_ = IndexOf<T>();
+      return *result;
+    }
+  }
+
+  template <typename T>
+  static void DestroyCase(VariantImpl& self) noexcept {
+    if constexpr (variant::IsStoredInline<T>()) {
+      self.template StoredValue<T>().~T();
+    } else {
+      delete &self.template StoredValue<T>();
+    }
+  }
+
+  void Reset() noexcept {
+    if (index_ != variant::kNoTypeIndex) {
+      static constexpr void (*destroyers[])(VariantImpl&) = {&VariantImpl::template DestroyCase<TYPES>...};
+      const size_t index = index_;
+      index_ = variant::kNoTypeIndex;
+      destroyers[index](*this);
+    }
+  }
+
+  // Takes over the value of `from`, which is then left empty. The `into` must be empty.
+  template <typename T>
+  static void MoveCase(VariantImpl& into, VariantImpl& from) noexcept {
+    if constexpr (variant::IsStoredInline<T>()) {
+      T& value = from.template StoredValue<T>();
+      new (into.inline_) T(std::move(value));
+      value.~T();
+    } else {
+      into.heap_ = from.heap_;
+    }
+  }
+
+  // Must only be called on an empty `Variant`.
+  void MoveFromSameType(VariantImpl& rhs) noexcept {
+    if (rhs.index_ != variant::kNoTypeIndex) {
+      static constexpr void (*movers[])(VariantImpl&, VariantImpl&) = {&VariantImpl::template MoveCase<TYPES>...};
+      const size_t index = rhs.index_;
+      rhs.index_ = variant::kNoTypeIndex;
+      movers[index](*this, rhs);
+      index_ = index;
+    }
+  }
+
+  // Takes over the value of type `U` from another type of `Variant`, which is then left empty.
+  template <typename U, typename RHS_VARIANT>
+  void MoveValueFrom(RHS_VARIANT& from) {
+    if constexpr (variant::IsStoredInline<U>()) {
+      Emplace<U>(std::move(from.template StoredValue<U>()));
+      from.Reset();
+    } else {
+      Reset();
+      heap_ = from.heap_;
+      index_ = IndexOf<U>();
+      from.index_ = variant::kNoTypeIndex;
+    }
+  }
+
+  // Takes over the object owned by `input`, of one of `TYPES...`, found by its RTTI.
+  void AdoptUniquePtr(std::unique_ptr<current::variant::object_base_t>&& input) {
+    if (input) {
+      TypeAwareAdopt adopter(*this, input);
+      current::metaprogramming::RTTIDynamicCall<typelist_t>(*input, adopter);
+    } else {
+      Reset();
+    }
+  }
+
+  struct TypeAwareAdopt {
+    VariantImpl& into;
+    std::unique_ptr<current::variant::object_base_t>& from;
+    TypeAwareAdopt(VariantImpl& into, std::unique_ptr<current::variant::object_base_t>& from)
+        : into(into), from(from) {}
+
+    template <typename U>
+    void operator()(U& instance) {
+      if constexpr (variant::IsStoredInline<U>()) {
+        into.template Emplace<U>(std::move(instance));
+        from = nullptr;
+      } else {
+        into.Reset();
+        static_cast<void>(from.release());
+        into.heap_ = &instance;
+        into.index_ = IndexOf<U>();
+      }
+    }
+  };
+
   struct TypeAwareClone {
-    std::unique_ptr<current::variant::object_base_t>& into;
-    TypeAwareClone(std::unique_ptr<current::variant::object_base_t>& into) : into(into) {}
+    VariantImpl& into;
+    TypeAwareClone(VariantImpl& into) : into(into) {}
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
     template <typename U>
     void operator()(const U& instance) {
       using decayed_u = current::decay_t<U>;
       variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_u>();
-      into = std::make_unique<decayed_u>(instance);
+      into.template Emplace<decayed_u>(instance);
     }
 #else
     template <typename U>
     std::enable_if_t<TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(const U& instance) {
-      into = std::make_unique<current::decay_t<U>>(instance);
+      into.template Emplace<current::decay_t<U>>(instance);
     }
 
     template <typename U>
@@ -309,56 +515,58 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
   };
 
+  template <typename RHS_VARIANT>
   struct TypeAwareMove {
-    // `from` should not be an rvalue reference, as the move operation in `operator()` may still throw.
-    std::unique_ptr<current::variant::object_base_t>& from;
-    std::unique_ptr<current::variant::object_base_t>& into;
-    TypeAwareMove(std::unique_ptr<current::variant::object_base_t>& from,
-                  std::unique_ptr<current::variant::object_base_t>& into)
-        : from(from), into(into) {}
+    // The value is only taken over from `from` once it is known to be of the type `into` can hold.
+    RHS_VARIANT& from;
+    VariantImpl& into;
+    TypeAwareMove(RHS_VARIANT& from, VariantImpl& into) : from(from), into(into) {}
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
     template <typename U>
-    void operator()(U&&) {
+    void operator()(U&) {
       using decayed_u = current::decay_t<U>;
       variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_u>();
-      into = std::move(from);
+      into.template MoveValueFrom<decayed_u>(from);
     }
 #else
     template <typename U>
-    std::enable_if_t<TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(U&&) {
-      into = std::move(from);
+    std::enable_if_t<TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(U&) {
+      into.template MoveValueFrom<current::decay_t<U>>(from);
     }
 
     template <typename U>
-    std::enable_if_t<!TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(U&&) {
+    std::enable_if_t<!TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(U&) {
       CURRENT_THROW(IncompatibleVariantTypeException<current::decay_t<U>>());
     }
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
   };
 
+  // Must only be called on an empty `Variant`.
   template <typename... RHS>
   void CopyFrom(const VariantImpl<RHS...>& rhs) {
-    if (rhs.object_) {
-      TypeAwareClone cloner(object_);
+    if (rhs.index_ != variant::kNoTypeIndex) {
+      TypeAwareClone cloner(*this);
       rhs.Call(cloner);
-    } else {
-      object_ = nullptr;
     }
   }
 
+  // Must only be called on an empty `Variant`.
   template <typename... RHS>
   void MoveFrom(VariantImpl<RHS...>&& rhs) {
-    if (rhs.object_) {
-      TypeAwareMove mover(rhs.object_, object_);
+    if (rhs.index_ != variant::kNoTypeIndex) {
+      TypeAwareMove<VariantImpl<RHS...>> mover(rhs, *this);
       rhs.Call(mover);
-    } else {
-      object_ = nullptr;
     }
   }
 
  private:
-  std::unique_ptr<current::variant::object_base_t> object_;
+  // The index of the type of the value in `TYPES...`, or `variant::kNoTypeIndex` if there is no value.
+  size_t index_ = variant::kNoTypeIndex;
+  union {
+    alignas(std::max_align_t) char inline_[variant::kInlineStorageSize ? variant::kInlineStorageSize : 1u];
+    void* heap_;
+  };
 };
 
 // `Variant<...>` can accept either a list of types, or a `TypeList<...>`.